@@ -1,965 +1,1655 @@
 #include "ARM64InstructionDecoder.h"
-#include <stdio.h>
 #include <string.h>
-#include <stdlib.h>
 
-// MARK: - Bit Manipulation Macros
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define A64_BATCH_NEON 1
+#elif defined(__x86_64__) || defined(__SSE2__)
+#include <immintrin.h>
+#define A64_BATCH_SSE2 1
+#endif
 
-#define BITS(ins, start, end) (((ins) >> (start)) & ((1U << ((end) - (start) + 1)) - 1))
-#define BIT(ins, pos) (((ins) >> (pos)) & 1)
+#define A64_BATCH_BLOCK 256
 
-static inline int64_t sign_extend(uint64_t value, int bits) {
-    if (value & (1ULL << (bits - 1))) {
-        return (int64_t)(value | (~0ULL << bits));
-    }
+/* The one ARM64 decoder in the tree. Words are decoded through per-class
+   mask/value tables into a mnemonic, structured operands and semantics
+   (branch target, register masks, NZCV writes); DisassemblyEngine and the
+   Swift services render text from that result instead of decoding again. */
+
+// MARK: - Register and Condition Names
+
+#define A64_REGISTER_NAMES(p, last) \
+    p "0", p "1", p "2", p "3", p "4", p "5", p "6", p "7", \
+    p "8", p "9", p "10", p "11", p "12", p "13", p "14", p "15", \
+    p "16", p "17", p "18", p "19", p "20", p "21", p "22", p "23", \
+    p "24", p "25", p "26", p "27", p "28", p "29", p "30", last
+
+static const char *const a64_register_names[][32] = {
+    [ARM64_REG_X] = { A64_REGISTER_NAMES("X", "XZR") },
+    [ARM64_REG_W] = { A64_REGISTER_NAMES("W", "WZR") },
+    [ARM64_REG_XSP] = { A64_REGISTER_NAMES("X", "SP") },
+    [ARM64_REG_WSP] = { A64_REGISTER_NAMES("W", "WSP") },
+    [ARM64_REG_B] = { A64_REGISTER_NAMES("B", "B31") },
+    [ARM64_REG_H] = { A64_REGISTER_NAMES("H", "H31") },
+    [ARM64_REG_S] = { A64_REGISTER_NAMES("S", "S31") },
+    [ARM64_REG_D] = { A64_REGISTER_NAMES("D", "D31") },
+    [ARM64_REG_Q] = { A64_REGISTER_NAMES("Q", "Q31") },
+};
+
+const char* arm64dec_register_name(ARM64Register reg) {
+    if (reg.num > 31 || reg.kind > ARM64_REG_Q) return "???";
+    return a64_register_names[reg.kind][reg.num];
+}
+
+const char* arm64dec_condition_name(ARM64Condition cond) {
+    static const char *const names[] = {
+        "EQ", "NE", "CS", "CC", "MI", "PL", "VS", "VC",
+        "HI", "LS", "GE", "LT", "GT", "LE", "AL", "NV"
+    };
+    return names[cond & 0xF];
+}
+
+// MARK: - Decoder State
+
+typedef struct {
+    const char *mnemonic;
+    char name[16];      // storage for mnemonics assembled from fields
+    ARM64DecodedInstruction *inst;
+} A64Decoded;
+
+typedef struct A64Encoding A64Encoding;
+typedef void (*A64DecodeFn)(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *out, ARM64DecodedInstruction *inst);
+
+/* One encoding row: the first row of a class whose mask/value matches owns
+   the word. A handler that finds the fields unallocated leaves `mnemonic`
+   unset and the search continues. */
+struct A64Encoding {
+    uint32_t mask;
+    uint32_t value;
+    const char *mnemonic;
+    A64DecodeFn decode;
+    uint8_t category;
+};
+
+typedef struct {
+    const A64Encoding *rows;
+    uint32_t row_count;
+    const A64Encoding *fallback;
+} A64EncodingClass;
+
+static inline int64_t a64_sext(uint64_t value, unsigned bits) {
+    if (value & (1ULL << (bits - 1))) value |= ~0ULL << bits;
     return (int64_t)value;
 }
 
-static inline uint64_t replicate(uint64_t value, int from_width, int to_width) {
-    uint64_t result = 0;
-    for (int i = 0; i < to_width; i += from_width) {
-        result |= value << i;
-    }
-    return result;
+static inline uint64_t a64_bit(uint8_t reg, uint8_t kind) {
+    if (kind > ARM64_REG_WSP) return 0;
+    if (reg == 31 && (kind == ARM64_REG_X || kind == ARM64_REG_W)) return 0;
+    return 1ULL << reg;
 }
 
-static inline uint64_t ror64(uint64_t value, int shift) {
-    return (value >> shift) | (value << (64 - shift));
+static inline ARM64Operand* a64_push(A64Decoded *d, ARM64OperandType type) {
+    ARM64Operand *op = &d->inst->operands[d->inst->operand_count++];
+    memset(op, 0, sizeof(ARM64Operand));
+    op->type = type;
+    return op;
 }
 
-static bool decode_bitmask_immediate(uint8_t n, uint8_t immr, uint8_t imms, bool is_64, uint64_t *out_value) {
-    if (!out_value) return false;
-    
-    uint8_t len = 0;
-    uint8_t levels;
-    
-    if (n == 1) {
-        len = 6;
-        levels = 0x3F;
-    } else {
-        uint8_t not_imms = (~imms) & 0x3F;
-        if (not_imms == 0) {
-            return false;
-        }
-        
-        int leading_zeros = 0;
-        for (int i = 5; i >= 0; i--) {
-            if (not_imms & (1 << i)) break;
-            leading_zeros++;
+static inline void a64_reg(A64Decoded *d, uint8_t kind, uint8_t reg) {
+    ARM64Operand *op = a64_push(d, ARM64_OPERAND_REG);
+    op->reg.kind = kind;
+    op->reg.num = reg;
+}
+
+static inline void a64_imm(A64Decoded *d, ARM64OperandType type, int64_t value) {
+    a64_push(d, type)->imm = value;
+}
+
+static inline void a64_shift(A64Decoded *d, uint8_t shift, uint8_t amount, bool show_amount) {
+    ARM64Operand *op = a64_push(d, ARM64_OPERAND_SHIFT);
+    op->shift = shift;
+    op->amount = amount;
+    op->show_amount = show_amount;
+}
+
+static inline void a64_mem(A64Decoded *d, uint8_t base, uint8_t mode, int64_t displacement) {
+    ARM64Operand *op = a64_push(d, ARM64_OPERAND_MEM);
+    op->reg.kind = ARM64_REG_XSP;
+    op->reg.num = base;
+    op->mode = mode;
+    op->imm = displacement;
+}
+
+static inline void a64_mem_index(A64Decoded *d, uint8_t base, uint8_t index, uint8_t index_kind,
+                                 uint8_t extend, uint8_t amount, bool show_amount) {
+    ARM64Operand *op = a64_push(d, ARM64_OPERAND_MEM);
+    op->reg.kind = ARM64_REG_XSP;
+    op->reg.num = base;
+    op->mode = (extend == ARM64_SHIFT_LSL) ? ARM64_ADDR_REG_OFFSET : ARM64_ADDR_REG_EXTENDED;
+    op->index.kind = index_kind;
+    op->index.num = index;
+    op->shift = extend;
+    op->amount = amount;
+    op->show_amount = show_amount;
+}
+
+static void a64_compose(A64Decoded *d, const char *stem, bool acquire, bool release, uint8_t size) {
+    size_t len = strlen(stem);
+    memcpy(d->name, stem, len);
+    if (acquire) d->name[len++] = 'A';
+    if (release) d->name[len++] = 'L';
+    if (size == 0) d->name[len++] = 'B';
+    else if (size == 1) d->name[len++] = 'H';
+    d->name[len] = '\0';
+    d->mnemonic = d->name;
+}
+
+// MARK: - Text Rendering
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t cap;
+} A64Text;
+
+static inline void a64_putc(A64Text *t, char c) {
+    if (t->len + 1 < t->cap) t->buf[t->len++] = c;
+}
+
+static inline void a64_puts(A64Text *t, const char *s) {
+    while (*s && t->len + 1 < t->cap) t->buf[t->len++] = *s++;
+}
+
+static void a64_put_dec(A64Text *t, int64_t value) {
+    char digits[24];
+    int n = 0;
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    do {
+        digits[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) a64_putc(t, '-');
+    while (n) a64_putc(t, digits[--n]);
+}
+
+static void a64_put_hex(A64Text *t, uint64_t value, bool upper) {
+    const char *alphabet = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char digits[16];
+    int n = 0;
+    do {
+        digits[n++] = alphabet[value & 0xF];
+        value >>= 4;
+    } while (value);
+    a64_puts(t, "0x");
+    while (n) a64_putc(t, digits[--n]);
+}
+
+static const char *const a64_shift_names[] = {
+    "LSL", "LSR", "ASR", "ROR",
+    "UXTB", "UXTH", "UXTW", "UXTX", "SXTB", "SXTH", "SXTW", "SXTX",
+};
+
+/* System registers worth naming; anything else prints as S<op0>_<op1>_c<n>_c<m>_<op2>.
+   Keys are the 16-bit o0:op1:CRn:CRm:op2 field at bits 5..20 of MRS/MSR. */
+static const struct { uint16_t key; const char *name; } a64_sysregs[] = {
+    { 0xD801, "CTR_EL0" },
+    { 0xD807, "DCZID_EL0" },
+    { 0xDA10, "NZCV" },
+    { 0xDA20, "FPCR" },
+    { 0xDA21, "FPSR" },
+    { 0xDE82, "TPIDR_EL0" },
+    { 0xDE83, "TPIDRRO_EL0" },
+    { 0xDF00, "CNTFRQ_EL0" },
+    { 0xDF01, "CNTPCT_EL0" },
+    { 0xDF02, "CNTVCT_EL0" },
+};
+
+static void a64_put_sysreg(A64Text *t, uint16_t key) {
+    for (size_t i = 0; i < sizeof(a64_sysregs) / sizeof(a64_sysregs[0]); i++) {
+        if (a64_sysregs[i].key == key) {
+            a64_puts(t, a64_sysregs[i].name);
+            return;
         }
-        
-        len = 5 - leading_zeros;
-        levels = (1 << len) - 1;
-        
-        if (!is_64 && len == 5) {
-            return false;
+    }
+    a64_putc(t, 'S');
+    a64_put_dec(t, (key >> 14) & 0x3);
+    a64_putc(t, '_');
+    a64_put_dec(t, (key >> 11) & 0x7);
+    a64_puts(t, "_c");
+    a64_put_dec(t, (key >> 7) & 0xF);
+    a64_puts(t, "_c");
+    a64_put_dec(t, (key >> 3) & 0xF);
+    a64_putc(t, '_');
+    a64_put_dec(t, key & 0x7);
+}
+
+static const char *const a64_barrier_options[16] = {
+    NULL, "OSHLD", "OSHST", "OSH", NULL, "NSHLD", "NSHST", "NSH",
+    NULL, "ISHLD", "ISHST", "ISH", NULL, "LD", "ST", "SY",
+};
+
+static void a64_put_operand(A64Text *t, const ARM64Operand *op) {
+    switch (op->type) {
+        case ARM64_OPERAND_NONE:
+            break;
+        case ARM64_OPERAND_REG:
+            a64_puts(t, arm64dec_register_name(op->reg));
+            break;
+        case ARM64_OPERAND_IMM:
+            a64_putc(t, '#');
+            a64_put_dec(t, op->imm);
+            break;
+        case ARM64_OPERAND_IMM_HEX:
+            a64_putc(t, '#');
+            a64_put_hex(t, (uint64_t)op->imm, true);
+            break;
+        case ARM64_OPERAND_LABEL:
+            a64_put_hex(t, (uint64_t)op->imm, false);
+            break;
+        case ARM64_OPERAND_SHIFT:
+            a64_puts(t, a64_shift_names[op->shift]);
+            if (op->show_amount) {
+                a64_puts(t, " #");
+                a64_put_dec(t, op->amount);
+            }
+            break;
+        case ARM64_OPERAND_COND:
+            a64_puts(t, arm64dec_condition_name((ARM64Condition)op->imm));
+            break;
+        case ARM64_OPERAND_SYSREG:
+            a64_put_sysreg(t, (uint16_t)op->imm);
+            break;
+        case ARM64_OPERAND_FP_ZERO:
+            a64_puts(t, "#0.0");
+            break;
+        case ARM64_OPERAND_BARRIER:
+            if (a64_barrier_options[op->imm & 0xF]) {
+                a64_puts(t, a64_barrier_options[op->imm & 0xF]);
+            } else {
+                a64_putc(t, '#');
+                a64_put_dec(t, op->imm);
+            }
+            break;
+        case ARM64_OPERAND_BTI_TARGET:
+            a64_puts(t, (op->imm == 1) ? "C" : (op->imm == 2) ? "J" : "JC");
+            break;
+        case ARM64_OPERAND_WORD: {
+            static const char digits[] = "0123456789ABCDEF";
+            a64_puts(t, "0x");
+            for (int shift = 28; shift >= 0; shift -= 4) a64_putc(t, digits[(op->imm >> shift) & 0xF]);
+            break;
         }
+        case ARM64_OPERAND_MEM:
+            a64_putc(t, '[');
+            a64_puts(t, arm64dec_register_name(op->reg));
+            if (op->mode == ARM64_ADDR_REG_OFFSET || op->mode == ARM64_ADDR_REG_EXTENDED) {
+                a64_puts(t, ", ");
+                a64_puts(t, arm64dec_register_name(op->index));
+                if (op->shift != ARM64_SHIFT_LSL || op->show_amount) {
+                    a64_puts(t, ", ");
+                    a64_puts(t, a64_shift_names[op->shift]);
+                    if (op->show_amount) {
+                        a64_puts(t, " #");
+                        a64_put_dec(t, op->amount);
+                    }
+                }
+                a64_putc(t, ']');
+            } else if (op->mode == ARM64_ADDR_POST_INDEX) {
+                a64_puts(t, "], #");
+                a64_put_dec(t, op->imm);
+            } else {
+                if (op->imm != 0 || op->mode == ARM64_ADDR_PRE_INDEX) {
+                    a64_puts(t, ", #");
+                    a64_put_dec(t, op->imm);
+                }
+                a64_putc(t, ']');
+                if (op->mode == ARM64_ADDR_PRE_INDEX) a64_putc(t, '!');
+            }
+            break;
+    }
+}
+
+static void a64_put_operands(A64Text *t, const ARM64Operand *operands, uint8_t operand_count) {
+    for (uint8_t i = 0; i < operand_count; i++) {
+        if (i > 0) a64_puts(t, ", ");
+        a64_put_operand(t, &operands[i]);
     }
-    
-    uint8_t s = imms & levels;
-    uint8_t r = immr & levels;
-    
-    int esize = 1 << len;
-    int ones = s + 1;
-    uint64_t pattern = (1ULL << ones) - 1;
-    
-    if (r > 0 && r < esize) {
-        uint64_t mask = (1ULL << esize) - 1;
-        pattern = ((pattern >> r) | (pattern << (esize - r))) & mask;
-    }
-    
-    int width = is_64 ? 64 : 32;
-    uint64_t result = replicate(pattern, esize, width);
-    
-    if (!is_64) {
-        result &= 0xFFFFFFFF;
-    }
-    
-    *out_value = result;
+}
+
+size_t arm64dec_format_operands(const ARM64Operand *operands, uint8_t operand_count,
+                                char *buffer, size_t buffer_size) {
+    if (!operands || !buffer || buffer_size == 0) return 0;
+    A64Text t = { buffer, 0, buffer_size };
+    a64_put_operands(&t, operands, operand_count);
+    t.buf[t.len] = '\0';
+    return t.len;
+}
+
+size_t arm64dec_format_instruction(const ARM64DecodedInstruction *decoded,
+                                   char *buffer, size_t buffer_size) {
+    if (!decoded || !buffer || buffer_size == 0) return 0;
+    A64Text t = { buffer, 0, buffer_size };
+    a64_puts(&t, decoded->mnemonic);
+    if (decoded->operand_count > 0) {
+        a64_putc(&t, ' ');
+        a64_put_operands(&t, decoded->operands, decoded->operand_count);
+    }
+    t.buf[t.len] = '\0';
+    return t.len;
+}
+
+// MARK: - Data Processing (Immediate)
+
+static void a64_pcrel(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                      A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t rd = bytes & 0x1F;
+    int64_t imm = a64_sext((((bytes >> 5) & 0x7FFFF) << 2) | ((bytes >> 29) & 0x3), 21);
+    bool is_adrp = (bytes & 0x80000000) != 0;
+    int64_t offset = is_adrp ? imm * 4096 : imm;
+    uint64_t target = (is_adrp ? (address & ~0xFFFULL) : address) + (uint64_t)offset;
+
+    d->mnemonic = enc->mnemonic;
+    a64_reg(d, ARM64_REG_X, rd);
+    a64_imm(d, ARM64_OPERAND_LABEL, (int64_t)target);
+
+    inst->regs_written |= a64_bit(rd, ARM64_REG_X);
+    inst->has_target = true;
+    inst->target = target;
+    inst->target_offset = offset;
+}
+
+static void a64_addsub_imm(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool sf = (bytes >> 31) & 1;
+    bool is_sub = (bytes >> 30) & 1;
+    bool set_flags = (bytes >> 29) & 1;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint32_t imm = ((bytes >> 10) & 0xFFF) << (((bytes >> 22) & 1) * 12);
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t sp_kind = sf ? ARM64_REG_XSP : ARM64_REG_WSP;
+
+    if (set_flags && rd == 31) {
+        d->mnemonic = is_sub ? "CMP" : "CMN";
+        a64_reg(d, sp_kind, rn);
+        a64_imm(d, ARM64_OPERAND_IMM, imm);
+    } else if (!set_flags && !is_sub && imm == 0 && (rd == 31 || rn == 31)) {
+        d->mnemonic = "MOV";
+        a64_reg(d, sp_kind, rd);
+        a64_reg(d, sp_kind, rn);
+    } else {
+        d->mnemonic = is_sub ? (set_flags ? "SUBS" : "SUB") : (set_flags ? "ADDS" : "ADD");
+        a64_reg(d, set_flags ? kind : sp_kind, rd);
+        a64_reg(d, sp_kind, rn);
+        a64_imm(d, ARM64_OPERAND_IMM, imm);
+    }
+
+    inst->regs_read |= a64_bit(rn, sp_kind);
+    inst->regs_written |= a64_bit(rd, set_flags ? kind : sp_kind);
+    if (set_flags) inst->flags_written = 0xF; /* NZCV */
+}
+
+/* DecodeBitMasks from the ARM ARM, for logical immediates. */
+static bool a64_bitmask_imm(uint8_t n, uint8_t immr, uint8_t imms, bool is_64bit, uint64_t *out) {
+    uint32_t combined = ((uint32_t)n << 6) | (~imms & 0x3F);
+    if (combined == 0) return false;
+
+    int len = 31 - __builtin_clz(combined);
+    if (len < 1 || (!is_64bit && len == 6)) return false;
+
+    uint32_t esize = 1u << len;
+    uint32_t levels = esize - 1;
+    uint32_t s = imms & levels;
+    uint32_t r = immr & levels;
+    if (s == levels) return false;
+
+    uint64_t emask = (esize == 64) ? ~0ULL : ((1ULL << esize) - 1);
+    uint64_t element = (1ULL << (s + 1)) - 1;
+    if (r) element = ((element >> r) | (element << (esize - r))) & emask;
+    for (uint32_t width = esize; width < 64; width *= 2) {
+        element |= element << width;
+    }
+
+    *out = is_64bit ? element : (element & 0xFFFFFFFFULL);
     return true;
 }
 
-// MARK: - Register Helpers
+static void a64_logical_imm(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[] = { "AND", "ORR", "EOR", "ANDS" };
+    bool sf = (bytes >> 31) & 1;
+    uint8_t opc = (bytes >> 29) & 0x3;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint64_t imm;
+
+    if (!sf && ((bytes >> 22) & 1)) return;
+    if (!a64_bitmask_imm((bytes >> 22) & 1, (bytes >> 16) & 0x3F, (bytes >> 10) & 0x3F, sf, &imm)) return;
 
-static ARM64Register make_reg(uint8_t num, bool is_64bit) {
-    ARM64Register reg;
-    reg.num = num;
-    reg.is_64bit = is_64bit;
-    reg.is_sp = (num == 31);
-    reg.is_zero = (num == 31);
-    return reg;
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t rd_kind = (opc == 3) ? kind : (sf ? ARM64_REG_XSP : ARM64_REG_WSP);
+
+    if (opc == 3 && rd == 31) {
+        d->mnemonic = "TST";
+        a64_reg(d, kind, rn);
+    } else if (opc == 1 && rn == 31) {
+        d->mnemonic = "MOV";
+        a64_reg(d, rd_kind, rd);
+    } else {
+        d->mnemonic = names[opc];
+        a64_reg(d, rd_kind, rd);
+        a64_reg(d, kind, rn);
+    }
+    a64_imm(d, ARM64_OPERAND_IMM_HEX, (int64_t)imm);
+
+    inst->regs_read |= a64_bit(rn, kind);
+    inst->regs_written |= a64_bit(rd, rd_kind);
+    if (opc == 3) inst->flags_written = 0xF; /* NZCV */
 }
 
-const char* arm64dec_register_name(ARM64Register reg) {
-    static char buf[8];
-    
-    if (reg.num == 31) {
-        if (reg.is_sp) {
-            return reg.is_64bit ? "sp" : "wsp";
-        } else {
-            return reg.is_64bit ? "xzr" : "wzr";
-        }
+static void a64_move_wide(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                          A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[] = { "MOVN", NULL, "MOVZ", "MOVK" };
+    bool sf = (bytes >> 31) & 1;
+    uint8_t opc = (bytes >> 29) & 0x3;
+    uint8_t hw = (bytes >> 21) & 0x3;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+
+    if (!names[opc] || (!sf && hw >= 2)) return;
+
+    d->mnemonic = names[opc];
+    a64_reg(d, kind, rd);
+    a64_imm(d, ARM64_OPERAND_IMM_HEX, (bytes >> 5) & 0xFFFF);
+    if (hw) a64_shift(d, ARM64_SHIFT_LSL, hw * 16, true);
+
+    if (opc == 3) inst->regs_read |= a64_bit(rd, kind);
+    inst->regs_written |= a64_bit(rd, kind);
+}
+
+static void a64_bitfield(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                         A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool sf = (bytes >> 31) & 1;
+    uint8_t opc = (bytes >> 29) & 0x3;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t immr = (bytes >> 16) & 0x3F;
+    uint8_t imms = (bytes >> 10) & 0x3F;
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t top = sf ? 63 : 31;
+
+    if (opc == 3 || ((bytes >> 22) & 1) != sf || (!sf && (immr > 31 || imms > 31))) return;
+
+    /* Prefer the shift/extend/field aliases that assemblers print. */
+    const char *name;
+    int64_t lsb = immr, width = -1;
+    uint8_t rn_kind = kind;
+    if (opc == 0 && imms == top) {
+        name = "ASR";
+    } else if (opc == 0 && immr == 0 && (imms == 7 || imms == 15 || (imms == 31 && sf))) {
+        name = (imms == 7) ? "SXTB" : (imms == 15) ? "SXTH" : "SXTW";
+        rn_kind = ARM64_REG_W;
+        lsb = -1;
+    } else if (opc == 2 && imms == top) {
+        name = "LSR";
+    } else if (opc == 2 && imms + 1 == immr) {
+        name = "LSL";
+        lsb = top - imms;
+    } else if (opc == 2 && !sf && immr == 0 && (imms == 7 || imms == 15)) {
+        name = (imms == 7) ? "UXTB" : "UXTH";
+        lsb = -1;
+    } else if (imms < immr) {
+        name = (opc == 0) ? "SBFIZ" : (opc != 1) ? "UBFIZ" : (rn == 31) ? "BFC" : "BFI";
+        lsb = top + 1 - immr;
+        width = imms + 1;
+    } else {
+        name = (opc == 0) ? "SBFX" : (opc == 1) ? "BFXIL" : "UBFX";
+        width = imms - immr + 1;
     }
-    
-    snprintf(buf, sizeof(buf), "%c%d", reg.is_64bit ? 'x' : 'w', reg.num);
-    return buf;
+
+    d->mnemonic = name;
+    a64_reg(d, kind, rd);
+    if (name[1] != 'F' || name[2] != 'C') a64_reg(d, rn_kind, rn);
+    if (lsb >= 0) a64_imm(d, ARM64_OPERAND_IMM, lsb);
+    if (width >= 0) a64_imm(d, ARM64_OPERAND_IMM, width);
+
+    inst->regs_read |= a64_bit(rn, kind);
+    if (opc == 1) inst->regs_read |= a64_bit(rd, kind);
+    inst->regs_written |= a64_bit(rd, kind);
 }
 
-const char* arm64dec_condition_name(ARM64Condition cond) {
-    static const char *names[] = {
-        "eq", "ne", "cs", "cc", "mi", "pl", "vs", "vc",
-        "hi", "ls", "ge", "lt", "gt", "le", "al", "nv"
+static void a64_extract(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                        A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool sf = (bytes >> 31) & 1;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    uint8_t lsb = (bytes >> 10) & 0x3F;
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+
+    if (((bytes >> 22) & 1) != sf || (!sf && lsb > 31)) return;
+
+    d->mnemonic = (rn == rm) ? "ROR" : "EXTR";
+    a64_reg(d, kind, rd);
+    a64_reg(d, kind, rn);
+    if (rn != rm) a64_reg(d, kind, rm);
+    a64_imm(d, ARM64_OPERAND_IMM, lsb);
+
+    inst->regs_read |= a64_bit(rn, kind) | a64_bit(rm, kind);
+    inst->regs_written |= a64_bit(rd, kind);
+}
+
+// MARK: - Branches and System
+
+static void a64_set_branch(ARM64DecodedInstruction *inst, ARM64BranchKind type, int64_t offset) {
+    inst->branch_kind = type;
+    inst->has_target = true;
+    inst->target_offset = offset;
+    inst->target = inst->address + (uint64_t)offset;
+}
+
+static void a64_branch_imm(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool is_link = (bytes >> 31) & 1;
+
+    a64_set_branch(inst, is_link ? ARM64_BRANCH_CALL : ARM64_BRANCH_UNCONDITIONAL, a64_sext(bytes & 0x3FFFFFF, 26) * 4);
+    if (is_link) inst->regs_written |= (1ULL << 30);
+
+    d->mnemonic = is_link ? "BL" : "B";
+    a64_imm(d, ARM64_OPERAND_LABEL, (int64_t)inst->target);
+}
+
+static void a64_branch_cond(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[] = {
+        "B.EQ", "B.NE", "B.CS", "B.CC", "B.MI", "B.PL", "B.VS", "B.VC",
+        "B.HI", "B.LS", "B.GE", "B.LT", "B.GT", "B.LE", "B.AL", "B.NV",
     };
-    return names[cond & 0xF];
+
+    a64_set_branch(inst, ARM64_BRANCH_CONDITIONAL, a64_sext((bytes >> 5) & 0x7FFFF, 19) * 4);
+    inst->condition = (ARM64Condition)(bytes & 0xF);
+
+    d->mnemonic = names[bytes & 0xF];
+    a64_imm(d, ARM64_OPERAND_LABEL, (int64_t)inst->target);
 }
 
-const char* arm64dec_opcode_mnemonic(ARM64Opcode opcode) {
-    switch (opcode) {
-        case ARM64_OP_B: return "b";
-        case ARM64_OP_BL: return "bl";
-        case ARM64_OP_BR: return "br";
-        case ARM64_OP_BLR: return "blr";
-        case ARM64_OP_RET: return "ret";
-        case ARM64_OP_CBZ: return "cbz";
-        case ARM64_OP_CBNZ: return "cbnz";
-        case ARM64_OP_TBZ: return "tbz";
-        case ARM64_OP_TBNZ: return "tbnz";
-        case ARM64_OP_B_COND: return "b";
-        case ARM64_OP_LDR: return "ldr";
-        case ARM64_OP_LDRB: return "ldrb";
-        case ARM64_OP_LDRH: return "ldrh";
-        case ARM64_OP_LDRSB: return "ldrsb";
-        case ARM64_OP_LDRSH: return "ldrsh";
-        case ARM64_OP_LDRSW: return "ldrsw";
-        case ARM64_OP_STR: return "str";
-        case ARM64_OP_STRB: return "strb";
-        case ARM64_OP_STRH: return "strh";
-        case ARM64_OP_LDP: return "ldp";
-        case ARM64_OP_STP: return "stp";
-        case ARM64_OP_LDUR: return "ldur";
-        case ARM64_OP_STUR: return "stur";
-        case ARM64_OP_ADD: return "add";
-        case ARM64_OP_ADDS: return "adds";
-        case ARM64_OP_SUB: return "sub";
-        case ARM64_OP_SUBS: return "subs";
-        case ARM64_OP_MUL: return "mul";
-        case ARM64_OP_MADD: return "madd";
-        case ARM64_OP_MSUB: return "msub";
-        case ARM64_OP_SMULL: return "smull";
-        case ARM64_OP_UMULL: return "umull";
-        case ARM64_OP_SDIV: return "sdiv";
-        case ARM64_OP_UDIV: return "udiv";
-        case ARM64_OP_AND: return "and";
-        case ARM64_OP_ANDS: return "ands";
-        case ARM64_OP_ORR: return "orr";
-        case ARM64_OP_EOR: return "eor";
-        case ARM64_OP_BIC: return "bic";
-        case ARM64_OP_EON: return "eon";
-        case ARM64_OP_TST: return "tst";
-        case ARM64_OP_MOV: return "mov";
-        case ARM64_OP_MOVZ: return "movz";
-        case ARM64_OP_MOVN: return "movn";
-        case ARM64_OP_MOVK: return "movk";
-        case ARM64_OP_MVN: return "mvn";
-        case ARM64_OP_LSL: return "lsl";
-        case ARM64_OP_LSR: return "lsr";
-        case ARM64_OP_ASR: return "asr";
-        case ARM64_OP_ROR: return "ror";
-        case ARM64_OP_CMP: return "cmp";
-        case ARM64_OP_CMN: return "cmn";
-        case ARM64_OP_UBFM: return "ubfm";
-        case ARM64_OP_SBFM: return "sbfm";
-        case ARM64_OP_BFM: return "bfm";
-        case ARM64_OP_EXTR: return "extr";
-        case ARM64_OP_NOP: return "nop";
-        case ARM64_OP_HLT: return "hlt";
-        case ARM64_OP_BRK: return "brk";
-        case ARM64_OP_SVC: return "svc";
-        case ARM64_OP_HVC: return "hvc";
-        case ARM64_OP_SMC: return "smc";
-        case ARM64_OP_ADRP: return "adrp";
-        case ARM64_OP_ADR: return "adr";
-        
-        default: return "unknown";
-    }
-}
-
-// MARK: - Instruction Category Detection
-
-static ARM64InstructionCategory get_instruction_category(uint32_t ins) {
-    uint8_t op0 = BITS(ins, 25, 28);
-    
-    switch (op0) {
-        case 0b0000 ... 0b0011:
-            return ARM64_INS_UNKNOWN;
-            
-        case 0b1000:
-        case 0b1001:
-            return ARM64_INS_DATA_PROCESSING_IMM;
-            
-        case 0b1010:
-        case 0b1011:
-            return ARM64_INS_BRANCH;
-            
-        case 0b0100:
-        case 0b0110:
-        case 0b1100:
-        case 0b1110:
-            return ARM64_INS_LOAD_STORE;
-            
-        case 0b0101:
-        case 0b1101:
-            return ARM64_INS_DATA_PROCESSING_REG;
-            
-        case 0b0111:
-        case 0b1111:
-            return ARM64_INS_DATA_PROCESSING_SIMD;
-            
-        default:
-            return ARM64_INS_UNKNOWN;
-    }
-}
-
-// MARK: - Branch Instruction Decoding
-
-static bool decode_branch_instruction(uint32_t ins, uint64_t addr, ARM64DecodedInstruction *decoded) {
-    decoded->category = ARM64_INS_BRANCH;
-    
-    if (BITS(ins, 26, 30) == 0b00101) {
-        bool is_link = BIT(ins, 31);
-        decoded->opcode = is_link ? ARM64_OP_BL : ARM64_OP_B;
-        
-        int64_t imm26 = sign_extend(BITS(ins, 0, 25), 26) << 2;
-        
-        decoded->operands[0].type = ARM64_OPERAND_LABEL;
-        decoded->operands[0].imm = addr + imm26;
-        decoded->operand_count = 1;
-        
-        return true;
-    }
-    
-    if (BITS(ins, 24, 30) == 0b0101010 && BIT(ins, 4) == 0) {
-        decoded->opcode = ARM64_OP_B_COND;
-        decoded->condition = (ARM64Condition)BITS(ins, 0, 3);
-        
-        int64_t imm19 = sign_extend(BITS(ins, 5, 23), 19) << 2;
-        
-        decoded->operands[0].type = ARM64_OPERAND_LABEL;
-        decoded->operands[0].imm = addr + imm19;
-        decoded->operand_count = 1;
-        
-        return true;
-    }
-    
-    if (BITS(ins, 25, 30) == 0b011010) {
-        bool is_nz = BIT(ins, 24);
-        bool is_64 = BIT(ins, 31);
-        
-        decoded->opcode = is_nz ? ARM64_OP_CBNZ : ARM64_OP_CBZ;
-        
-        uint8_t rt = BITS(ins, 0, 4);
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rt, is_64);
-        
-        int64_t imm19 = sign_extend(BITS(ins, 5, 23), 19) << 2;
-        decoded->operands[1].type = ARM64_OPERAND_LABEL;
-        decoded->operands[1].imm = addr + imm19;
-        decoded->operand_count = 2;
-        
-        return true;
-    }
-    
-    if (BITS(ins, 25, 30) == 0b011011) {
-        bool is_nz = BIT(ins, 24);
-        uint8_t b5 = BIT(ins, 31);
-        uint8_t b40 = BITS(ins, 19, 23);
-        uint8_t bit_pos = (b5 << 5) | b40;
-        
-        decoded->opcode = is_nz ? ARM64_OP_TBNZ : ARM64_OP_TBZ;
-        
-        uint8_t rt = BITS(ins, 0, 4);
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rt, b5);
-        
-        decoded->operands[1].type = ARM64_OPERAND_IMM;
-        decoded->operands[1].imm = bit_pos;
-        
-        int64_t imm14 = sign_extend(BITS(ins, 5, 18), 14) << 2;
-        decoded->operands[2].type = ARM64_OPERAND_LABEL;
-        decoded->operands[2].imm = addr + imm14;
-        decoded->operand_count = 3;
-        
-        return true;
-    }
-    
-    if (BITS(ins, 25, 31) == 0b1101011) {
-        uint8_t opc = BITS(ins, 21, 24);
-        uint8_t rn = BITS(ins, 5, 9);
-        
-        if (opc == 0b0000) {
-            decoded->opcode = ARM64_OP_BR;
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rn, true);
-            decoded->operand_count = 1;
-            return true;
-        } else if (opc == 0b0001) {
-            decoded->opcode = ARM64_OP_BLR;
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rn, true);
-            decoded->operand_count = 1;
-            return true;
-        } else if (opc == 0b0010) {
-            decoded->opcode = ARM64_OP_RET;
-            if (rn != 30) {
-                decoded->operands[0].type = ARM64_OPERAND_REG;
-                decoded->operands[0].reg = make_reg(rn, true);
-                decoded->operand_count = 1;
-            } else {
-                decoded->operand_count = 0;
-            }
-            return true;
-        }
+static void a64_compare_branch(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                               A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t rt = bytes & 0x1F;
+    uint8_t kind = ((bytes >> 31) & 1) ? ARM64_REG_X : ARM64_REG_W;
+
+    a64_set_branch(inst, ARM64_BRANCH_CONDITIONAL, a64_sext((bytes >> 5) & 0x7FFFF, 19) * 4);
+    inst->regs_read |= a64_bit(rt, kind);
+
+    d->mnemonic = ((bytes >> 24) & 1) ? "CBNZ" : "CBZ";
+    a64_reg(d, kind, rt);
+    a64_imm(d, ARM64_OPERAND_LABEL, (int64_t)inst->target);
+}
+
+static void a64_test_branch(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t rt = bytes & 0x1F;
+    uint8_t b5 = (bytes >> 31) & 1;
+    uint8_t kind = b5 ? ARM64_REG_X : ARM64_REG_W;
+
+    a64_set_branch(inst, ARM64_BRANCH_CONDITIONAL, a64_sext((bytes >> 5) & 0x3FFF, 14) * 4);
+    inst->regs_read |= a64_bit(rt, kind);
+
+    d->mnemonic = ((bytes >> 24) & 1) ? "TBNZ" : "TBZ";
+    a64_reg(d, kind, rt);
+    a64_imm(d, ARM64_OPERAND_IMM, (b5 << 5) | ((bytes >> 19) & 0x1F));
+    a64_imm(d, ARM64_OPERAND_LABEL, (int64_t)inst->target);
+}
+
+/* BR/BLR/RET and their pointer-authenticating forms (…AA/…AB, …Z). */
+static void a64_branch_reg(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t opc = (bytes >> 21) & 0xF;
+    uint8_t op3 = (bytes >> 10) & 0x3F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t op4 = bytes & 0x1F;
+    bool pac = (op3 & 0x3E) == 0x2;
+    bool key_b = op3 & 1;
+
+    if (((bytes >> 16) & 0x1F) != 0x1F || (!pac && (op3 || op4))) return;
+
+    const char *stem;
+    ARM64BranchKind type;
+    bool modifier = false;
+    switch (opc) {
+        case 0: stem = "BR"; type = ARM64_BRANCH_UNCONDITIONAL; break;
+        case 1: stem = "BLR"; type = ARM64_BRANCH_CALL; break;
+        case 2: stem = "RET"; type = ARM64_BRANCH_RETURN; break;
+        case 4: stem = "ERET"; type = ARM64_BRANCH_RETURN; break;
+        case 8: stem = "BR"; type = ARM64_BRANCH_UNCONDITIONAL; modifier = true; break;
+        case 9: stem = "BLR"; type = ARM64_BRANCH_CALL; modifier = true; break;
+        default: return;
     }
-    
-    if (ins == 0xD503201F) {
-        decoded->opcode = ARM64_OP_NOP;
-        decoded->operand_count = 0;
-        return true;
-    }
-    
-    return false;
-}
-
-// MARK: - Load/Store Instruction Decoding
-
-static bool decode_load_store_instruction(uint32_t ins, uint64_t addr, ARM64DecodedInstruction *decoded) {
-    decoded->category = ARM64_INS_LOAD_STORE;
-    
-    uint8_t op0 = BITS(ins, 28, 31);
-    uint8_t op1 = BIT(ins, 26);
-    uint8_t op2 = BITS(ins, 23, 24);
-    uint8_t op3 = BITS(ins, 16, 21);
-    uint8_t op4 = BITS(ins, 10, 11);
-    
-    if ((op0 & 0b0011) == 0b0011 && op1 == 1 && op2 == 0b01) {
-        uint8_t size = BITS(ins, 30, 31);
-        bool is_load = BIT(ins, 22);
-        
-        uint8_t rt = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint16_t imm12 = BITS(ins, 10, 21);
-        
-        bool is_64 = (size == 0b11);
-        
-        if (size == 0b00) {
-            decoded->opcode = is_load ? ARM64_OP_LDRB : ARM64_OP_STRB;
-        } else if (size == 0b01) {
-            decoded->opcode = is_load ? ARM64_OP_LDRH : ARM64_OP_STRH;
-        } else if (size == 0b10) {
-            decoded->opcode = is_load ? ARM64_OP_LDR : ARM64_OP_STR;
-            is_64 = false;
-        } else {
-            decoded->opcode = is_load ? ARM64_OP_LDR : ARM64_OP_STR;
-            is_64 = true;
-        }
-        
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rt, is_64);
-        decoded->operands[1].type = ARM64_OPERAND_MEM;
-        decoded->operands[1].mem.base = make_reg(rn, true);
-        decoded->operands[1].mem.offset_imm = imm12 << size;
-        decoded->operands[1].mem.mode = ARM64_ADDR_OFFSET;
-        
-        decoded->operand_count = 2;
-        return true;
-    }
-    
-    if ((op0 & 0b0011) == 0b0011 && op1 == 1 && op2 == 0b00 && op4 == 0b10) {
-        uint8_t size = BITS(ins, 30, 31);
-        bool is_load = BIT(ins, 22);
-        
-        uint8_t rt = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint8_t rm = BITS(ins, 16, 20);
-        uint8_t option = BITS(ins, 13, 15);
-        uint8_t s = BIT(ins, 12);
-        
-        bool is_64 = (size == 0b11);
-        
-        if (size == 0b00) {
-            decoded->opcode = is_load ? ARM64_OP_LDRB : ARM64_OP_STRB;
-        } else if (size == 0b01) {
-            decoded->opcode = is_load ? ARM64_OP_LDRH : ARM64_OP_STRH;
-        } else if (size == 0b10) {
-            decoded->opcode = is_load ? ARM64_OP_LDR : ARM64_OP_STR;
-            is_64 = false;
-        } else {
-            decoded->opcode = is_load ? ARM64_OP_LDR : ARM64_OP_STR;
-            is_64 = true;
-        }
-        
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rt, is_64);
-        decoded->operands[1].type = ARM64_OPERAND_MEM;
-        decoded->operands[1].mem.base = make_reg(rn, true);
-        decoded->operands[1].mem.offset_reg = make_reg(rm, true);
-        decoded->operands[1].mem.mode = ARM64_ADDR_REG_EXTENDED;
-        decoded->operands[1].mem.extend_type = option;
-        decoded->operands[1].mem.shift_amount = s ? size : 0;
-        
-        decoded->operand_count = 2;
-        return true;
-    }
-    
-    if ((op0 & 0b0010) == 0b0010 && op1 == 1) {
-        uint8_t opc = BITS(ins, 30, 31);
-        bool is_load = BIT(ins, 22);
-        
-        uint8_t rt = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint8_t rt2 = BITS(ins, 10, 14);
-        int8_t imm7 = sign_extend(BITS(ins, 15, 21), 7);
-        
-        bool is_64 = (opc & 0b10);
-        int scale = is_64 ? 3 : 2;
-        
-        decoded->opcode = is_load ? ARM64_OP_LDP : ARM64_OP_STP;
-        
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rt, is_64);
-        
-        decoded->operands[1].type = ARM64_OPERAND_REG;
-        decoded->operands[1].reg = make_reg(rt2, is_64);
-        
-        decoded->operands[2].type = ARM64_OPERAND_MEM;
-        decoded->operands[2].mem.base = make_reg(rn, true);
-        decoded->operands[2].mem.offset_imm = imm7 << scale;
-        
-        if (op2 == 0b01) {
-            decoded->operands[2].mem.mode = ARM64_ADDR_POST_INDEX;
-        } else if (op2 == 0b11) {
-            decoded->operands[2].mem.mode = ARM64_ADDR_PRE_INDEX;
-        } else {
-            decoded->operands[2].mem.mode = ARM64_ADDR_OFFSET;
-        }
-        
-        decoded->operand_count = 3;
-        return true;
-    }
-    
-    if (BITS(ins, 24, 30) == 0b0011000) {
-        bool is_64 = BIT(ins, 30);
-        uint8_t rt = BITS(ins, 0, 4);
-        int32_t imm19 = sign_extend(BITS(ins, 5, 23), 19) << 2;
-        
-        decoded->opcode = ARM64_OP_LDR;
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rt, is_64);
-        decoded->operands[1].type = ARM64_OPERAND_MEM;
-        decoded->operands[1].mem.offset_imm = addr + imm19;
-        decoded->operands[1].mem.mode = ARM64_ADDR_LITERAL;
-        decoded->operand_count = 2;
-        return true;
-    }
-    
-    return false;
-}
-
-// MARK: - Data Processing (Immediate) Instruction Decoding
-
-static bool decode_data_processing_imm(uint32_t ins, uint64_t addr, ARM64DecodedInstruction *decoded) {
-    decoded->category = ARM64_INS_DATA_PROCESSING_IMM;
-    
-    bool is_64 = BIT(ins, 31);
-    uint8_t op = BITS(ins, 23, 25);
-    
-    if (op == 0b000) {
-        bool is_adrp = BIT(ins, 31);
-        uint8_t rd = BITS(ins, 0, 4);
-        uint32_t immlo = BITS(ins, 29, 30);
-        uint32_t immhi = BITS(ins, 5, 23);
-        int64_t imm = sign_extend((immhi << 2) | immlo, 21);
-        
-        decoded->opcode = is_adrp ? ARM64_OP_ADRP : ARM64_OP_ADR;
-        
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rd, true);
-        
-        decoded->operands[1].type = ARM64_OPERAND_IMM;
-        if (is_adrp) {
-            decoded->operands[1].imm = (addr & ~0xFFFULL) + (imm << 12);
-        } else {
-            decoded->operands[1].imm = addr + imm;
-        }
-        
-        decoded->operand_count = 2;
-        return true;
-    }
-    
-    if (op == 0b010 || op == 0b011) {
-        bool is_sub = BIT(ins, 30);
-        bool set_flags = BIT(ins, 29);
-        
-        uint8_t rd = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint16_t imm12 = BITS(ins, 10, 21);
-        uint8_t shift = BIT(ins, 22) ? 12 : 0;
-        
-        if (is_sub) {
-            decoded->opcode = set_flags ? ARM64_OP_SUBS : ARM64_OP_SUB;
-        } else {
-            decoded->opcode = set_flags ? ARM64_OP_ADDS : ARM64_OP_ADD;
-        }
-        
-        if (set_flags && rd == 31) {
-            decoded->opcode = is_sub ? ARM64_OP_CMP : ARM64_OP_CMN;
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rn, is_64);
-            decoded->operands[1].type = ARM64_OPERAND_IMM;
-            decoded->operands[1].imm = imm12 << shift;
-            decoded->operand_count = 2;
-        } else {
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rd, is_64);
-            decoded->operands[1].type = ARM64_OPERAND_REG;
-            decoded->operands[1].reg = make_reg(rn, is_64);
-            decoded->operands[2].type = ARM64_OPERAND_IMM;
-            decoded->operands[2].imm = imm12 << shift;
-            decoded->operand_count = 3;
-        }
-        
-        return true;
-    }
-    
-    if (op == 0b100) {
-        uint8_t opc = BITS(ins, 29, 30);
-        uint8_t rd = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint8_t n = BIT(ins, 22);
-        uint8_t immr = BITS(ins, 16, 21);
-        uint8_t imms = BITS(ins, 10, 15);
-        
-        uint64_t immediate_value = 0;
-        if (!decode_bitmask_immediate(n, immr, imms, is_64, &immediate_value)) {
-            return false;
-        }
-        
-        switch (opc) {
-            case 0b00: decoded->opcode = ARM64_OP_AND; break;
-            case 0b01: decoded->opcode = ARM64_OP_ORR; break;
-            case 0b10: decoded->opcode = ARM64_OP_EOR; break;
-            case 0b11: decoded->opcode = ARM64_OP_ANDS; break;
-        }
-        
-        if (opc == 0b11 && rd == 31) {
-            decoded->opcode = ARM64_OP_TST;
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rn, is_64);
-            decoded->operand_count = 2;
-        } else {
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rd, is_64);
-            
-            decoded->operands[1].type = ARM64_OPERAND_REG;
-            decoded->operands[1].reg = make_reg(rn, is_64);
-            
-            decoded->operand_count = 3;
-        }
-        
-        decoded->operands[decoded->operand_count - 1].type = ARM64_OPERAND_IMM;
-        decoded->operands[decoded->operand_count - 1].imm = immediate_value;
-        
-        return true;
-    }
-    
-    if (op == 0b101) {
-        uint8_t opc = BITS(ins, 29, 30);
-        uint8_t rd = BITS(ins, 0, 4);
-        uint16_t imm16 = BITS(ins, 5, 20);
-        uint8_t hw = BITS(ins, 21, 22);
-        
-        switch (opc) {
-            case 0b00: decoded->opcode = ARM64_OP_MOVN; break;
-            case 0b10: decoded->opcode = ARM64_OP_MOVZ; break;
-            case 0b11: decoded->opcode = ARM64_OP_MOVK; break;
-            default: return false;
-        }
-        
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rd, is_64);
-        decoded->operands[1].type = ARM64_OPERAND_IMM;
-        decoded->operands[1].imm = imm16;
-        
-        if (hw > 0) {
-            decoded->operands[2].type = ARM64_OPERAND_IMM;
-            decoded->operands[2].imm = hw * 16;
-            decoded->operand_count = 3;
-        } else {
-            decoded->operand_count = 2;
-        }
-        
-        return true;
-    }
-    
-    if (op == 0b110) {
-        uint8_t opc = BITS(ins, 29, 30);
-        uint8_t rd = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint8_t immr = BITS(ins, 16, 21);
-        uint8_t imms = BITS(ins, 10, 15);
-        
-        switch (opc) {
-            case 0b00: decoded->opcode = ARM64_OP_SBFM; break;
-            case 0b01: decoded->opcode = ARM64_OP_BFM; break;
-            case 0b10: decoded->opcode = ARM64_OP_UBFM; break;
-            default: return false;
-        }
-        
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rd, is_64);
-        decoded->operands[1].type = ARM64_OPERAND_REG;
-        decoded->operands[1].reg = make_reg(rn, is_64);
-        decoded->operands[2].type = ARM64_OPERAND_IMM;
-        decoded->operands[2].imm = immr;
-        decoded->operands[3].type = ARM64_OPERAND_IMM;
-        decoded->operands[3].imm = imms;
-        decoded->operand_count = 4;
-        return true;
-    }
-    
-    return false;
-}
-
-// MARK: - Data Processing (Register) Instruction Decoding
-
-static bool decode_data_processing_reg(uint32_t ins, uint64_t addr, ARM64DecodedInstruction *decoded) {
-    decoded->category = ARM64_INS_DATA_PROCESSING_REG;
-    
-    bool is_64 = BIT(ins, 31);
-    uint8_t op0 = BIT(ins, 30);
-    uint8_t op1 = BIT(ins, 28);
-    uint8_t op2 = BITS(ins, 21, 24);
-    uint8_t op3 = BITS(ins, 10, 15);
-    
-    if (op1 == 0 && op2 == 0b0000) {
-        bool is_sub = BIT(ins, 30);
-        bool set_flags = BIT(ins, 29);
-        
-        uint8_t rd = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint8_t rm = BITS(ins, 16, 20);
-        uint8_t shift = BITS(ins, 22, 23);
-        uint8_t imm6 = BITS(ins, 10, 15);
-        
-        if (is_sub) {
-            decoded->opcode = set_flags ? ARM64_OP_SUBS : ARM64_OP_SUB;
-        } else {
-            decoded->opcode = set_flags ? ARM64_OP_ADDS : ARM64_OP_ADD;
-        }
-        
-        if (set_flags && rd == 31) {
-            decoded->opcode = is_sub ? ARM64_OP_CMP : ARM64_OP_CMN;
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rn, is_64);
-            decoded->operands[1].type = ARM64_OPERAND_REG;
-            decoded->operands[1].reg = make_reg(rm, is_64);
-            decoded->operand_count = 2;
-        } else {
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rd, is_64);
-            decoded->operands[1].type = ARM64_OPERAND_REG;
-            decoded->operands[1].reg = make_reg(rn, is_64);
-            decoded->operands[2].type = ARM64_OPERAND_REG;
-            decoded->operands[2].reg = make_reg(rm, is_64);
-            decoded->operand_count = 3;
-        }
-        
-        return true;
-    }
-    
-    if (op1 == 0 && (op2 == 0b0000 || op2 == 0b0001 || op2 == 0b0010 || op2 == 0b0011)) {
-        uint8_t opc = BITS(ins, 29, 30);
-        bool n = BIT(ins, 21);
-        uint8_t rd = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint8_t rm = BITS(ins, 16, 20);
-        
-        if (opc == 0b00) {
-            decoded->opcode = n ? ARM64_OP_BIC : ARM64_OP_AND;
-        } else if (opc == 0b01) {
-            decoded->opcode = n ? ARM64_OP_EON : ARM64_OP_ORR;
-        } else if (opc == 0b10) {
-            decoded->opcode = ARM64_OP_EOR;
-        } else if (opc == 0b11) {
-            decoded->opcode = n ? ARM64_OP_BIC : ARM64_OP_ANDS;
-        }
-        
-        if (decoded->opcode == ARM64_OP_ORR && rn == 31) {
-            decoded->opcode = ARM64_OP_MOV;
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rd, is_64);
-            decoded->operands[1].type = ARM64_OPERAND_REG;
-            decoded->operands[1].reg = make_reg(rm, is_64);
-            decoded->operand_count = 2;
-        } else {
-            decoded->operands[0].type = ARM64_OPERAND_REG;
-            decoded->operands[0].reg = make_reg(rd, is_64);
-            decoded->operands[1].type = ARM64_OPERAND_REG;
-            decoded->operands[1].reg = make_reg(rn, is_64);
-            decoded->operands[2].type = ARM64_OPERAND_REG;
-            decoded->operands[2].reg = make_reg(rm, is_64);
-            decoded->operand_count = 3;
-        }
-        
-        return true;
-    }
-    
-    if (op1 == 1 && op2 == 0b0110) {
-        uint8_t rd = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint8_t rm = BITS(ins, 16, 20);
-        uint8_t opcode = BITS(ins, 10, 15);
-        
+
+    bool is_ret = (opc == 2 || opc == 4);
+    if (pac && !modifier && op4 != 0x1F) return;
+    if ((opc == 4 || (pac && is_ret)) && (rn != 0x1F || (opc == 4 && !pac && op4))) return;
+
+    if (pac) {
+        size_t len = strlen(stem);
+        memcpy(d->name, stem, len);
+        d->name[len++] = 'A';
+        d->name[len++] = key_b ? 'B' : 'A';
+        if (!modifier && !is_ret) d->name[len++] = 'Z';
+        d->name[len] = '\0';
+        d->mnemonic = d->name;
+    } else {
+        d->mnemonic = stem;
+    }
+
+    /* RET always shows its register so a non-default link register stands
+       out; the authenticated returns take none. */
+    if (!(is_ret && (pac || opc == 4))) {
+        a64_reg(d, ARM64_REG_X, rn);
+        inst->regs_read |= a64_bit(rn, ARM64_REG_X);
+    }
+    if (modifier) {
+        a64_reg(d, ARM64_REG_XSP, op4);
+        inst->regs_read |= a64_bit(op4, ARM64_REG_XSP);
+    }
+
+    inst->branch_kind = type;
+    if (type == ARM64_BRANCH_CALL) inst->regs_written |= (1ULL << 30);
+}
+
+static void a64_exception(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                          A64Decoded *d, ARM64DecodedInstruction *inst) {
+    switch (((bytes >> 21) & 0x7) << 2 | (bytes & 0x3)) {
+        case 0x01: d->mnemonic = "SVC"; break;
+        case 0x02: d->mnemonic = "HVC"; break;
+        case 0x03: d->mnemonic = "SMC"; break;
+        case 0x04: d->mnemonic = "BRK"; break;
+        case 0x08: d->mnemonic = "HLT"; break;
+        default: return;
+    }
+    if (bytes & 0x1C) {
+        d->mnemonic = NULL;
+        return;
+    }
+    a64_imm(d, ARM64_OPERAND_IMM_HEX, (bytes >> 5) & 0xFFFF);
+}
+
+static void a64_hint(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                     A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[40] = {
+        [0] = "NOP", [1] = "YIELD", [2] = "WFE", [3] = "WFI", [4] = "SEV", [5] = "SEVL",
+        [7] = "XPACLRI", [8] = "PACIA1716", [10] = "PACIB1716", [12] = "AUTIA1716", [14] = "AUTIB1716",
+        [16] = "ESB", [20] = "CSDB",
+        [24] = "PACIAZ", [25] = "PACIASP", [26] = "PACIBZ", [27] = "PACIBSP",
+        [28] = "AUTIAZ", [29] = "AUTIASP", [30] = "AUTIBZ", [31] = "AUTIBSP",
+        [32] = "BTI", [34] = "BTI", [36] = "BTI", [38] = "BTI",
+    };
+    uint8_t imm = (bytes >> 5) & 0x7F;
+
+    if (imm < 40 && names[imm]) {
+        d->mnemonic = names[imm];
+        if (imm > 32) a64_imm(d, ARM64_OPERAND_BTI_TARGET, (imm - 32) / 2);
+    } else {
+        d->mnemonic = "HINT";
+        a64_imm(d, ARM64_OPERAND_IMM, imm);
+    }
+    if (imm == 7 || (imm >= 24 && imm <= 31)) inst->regs_written |= (1ULL << 30);
+}
+
+static void a64_barrier(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                        A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t crm = (bytes >> 8) & 0xF;
+
+    switch ((bytes >> 5) & 0x7) {
+        case 2: d->mnemonic = "CLREX"; break;
+        case 4: d->mnemonic = "DSB"; break;
+        case 5: d->mnemonic = "DMB"; break;
+        case 6: d->mnemonic = "ISB"; break;
+        case 7: d->mnemonic = "SB"; return;
+        default: return;
+    }
+    /* CLREX and ISB only spell out a non-default (#15) option. */
+    if (d->mnemonic[0] == 'D') a64_imm(d, ARM64_OPERAND_BARRIER, crm);
+    else if (crm != 15) a64_imm(d, ARM64_OPERAND_IMM, crm);
+}
+
+static void a64_system_move(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool is_read = (bytes >> 21) & 1;
+    uint8_t rt = bytes & 0x1F;
+    int64_t sysreg = (bytes >> 5) & 0xFFFF;
+
+    d->mnemonic = is_read ? "MRS" : "MSR";
+    if (is_read) {
+        a64_reg(d, ARM64_REG_X, rt);
+        a64_imm(d, ARM64_OPERAND_SYSREG, sysreg);
+        inst->regs_written |= a64_bit(rt, ARM64_REG_X);
+    } else {
+        a64_imm(d, ARM64_OPERAND_SYSREG, sysreg);
+        a64_reg(d, ARM64_REG_X, rt);
+        inst->regs_read |= a64_bit(rt, ARM64_REG_X);
+    }
+}
+
+static void a64_system_other(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                             A64Decoded *d, ARM64DecodedInstruction *inst) {
+    d->mnemonic = enc->mnemonic;
+    a64_imm(d, ARM64_OPERAND_IMM_HEX, bytes & 0x3FFFFF);
+}
+
+// MARK: - Loads and Stores
+
+/* Single-register load/store forms indexed by size:V:opc. `name` is the
+   scaled/indexed spelling, `unscaled` the LDUR-style one. */
+typedef struct {
+    const char *name;
+    const char *unscaled;
+    uint8_t kind;
+    uint8_t scale;
+    bool is_load;
+    bool is_prefetch;
+} A64LoadStoreForm;
+
+static const A64LoadStoreForm a64_ldst_forms[32] = {
+    [0x00] = { "STRB", "STURB", ARM64_REG_W, 0, false },
+    [0x01] = { "LDRB", "LDURB", ARM64_REG_W, 0, true },
+    [0x02] = { "LDRSB", "LDURSB", ARM64_REG_X, 0, true },
+    [0x03] = { "LDRSB", "LDURSB", ARM64_REG_W, 0, true },
+    [0x04] = { "STR", "STUR", ARM64_REG_B, 0, false },
+    [0x05] = { "LDR", "LDUR", ARM64_REG_B, 0, true },
+    [0x06] = { "STR", "STUR", ARM64_REG_Q, 4, false },
+    [0x07] = { "LDR", "LDUR", ARM64_REG_Q, 4, true },
+    [0x08] = { "STRH", "STURH", ARM64_REG_W, 1, false },
+    [0x09] = { "LDRH", "LDURH", ARM64_REG_W, 1, true },
+    [0x0A] = { "LDRSH", "LDURSH", ARM64_REG_X, 1, true },
+    [0x0B] = { "LDRSH", "LDURSH", ARM64_REG_W, 1, true },
+    [0x0C] = { "STR", "STUR", ARM64_REG_H, 1, false },
+    [0x0D] = { "LDR", "LDUR", ARM64_REG_H, 1, true },
+    [0x10] = { "STR", "STUR", ARM64_REG_W, 2, false },
+    [0x11] = { "LDR", "LDUR", ARM64_REG_W, 2, true },
+    [0x12] = { "LDRSW", "LDURSW", ARM64_REG_X, 2, true },
+    [0x14] = { "STR", "STUR", ARM64_REG_S, 2, false },
+    [0x15] = { "LDR", "LDUR", ARM64_REG_S, 2, true },
+    [0x18] = { "STR", "STUR", ARM64_REG_X, 3, false },
+    [0x19] = { "LDR", "LDUR", ARM64_REG_X, 3, true },
+    [0x1A] = { "PRFM", "PRFUM", ARM64_REG_X, 3, false, true },
+    [0x1C] = { "STR", "STUR", ARM64_REG_D, 3, false },
+    [0x1D] = { "LDR", "LDUR", ARM64_REG_D, 3, true },
+};
+
+static inline const A64LoadStoreForm* a64_ldst_form(uint32_t bytes) {
+    const A64LoadStoreForm *form = &a64_ldst_forms[((bytes >> 27) & 0x18) | ((bytes >> 24) & 0x4) | ((bytes >> 22) & 0x3)];
+    return form->name ? form : NULL;
+}
+
+/* Transfer register operand plus register-usage bookkeeping shared by the
+   single-register forms. */
+static void a64_ldst_transfer(const A64LoadStoreForm *form, uint8_t rt, uint8_t rn, bool writeback,
+                              A64Decoded *d, ARM64DecodedInstruction *inst) {
+    if (form->is_prefetch) {
+        a64_imm(d, ARM64_OPERAND_IMM, rt);
+    } else {
+        a64_reg(d, form->kind, rt);
+        if (form->is_load) inst->regs_written |= a64_bit(rt, form->kind);
+        else inst->regs_read |= a64_bit(rt, form->kind);
+    }
+    inst->regs_read |= a64_bit(rn, ARM64_REG_XSP);
+    if (writeback) inst->regs_written |= a64_bit(rn, ARM64_REG_XSP);
+}
+
+static void a64_ldst_unsigned(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                              A64Decoded *d, ARM64DecodedInstruction *inst) {
+    const A64LoadStoreForm *form = a64_ldst_form(bytes);
+    if (!form) return;
+
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    d->mnemonic = form->name;
+    a64_ldst_transfer(form, bytes & 0x1F, rn, false, d, inst);
+    a64_mem(d, rn, ARM64_ADDR_OFFSET, (int64_t)(((bytes >> 10) & 0xFFF) << form->scale));
+}
+
+/* imm9 forms: unscaled (LDUR), post-index, unprivileged (LDTR) and
+   pre-index. */
+static void a64_ldst_imm9(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                          A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const uint8_t modes[] = { ARM64_ADDR_OFFSET, ARM64_ADDR_POST_INDEX, ARM64_ADDR_OFFSET, ARM64_ADDR_PRE_INDEX };
+    const A64LoadStoreForm *form = a64_ldst_form(bytes);
+    uint8_t variant = (bytes >> 10) & 0x3;
+
+    if (!form || (form->is_prefetch && variant != 0)) return;
+
+    if (variant == 2) {
+        /* LDTR/STTR and sized variants exist for general registers only */
+        if ((bytes >> 26) & 1) return;
+        size_t len = strlen(form->name);
+        memcpy(d->name, form->name, 2);
+        d->name[2] = 'T';
+        memcpy(d->name + 3, form->name + 2, len - 1);
+        d->mnemonic = d->name;
+    } else {
+        d->mnemonic = (variant == 0) ? form->unscaled : form->name;
+    }
+
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    a64_ldst_transfer(form, bytes & 0x1F, rn, variant & 1, d, inst);
+    a64_mem(d, rn, modes[variant], a64_sext((bytes >> 12) & 0x1FF, 9));
+}
+
+static void a64_ldst_register(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                              A64Decoded *d, ARM64DecodedInstruction *inst) {
+    const A64LoadStoreForm *form = a64_ldst_form(bytes);
+    uint8_t option = (bytes >> 13) & 0x7;
+
+    if (!form || !(option & 0x2)) return;
+
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    bool scaled = (bytes >> 12) & 1;
+    uint8_t index_kind = (option & 1) ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t extend = (option == 3) ? ARM64_SHIFT_LSL : (uint8_t)(ARM64_EXTEND_UXTB + option);
+
+    d->mnemonic = form->name;
+    a64_ldst_transfer(form, bytes & 0x1F, rn, false, d, inst);
+    a64_mem_index(d, rn, rm, index_kind, extend, scaled ? form->scale : 0, scaled);
+    inst->regs_read |= a64_bit(rm, index_kind);
+}
+
+static void a64_ldr_literal(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const uint8_t gpr_kinds[] = { ARM64_REG_W, ARM64_REG_X, ARM64_REG_X };
+    static const uint8_t fp_kinds[] = { ARM64_REG_S, ARM64_REG_D, ARM64_REG_Q };
+    uint8_t opc = (bytes >> 30) & 0x3;
+    bool is_simd = (bytes >> 26) & 1;
+    uint8_t rt = bytes & 0x1F;
+    int64_t offset = a64_sext((bytes >> 5) & 0x7FFFF, 19) * 4;
+
+    if (is_simd && opc == 3) return;
+
+    if (!is_simd && opc == 3) {
+        d->mnemonic = "PRFM";
+        a64_imm(d, ARM64_OPERAND_IMM, rt);
+    } else {
+        uint8_t kind = is_simd ? fp_kinds[opc] : gpr_kinds[opc];
+        d->mnemonic = (!is_simd && opc == 2) ? "LDRSW" : "LDR";
+        a64_reg(d, kind, rt);
+        inst->regs_written |= a64_bit(rt, kind);
+    }
+
+    inst->has_target = true;
+    inst->target_offset = offset;
+    inst->target = address + (uint64_t)offset;
+    a64_imm(d, ARM64_OPERAND_LABEL, (int64_t)inst->target);
+}
+
+static void a64_ldst_pair(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                          A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const uint8_t modes[] = { ARM64_ADDR_OFFSET, ARM64_ADDR_POST_INDEX, ARM64_ADDR_OFFSET, ARM64_ADDR_PRE_INDEX };
+    uint8_t opc = (bytes >> 30) & 0x3;
+    bool is_simd = (bytes >> 26) & 1;
+    bool is_load = (bytes >> 22) & 1;
+    uint8_t variant = (bytes >> 23) & 0x3;
+    uint8_t rt = bytes & 0x1F;
+    uint8_t rt2 = (bytes >> 10) & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t kind, scale;
+
+    if (opc == 3) return;
+    if (is_simd) {
+        kind = ARM64_REG_S + opc;
+        scale = 2 + opc;
+    } else if (opc == 1) {
+        if (!is_load || variant == 0) return;
+        kind = ARM64_REG_X;
+        scale = 2;
+    } else {
+        kind = opc ? ARM64_REG_X : ARM64_REG_W;
+        scale = opc ? 3 : 2;
+    }
+
+    if (variant == 0) d->mnemonic = is_load ? "LDNP" : "STNP";
+    else if (opc == 1 && !is_simd) d->mnemonic = "LDPSW";
+    else d->mnemonic = is_load ? "LDP" : "STP";
+
+    a64_reg(d, kind, rt);
+    a64_reg(d, kind, rt2);
+    a64_mem(d, rn, modes[variant], a64_sext((bytes >> 15) & 0x7F, 7) * (1 << scale));
+
+    /* register usage: pair loads write two regs, pair stores read two regs */
+    uint64_t pair = a64_bit(rt, kind) | a64_bit(rt2, kind);
+    if (is_load) inst->regs_written |= pair;
+    else inst->regs_read |= pair;
+    inst->regs_read |= a64_bit(rn, ARM64_REG_XSP);
+    if (variant & 1) inst->regs_written |= a64_bit(rn, ARM64_REG_XSP);
+}
+
+/* Exclusive, load-acquire/store-release and compare-and-swap. */
+static void a64_ldst_exclusive(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                               A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t size = (bytes >> 30) & 0x3;
+    bool o2 = (bytes >> 23) & 1;
+    bool is_load = (bytes >> 22) & 1;
+    bool o1 = (bytes >> 21) & 1;
+    bool o0 = (bytes >> 15) & 1;
+    uint8_t rs = (bytes >> 16) & 0x1F;
+    uint8_t rt2 = (bytes >> 10) & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rt = bytes & 0x1F;
+    uint8_t kind = (size == 3) ? ARM64_REG_X : ARM64_REG_W;
+    bool pair = o1 && !o2;
+    bool status = !o2 && !is_load;
+
+    if (o2 && o1) {
+        if (rt2 != 0x1F) return;
+        a64_compose(d, "CAS", is_load, o0, size);
+        a64_reg(d, kind, rs);
+        a64_reg(d, kind, rt);
+        a64_mem(d, rn, ARM64_ADDR_OFFSET, 0);
+        inst->regs_read |= a64_bit(rs, kind) | a64_bit(rt, kind) | a64_bit(rn, ARM64_REG_XSP);
+        inst->regs_written |= a64_bit(rs, kind);
+        return;
+    }
+    if (pair && size < 2) return;
+
+    if (o2) {
+        a64_compose(d, is_load ? (o0 ? "LDAR" : "LDLAR") : (o0 ? "STLR" : "STLLR"), false, false, size);
+    } else {
+        /* LDXR/STXR, with LDAXR/STLXR for the ordered forms */
+        char stem[8] = { is_load ? 'L' : 'S', is_load ? 'D' : 'T' };
+        size_t len = 2;
+        if (o0) stem[len++] = is_load ? 'A' : 'L';
+        stem[len++] = 'X';
+        stem[len++] = pair ? 'P' : 'R';
+        a64_compose(d, stem, false, false, pair ? 2 : size);
+    }
+
+    if (status) {
+        a64_reg(d, ARM64_REG_W, rs);
+        inst->regs_written |= a64_bit(rs, ARM64_REG_W);
+    }
+    a64_reg(d, kind, rt);
+    if (pair) a64_reg(d, kind, rt2);
+    a64_mem(d, rn, ARM64_ADDR_OFFSET, 0);
+
+    uint64_t transfer = a64_bit(rt, kind) | (pair ? a64_bit(rt2, kind) : 0);
+    if (is_load) inst->regs_written |= transfer;
+    else inst->regs_read |= transfer;
+    inst->regs_read |= a64_bit(rn, ARM64_REG_XSP);
+}
+
+/* LSE atomic memory operations (LDADD, SWP, ... and the ST<op> aliases). */
+static void a64_ldst_atomic(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const ops[] = { "ADD", "CLR", "EOR", "SET", "SMAX", "SMIN", "UMAX", "UMIN" };
+    uint8_t size = (bytes >> 30) & 0x3;
+    bool acquire = (bytes >> 23) & 1;
+    bool release = (bytes >> 22) & 1;
+    uint8_t rs = (bytes >> 16) & 0x1F;
+    bool o3 = (bytes >> 15) & 1;
+    uint8_t opc = (bytes >> 12) & 0x7;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rt = bytes & 0x1F;
+    uint8_t kind = (size == 3) ? ARM64_REG_X : ARM64_REG_W;
+
+    if ((bytes >> 26) & 1) return;
+    if (o3 && opc != 0) return;
+
+    bool store_alias = !o3 && rt == 31 && !acquire;
+    char stem[8] = "LD";
+    if (o3) strcpy(stem, "SWP");
+    else {
+        if (store_alias) stem[0] = 'S', stem[1] = 'T';
+        strcpy(stem + 2, ops[opc]);
+    }
+    a64_compose(d, stem, acquire, release, size);
+
+    a64_reg(d, kind, rs);
+    if (!store_alias) a64_reg(d, kind, rt);
+    a64_mem(d, rn, ARM64_ADDR_OFFSET, 0);
+
+    inst->regs_read |= a64_bit(rs, kind) | a64_bit(rn, ARM64_REG_XSP);
+    inst->regs_written |= a64_bit(rt, kind);
+}
+
+/* Encodings without a row (tag stores, RCpc, ...) keep the generic
+   description. AdvSIMD structure loads/stores (LD1-LD4, ST1-ST4 and the
+   replicate forms) transfer a vector list, so they stay `.word` rather than
+   claim a general register and an address they do not use. */
+static void a64_ldst_generic(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                             A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t kind = (((bytes >> 30) & 0x3) >= 2) ? ARM64_REG_X : ARM64_REG_W;
+
+    if ((bytes & 0xBE000000) == 0x0C000000) return;
+
+    d->mnemonic = ((bytes >> 22) & 1) ? "LDR" : "STR";
+    a64_reg(d, kind, bytes & 0x1F);
+    a64_mem(d, (bytes >> 5) & 0x1F, ARM64_ADDR_OFFSET, 0);
+}
+
+// MARK: - Data Processing (Register)
+
+static void a64_logical_reg(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[4][2] = {
+        { "AND", "BIC" }, { "ORR", "ORN" }, { "EOR", "EON" }, { "ANDS", "BICS" },
+    };
+    bool sf = (bytes >> 31) & 1;
+    uint8_t opc = (bytes >> 29) & 0x3;
+    bool negate = (bytes >> 21) & 1;
+    uint8_t shift = (bytes >> 22) & 0x3;
+    uint8_t amount = (bytes >> 10) & 0x3F;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+
+    if (!sf && amount > 31) return;
+
+    bool reads_rn = true;
+    if (opc == 1 && rn == 31 && !negate && amount == 0) {
+        d->mnemonic = "MOV";
+        a64_reg(d, kind, rd);
+        a64_reg(d, kind, rm);
+        reads_rn = false;
+    } else if (opc == 1 && rn == 31 && negate) {
+        d->mnemonic = "MVN";
+        a64_reg(d, kind, rd);
+        a64_reg(d, kind, rm);
+        reads_rn = false;
+    } else if (opc == 3 && rd == 31 && !negate) {
+        d->mnemonic = "TST";
+        a64_reg(d, kind, rn);
+        a64_reg(d, kind, rm);
+    } else {
+        d->mnemonic = names[opc][negate];
+        a64_reg(d, kind, rd);
+        a64_reg(d, kind, rn);
+        a64_reg(d, kind, rm);
+    }
+    if (amount || shift) a64_shift(d, shift, amount, true);
+
+    if (reads_rn) inst->regs_read |= a64_bit(rn, kind);
+    inst->regs_read |= a64_bit(rm, kind);
+    inst->regs_written |= a64_bit(rd, kind);
+    /* Logical ops setflags is encoded as opc == 3 for this class. */
+    if (opc == 3) inst->flags_written = 0xF; /* NZCV */
+}
+
+static void a64_addsub_reg(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool sf = (bytes >> 31) & 1;
+    bool is_sub = (bytes >> 30) & 1;
+    bool set_flags = (bytes >> 29) & 1;
+    uint8_t shift = (bytes >> 22) & 0x3;
+    uint8_t amount = (bytes >> 10) & 0x3F;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+
+    if (shift == 3 || (!sf && amount > 31)) return;
+
+    if (set_flags && rd == 31) {
+        d->mnemonic = is_sub ? "CMP" : "CMN";
+        a64_reg(d, kind, rn);
+    } else if (is_sub && rn == 31) {
+        d->mnemonic = set_flags ? "NEGS" : "NEG";
+        a64_reg(d, kind, rd);
+    } else {
+        d->mnemonic = is_sub ? (set_flags ? "SUBS" : "SUB") : (set_flags ? "ADDS" : "ADD");
+        a64_reg(d, kind, rd);
+        a64_reg(d, kind, rn);
+    }
+    a64_reg(d, kind, rm);
+    if (amount || shift) a64_shift(d, shift, amount, true);
+
+    inst->regs_read |= a64_bit(rn, kind) | a64_bit(rm, kind);
+    inst->regs_written |= a64_bit(rd, kind);
+    if (set_flags) inst->flags_written = 0xF; /* NZCV */
+}
+
+static void a64_addsub_ext(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool sf = (bytes >> 31) & 1;
+    bool is_sub = (bytes >> 30) & 1;
+    bool set_flags = (bytes >> 29) & 1;
+    uint8_t option = (bytes >> 13) & 0x7;
+    uint8_t amount = (bytes >> 10) & 0x7;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    uint8_t sp_kind = sf ? ARM64_REG_XSP : ARM64_REG_WSP;
+    uint8_t rd_kind = set_flags ? (sf ? ARM64_REG_X : ARM64_REG_W) : sp_kind;
+    uint8_t rm_kind = (sf && (option & 0x3) == 0x3) ? ARM64_REG_X : ARM64_REG_W;
+
+    if (((bytes >> 22) & 0x3) || amount > 4) return;
+
+    if (set_flags && rd == 31) {
+        d->mnemonic = is_sub ? "CMP" : "CMN";
+    } else {
+        d->mnemonic = is_sub ? (set_flags ? "SUBS" : "SUB") : (set_flags ? "ADDS" : "ADD");
+        a64_reg(d, rd_kind, rd);
+    }
+    a64_reg(d, sp_kind, rn);
+    a64_reg(d, rm_kind, rm);
+
+    /* With SP involved, UXTX (UXTW for 32-bit) is spelled LSL and may vanish. */
+    bool uses_sp = rn == 31 || (rd == 31 && !set_flags);
+    if (uses_sp && option == (sf ? 3 : 2)) {
+        if (amount) a64_shift(d, ARM64_SHIFT_LSL, amount, true);
+    } else {
+        a64_shift(d, ARM64_EXTEND_UXTB + option, amount, amount != 0);
+    }
+
+    inst->regs_read |= a64_bit(rn, sp_kind) | a64_bit(rm, rm_kind);
+    inst->regs_written |= a64_bit(rd, rd_kind);
+    if (set_flags) inst->flags_written = 0xF; /* NZCV */
+}
+
+static void a64_addsub_carry(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                             A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[] = { "ADC", "ADCS", "SBC", "SBCS" };
+    uint8_t kind = ((bytes >> 31) & 1) ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    bool set_flags = (bytes >> 29) & 1;
+
+    d->mnemonic = names[(bytes >> 29) & 0x3];
+    a64_reg(d, kind, rd);
+    a64_reg(d, kind, rn);
+    a64_reg(d, kind, rm);
+
+    inst->regs_read |= a64_bit(rn, kind) | a64_bit(rm, kind);
+    inst->regs_written |= a64_bit(rd, kind);
+    if (set_flags) inst->flags_written = 0xF; /* NZCV */
+}
+
+static void a64_cond_compare(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                             A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t kind = ((bytes >> 31) & 1) ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    bool is_imm = (bytes >> 11) & 1;
+
+    d->mnemonic = ((bytes >> 30) & 1) ? "CCMP" : "CCMN";
+    a64_reg(d, kind, rn);
+    if (is_imm) a64_imm(d, ARM64_OPERAND_IMM, rm);
+    else a64_reg(d, kind, rm);
+    a64_imm(d, ARM64_OPERAND_IMM, bytes & 0xF);
+    a64_imm(d, ARM64_OPERAND_COND, (bytes >> 12) & 0xF);
+
+    /* CCMP/CCMN read the registers and update NZCV condition flags. */
+    inst->regs_read |= a64_bit(rn, kind) | (is_imm ? 0 : a64_bit(rm, kind));
+    inst->flags_written = 0xF; /* NZCV */
+}
+
+static void a64_cond_select(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                            A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[] = { "CSEL", "CSINC", "CSINV", "CSNEG" };
+    static const char *const set_names[] = { NULL, "CSET", "CSETM", NULL };
+    static const char *const same_names[] = { NULL, "CINC", "CINV", "CNEG" };
+    uint8_t kind = ((bytes >> 31) & 1) ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t op = (((bytes >> 30) & 1) << 1) | ((bytes >> 10) & 1);
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    uint8_t cond = (bytes >> 12) & 0xF;
+    bool invertible = (cond & 0xE) != 0xE;
+
+    if ((bytes >> 11) & 1) return;
+
+    if (set_names[op] && rn == 31 && rm == 31 && invertible) {
+        d->mnemonic = set_names[op];
+        a64_reg(d, kind, rd);
+        a64_imm(d, ARM64_OPERAND_COND, cond ^ 1);
+    } else if (same_names[op] && rn == rm && rn != 31 && invertible) {
+        d->mnemonic = same_names[op];
+        a64_reg(d, kind, rd);
+        a64_reg(d, kind, rn);
+        a64_imm(d, ARM64_OPERAND_COND, cond ^ 1);
+    } else {
+        d->mnemonic = names[op];
+        a64_reg(d, kind, rd);
+        a64_reg(d, kind, rn);
+        a64_reg(d, kind, rm);
+        a64_imm(d, ARM64_OPERAND_COND, cond);
+    }
+
+    inst->regs_read |= a64_bit(rn, kind) | a64_bit(rm, kind);
+    inst->regs_written |= a64_bit(rd, kind);
+}
+
+static void a64_dp_2source(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[32] = {
+        [2] = "UDIV", [3] = "SDIV", [8] = "LSL", [9] = "LSR", [10] = "ASR", [11] = "ROR", [12] = "PACGA",
+        [16] = "CRC32B", [17] = "CRC32H", [18] = "CRC32W", [19] = "CRC32X",
+        [20] = "CRC32CB", [21] = "CRC32CH", [22] = "CRC32CW", [23] = "CRC32CX",
+    };
+    bool sf = (bytes >> 31) & 1;
+    uint8_t opcode = (bytes >> 10) & 0x3F;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+
+    if (opcode >= 32 || !names[opcode] || ((bytes >> 29) & 1)) return;
+
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t rd_kind = kind, rn_kind = kind, rm_kind = kind;
+    if (opcode >= 16) {
+        bool wide = (opcode & 0x3) == 0x3;
+        if (wide != sf) return;
+        rd_kind = rn_kind = ARM64_REG_W;
+    } else if (opcode == 12) {
+        if (!sf) return;
+        rm_kind = ARM64_REG_XSP;
+    }
+
+    d->mnemonic = names[opcode];
+    a64_reg(d, rd_kind, rd);
+    a64_reg(d, rn_kind, rn);
+    a64_reg(d, rm_kind, rm);
+
+    inst->regs_read |= a64_bit(rn, rn_kind) | a64_bit(rm, rm_kind);
+    inst->regs_written |= a64_bit(rd, rd_kind);
+}
+
+static void a64_dp_1source(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const pac_names[18] = {
+        "PACIA", "PACIB", "PACDA", "PACDB", "AUTIA", "AUTIB", "AUTDA", "AUTDB",
+        "PACIZA", "PACIZB", "PACDZA", "PACDZB", "AUTIZA", "AUTIZB", "AUTDZA", "AUTDZB",
+        "XPACI", "XPACD",
+    };
+    bool sf = (bytes >> 31) & 1;
+    uint8_t opcode2 = (bytes >> 16) & 0x1F;
+    uint8_t opcode = (bytes >> 10) & 0x3F;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+
+    if ((bytes >> 29) & 1) return;
+
+    if (opcode2 == 0) {
         switch (opcode) {
-            case 0b000010: decoded->opcode = ARM64_OP_UDIV; break;
-            case 0b000011: decoded->opcode = ARM64_OP_SDIV; break;
-            case 0b001000: decoded->opcode = ARM64_OP_LSL; break;
-            case 0b001001: decoded->opcode = ARM64_OP_LSR; break;
-            case 0b001010: decoded->opcode = ARM64_OP_ASR; break;
-            case 0b001011: decoded->opcode = ARM64_OP_ROR; break;
-            default: return false;
+            case 0: d->mnemonic = "RBIT"; break;
+            case 1: d->mnemonic = "REV16"; break;
+            case 2: d->mnemonic = sf ? "REV32" : "REV"; break;
+            case 3: if (sf) d->mnemonic = "REV"; break;
+            case 4: d->mnemonic = "CLZ"; break;
+            case 5: d->mnemonic = "CLS"; break;
         }
-        
-        decoded->operands[0].type = ARM64_OPERAND_REG;
-        decoded->operands[0].reg = make_reg(rd, is_64);
-        decoded->operands[1].type = ARM64_OPERAND_REG;
-        decoded->operands[1].reg = make_reg(rn, is_64);
-        decoded->operands[2].type = ARM64_OPERAND_REG;
-        decoded->operands[2].reg = make_reg(rm, is_64);
-        decoded->operand_count = 3;
-        return true;
-    }
-    
-    if (op1 == 1 && (op2 & 0b1000)) {
-        uint8_t op31 = BITS(ins, 15, 15);
-        uint8_t o0 = BIT(ins, 15);
-        uint8_t rd = BITS(ins, 0, 4);
-        uint8_t rn = BITS(ins, 5, 9);
-        uint8_t ra = BITS(ins, 10, 14);
-        uint8_t rm = BITS(ins, 16, 20);
-        
-        if ((op2 & 0b0111) == 0b0000) {
-            decoded->opcode = o0 ? ARM64_OP_MSUB : ARM64_OP_MADD;
-            
-            if (decoded->opcode == ARM64_OP_MADD && ra == 31) {
-                decoded->opcode = ARM64_OP_MUL;
-                decoded->operands[0].type = ARM64_OPERAND_REG;
-                decoded->operands[0].reg = make_reg(rd, is_64);
-                decoded->operands[1].type = ARM64_OPERAND_REG;
-                decoded->operands[1].reg = make_reg(rn, is_64);
-                decoded->operands[2].type = ARM64_OPERAND_REG;
-                decoded->operands[2].reg = make_reg(rm, is_64);
-                decoded->operand_count = 3;
-            } else {
-                decoded->operands[0].type = ARM64_OPERAND_REG;
-                decoded->operands[0].reg = make_reg(rd, is_64);
-                decoded->operands[1].type = ARM64_OPERAND_REG;
-                decoded->operands[1].reg = make_reg(rn, is_64);
-                decoded->operands[2].type = ARM64_OPERAND_REG;
-                decoded->operands[2].reg = make_reg(rm, is_64);
-                decoded->operands[3].type = ARM64_OPERAND_REG;
-                decoded->operands[3].reg = make_reg(ra, is_64);
-                decoded->operand_count = 4;
-            }
-            
-            return true;
+        if (!d->mnemonic) return;
+        a64_reg(d, kind, rd);
+        a64_reg(d, kind, rn);
+        inst->regs_read |= a64_bit(rn, kind);
+    } else if (opcode2 == 1 && sf && opcode < 18) {
+        bool zero_form = opcode >= 8;
+        if (zero_form && rn != 31) return;
+        d->mnemonic = pac_names[opcode];
+        a64_reg(d, ARM64_REG_X, rd);
+        if (!zero_form) {
+            a64_reg(d, ARM64_REG_XSP, rn);
+            inst->regs_read |= a64_bit(rn, ARM64_REG_XSP);
         }
+        inst->regs_read |= a64_bit(rd, ARM64_REG_X);
+    } else {
+        return;
     }
-    
-    return false;
-}
-
-// MARK: - Main Decoder
-
-bool arm64dec_decode_instruction(uint32_t raw_instruction, uint64_t address, ARM64DecodedInstruction *decoded) {
-    if (!decoded) return false;
-    
-    memset(decoded, 0, sizeof(ARM64DecodedInstruction));
-    
-    decoded->raw = raw_instruction;
-    decoded->address = address;
-    decoded->condition = ARM64_COND_AL;
-    decoded->category = get_instruction_category(raw_instruction);
-    
-    bool success = false;
-    switch (decoded->category) {
-        case ARM64_INS_BRANCH:
-            success = decode_branch_instruction(raw_instruction, address, decoded);
-            break;
-            
-        case ARM64_INS_LOAD_STORE:
-            success = decode_load_store_instruction(raw_instruction, address, decoded);
+    inst->regs_written |= a64_bit(rd, kind);
+}
+
+static void a64_dp_3source(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool sf = (bytes >> 31) & 1;
+    uint8_t op31 = (bytes >> 21) & 0x7;
+    bool o0 = (bytes >> 15) & 1;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+    uint8_t rm = (bytes >> 16) & 0x1F;
+    uint8_t ra = (bytes >> 10) & 0x1F;
+    uint8_t kind = sf ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t src_kind = kind;
+    bool has_ra = true;
+
+    if ((bytes >> 29) & 0x3) return;
+
+    switch (op31) {
+        case 0:
+            d->mnemonic = (ra == 31) ? (o0 ? "MNEG" : "MUL") : (o0 ? "MSUB" : "MADD");
+            has_ra = ra != 31;
             break;
-            
-        case ARM64_INS_DATA_PROCESSING_IMM:
-            success = decode_data_processing_imm(raw_instruction, address, decoded);
+        case 1:
+        case 5:
+            if (!sf) return;
+            src_kind = ARM64_REG_W;
+            has_ra = ra != 31;
+            if (op31 == 1) d->mnemonic = has_ra ? (o0 ? "SMSUBL" : "SMADDL") : (o0 ? "SMNEGL" : "SMULL");
+            else d->mnemonic = has_ra ? (o0 ? "UMSUBL" : "UMADDL") : (o0 ? "UMNEGL" : "UMULL");
             break;
-            
-        case ARM64_INS_DATA_PROCESSING_REG:
-            success = decode_data_processing_reg(raw_instruction, address, decoded);
+        case 2:
+        case 6:
+            if (!sf || o0) return;
+            d->mnemonic = (op31 == 2) ? "SMULH" : "UMULH";
+            has_ra = false;
             break;
-            
-        case ARM64_INS_DATA_PROCESSING_SIMD:
-        case ARM64_INS_UNKNOWN:
         default:
-            decoded->opcode = ARM64_OP_UNKNOWN;
-            snprintf(decoded->mnemonic, sizeof(decoded->mnemonic), ".long");
-            snprintf(decoded->operand_str, sizeof(decoded->operand_str), "0x%08x", raw_instruction);
-            return false;
-    }
-    
-    if (success) {
-        const char *base_mnemonic = arm64dec_opcode_mnemonic(decoded->opcode);
-        if (decoded->opcode == ARM64_OP_B_COND) {
-            snprintf(decoded->mnemonic, sizeof(decoded->mnemonic), "b.%s",
-                    arm64dec_condition_name(decoded->condition));
-        } else {
-            snprintf(decoded->mnemonic, sizeof(decoded->mnemonic), "%s", base_mnemonic);
-        }
+            return;
     }
-    
-    return success;
+
+    a64_reg(d, kind, rd);
+    a64_reg(d, src_kind, rn);
+    a64_reg(d, src_kind, rm);
+    if (has_ra) a64_reg(d, kind, ra);
+
+    inst->regs_read |= a64_bit(rn, src_kind) | a64_bit(rm, src_kind) | (has_ra ? a64_bit(ra, kind) : 0);
+    inst->regs_written |= a64_bit(rd, kind);
 }
 
-// MARK: - Formatting and Analysis
+static void a64_dp_generic(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    uint8_t kind = ((bytes >> 31) & 1) ? ARM64_REG_X : ARM64_REG_W;
 
-size_t arm64dec_format_instruction(const ARM64DecodedInstruction *decoded, char *buffer, size_t buffer_size) {
-    if (!decoded || !buffer || buffer_size == 0) return 0;
-    
-    size_t written = 0;
-    
-    written += snprintf(buffer + written, buffer_size - written, "%-8s ", decoded->mnemonic);
-    
-    for (uint8_t i = 0; i < decoded->operand_count && written < buffer_size; i++) {
-        if (i > 0) {
-            written += snprintf(buffer + written, buffer_size - written, ", ");
+    d->mnemonic = "DPREG";
+    a64_reg(d, kind, bytes & 0x1F);
+    a64_reg(d, kind, (bytes >> 5) & 0x1F);
+}
+
+// MARK: - Floating Point
+
+static inline int a64_fp_kind(uint32_t bytes) {
+    switch ((bytes >> 22) & 0x3) {
+        case 0: return ARM64_REG_S;
+        case 1: return ARM64_REG_D;
+        case 3: return ARM64_REG_H;
+        default: return -1;
+    }
+}
+
+static void a64_fp_move(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                        A64Decoded *d, ARM64DecodedInstruction *inst) {
+    int kind = a64_fp_kind(bytes);
+    if (kind < 0) return;
+
+    d->mnemonic = "FMOV";
+    a64_reg(d, (uint8_t)kind, bytes & 0x1F);
+    a64_reg(d, (uint8_t)kind, (bytes >> 5) & 0x1F);
+}
+
+static void a64_fp_2source(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    static const char *const names[] = {
+        "FMUL", "FDIV", "FADD", "FSUB", "FMAX", "FMIN", "FMAXNM", "FMINNM", "FNMUL",
+    };
+    uint8_t opcode = (bytes >> 12) & 0xF;
+    int kind = a64_fp_kind(bytes);
+    if (kind < 0 || opcode > 8) return;
+
+    d->mnemonic = names[opcode];
+    a64_reg(d, (uint8_t)kind, bytes & 0x1F);
+    a64_reg(d, (uint8_t)kind, (bytes >> 5) & 0x1F);
+    a64_reg(d, (uint8_t)kind, (bytes >> 16) & 0x1F);
+}
+
+static void a64_fp_compare(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    int kind = a64_fp_kind(bytes);
+    bool with_zero = (bytes >> 3) & 1;
+    if (kind < 0) return;
+
+    d->mnemonic = ((bytes >> 4) & 1) ? "FCMPE" : "FCMP";
+    a64_reg(d, (uint8_t)kind, (bytes >> 5) & 0x1F);
+    if (with_zero) a64_push(d, ARM64_OPERAND_FP_ZERO);
+    else a64_reg(d, (uint8_t)kind, (bytes >> 16) & 0x1F);
+    inst->flags_written = 0xF; /* NZCV */
+}
+
+/* FMOV between general and FP registers and the integer conversions. */
+static void a64_fp_convert(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                           A64Decoded *d, ARM64DecodedInstruction *inst) {
+    bool sf = (bytes >> 31) & 1;
+    uint8_t opcode = (bytes >> 16) & 0x7;
+    bool to_gpr = opcode < 2 || opcode == 6;
+    int kind = a64_fp_kind(bytes);
+    uint8_t gpr_kind = sf ? ARM64_REG_X : ARM64_REG_W;
+    uint8_t rd = bytes & 0x1F;
+    uint8_t rn = (bytes >> 5) & 0x1F;
+
+    if (kind < 0) return;
+    if (opcode >= 6 && ((kind == ARM64_REG_D) != sf || kind == ARM64_REG_H)) return;
+
+    d->mnemonic = enc->mnemonic;
+    if (to_gpr) {
+        a64_reg(d, gpr_kind, rd);
+        a64_reg(d, (uint8_t)kind, rn);
+        inst->regs_written |= a64_bit(rd, gpr_kind);
+    } else {
+        a64_reg(d, (uint8_t)kind, rd);
+        a64_reg(d, gpr_kind, rn);
+        inst->regs_read |= a64_bit(rn, gpr_kind);
+    }
+}
+
+static void a64_simd_generic(const A64Encoding *enc, uint32_t bytes, uint64_t address,
+                             A64Decoded *d, ARM64DecodedInstruction *inst) {
+    d->mnemonic = "SIMD";
+}
+
+// MARK: - Encoding Tables
+
+/* Rows are tried in order within the class selected by op0 (bits 25..28),
+   so aliases and narrower encodings come before the forms they overlap.
+   Adding an encoding is a row here plus, if no existing handler fits, a
+   decode function above. */
+
+static const A64Encoding a64_dp_imm_rows[] = {
+    { 0x9F000000, 0x10000000, "ADR", a64_pcrel, ARM64_INS_DATA_PROCESSING_IMM },
+    { 0x9F000000, 0x90000000, "ADRP", a64_pcrel, ARM64_INS_DATA_PROCESSING_IMM },
+    { 0x1F800000, 0x11000000, NULL, a64_addsub_imm, ARM64_INS_DATA_PROCESSING_IMM },
+    { 0x1F800000, 0x12000000, NULL, a64_logical_imm, ARM64_INS_DATA_PROCESSING_IMM },
+    { 0x1F800000, 0x12800000, NULL, a64_move_wide, ARM64_INS_DATA_PROCESSING_IMM },
+    { 0x1F800000, 0x13000000, NULL, a64_bitfield, ARM64_INS_DATA_PROCESSING_IMM },
+    { 0x7FA00000, 0x13800000, NULL, a64_extract, ARM64_INS_DATA_PROCESSING_IMM },
+};
+
+static const A64Encoding a64_branch_rows[] = {
+    { 0x7C000000, 0x14000000, NULL, a64_branch_imm, ARM64_INS_BRANCH },
+    { 0xFF000010, 0x54000000, NULL, a64_branch_cond, ARM64_INS_BRANCH },
+    { 0x7E000000, 0x34000000, NULL, a64_compare_branch, ARM64_INS_BRANCH },
+    { 0x7E000000, 0x36000000, NULL, a64_test_branch, ARM64_INS_BRANCH },
+    { 0xFE000000, 0xD6000000, NULL, a64_branch_reg, ARM64_INS_BRANCH },
+    { 0xFF000000, 0xD4000000, NULL, a64_exception, ARM64_INS_SYSTEM },
+    { 0xFFFFF01F, 0xD503201F, NULL, a64_hint, ARM64_INS_SYSTEM },
+    { 0xFFFFF01F, 0xD503301F, NULL, a64_barrier, ARM64_INS_SYSTEM },
+    { 0xFFD00000, 0xD5100000, NULL, a64_system_move, ARM64_INS_SYSTEM },
+    { 0xFFC00000, 0xD5000000, "SYS", a64_system_other, ARM64_INS_SYSTEM },
+};
+
+static const A64Encoding a64_ldst_rows[] = {
+    { 0x3F000000, 0x08000000, NULL, a64_ldst_exclusive, ARM64_INS_LOAD_STORE },
+    { 0x3B000000, 0x18000000, NULL, a64_ldr_literal, ARM64_INS_LOAD_STORE },
+    { 0x3A000000, 0x28000000, NULL, a64_ldst_pair, ARM64_INS_LOAD_STORE },
+    { 0x3B000000, 0x39000000, NULL, a64_ldst_unsigned, ARM64_INS_LOAD_STORE },
+    { 0x3B200C00, 0x38200000, NULL, a64_ldst_atomic, ARM64_INS_LOAD_STORE },
+    { 0x3B200C00, 0x38200800, NULL, a64_ldst_register, ARM64_INS_LOAD_STORE },
+    { 0x3B200000, 0x38000000, NULL, a64_ldst_imm9, ARM64_INS_LOAD_STORE },
+};
+
+static const A64Encoding a64_dp_reg_rows[] = {
+    { 0x1F000000, 0x0A000000, NULL, a64_logical_reg, ARM64_INS_DATA_PROCESSING_REG },
+    { 0x1F200000, 0x0B000000, NULL, a64_addsub_reg, ARM64_INS_DATA_PROCESSING_REG },
+    { 0x1F200000, 0x0B200000, NULL, a64_addsub_ext, ARM64_INS_DATA_PROCESSING_REG },
+    { 0x1FE0FC00, 0x1A000000, NULL, a64_addsub_carry, ARM64_INS_DATA_PROCESSING_REG },
+    { 0x3FE00410, 0x3A400000, NULL, a64_cond_compare, ARM64_INS_DATA_PROCESSING_REG },
+    { 0x3FE00000, 0x1A800000, NULL, a64_cond_select, ARM64_INS_DATA_PROCESSING_REG },
+    { 0x5FE00000, 0x1AC00000, NULL, a64_dp_2source, ARM64_INS_DATA_PROCESSING_REG },
+    { 0x5FE00000, 0x5AC00000, NULL, a64_dp_1source, ARM64_INS_DATA_PROCESSING_REG },
+    { 0x1F000000, 0x1B000000, NULL, a64_dp_3source, ARM64_INS_DATA_PROCESSING_REG },
+};
+
+static const A64Encoding a64_fp_rows[] = {
+    { 0xFF3FFC00, 0x1E204000, NULL, a64_fp_move, ARM64_INS_DATA_PROCESSING_SIMD },
+    { 0xFF200C00, 0x1E200800, NULL, a64_fp_2source, ARM64_INS_DATA_PROCESSING_SIMD },
+    { 0xFF20FC07, 0x1E202000, NULL, a64_fp_compare, ARM64_INS_DATA_PROCESSING_SIMD },
+    { 0x7F3FFC00, 0x1E260000, "FMOV", a64_fp_convert, ARM64_INS_DATA_PROCESSING_SIMD },
+    { 0x7F3FFC00, 0x1E270000, "FMOV", a64_fp_convert, ARM64_INS_DATA_PROCESSING_SIMD },
+    { 0x7F3FFC00, 0x1E380000, "FCVTZS", a64_fp_convert, ARM64_INS_DATA_PROCESSING_SIMD },
+    { 0x7F3FFC00, 0x1E390000, "FCVTZU", a64_fp_convert, ARM64_INS_DATA_PROCESSING_SIMD },
+    { 0x7F3FFC00, 0x1E220000, "SCVTF", a64_fp_convert, ARM64_INS_DATA_PROCESSING_SIMD },
+    { 0x7F3FFC00, 0x1E230000, "UCVTF", a64_fp_convert, ARM64_INS_DATA_PROCESSING_SIMD },
+};
+
+static const A64Encoding a64_ldst_fallback = { 0, 0, NULL, a64_ldst_generic, ARM64_INS_LOAD_STORE };
+static const A64Encoding a64_dp_fallback = { 0, 0, NULL, a64_dp_generic, ARM64_INS_DATA_PROCESSING_REG };
+static const A64Encoding a64_simd_fallback = { 0, 0, NULL, a64_simd_generic, ARM64_INS_DATA_PROCESSING_SIMD };
+
+#define A64_CLASS(rows, fallback) { rows, sizeof(rows) / sizeof(rows[0]), fallback }
+
+/* Top-level dispatch on op0. Classes 0-3 (reserved, SVE) have no rows. */
+static const A64EncodingClass a64_classes[16] = {
+    [0x4] = A64_CLASS(a64_ldst_rows, &a64_ldst_fallback),
+    [0x5] = A64_CLASS(a64_dp_reg_rows, &a64_dp_fallback),
+    [0x6] = A64_CLASS(a64_ldst_rows, &a64_ldst_fallback),
+    [0x7] = A64_CLASS(a64_fp_rows, &a64_simd_fallback),
+    [0x8] = A64_CLASS(a64_dp_imm_rows, NULL),
+    [0x9] = A64_CLASS(a64_dp_imm_rows, NULL),
+    [0xA] = A64_CLASS(a64_branch_rows, NULL),
+    [0xB] = A64_CLASS(a64_branch_rows, NULL),
+    [0xC] = A64_CLASS(a64_ldst_rows, &a64_ldst_fallback),
+    [0xD] = A64_CLASS(a64_dp_reg_rows, &a64_dp_fallback),
+    [0xE] = A64_CLASS(a64_ldst_rows, &a64_ldst_fallback),
+    [0xF] = A64_CLASS(a64_fp_rows, &a64_simd_fallback),
+};
+
+// MARK: - Decoder API
+
+static inline void a64_reset(ARM64DecodedInstruction *inst, uint32_t bytes, uint64_t address) {
+    memset(inst, 0, sizeof(ARM64DecodedInstruction));
+    inst->raw = bytes;
+    inst->address = address;
+    inst->condition = ARM64_COND_AL;
+}
+
+/* Decodes one word within its op0 class. Coverage is the base A64 integer
+   set, common PAC/LSE/FP forms and the system instructions seen in
+   user-space binaries. Classes with rows but no exact match fall back to a
+   generic description (`LDR Xt, [Xn]`, `DPREG`, `SIMD`); anything else
+   becomes `.word 0xXXXXXXXX`. */
+static bool a64_decode(const A64EncodingClass *cls, uint32_t raw_instruction, uint64_t address,
+                       ARM64DecodedInstruction *inst) {
+    A64Decoded decoded;
+    decoded.mnemonic = NULL;
+    decoded.inst = inst;
+    a64_reset(inst, raw_instruction, address);
+
+    for (uint32_t i = 0; i < cls->row_count && !decoded.mnemonic; i++) {
+        const A64Encoding *row = &cls->rows[i];
+        if ((raw_instruction & row->mask) != row->value) continue;
+
+        inst->category = (ARM64InstructionCategory)row->category;
+        row->decode(row, raw_instruction, address, &decoded, inst);
+        if (!decoded.mnemonic) {
+            /* Declined: drop anything the handler recorded. */
+            a64_reset(inst, raw_instruction, address);
         }
-        
-        const ARM64Operand *op = &decoded->operands[i];
-        
-        switch (op->type) {
-            case ARM64_OPERAND_REG:
-                written += snprintf(buffer + written, buffer_size - written, "%s",
-                                  arm64dec_register_name(op->reg));
-                break;
-                
-            case ARM64_OPERAND_IMM:
-                written += snprintf(buffer + written, buffer_size - written, "#0x%llx",
-                                  (unsigned long long)op->imm);
-                break;
-                
-            case ARM64_OPERAND_LABEL:
-                written += snprintf(buffer + written, buffer_size - written, "0x%llx",
-                                  (unsigned long long)op->imm);
-                break;
-                
-            case ARM64_OPERAND_MEM: {
-                const ARM64MemoryOperand *mem = &op->mem;
-                written += snprintf(buffer + written, buffer_size - written, "[%s",
-                                  arm64dec_register_name(mem->base));
-                
-                if (mem->mode == ARM64_ADDR_LITERAL) {
-                    written += snprintf(buffer + written, buffer_size - written, "]=0x%llx",
-                                      (unsigned long long)mem->offset_imm);
-                } else if (mem->mode == ARM64_ADDR_REG_OFFSET || mem->mode == ARM64_ADDR_REG_EXTENDED) {
-                    written += snprintf(buffer + written, buffer_size - written, ", %s",
-                                      arm64dec_register_name(mem->offset_reg));
-                    if (mem->shift_amount > 0) {
-                        written += snprintf(buffer + written, buffer_size - written, ", lsl #%d",
-                                          mem->shift_amount);
-                    }
-                    written += snprintf(buffer + written, buffer_size - written, "]");
-                } else if (mem->offset_imm != 0) {
-                    written += snprintf(buffer + written, buffer_size - written, ", #%lld]",
-                                      (long long)mem->offset_imm);
-                } else {
-                    written += snprintf(buffer + written, buffer_size - written, "]");
-                }
-                
-                if (mem->mode == ARM64_ADDR_PRE_INDEX) {
-                    written += snprintf(buffer + written, buffer_size - written, "!");
-                } else if (mem->mode == ARM64_ADDR_POST_INDEX) {
-                    written += snprintf(buffer + written, buffer_size - written - 1, ", #%lld",
-                                      (long long)mem->offset_imm);
-                }
-                break;
+    }
+
+    if (!decoded.mnemonic && cls->fallback) {
+        inst->category = (ARM64InstructionCategory)cls->fallback->category;
+        cls->fallback->decode(cls->fallback, raw_instruction, address, &decoded, inst);
+    }
+
+    bool known = decoded.mnemonic != NULL;
+    if (!known) {
+        decoded.mnemonic = ".word";
+        a64_imm(&decoded, ARM64_OPERAND_WORD, raw_instruction);
+        inst->category = ARM64_INS_UNKNOWN;
+    }
+
+    A64Text t = { inst->mnemonic, 0, sizeof(inst->mnemonic) };
+    a64_puts(&t, decoded.mnemonic);
+    t.buf[t.len] = '\0';
+
+    return known;
+}
+
+bool arm64dec_decode_instruction(uint32_t raw_instruction, uint64_t address,
+                                 ARM64DecodedInstruction *out_decoded) {
+    if (!out_decoded) return false;
+    return a64_decode(&a64_classes[(raw_instruction >> 25) & 0xF], raw_instruction, address, out_decoded);
+}
+
+/* Writes the op0 field (bits 25..28) of each word to classes[]. */
+static void a64_classify(const uint32_t *words, size_t count, uint8_t *classes) {
+    size_t i = 0;
+#if A64_BATCH_NEON
+    const uint32x4_t mask = vdupq_n_u32(0xF);
+    for (; i + 8 <= count; i += 8) {
+        uint32x4_t lo = vandq_u32(vshrq_n_u32(vld1q_u32(words + i), 25), mask);
+        uint32x4_t hi = vandq_u32(vshrq_n_u32(vld1q_u32(words + i + 4), 25), mask);
+        vst1_u8(classes + i, vmovn_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi))));
+    }
+#elif A64_BATCH_SSE2
+    const __m128i mask = _mm_set1_epi32(0xF);
+    for (; i + 8 <= count; i += 8) {
+        __m128i lo = _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128((const __m128i*)(words + i)), 25), mask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128((const __m128i*)(words + i + 4)), 25), mask);
+        __m128i halves = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64((__m128i*)(classes + i), _mm_packus_epi16(halves, halves));
+    }
+#endif
+    for (; i < count; i++) classes[i] = (uint8_t)((words[i] >> 25) & 0xF);
+}
+
+size_t arm64dec_decode_batch(const uint32_t *words, size_t count, uint64_t base_address,
+                             ARM64DecodedInstruction *out) {
+    if (!words || !out) return 0;
+
+    uint8_t classes[A64_BATCH_BLOCK];
+    uint16_t order[A64_BATCH_BLOCK];
+    size_t known = 0;
+
+    for (size_t first = 0; first < count; first += A64_BATCH_BLOCK) {
+        size_t n = count - first;
+        if (n > A64_BATCH_BLOCK) n = A64_BATCH_BLOCK;
+        a64_classify(words + first, n, classes);
+
+        /* Counting sort of the block by class, so each class's rows and
+           handlers are walked for a run of words rather than interleaved. */
+        uint16_t starts[17] = {0};
+        for (size_t i = 0; i < n; i++) starts[classes[i] + 1]++;
+        for (int c = 0; c < 16; c++) starts[c + 1] += starts[c];
+        uint16_t fill[16];
+        memcpy(fill, starts, sizeof(fill));
+        for (size_t i = 0; i < n; i++) order[fill[classes[i]]++] = (uint16_t)i;
+
+        for (int c = 0; c < 16; c++) {
+            const A64EncodingClass *cls = &a64_classes[c];
+            for (uint16_t k = starts[c]; k < starts[c + 1]; k++) {
+                size_t i = first + order[k];
+                known += a64_decode(cls, words[i], base_address + (uint64_t)i * 4, &out[i]);
             }
-                
-            case ARM64_OPERAND_NONE:
-            default:
-                break;
         }
     }
-    
-    return written;
+
+    return known;
 }
 
 bool arm64dec_get_branch_target(const ARM64DecodedInstruction *decoded, uint64_t *out_target) {
-    if (!decoded || !out_target) return false;
-    
-    switch (decoded->opcode) {
-        case ARM64_OP_B:
-        case ARM64_OP_BL:
-        case ARM64_OP_B_COND:
-            if (decoded->operand_count > 0 && decoded->operands[0].type == ARM64_OPERAND_LABEL) {
-                *out_target = decoded->operands[0].imm;
-                return true;
-            }
-            break;
-            
-        case ARM64_OP_CBZ:
-        case ARM64_OP_CBNZ:
-            if (decoded->operand_count > 1 && decoded->operands[1].type == ARM64_OPERAND_LABEL) {
-                *out_target = decoded->operands[1].imm;
-                return true;
-            }
-            break;
-            
-        case ARM64_OP_TBZ:
-        case ARM64_OP_TBNZ:
-            if (decoded->operand_count > 2 && decoded->operands[2].type == ARM64_OPERAND_LABEL) {
-                *out_target = decoded->operands[2].imm;
-                return true;
-            }
-            break;
-            
-        default:
-            break;
-    }
-    
-    return false;
+    if (!decoded || decoded->branch_kind == ARM64_BRANCH_NONE || !decoded->has_target) return false;
+    if (out_target) *out_target = decoded->target;
+    return true;
 }
 
 bool arm64dec_is_call(const ARM64DecodedInstruction *decoded) {
-    return decoded && (decoded->opcode == ARM64_OP_BL || decoded->opcode == ARM64_OP_BLR);
+    return decoded && decoded->branch_kind == ARM64_BRANCH_CALL;
 }
 
 bool arm64dec_is_return(const ARM64DecodedInstruction *decoded) {
-    return decoded && decoded->opcode == ARM64_OP_RET;
+    return decoded && decoded->branch_kind == ARM64_BRANCH_RETURN;
 }
 
 bool arm64dec_is_conditional_branch(const ARM64DecodedInstruction *decoded) {
-    if (!decoded) return false;
-    
-    switch (decoded->opcode) {
-        case ARM64_OP_B_COND:
-        case ARM64_OP_CBZ:
-        case ARM64_OP_CBNZ:
-        case ARM64_OP_TBZ:
-        case ARM64_OP_TBNZ:
-            return true;
-        default:
-            return false;
-    }
+    return decoded && decoded->branch_kind == ARM64_BRANCH_CONDITIONAL;
 }
-
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,77 +18,17 @@ typedef enum {
     ARM64_INS_LOAD_STORE,
     ARM64_INS_DATA_PROCESSING_REG,
     ARM64_INS_DATA_PROCESSING_SIMD,
+    ARM64_INS_SYSTEM,
 } ARM64InstructionCategory;
 
+/* Same order as the disassembler's BranchType. */
 typedef enum {
-    ARM64_OP_UNKNOWN = 0,
-    ARM64_OP_B,
-    ARM64_OP_BL,
-    ARM64_OP_BR,
-    ARM64_OP_BLR,
-    ARM64_OP_RET,
-    ARM64_OP_CBZ,
-    ARM64_OP_CBNZ,
-    ARM64_OP_TBZ,
-    ARM64_OP_TBNZ,
-    ARM64_OP_B_COND,
-    ARM64_OP_LDR,
-    ARM64_OP_LDRB,
-    ARM64_OP_LDRH,
-    ARM64_OP_LDRSB,
-    ARM64_OP_LDRSH,
-    ARM64_OP_LDRSW,
-    ARM64_OP_STR,
-    ARM64_OP_STRB,
-    ARM64_OP_STRH,
-    ARM64_OP_LDP,
-    ARM64_OP_STP,
-    ARM64_OP_LDUR,
-    ARM64_OP_STUR,
-    ARM64_OP_ADD,
-    ARM64_OP_ADDS,
-    ARM64_OP_SUB,
-    ARM64_OP_SUBS,
-    ARM64_OP_MUL,
-    ARM64_OP_MADD,
-    ARM64_OP_MSUB,
-    ARM64_OP_SMULL,
-    ARM64_OP_UMULL,
-    ARM64_OP_SDIV,
-    ARM64_OP_UDIV,
-    ARM64_OP_AND,
-    ARM64_OP_ANDS,
-    ARM64_OP_ORR,
-    ARM64_OP_EOR,
-    ARM64_OP_BIC,
-    ARM64_OP_EON,
-    ARM64_OP_TST,
-    ARM64_OP_MOV,
-    ARM64_OP_MOVZ,
-    ARM64_OP_MOVN,
-    ARM64_OP_MOVK,
-    ARM64_OP_MVN,
-    ARM64_OP_LSL,
-    ARM64_OP_LSR,
-    ARM64_OP_ASR,
-    ARM64_OP_ROR,
-    ARM64_OP_CMP,
-    ARM64_OP_CMN,
-    ARM64_OP_UBFM,
-    ARM64_OP_SBFM,
-    ARM64_OP_BFM,
-    ARM64_OP_EXTR,
-    ARM64_OP_NOP,
-    ARM64_OP_HLT,
-    ARM64_OP_BRK,
-    ARM64_OP_SVC,
-    ARM64_OP_HVC,
-    ARM64_OP_SMC,
-    ARM64_OP_ADRP,
-    ARM64_OP_ADR,
-    ARM64_OP_SXT,
-    ARM64_OP_UXT,
-} ARM64Opcode;
+    ARM64_BRANCH_NONE = 0,
+    ARM64_BRANCH_CALL,
+    ARM64_BRANCH_UNCONDITIONAL,
+    ARM64_BRANCH_CONDITIONAL,
+    ARM64_BRANCH_RETURN,
+} ARM64BranchKind;
 
 typedef enum {
     ARM64_COND_EQ = 0x0,
@@ -108,19 +49,39 @@ typedef enum {
     ARM64_COND_NV = 0xF,
 } ARM64Condition;
 
+/* Views of an encoded register number. Number 31 is the zero register in
+   the X/W views and the stack pointer in the SP views. */
+typedef enum {
+    ARM64_REG_X = 0,
+    ARM64_REG_W,
+    ARM64_REG_XSP,
+    ARM64_REG_WSP,
+    ARM64_REG_B,
+    ARM64_REG_H,
+    ARM64_REG_S,
+    ARM64_REG_D,
+    ARM64_REG_Q,
+} ARM64RegisterKind;
+
 typedef struct {
     uint8_t num;
-    bool is_64bit;
-    bool is_sp;
-    bool is_zero;
+    uint8_t kind;               // ARM64RegisterKind
 } ARM64Register;
 
 typedef enum {
     ARM64_OPERAND_NONE = 0,
     ARM64_OPERAND_REG,
-    ARM64_OPERAND_IMM,
+    ARM64_OPERAND_IMM,          // #decimal
     ARM64_OPERAND_MEM,
-    ARM64_OPERAND_LABEL,
+    ARM64_OPERAND_LABEL,        // absolute address
+    ARM64_OPERAND_IMM_HEX,      // #0xHEX
+    ARM64_OPERAND_SHIFT,        // shift or extend applied to the previous register
+    ARM64_OPERAND_COND,
+    ARM64_OPERAND_SYSREG,       // o0:op1:CRn:CRm:op2 of MRS/MSR
+    ARM64_OPERAND_FP_ZERO,
+    ARM64_OPERAND_BARRIER,      // barrier option (CRm)
+    ARM64_OPERAND_BTI_TARGET,   // 1 = C, 2 = J, 3 = JC
+    ARM64_OPERAND_WORD,         // raw word of an undecoded instruction
 } ARM64OperandType;
 
 typedef enum {
@@ -133,50 +94,92 @@ typedef enum {
     ARM64_ADDR_LITERAL,
 } ARM64AddressingMode;
 
-typedef struct {
-    ARM64Register base;
-    ARM64Register offset_reg;
-    int64_t offset_imm;
-    ARM64AddressingMode mode;
-    uint8_t extend_type;
-    uint8_t shift_amount;
-} ARM64MemoryOperand;
+/* Shifts and extends share one numbering. */
+typedef enum {
+    ARM64_SHIFT_LSL = 0,
+    ARM64_SHIFT_LSR,
+    ARM64_SHIFT_ASR,
+    ARM64_SHIFT_ROR,
+    ARM64_EXTEND_UXTB,
+    ARM64_EXTEND_UXTH,
+    ARM64_EXTEND_UXTW,
+    ARM64_EXTEND_UXTX,
+    ARM64_EXTEND_SXTB,
+    ARM64_EXTEND_SXTH,
+    ARM64_EXTEND_SXTW,
+    ARM64_EXTEND_SXTX,
+} ARM64ShiftType;
 
 typedef struct {
     ARM64OperandType type;
-    union {
-        ARM64Register reg;
-        int64_t imm;
-        ARM64MemoryOperand mem;
-    };
+    ARM64Register reg;          // REG, or the base register of MEM
+    ARM64Register index;        // MEM in the REG_OFFSET / REG_EXTENDED modes
+    uint8_t mode;               // ARM64AddressingMode for MEM
+    uint8_t shift;              // ARM64ShiftType for SHIFT and indexed MEM
+    uint8_t amount;
+    bool show_amount;
+    int64_t imm;                // immediate, label, displacement, condition, sysreg, barrier
 } ARM64Operand;
 
+#define ARM64_MAX_OPERANDS 5
+
 typedef struct {
     uint32_t raw;
     uint64_t address;
     ARM64InstructionCategory category;
-    ARM64Opcode opcode;
-    ARM64Condition condition;
-    ARM64Operand operands[4];
+    ARM64BranchKind branch_kind;
+    ARM64Condition condition;   // B.cond only, ARM64_COND_AL otherwise
+
+    bool has_target;            // branch, ADR/ADRP or literal load
+    uint64_t target;
+    int64_t target_offset;
+    uint64_t regs_read;         // X0..X30 and SP as bits 0..31, XZR excluded
+    uint64_t regs_written;
+    uint8_t flags_written;      // NZCV bitmask (N=1, Z=2, C=4, V=8)
+
+    ARM64Operand operands[ARM64_MAX_OPERANDS];
     uint8_t operand_count;
-    char mnemonic[32];
-    char operand_str[256];
+    char mnemonic[16];
 } ARM64DecodedInstruction;
 
 // MARK: - Decoder API
 
+/* Decodes one word into mnemonic, structured operands and semantics. No
+   text is produced; use arm64dec_format_instruction/_operands for that.
+   Returns false for words with no decoding (mnemonic ".word"). Reentrant. */
 bool arm64dec_decode_instruction(
     uint32_t raw_instruction,
     uint64_t address,
     ARM64DecodedInstruction *out_decoded
 );
 
+/* Decodes count consecutive words, word i at base_address + 4*i, into
+   out[i]. Each block of words is first classified by op0 in one vector
+   pass and then decoded class by class; the results are the same as
+   calling arm64dec_decode_instruction on each word. Returns how many words
+   decoded to an instruction. Reentrant. */
+size_t arm64dec_decode_batch(
+    const uint32_t *words,
+    size_t count,
+    uint64_t base_address,
+    ARM64DecodedInstruction *out
+);
+
+/* Renders "MNEMONIC operands" into buffer; returns the text length. */
 size_t arm64dec_format_instruction(
     const ARM64DecodedInstruction *decoded,
     char *buffer,
     size_t buffer_size
 );
 
+/* Renders only the comma-separated operands. */
+size_t arm64dec_format_operands(
+    const ARM64Operand *operands,
+    uint8_t operand_count,
+    char *buffer,
+    size_t buffer_size
+);
+
 bool arm64dec_get_branch_target(
     const ARM64DecodedInstruction *decoded,
     uint64_t *out_target
@@ -190,11 +193,9 @@ bool arm64dec_is_conditional_branch(const ARM64DecodedInstruction *decoded);
 
 const char* arm64dec_register_name(ARM64Register reg);
 const char* arm64dec_condition_name(ARM64Condition cond);
-const char* arm64dec_opcode_mnemonic(ARM64Opcode opcode);
 
 #ifdef __cplusplus
 }
 #endif
 
 #endif
-
@@ -0,0 +1,440 @@
+#include "BatchAnalysis.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#define BATCH_MAX_WORKERS 256
+
+#pragma mark - Scheduler State
+
+typedef struct {
+    const char *path;
+    uint64_t file_size;
+    uint32_t stages;            // BATCH_STAGE_FLAG_* still to run after parsing
+    uint32_t stage_count;       // including the parse stage
+    uint32_t stages_done;
+    uint32_t stages_pending;    // stage tasks queued or running
+    size_t reserved;
+    double start;
+    BatchJobResult result;
+} BatchJob;
+
+typedef struct {
+    uint32_t job;
+    uint32_t stage;
+} BatchTask;
+
+/* Stage tasks of admitted jobs run before new jobs are parsed, so binaries
+   finish (and release their budget) in roughly the order they started.
+   Parsed jobs that do not fit the budget wait in `parked`; no new job is
+   parsed while one is waiting. */
+typedef struct {
+    BatchOptions options;
+    BatchJob *jobs;
+    uint32_t job_count;
+    uint32_t *order;            // job indices, largest file first
+    uint32_t next_parse;
+
+    BatchTask *tasks;           // ring of stage tasks
+    uint32_t task_capacity;
+    uint32_t task_head;
+    uint32_t task_count;
+
+    uint32_t *parked;           // ring of parsed jobs waiting for budget
+    uint32_t parked_head;
+    uint32_t parked_count;
+
+    size_t reserved_bytes;
+    uint32_t finished;
+    uint32_t failures;
+    uint32_t worker_count;
+    uint32_t idle_workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_mutex_t callback_lock;  // serializes user callbacks
+} BatchScheduler;
+
+static double batch_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint32_t batch_stage_count(uint32_t stages) {
+    uint32_t count = 0;
+    for (uint32_t stage = BATCH_STAGE_SYMBOLS; stage < BATCH_STAGE_COUNT; stage++) {
+        if (stages & (1u << stage)) count++;
+    }
+    return count;
+}
+
+#pragma mark - Memory Estimate
+
+static const SectionInfo* batch_find_text(const MachOContext *ctx) {
+    for (uint32_t i = 0; i < ctx->section_count; i++) {
+        if (strncmp(ctx->sections[i].sectname, "__text", 16) == 0) return &ctx->sections[i];
+    }
+    return NULL;
+}
+
+size_t batch_estimate_memory(const MachOContext *ctx, uint32_t stages, uint32_t disasm_flags) {
+    if (!ctx) return 0;
+
+    /* Mapped windows are bounded by the context's own budget. */
+    size_t bytes = ctx->slice_size < ctx->memory_budget ? (size_t)ctx->slice_size : ctx->memory_budget;
+
+    if (stages & BATCH_STAGE_FLAG_SYMBOLS) {
+        bytes += (size_t)ctx->nsyms * (sizeof(SymbolInfo) + 4 * sizeof(uint32_t)) + ctx->strsize;
+    }
+
+    if (stages & BATCH_STAGE_FLAG_STRINGS) {
+        /* Roughly one string per 32 readable bytes, plus its interned text. */
+        uint64_t readable = 0;
+        for (uint32_t i = 0; i < ctx->segment_count; i++) {
+            if (ctx->segments[i].initprot & 0x01) readable += ctx->segments[i].filesize;
+        }
+        bytes += (size_t)(readable / 32) * (sizeof(StringInfo) + 32);
+    }
+
+    if (stages & BATCH_STAGE_FLAG_DISASSEMBLY) {
+        const SectionInfo *text = batch_find_text(ctx);
+        if (text) {
+            /* ARM64 is 4 bytes per instruction; x86_64 averages about as much. */
+            size_t per_instruction = (disasm_flags & DISASM_FLAG_COMPACT) ? 32 : sizeof(DisassembledInstruction);
+            bytes += (size_t)(text->size / 4) * (per_instruction + sizeof(uint32_t));
+        }
+    }
+
+    if (stages & BATCH_STAGE_FLAG_OBJC) {
+        for (uint32_t i = 0; i < ctx->section_count; i++) {
+            if (strncmp(ctx->sections[i].sectname, "__objc_classlist", 16) == 0) {
+                bytes += (size_t)(ctx->sections[i].size / 8) * (sizeof(ObjCClassInfo) + 16 * sizeof(ObjCMethodInfo));
+            }
+        }
+    }
+
+    return bytes;
+}
+
+const char* batch_stage_name(BatchStage stage) {
+    switch (stage) {
+        case BATCH_STAGE_PARSE: return "parse";
+        case BATCH_STAGE_SYMBOLS: return "symbols";
+        case BATCH_STAGE_STRINGS: return "strings";
+        case BATCH_STAGE_DISASSEMBLY: return "disassembly";
+        case BATCH_STAGE_OBJC: return "objc";
+        default: return "unknown";
+    }
+}
+
+#pragma mark - Stages
+
+static bool batch_parse(BatchJob *job) {
+    BatchJobResult *result = &job->result;
+    MachOContext *ctx = macho_open(job->path, result->error);
+    if (!ctx) {
+        if (!result->error[0]) snprintf(result->error, sizeof(result->error), "Failed to open file");
+        return false;
+    }
+    if (!macho_parse_header(ctx)) {
+        snprintf(result->error, sizeof(result->error), "Invalid Mach-O header");
+        macho_close(ctx);
+        return false;
+    }
+    if (!macho_parse_load_commands(ctx)) {
+        snprintf(result->error, sizeof(result->error), "Failed to parse load commands");
+        macho_close(ctx);
+        return false;
+    }
+    macho_extract_segments(ctx);
+    macho_extract_sections(ctx);
+
+    result->macho = ctx;
+    result->ok = true;
+    return true;
+}
+
+/* Runs one post-parse stage. Stages write only their own result field and
+   read the shared MachOContext, whose window cache is locked internally. */
+static void batch_run_stage(BatchScheduler *s, BatchJob *job, BatchStage stage, uint32_t threads) {
+    BatchJobResult *result = &job->result;
+    MachOContext *ctx = result->macho;
+
+    switch (stage) {
+        case BATCH_STAGE_SYMBOLS: {
+            SymbolTableContext *symbols = symbol_table_create(ctx);
+            if (!symbols) break;
+            if (!symbol_table_parse_parallel(symbols, threads)) {
+                symbol_table_free(symbols);
+                break;
+            }
+            symbol_table_categorize(symbols);
+            symbol_table_extract_functions(symbols);
+            result->symbols = symbols;
+            break;
+        }
+        case BATCH_STAGE_STRINGS: {
+            StringContext *strings = string_context_create(1024);
+            if (!strings) break;
+            string_context_set_workers(strings, threads);
+            string_extract_all(strings, ctx);
+            result->strings = strings;
+            break;
+        }
+        case BATCH_STAGE_DISASSEMBLY: {
+            DisassemblyContext *disasm = disasm_create(ctx);
+            if (!disasm) break;
+            if (s->options.disasm_flags) disasm_enable_flag(disasm, s->options.disasm_flags);
+            if (!disasm_load_section(disasm, "__text")) {
+                disasm_free(disasm);
+                break;
+            }
+            if (threads > 1) {
+                disasm_all_parallel(disasm, threads);
+            } else {
+                disasm_all(disasm);
+            }
+            result->disasm = disasm;
+            break;
+        }
+        case BATCH_STAGE_OBJC:
+            result->objc = objc_parse_runtime(ctx);
+            break;
+        default:
+            break;
+    }
+}
+
+static void batch_report_progress(BatchScheduler *s, BatchJob *job, BatchStage stage, uint32_t stages_done) {
+    if (!s->options.progress) return;
+    pthread_mutex_lock(&s->callback_lock);
+    s->options.progress(job->result.index, stage, stages_done, job->stage_count, s->options.user_data);
+    pthread_mutex_unlock(&s->callback_lock);
+}
+
+static void batch_deliver(BatchScheduler *s, BatchJob *job) {
+    BatchJobResult *result = &job->result;
+    result->elapsed = batch_now() - job->start;
+
+    if (s->options.result) {
+        pthread_mutex_lock(&s->callback_lock);
+        s->options.result(result, s->options.user_data);
+        pthread_mutex_unlock(&s->callback_lock);
+    }
+
+    if (result->objc) objc_free_runtime_info(result->objc);
+    if (result->disasm) disasm_free(result->disasm);
+    if (result->strings) string_context_free(result->strings);
+    if (result->symbols) symbol_table_free(result->symbols);
+    if (result->macho) macho_close(result->macho);
+    result->objc = NULL;
+    result->disasm = NULL;
+    result->strings = NULL;
+    result->symbols = NULL;
+    result->macho = NULL;
+}
+
+#pragma mark - Scheduling
+
+/* Called with the lock held. Reserves the job's budget and queues its stages. */
+static void batch_admit(BatchScheduler *s, uint32_t index) {
+    BatchJob *job = &s->jobs[index];
+    s->reserved_bytes += job->reserved;
+    for (uint32_t stage = BATCH_STAGE_SYMBOLS; stage < BATCH_STAGE_COUNT; stage++) {
+        if (!(job->stages & (1u << stage))) continue;
+        uint32_t slot = (s->task_head + s->task_count) % s->task_capacity;
+        s->tasks[slot].job = index;
+        s->tasks[slot].stage = stage;
+        s->task_count++;
+        job->stages_pending++;
+    }
+    pthread_cond_broadcast(&s->wake);
+}
+
+static bool batch_fits(const BatchScheduler *s, const BatchJob *job) {
+    return s->reserved_bytes == 0 || s->reserved_bytes + job->reserved <= s->options.memory_budget;
+}
+
+static void batch_admit_parked(BatchScheduler *s) {
+    while (s->parked_count > 0) {
+        uint32_t index = s->parked[s->parked_head];
+        if (!batch_fits(s, &s->jobs[index])) break;
+        s->parked_head = (s->parked_head + 1) % s->job_count;
+        s->parked_count--;
+        batch_admit(s, index);
+    }
+}
+
+/* Called with the lock held; drops it while the result is delivered. */
+static void batch_complete(BatchScheduler *s, BatchJob *job) {
+    pthread_mutex_unlock(&s->lock);
+    batch_deliver(s, job);
+    pthread_mutex_lock(&s->lock);
+
+    s->reserved_bytes -= job->reserved;
+    if (!job->result.ok) s->failures++;
+    s->finished++;
+    batch_admit_parked(s);
+    pthread_cond_broadcast(&s->wake);
+}
+
+static void* batch_worker(void *arg) {
+    BatchScheduler *s = (BatchScheduler*)arg;
+    pthread_mutex_lock(&s->lock);
+
+    for (;;) {
+        if (s->task_count > 0) {
+            BatchTask task = s->tasks[s->task_head];
+            s->task_head = (s->task_head + 1) % s->task_capacity;
+            s->task_count--;
+            uint32_t threads = 1 + s->idle_workers;
+            pthread_mutex_unlock(&s->lock);
+
+            BatchJob *job = &s->jobs[task.job];
+            batch_run_stage(s, job, (BatchStage)task.stage, threads);
+
+            pthread_mutex_lock(&s->lock);
+            uint32_t stages_done = ++job->stages_done;
+            bool last = --job->stages_pending == 0;
+            pthread_mutex_unlock(&s->lock);
+            batch_report_progress(s, job, (BatchStage)task.stage, stages_done);
+            pthread_mutex_lock(&s->lock);
+
+            if (last) batch_complete(s, job);
+            continue;
+        }
+
+        if (s->next_parse < s->job_count && s->parked_count == 0) {
+            uint32_t index = s->order[s->next_parse++];
+            BatchJob *job = &s->jobs[index];
+            pthread_mutex_unlock(&s->lock);
+
+            job->start = batch_now();
+            bool parsed = batch_parse(job);
+            if (parsed) {
+                job->stages = s->options.stages & BATCH_STAGE_FLAG_ALL;
+                if (job->result.macho->is_encrypted) job->stages &= BATCH_STAGE_FLAG_SYMBOLS;
+                job->stage_count = 1 + batch_stage_count(job->stages);
+                job->reserved = batch_estimate_memory(job->result.macho, job->stages, s->options.disasm_flags);
+            } else {
+                job->stages = 0;
+                job->stage_count = 1;
+            }
+            job->stages_done = 1;
+            batch_report_progress(s, job, BATCH_STAGE_PARSE, 1);
+
+            pthread_mutex_lock(&s->lock);
+            if (job->stages == 0) {
+                job->reserved = 0;
+                batch_complete(s, job);
+            } else if (batch_fits(s, job)) {
+                batch_admit(s, index);
+            } else {
+                s->parked[(s->parked_head + s->parked_count) % s->job_count] = index;
+                s->parked_count++;
+            }
+            continue;
+        }
+
+        if (s->finished == s->job_count) break;
+
+        s->idle_workers++;
+        pthread_cond_wait(&s->wake, &s->lock);
+        s->idle_workers--;
+    }
+
+    pthread_cond_broadcast(&s->wake);
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+typedef struct {
+    uint64_t file_size;
+    uint32_t index;
+} BatchSortKey;
+
+static int batch_compare_size(const void *a, const void *b) {
+    const BatchSortKey *ka = (const BatchSortKey*)a;
+    const BatchSortKey *kb = (const BatchSortKey*)b;
+    if (ka->file_size != kb->file_size) return ka->file_size > kb->file_size ? -1 : 1;
+    return (ka->index > kb->index) - (ka->index < kb->index);
+}
+
+#pragma mark - Public API
+
+uint32_t batch_analyze(const char *const *paths, uint32_t count, const BatchOptions *options) {
+    if (!paths || count == 0) return 0;
+
+    BatchScheduler s;
+    memset(&s, 0, sizeof(s));
+    if (options) s.options = *options;
+    if (s.options.memory_budget == 0) s.options.memory_budget = BATCH_DEFAULT_MEMORY_BUDGET;
+
+    s.job_count = count;
+    s.jobs = (BatchJob*)calloc(count, sizeof(BatchJob));
+    s.order = (uint32_t*)malloc(count * sizeof(uint32_t));
+    s.parked = (uint32_t*)malloc(count * sizeof(uint32_t));
+    s.task_capacity = count * (BATCH_STAGE_COUNT - 1);
+    s.tasks = (BatchTask*)malloc(s.task_capacity * sizeof(BatchTask));
+    if (!s.jobs || !s.order || !s.parked || !s.tasks) {
+        free(s.jobs);
+        free(s.order);
+        free(s.parked);
+        free(s.tasks);
+        return count;
+    }
+
+    /* Largest first, so the longest binary is not the one left running alone. */
+    BatchSortKey *keys = (BatchSortKey*)malloc(count * sizeof(BatchSortKey));
+    for (uint32_t i = 0; i < count; i++) {
+        struct stat st;
+        s.jobs[i].path = paths[i];
+        s.jobs[i].file_size = (stat(paths[i], &st) == 0) ? (uint64_t)st.st_size : 0;
+        s.jobs[i].result.index = i;
+        s.jobs[i].result.path = paths[i];
+        if (keys) {
+            keys[i].file_size = s.jobs[i].file_size;
+            keys[i].index = i;
+        }
+    }
+    if (keys) qsort(keys, count, sizeof(BatchSortKey), batch_compare_size);
+    for (uint32_t i = 0; i < count; i++) s.order[i] = keys ? keys[i].index : i;
+    free(keys);
+
+    uint32_t workers = s.options.worker_count;
+    if (workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (workers > BATCH_MAX_WORKERS) workers = BATCH_MAX_WORKERS;
+    s.worker_count = workers;
+
+    pthread_mutex_init(&s.lock, NULL);
+    pthread_cond_init(&s.wake, NULL);
+    pthread_mutex_init(&s.callback_lock, NULL);
+
+    pthread_t threads[BATCH_MAX_WORKERS];
+    bool started[BATCH_MAX_WORKERS] = {false};
+    for (uint32_t t = 1; t < workers; t++) {
+        started[t] = (pthread_create(&threads[t], NULL, batch_worker, &s) == 0);
+    }
+    batch_worker(&s);
+    for (uint32_t t = 1; t < workers; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+    }
+
+    pthread_mutex_destroy(&s.callback_lock);
+    pthread_cond_destroy(&s.wake);
+    pthread_mutex_destroy(&s.lock);
+
+    uint32_t failures = s.failures;
+    free(s.jobs);
+    free(s.order);
+    free(s.parked);
+    free(s.tasks);
+    return failures;
+}
@@ -0,0 +1,92 @@
+#ifndef BatchAnalysis_h
+#define BatchAnalysis_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "MachOHeader.h"
+#include "SymbolTable.h"
+#include "StringExtractor.h"
+#include "DisassemblyEngine.h"
+#include "ObjCParser.h"
+
+#pragma mark - Constants
+
+/* Upper bound on the estimated working set of the binaries in flight. */
+#define BATCH_DEFAULT_MEMORY_BUDGET ((size_t)1024 * 1024 * 1024)
+
+typedef enum {
+    BATCH_STAGE_PARSE = 0,      // open, header, load commands, segments, sections
+    BATCH_STAGE_SYMBOLS,        // parse, categorize, extract functions
+    BATCH_STAGE_STRINGS,        // string_extract_all
+    BATCH_STAGE_DISASSEMBLY,    // __text sweep
+    BATCH_STAGE_OBJC,           // objc_parse_runtime
+    BATCH_STAGE_COUNT
+} BatchStage;
+
+enum {
+    BATCH_STAGE_FLAG_SYMBOLS     = (1u << BATCH_STAGE_SYMBOLS),
+    BATCH_STAGE_FLAG_STRINGS     = (1u << BATCH_STAGE_STRINGS),
+    BATCH_STAGE_FLAG_DISASSEMBLY = (1u << BATCH_STAGE_DISASSEMBLY),
+    BATCH_STAGE_FLAG_OBJC        = (1u << BATCH_STAGE_OBJC),
+    BATCH_STAGE_FLAG_ALL         = BATCH_STAGE_FLAG_SYMBOLS | BATCH_STAGE_FLAG_STRINGS |
+                                   BATCH_STAGE_FLAG_DISASSEMBLY | BATCH_STAGE_FLAG_OBJC,
+};
+
+#pragma mark - Structures
+
+/* One finished binary. The contexts are freed when the result callback
+   returns; to keep one, take it and set the field to NULL. symbols,
+   strings and disasm read through macho, so taking any of them means
+   taking macho too. Encrypted binaries (macho->is_encrypted) only get the
+   symbols stage; their code and data are ciphertext. */
+typedef struct {
+    uint32_t index;             // position in the caller's path list
+    const char *path;
+    bool ok;
+    char error[256];            // set when ok is false
+    double elapsed;             // seconds from the parse stage to the last stage
+
+    MachOContext *macho;
+    SymbolTableContext *symbols;
+    StringContext *strings;
+    DisassemblyContext *disasm;
+    ObjCRuntimeInfo *objc;
+} BatchJobResult;
+
+/* Called after each stage of a job; stages_done of stage_count. */
+typedef void (*BatchProgressCallback)(uint32_t index, BatchStage stage, uint32_t stages_done,
+                                      uint32_t stage_count, void *user_data);
+
+typedef void (*BatchResultCallback)(BatchJobResult *result, void *user_data);
+
+typedef struct {
+    uint32_t worker_count;      // 0 = one per online CPU
+    size_t memory_budget;       // 0 = BATCH_DEFAULT_MEMORY_BUDGET
+    uint32_t stages;            // BATCH_STAGE_FLAG_*; parsing always runs
+    uint32_t disasm_flags;      // DISASM_FLAG_* for the disassembly stage
+    BatchProgressCallback progress;
+    BatchResultCallback result;
+    void *user_data;
+} BatchOptions;
+
+#pragma mark - Function Declarations
+
+/* Analyzes count binaries on one shared pool of worker threads and blocks
+   until all are done. Larger files start first. After a binary is parsed,
+   its remaining stages run as separate tasks in parallel. A stage started
+   while workers are idle lends them to the parallel symbol, string and
+   disassembly passes, so the last large binary still uses every core.
+   A parsed binary starts only if its estimated working set fits next to
+   those in flight (one always runs). Callbacks come from worker threads
+   one at a time, and each result is delivered as soon as its binary
+   finishes. Returns the number of binaries that failed to parse. */
+uint32_t batch_analyze(const char *const *paths, uint32_t count, const BatchOptions *options);
+
+/* Estimated peak bytes for running stages on a parsed image. */
+size_t batch_estimate_memory(const MachOContext *ctx, uint32_t stages, uint32_t disasm_flags);
+
+const char* batch_stage_name(BatchStage stage);
+
+#endif
@@ -10,6 +10,7 @@ import UIKit
     @objc let instructions: [String]
     @objc var successors: [Int] = []
     @objc var nodeType: CFGNodeType = .normal
+    @objc var loopDepth: Int = 0
     
     var position: CGPoint = .zero
     var size: CGSize = CGSize(width: 200, height: 80)
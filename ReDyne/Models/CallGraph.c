@@ -0,0 +1,379 @@
+#include "CallGraph.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CALLGRAPH_UNDEFINED UINT32_MAX
+
+#pragma mark - Nodes
+
+static int compare_indices(const void *a, const void *b) {
+    uint32_t ia = *(const uint32_t*)a, ib = *(const uint32_t*)b;
+    return (ia > ib) - (ia < ib);
+}
+
+static int compare_nodes(const void *a, const void *b) {
+    uint64_t aa = ((const CallGraphNode*)a)->address, ab = ((const CallGraphNode*)b)->address;
+    return (aa > ab) - (aa < ab);
+}
+
+/* Sorted, distinct first-instruction indices of each function, followed by
+   instruction_count as the end of the last one. */
+static uint32_t* callgraph_function_starts(DisassemblyContext *disasm, const uint64_t *starts,
+                                           uint32_t count, uint32_t *function_count) {
+    uint32_t total = disasm->instruction_count;
+    uint32_t n = 0;
+    uint32_t *indices;
+
+    if (starts) {
+        indices = (uint32_t*)malloc(((size_t)count + 1) * sizeof(uint32_t));
+        if (!indices) return NULL;
+
+        if (!disasm->index_valid) disasm_build_address_index(disasm);
+        for (uint32_t i = 0; i < count; i++) {
+            int32_t index = disasm_find_by_address(disasm, starts[i]);
+            if (index >= 0) indices[n++] = (uint32_t)index;
+        }
+        qsort(indices, n, sizeof(uint32_t), compare_indices);
+    } else {
+        DisasmSemantics inst;
+        uint32_t marked = 1;
+        for (uint32_t i = 1; i < total; i++) {
+            disasm_get_semantics(disasm, i, &inst);
+            if (inst.attrs & DISASM_ATTR_FUNCTION_START) marked++;
+        }
+
+        indices = (uint32_t*)malloc(((size_t)marked + 1) * sizeof(uint32_t));
+        if (!indices) return NULL;
+
+        indices[n++] = 0;
+        for (uint32_t i = 1; i < total; i++) {
+            disasm_get_semantics(disasm, i, &inst);
+            if (inst.attrs & DISASM_ATTR_FUNCTION_START) indices[n++] = i;
+        }
+    }
+
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (unique == 0 || indices[i] != indices[unique - 1]) indices[unique++] = indices[i];
+    }
+    indices[unique] = total;
+    *function_count = unique;
+    return indices;
+}
+
+static uint32_t callgraph_stub_count(const MachOContext *macho) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; macho && i < macho->section_count; i++) {
+        const SectionInfo *sect = &macho->sections[i];
+        if ((sect->flags & SECTION_TYPE) == S_SYMBOL_STUBS && sect->reserved2 > 0) {
+            count += (uint32_t)(sect->size / sect->reserved2);
+        }
+    }
+    return count;
+}
+
+static void callgraph_add_stubs(CallGraph *graph, const MachOContext *macho, SymbolTableContext *symbols) {
+    uint32_t first = graph->node_count;
+
+    for (uint32_t i = 0; macho && i < macho->section_count; i++) {
+        const SectionInfo *sect = &macho->sections[i];
+        if ((sect->flags & SECTION_TYPE) != S_SYMBOL_STUBS || sect->reserved2 == 0) continue;
+
+        uint32_t entries = (uint32_t)(sect->size / sect->reserved2);
+        for (uint32_t e = 0; e < entries; e++) {
+            CallGraphNode *node = &graph->nodes[graph->node_count++];
+            node->address = sect->addr + (uint64_t)e * sect->reserved2;
+            node->end_address = node->address + sect->reserved2;
+            node->name = symbols ? symbol_table_stub_name(symbols, node->address) : NULL;
+            node->is_stub = true;
+        }
+    }
+
+    qsort(graph->nodes + first, graph->node_count - first, sizeof(CallGraphNode), compare_nodes);
+}
+
+/* Index in [lo, hi) of the node containing address, or -1. */
+static int32_t callgraph_search(const CallGraphNode *nodes, uint32_t lo, uint32_t hi, uint64_t address) {
+    uint32_t first = lo;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (nodes[mid].address <= address) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == first || address >= nodes[lo - 1].end_address) return -1;
+    return (int32_t)(lo - 1);
+}
+
+int32_t callgraph_find_node(const CallGraph *graph, uint64_t address) {
+    if (!graph) return -1;
+    int32_t node = callgraph_search(graph->nodes, 0, graph->function_count, address);
+    if (node < 0) node = callgraph_search(graph->nodes, graph->function_count, graph->node_count, address);
+    return node;
+}
+
+#pragma mark - Edges
+
+static bool callgraph_reserve(uint32_t **array, uint32_t *capacity, uint32_t needed) {
+    if (needed <= *capacity) return true;
+
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 1024;
+    while (new_capacity < needed) new_capacity *= 2;
+    uint32_t *grown = (uint32_t*)realloc(*array, new_capacity * sizeof(uint32_t));
+    if (!grown) return false;
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+/* Callee rows are filled caller by caller, so each is sorted on its own
+   and the callers CSR comes out sorted by counting. */
+static bool callgraph_build_edges(CallGraph *graph, DisassemblyContext *disasm, const uint32_t *starts) {
+    uint32_t n = graph->node_count;
+    graph->callee_offsets = (uint32_t*)calloc((size_t)n + 1, sizeof(uint32_t));
+    graph->caller_offsets = (uint32_t*)calloc((size_t)n + 1, sizeof(uint32_t));
+    if (!graph->callee_offsets || !graph->caller_offsets) return false;
+
+    // Reserved up front so rows and queries never offset a NULL array.
+    uint32_t capacity = 0;
+    if (!callgraph_reserve(&graph->callees, &capacity, 1)) return false;
+    DisasmSemantics inst;
+
+    for (uint32_t f = 0; f < graph->function_count; f++) {
+        uint32_t row = graph->edge_count;
+
+        for (uint32_t i = starts[f]; i < starts[f + 1]; i++) {
+            disasm_get_semantics(disasm, i, &inst);
+            if (inst.branch_type != BRANCH_CALL) continue;
+
+            int32_t target = (inst.attrs & DISASM_ATTR_HAS_BRANCH_TARGET)
+                           ? callgraph_find_node(graph, inst.branch_target) : -1;
+            if (target < 0) {
+                graph->unresolved_call_count++;
+                continue;
+            }
+
+            graph->call_site_count++;
+            if (!callgraph_reserve(&graph->callees, &capacity, graph->edge_count + 1)) return false;
+            graph->callees[graph->edge_count++] = (uint32_t)target;
+        }
+
+        uint32_t length = graph->edge_count - row;
+        if (length > 1) qsort(graph->callees + row, length, sizeof(uint32_t), compare_indices);
+        uint32_t unique = 0;
+        for (uint32_t k = 0; k < length; k++) {
+            uint32_t callee = graph->callees[row + k];
+            if (unique == 0 || callee != graph->callees[row + unique - 1]) graph->callees[row + unique++] = callee;
+        }
+        graph->edge_count = row + unique;
+        graph->callee_offsets[f + 1] = graph->edge_count;
+    }
+    for (uint32_t v = graph->function_count; v < n; v++) graph->callee_offsets[v + 1] = graph->edge_count;
+
+    graph->callers = (uint32_t*)malloc((graph->edge_count ? graph->edge_count : 1) * sizeof(uint32_t));
+    if (!graph->callers) return false;
+
+    for (uint32_t e = 0; e < graph->edge_count; e++) graph->caller_offsets[graph->callees[e] + 1]++;
+    for (uint32_t v = 0; v < n; v++) graph->caller_offsets[v + 1] += graph->caller_offsets[v];
+
+    uint32_t *fill = (uint32_t*)malloc(((size_t)n + 1) * sizeof(uint32_t));
+    if (!fill) return false;
+    memcpy(fill, graph->caller_offsets, n * sizeof(uint32_t));
+    for (uint32_t v = 0; v < n; v++) {
+        for (uint32_t e = graph->callee_offsets[v]; e < graph->callee_offsets[v + 1]; e++) {
+            graph->callers[fill[graph->callees[e]]++] = v;
+        }
+    }
+    free(fill);
+    return true;
+}
+
+#pragma mark - Components
+
+/* Iterative Tarjan; components complete callees first. */
+static bool callgraph_build_sccs(CallGraph *graph) {
+    uint32_t n = graph->node_count;
+    graph->scc_ids = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    graph->scc_sizes = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t *index = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t *low = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t *stack = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t *calls = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t *edge_pos = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+
+    bool ok = graph->scc_ids && graph->scc_sizes && index && low && stack && calls && edge_pos;
+    if (ok) {
+        uint32_t next_index = 0, sp = 0;
+        for (uint32_t v = 0; v < n; v++) {
+            index[v] = CALLGRAPH_UNDEFINED;
+            graph->scc_ids[v] = CALLGRAPH_UNDEFINED;
+        }
+
+        for (uint32_t root = 0; root < n; root++) {
+            if (index[root] != CALLGRAPH_UNDEFINED) continue;
+
+            uint32_t cp = 0;
+            index[root] = low[root] = next_index++;
+            edge_pos[root] = graph->callee_offsets[root];
+            stack[sp++] = root;
+            calls[cp++] = root;
+
+            while (cp > 0) {
+                uint32_t v = calls[cp - 1];
+
+                if (edge_pos[v] < graph->callee_offsets[v + 1]) {
+                    uint32_t w = graph->callees[edge_pos[v]++];
+                    if (index[w] == CALLGRAPH_UNDEFINED) {
+                        index[w] = low[w] = next_index++;
+                        edge_pos[w] = graph->callee_offsets[w];
+                        stack[sp++] = w;
+                        calls[cp++] = w;
+                    } else if (graph->scc_ids[w] == CALLGRAPH_UNDEFINED && index[w] < low[v]) {
+                        // Still on the stack: not yet assigned a component.
+                        low[v] = index[w];
+                    }
+                    continue;
+                }
+
+                cp--;
+                if (cp > 0 && low[v] < low[calls[cp - 1]]) low[calls[cp - 1]] = low[v];
+
+                if (low[v] == index[v]) {
+                    uint32_t id = graph->scc_count++;
+                    uint32_t size = 0;
+                    uint32_t w;
+                    do {
+                        w = stack[--sp];
+                        graph->scc_ids[w] = id;
+                        size++;
+                    } while (w != v);
+                    graph->scc_sizes[id] = size;
+                }
+            }
+        }
+    }
+
+    free(index);
+    free(low);
+    free(stack);
+    free(calls);
+    free(edge_pos);
+    return ok;
+}
+
+#pragma mark - Building
+
+CallGraph* callgraph_build(DisassemblyContext *disasm, SymbolTableContext *symbols,
+                           const uint64_t *starts, uint32_t count) {
+    if (!disasm || disasm->instruction_count == 0) return NULL;
+
+    CallGraph *graph = (CallGraph*)calloc(1, sizeof(CallGraph));
+    if (!graph) return NULL;
+
+    uint32_t function_count = 0;
+    uint32_t *indices = callgraph_function_starts(disasm, starts, count, &function_count);
+    uint32_t stub_count = callgraph_stub_count(disasm->macho_ctx);
+    graph->nodes = (CallGraphNode*)calloc((size_t)function_count + stub_count + 1, sizeof(CallGraphNode));
+    if (!indices || !graph->nodes) {
+        free(indices);
+        callgraph_free(graph);
+        return NULL;
+    }
+
+    if (symbols) symbol_table_build_indices(symbols);
+
+    DisasmSemantics last;
+    for (uint32_t f = 0; f < function_count; f++) {
+        CallGraphNode *node = &graph->nodes[f];
+        node->address = disasm_address_at(disasm, indices[f]);
+        disasm_get_semantics(disasm, indices[f + 1] - 1, &last);
+        node->end_address = last.address + last.length;
+        if (symbols) {
+            // Only a symbol starting exactly here names the node; one that merely
+            // precedes it belongs to another function.
+            int32_t symbol = symbol_table_find_containing(symbols, node->address);
+            if (symbol >= 0 && symbols->symbols[symbol].address == node->address) {
+                node->name = symbols->symbols[symbol].name;
+            }
+        }
+    }
+    graph->function_count = function_count;
+    graph->node_count = function_count;
+    callgraph_add_stubs(graph, disasm->macho_ctx, symbols);
+
+    // Targets are looked up from the finished node list; disasm_find_by_address
+    // is not needed, so no index has to be built for the sweep.
+    bool ok = callgraph_build_edges(graph, disasm, indices) && callgraph_build_sccs(graph);
+    free(indices);
+    if (!ok) {
+        callgraph_free(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+#pragma mark - Queries
+
+const uint32_t* callgraph_callees(const CallGraph *graph, uint32_t node, uint32_t *count) {
+    if (count) *count = 0;
+    if (!graph || node >= graph->node_count) return NULL;
+    if (count) *count = graph->callee_offsets[node + 1] - graph->callee_offsets[node];
+    return graph->callees + graph->callee_offsets[node];
+}
+
+const uint32_t* callgraph_callers(const CallGraph *graph, uint32_t node, uint32_t *count) {
+    if (count) *count = 0;
+    if (!graph || node >= graph->node_count) return NULL;
+    if (count) *count = graph->caller_offsets[node + 1] - graph->caller_offsets[node];
+    return graph->callers + graph->caller_offsets[node];
+}
+
+bool callgraph_is_recursive(const CallGraph *graph, uint32_t node) {
+    if (!graph || node >= graph->node_count) return false;
+    if (graph->scc_sizes[graph->scc_ids[node]] > 1) return true;
+
+    for (uint32_t e = graph->callee_offsets[node]; e < graph->callee_offsets[node + 1]; e++) {
+        if (graph->callees[e] == node) return true;
+    }
+    return false;
+}
+
+uint32_t callgraph_reachable(const CallGraph *graph, uint32_t node, bool callers, uint32_t *out) {
+    if (!graph || !out || node >= graph->node_count) return 0;
+
+    uint8_t *seen = (uint8_t*)calloc((graph->node_count + 7) / 8, 1);
+    if (!seen) return 0;
+
+    const uint32_t *offsets = callers ? graph->caller_offsets : graph->callee_offsets;
+    const uint32_t *edges = callers ? graph->callers : graph->callees;
+
+    // out doubles as the BFS queue.
+    uint32_t count = 0;
+    out[count++] = node;
+    seen[node / 8] |= (uint8_t)(1u << (node % 8));
+    for (uint32_t head = 0; head < count; head++) {
+        uint32_t v = out[head];
+        for (uint32_t e = offsets[v]; e < offsets[v + 1]; e++) {
+            uint32_t w = edges[e];
+            if (seen[w / 8] & (1u << (w % 8))) continue;
+            seen[w / 8] |= (uint8_t)(1u << (w % 8));
+            out[count++] = w;
+        }
+    }
+
+    free(seen);
+    return count;
+}
+
+void callgraph_free(CallGraph *graph) {
+    if (!graph) return;
+
+    free(graph->nodes);
+    free(graph->callee_offsets);
+    free(graph->callees);
+    free(graph->caller_offsets);
+    free(graph->callers);
+    free(graph->scc_ids);
+    free(graph->scc_sizes);
+
+    free(graph);
+}
@@ -0,0 +1,78 @@
+#ifndef CallGraph_h
+#define CallGraph_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "DisassemblyEngine.h"
+#include "SymbolTable.h"
+
+#pragma mark - Structures
+
+/* A function of the disassembly, or one entry of an S_SYMBOL_STUBS section
+   standing for the import it jumps to. */
+typedef struct {
+    uint64_t address;
+    uint64_t end_address;
+    const char *name;           // borrowed from the symbol table; NULL when unknown
+    bool is_stub;
+} CallGraphNode;
+
+/* Whole-program call graph. Nodes [0, function_count) are functions in
+   address order, followed by stub entries in address order. Edges are
+   deduplicated, sorted, and stored as CSR in both directions: the callees
+   of node v are callees[callee_offsets[v] .. callee_offsets[v + 1]), and
+   callers mirror them. */
+typedef struct {
+    CallGraphNode *nodes;
+    uint32_t node_count;
+    uint32_t function_count;
+
+    uint32_t *callee_offsets;
+    uint32_t *callees;
+    uint32_t *caller_offsets;
+    uint32_t *callers;
+    uint32_t edge_count;
+
+    uint32_t call_site_count;       // direct calls resolved to a node
+    uint32_t unresolved_call_count; // indirect calls and targets outside any node
+
+    // Strongly connected components, numbered callees first (reverse
+    // topological order of the condensation).
+    uint32_t *scc_ids;
+    uint32_t *scc_sizes;
+    uint32_t scc_count;
+} CallGraph;
+
+#pragma mark - Function Declarations
+
+/* Builds the call graph from every direct call (BRANCH_CALL with a target)
+   in the disassembly. Functions are split at the given start addresses, or
+   at each DISASM_ATTR_FUNCTION_START when starts is NULL, as in
+   cfg_build_functions. Calls into stubs resolve to stub nodes. When symbols
+   is given (strings loaded), stubs are named from the indirect symbol table
+   and functions from a symbol starting at their first instruction; other
+   functions keep a NULL name. Names stay valid until the symbol table is
+   freed. */
+CallGraph* callgraph_build(DisassemblyContext *disasm, SymbolTableContext *symbols,
+                           const uint64_t *starts, uint32_t count);
+
+/* Node whose function or stub contains address, or -1. O(log N). */
+int32_t callgraph_find_node(const CallGraph *graph, uint64_t address);
+
+/* Distinct callees / callers of node, in node order. O(1). */
+const uint32_t* callgraph_callees(const CallGraph *graph, uint32_t node, uint32_t *count);
+
+const uint32_t* callgraph_callers(const CallGraph *graph, uint32_t node, uint32_t *count);
+
+/* Whether node can call itself, directly or through other nodes. */
+bool callgraph_is_recursive(const CallGraph *graph, uint32_t node);
+
+/* Writes node and every node it transitively calls (or, with callers,
+   that transitively call it) to out, which must hold node_count entries,
+   in breadth-first order. Returns the number written. O(V + E). */
+uint32_t callgraph_reachable(const CallGraph *graph, uint32_t node, bool callers, uint32_t *out);
+
+void callgraph_free(CallGraph *graph);
+
+#endif
@@ -0,0 +1,110 @@
+import Foundation
+
+// MARK: - Call Graph Node
+
+@objc class CallGraphNodeInfo: NSObject {
+    @objc let index: Int
+    @objc let address: UInt64
+    @objc let endAddress: UInt64
+    @objc let name: String
+    @objc let isStub: Bool
+
+    init(index: Int, address: UInt64, endAddress: UInt64, name: String, isStub: Bool) {
+        self.index = index
+        self.address = address
+        self.endAddress = endAddress
+        self.name = name
+        self.isStub = isStub
+        super.init()
+    }
+}
+
+// MARK: - Call Graph
+
+@objc class CallGraphResult: NSObject {
+    @objc let nodes: [CallGraphNodeInfo]
+    @objc let functionCount: Int
+    @objc let callSiteCount: Int
+    @objc let unresolvedCallCount: Int
+    @objc let componentCount: Int
+
+    private let calleeOffsets: [UInt32]
+    private let callees: [UInt32]
+    private let callerOffsets: [UInt32]
+    private let callers: [UInt32]
+    private let recursive: [Bool]
+
+    init(nodes: [CallGraphNodeInfo], functionCount: Int, calleeOffsets: [UInt32], callees: [UInt32],
+         callerOffsets: [UInt32], callers: [UInt32], recursive: [Bool],
+         callSiteCount: Int, unresolvedCallCount: Int, componentCount: Int) {
+        self.nodes = nodes
+        self.functionCount = functionCount
+        self.calleeOffsets = calleeOffsets
+        self.callees = callees
+        self.callerOffsets = callerOffsets
+        self.callers = callers
+        self.recursive = recursive
+        self.callSiteCount = callSiteCount
+        self.unresolvedCallCount = unresolvedCallCount
+        self.componentCount = componentCount
+        super.init()
+    }
+
+    @objc var totalNodes: Int { nodes.count }
+    @objc var totalEdges: Int { callees.count }
+    @objc var stubCount: Int { nodes.count - functionCount }
+
+    @objc func node(containing address: UInt64) -> CallGraphNodeInfo? {
+        if let node = search(address, in: 0..<functionCount) { return node }
+        return search(address, in: functionCount..<nodes.count)
+    }
+
+    @objc func callers(of node: CallGraphNodeInfo) -> [CallGraphNodeInfo] {
+        return neighbors(of: node.index, offsets: callerOffsets, edges: callers)
+    }
+
+    @objc func callees(of node: CallGraphNodeInfo) -> [CallGraphNodeInfo] {
+        return neighbors(of: node.index, offsets: calleeOffsets, edges: callees)
+    }
+
+    @objc func isRecursive(_ node: CallGraphNodeInfo) -> Bool {
+        return recursive[node.index]
+    }
+
+    @objc func reachable(from node: CallGraphNodeInfo, followingCallers: Bool) -> [CallGraphNodeInfo] {
+        let offsets = followingCallers ? callerOffsets : calleeOffsets
+        let edges = followingCallers ? callers : callees
+        var seen = [Bool](repeating: false, count: nodes.count)
+        var queue = [node.index]
+        seen[node.index] = true
+
+        var head = 0
+        while head < queue.count {
+            let v = queue[head]
+            head += 1
+            for e in Int(offsets[v])..<Int(offsets[v + 1]) {
+                let w = Int(edges[e])
+                if !seen[w] {
+                    seen[w] = true
+                    queue.append(w)
+                }
+            }
+        }
+        return queue.map { nodes[$0] }
+    }
+
+    private func neighbors(of index: Int, offsets: [UInt32], edges: [UInt32]) -> [CallGraphNodeInfo] {
+        return edges[Int(offsets[index])..<Int(offsets[index + 1])].map { nodes[Int($0)] }
+    }
+
+    private func search(_ address: UInt64, in range: Range<Int>) -> CallGraphNodeInfo? {
+        var lo = range.lowerBound
+        var hi = range.upperBound
+        while lo < hi {
+            let mid = (lo + hi) / 2
+            if nodes[mid].address <= address { lo = mid + 1 } else { hi = mid }
+        }
+        guard lo > range.lowerBound, address < nodes[lo - 1].endAddress else { return nil }
+        return nodes[lo - 1]
+    }
+}
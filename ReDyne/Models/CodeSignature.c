@@ -1,7 +1,6 @@
 #include "CodeSignature.h"
 #include <stdlib.h>
 #include <string.h>
-#include <mach-o/loader.h>
 
 #define MAX_ENTITLEMENTS 200
 
@@ -10,25 +9,16 @@
 static uint32_t find_code_signature_offset(MachOContext *ctx, uint32_t *size) {
     if (!ctx) return 0;
     
-    uint32_t header_size = ctx->header.is_64bit ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
-    fseek(ctx->file, header_size, SEEK_SET);
+    uint64_t cmd_start = ctx->header.is_64bit ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
     
     for (uint32_t i = 0; i < ctx->header.ncmds; i++) {
-        uint32_t cmd, cmdsize;
-        long cmd_start = ftell(ctx->file);
-        
-        fread(&cmd, sizeof(uint32_t), 1, ctx->file);
-        fread(&cmdsize, sizeof(uint32_t), 1, ctx->file);
-        
-        if (ctx->header.is_swapped) {
-            cmd = __builtin_bswap32(cmd);
-            cmdsize = __builtin_bswap32(cmdsize);
-        }
+        uint32_t cmd = macho_read_uint32(ctx, cmd_start);
+        uint32_t cmdsize = macho_read_uint32(ctx, cmd_start + 4);
+        if (cmdsize < 8) break;
         
         if (cmd == LC_CODE_SIGNATURE) {
             struct linkedit_data_command sig_cmd;
-            fseek(ctx->file, cmd_start, SEEK_SET);
-            fread(&sig_cmd, sizeof(struct linkedit_data_command), 1, ctx->file);
+            if (!macho_read(ctx, cmd_start, &sig_cmd, sizeof(struct linkedit_data_command))) return 0;
             
             if (ctx->header.is_swapped) {
                 *size = __builtin_bswap32(sig_cmd.datasize);
@@ -39,7 +29,7 @@ static uint32_t find_code_signature_offset(MachOContext *ctx, uint32_t *size) {
             }
         }
         
-        fseek(ctx->file, cmd_start + cmdsize, SEEK_SET);
+        cmd_start += cmdsize;
     }
     
     return 0;
@@ -73,22 +63,14 @@ CodeSignatureInfo* codesign_parse_signature(MachOContext *ctx) {
     info->signature_size = sig_size;
     info->is_adhoc_signed = (sig_size < 4096);
     
-    fseek(ctx->file, sig_offset, SEEK_SET);
-    
-    uint8_t *sig_data = (uint8_t*)malloc(sig_size);
+    const uint8_t *sig_data = (const uint8_t*)macho_span_acquire(ctx, sig_offset, sig_size);
     if (!sig_data) {
-        printf("   Memory allocation failed\n");
-        return info;
-    }
-    
-    if (fread(sig_data, 1, sig_size, ctx->file) != sig_size) {
-        free(sig_data);
         printf("   Failed to read signature data\n");
         return info;
     }
     
     if (sig_size < 12) {
-        free(sig_data);
+        macho_span_release(ctx, sig_data);
         return info;
     }
     
@@ -108,9 +90,9 @@ CodeSignatureInfo* codesign_parse_signature(MachOContext *ctx) {
             blob_count = __builtin_bswap32(blob_count);
             printf("   Trying big-endian interpretation: length=0x%x, count=%u\n", super_length, blob_count);
         } else {
-            free(sig_data);
             printf("   Unknown SuperBlob magic: 0x%08x - signature may be in an unsupported format\n", super_magic);
             info->is_signed = false;
+            macho_span_release(ctx, sig_data);
             return info;
         }
     }
@@ -154,7 +136,7 @@ CodeSignatureInfo* codesign_parse_signature(MachOContext *ctx) {
             continue;
         }
 
-        uint8_t *blob_data = sig_data + blob_offset;
+        const uint8_t *blob_data = sig_data + blob_offset;
         uint32_t blob_magic = *(uint32_t*)blob_data;
         
         if (blob_type == 5 || blob_magic == 0x71177ade || blob_magic == 0xfade7171) {
@@ -175,9 +157,8 @@ CodeSignatureInfo* codesign_parse_signature(MachOContext *ctx) {
         }
     }
     
-    free(sig_data);
-    
 finish_parsing:
+    macho_span_release(ctx, sig_data);
     if (strlen(info->team_id) == 0) {
         strncpy(info->team_id, "(not embedded)", sizeof(info->team_id) - 1);
     }
@@ -211,11 +192,12 @@ EntitlementsInfo* codesign_parse_entitlements(MachOContext *ctx) {
         return info;
     }
     
-    uint8_t *sig_data = (uint8_t*)malloc(sig_size);
+    const uint8_t *sig_data = (const uint8_t*)macho_span_acquire(ctx, sig_offset, sig_size);
     if (!sig_data) return info;
-    
-    fseek(ctx->file, sig_offset, SEEK_SET);
-    fread(sig_data, 1, sig_size, ctx->file);
+    if (sig_size < 8) {
+        macho_span_release(ctx, sig_data);
+        return info;
+    }
     
     for (uint32_t i = 0; i < sig_size - 8; i++) {
         uint32_t magic = __builtin_bswap32(*(uint32_t*)(sig_data + i));
@@ -223,7 +205,7 @@ EntitlementsInfo* codesign_parse_entitlements(MachOContext *ctx) {
             uint32_t length = __builtin_bswap32(*(uint32_t*)(sig_data + i + 4));
             
             if (length > 8 && length < sig_size - i) {
-                uint8_t *entitlements_data = sig_data + i + 8;
+                const uint8_t *entitlements_data = sig_data + i + 8;
                 size_t entitlements_len = length - 8;
                 
                 info->entitlements_xml = (char*)malloc(entitlements_len + 1);
@@ -238,8 +220,7 @@ EntitlementsInfo* codesign_parse_entitlements(MachOContext *ctx) {
             }
         }
     }
-    
-    free(sig_data);
+    macho_span_release(ctx, sig_data);
     
     if (info->entitlement_count == 0 && !info->entitlements_xml) {
         printf("   No entitlements found\n");
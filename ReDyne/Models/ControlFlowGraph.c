@@ -1,6 +1,7 @@
 #include "ControlFlowGraph.h"
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #pragma mark - String Helpers
 
@@ -38,304 +39,1424 @@ CFGContext* cfg_create(DisassemblyContext *disasm_ctx) {
 void cfg_free(CFGContext *ctx) {
     if (!ctx) return;
     
-    if (ctx->blocks) {
-        for (uint32_t i = 0; i < ctx->block_count; i++) {
-            if (ctx->blocks[i].successors) free(ctx->blocks[i].successors);
-            if (ctx->blocks[i].successor_edge_types) free(ctx->blocks[i].successor_edge_types);
-            if (ctx->blocks[i].predecessors) free(ctx->blocks[i].predecessors);
-        }
-        free(ctx->blocks);
-    }
+    free(ctx->blocks);
+    free(ctx->edge_pool);
     
     if (ctx->exit_blocks) free(ctx->exit_blocks);
+    free(ctx->block_order);
+    free(ctx->dom_frontier_offsets);
+    free(ctx->dom_frontier);
+    free(ctx->post_dom_frontier_offsets);
+    free(ctx->post_dom_frontier);
+    free(ctx->functions);
+    free(ctx->loops);
+    free(ctx->loop_blocks);
+    free(ctx->loop_block_slot);
+    free(ctx->block_loop);
+    free(ctx->loop_exits);
     
     free(ctx);
 }
 
 #pragma mark - Basic Block Management
 
+static void cfg_init_block(BasicBlock *block, uint64_t start_addr, uint64_t end_addr) {
+    memset(block, 0, sizeof(BasicBlock));
+    block->start_address = start_addr;
+    block->end_address = end_addr;
+    block->dom_level = CFG_LEVEL_UNREACHABLE;
+    block->post_dom_level = CFG_LEVEL_UNREACHABLE;
+}
+
 BasicBlock* cfg_add_block(CFGContext *ctx, uint64_t start_addr, uint64_t end_addr) {
     if (!ctx || start_addr >= end_addr) return NULL;
     
     if (ctx->block_count >= ctx->block_capacity) {
-        ctx->block_capacity *= 2;
-        ctx->blocks = (BasicBlock*)realloc(ctx->blocks, ctx->block_capacity * sizeof(BasicBlock));
-        if (!ctx->blocks) return NULL;
+        uint32_t new_capacity = ctx->block_capacity * 2;
+        BasicBlock *new_blocks = (BasicBlock*)realloc(ctx->blocks, new_capacity * sizeof(BasicBlock));
+        if (!new_blocks) return NULL;
+        ctx->blocks = new_blocks;
+        ctx->block_capacity = new_capacity;
+    }
+    
+    if (ctx->block_count == 0) {
+        ctx->blocks_ordered = true;
+    } else if (start_addr < ctx->blocks[ctx->block_count - 1].start_address) {
+        ctx->blocks_ordered = false;
     }
     
     BasicBlock *block = &ctx->blocks[ctx->block_count++];
-    memset(block, 0, sizeof(BasicBlock));
+    cfg_init_block(block, start_addr, end_addr);
     
-    block->start_address = start_addr;
-    block->end_address = end_addr;
+    ctx->has_dominance = false;
+    ctx->has_post_dominance = false;
+    ctx->has_loops = false;
     
     return block;
 }
 
-bool cfg_add_edge(BasicBlock *from, BasicBlock *to, EdgeType edge_type) {
-    if (!from || !to) return false;
+/* Grows the edge arena to hold extra more slots. The arena is one buffer
+   (indices, then edge types), so blocks' slices are rebased on growth. */
+static bool cfg_reserve_edge_pool(CFGContext *ctx, uint32_t extra) {
+    uint32_t needed = ctx->edge_pool_count + extra;
+    if (needed <= ctx->edge_pool_capacity) return true;
+    
+    uint32_t new_capacity = ctx->edge_pool_capacity ? ctx->edge_pool_capacity * 2 : 256;
+    while (new_capacity < needed) new_capacity *= 2;
+    
+    uint32_t *pool = (uint32_t*)malloc((size_t)new_capacity * (sizeof(uint32_t) + sizeof(EdgeType)));
+    if (!pool) return false;
+    EdgeType *types = (EdgeType*)(pool + new_capacity);
+    
+    if (ctx->edge_pool) {
+        memcpy(pool, ctx->edge_pool, ctx->edge_pool_count * sizeof(uint32_t));
+        memcpy(types, ctx->edge_pool_types, ctx->edge_pool_count * sizeof(EdgeType));
+        
+        for (uint32_t i = 0; i < ctx->block_count; i++) {
+            BasicBlock *block = &ctx->blocks[i];
+            if (block->successors) {
+                size_t offset = (size_t)(block->successors - ctx->edge_pool);
+                block->successors = pool + offset;
+                block->successor_edge_types = types + offset;
+            }
+            if (block->predecessors) block->predecessors = pool + (block->predecessors - ctx->edge_pool);
+        }
+        free(ctx->edge_pool);
+    }
+    
+    ctx->edge_pool = pool;
+    ctx->edge_pool_types = types;
+    ctx->edge_pool_capacity = new_capacity;
+    return true;
+}
+
+/* Makes room for one more entry in a block's edge slice, moving a full
+   slice to the end of the arena with twice the room. The old slots are
+   left unused until the context is freed. */
+static bool cfg_grow_slice(CFGContext *ctx, uint32_t **slice, EdgeType **types,
+                           uint32_t count, uint32_t *capacity) {
+    if (count < *capacity) return true;
     
-    from->successor_count++;
-    from->successors = (BasicBlock**)realloc(from->successors, from->successor_count * sizeof(BasicBlock*));
-    from->successor_edge_types = (EdgeType*)realloc(from->successor_edge_types, from->successor_count * sizeof(EdgeType));
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 2;
+    if (!cfg_reserve_edge_pool(ctx, new_capacity)) return false;
     
-    if (!from->successors || !from->successor_edge_types) return false;
+    uint32_t offset = ctx->edge_pool_count;
+    if (count > 0) {
+        memcpy(ctx->edge_pool + offset, *slice, count * sizeof(uint32_t));
+        if (types) memcpy(ctx->edge_pool_types + offset, *types, count * sizeof(EdgeType));
+    }
+    *slice = ctx->edge_pool + offset;
+    if (types) *types = ctx->edge_pool_types + offset;
     
-    from->successors[from->successor_count - 1] = to;
-    from->successor_edge_types[from->successor_count - 1] = edge_type;
+    ctx->edge_pool_count += new_capacity;
+    *capacity = new_capacity;
+    return true;
+}
+
+bool cfg_add_edge(CFGContext *ctx, uint32_t from, uint32_t to, EdgeType edge_type) {
+    if (!ctx || from >= ctx->block_count || to >= ctx->block_count) return false;
     
-    to->predecessor_count++;
-    to->predecessors = (BasicBlock**)realloc(to->predecessors, to->predecessor_count * sizeof(BasicBlock*));
+    BasicBlock *src = &ctx->blocks[from];
+    BasicBlock *dst = &ctx->blocks[to];
+    if (!cfg_grow_slice(ctx, &src->successors, &src->successor_edge_types,
+                        src->successor_count, &src->successor_capacity)) return false;
+    if (!cfg_grow_slice(ctx, &dst->predecessors, NULL,
+                        dst->predecessor_count, &dst->predecessor_capacity)) return false;
     
-    if (!to->predecessors) return false;
+    src->successors[src->successor_count] = to;
+    src->successor_edge_types[src->successor_count] = edge_type;
+    src->successor_count++;
+    dst->predecessors[dst->predecessor_count++] = from;
     
-    to->predecessors[to->predecessor_count - 1] = from;
+    ctx->has_dominance = false;
+    ctx->has_post_dominance = false;
+    ctx->has_loops = false;
     
     return true;
 }
 
-BasicBlock* cfg_find_block(CFGContext *ctx, uint64_t address) {
-    if (!ctx || !ctx->blocks) return NULL;
+static int compare_block_order(const void *a, const void *b) {
+    const CFGBlockOrderEntry *ea = (const CFGBlockOrderEntry*)a;
+    const CFGBlockOrderEntry *eb = (const CFGBlockOrderEntry*)b;
+    if (ea->address != eb->address) return (ea->address < eb->address) ? -1 : 1;
+    return (ea->block < eb->block) ? -1 : (ea->block > eb->block);
+}
+
+static bool cfg_build_block_order(CFGContext *ctx) {
+    CFGBlockOrderEntry *order = (CFGBlockOrderEntry*)realloc(ctx->block_order, ctx->block_count * sizeof(CFGBlockOrderEntry));
+    if (!order) return false;
+    ctx->block_order = order;
     
     for (uint32_t i = 0; i < ctx->block_count; i++) {
-        if (address >= ctx->blocks[i].start_address && address < ctx->blocks[i].end_address) {
-            return &ctx->blocks[i];
-        }
+        order[i].address = ctx->blocks[i].start_address;
+        order[i].block = i;
     }
+    qsort(order, ctx->block_count, sizeof(CFGBlockOrderEntry), compare_block_order);
     
-    return NULL;
+    ctx->block_order_count = ctx->block_count;
+    return true;
+}
+
+int32_t cfg_find_block_index(CFGContext *ctx, uint64_t address) {
+    if (!ctx || !ctx->blocks || ctx->block_count == 0) return -1;
+    
+    const CFGBlockOrderEntry *order = NULL;
+    if (!ctx->blocks_ordered) {
+        if (ctx->block_order_count != ctx->block_count && !cfg_build_block_order(ctx)) return -1;
+        order = ctx->block_order;
+    }
+    
+    // Last block starting at or before address.
+    uint32_t lo = 0, hi = ctx->block_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        uint64_t start = order ? order[mid].address : ctx->blocks[mid].start_address;
+        if (start <= address) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return -1;
+    
+    uint32_t idx = order ? order[lo - 1].block : lo - 1;
+    if (address >= ctx->blocks[idx].end_address) return -1;
+    return (int32_t)idx;
+}
+
+BasicBlock* cfg_find_block(CFGContext *ctx, uint64_t address) {
+    int32_t idx = cfg_find_block_index(ctx, address);
+    return idx >= 0 ? &ctx->blocks[idx] : NULL;
 }
 
 #pragma mark - CFG Building
 
+/* Blocks built by one builder. Successors are appended to edges in block
+   order, as indices into the arena's own block array; predecessors are
+   derived when a function is copied into the context. Parallel builds
+   give each worker an arena and copy the results into the context in
+   function order; is_leader is scratch reused across functions. */
+typedef struct {
+    BasicBlock *blocks;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t *edges;
+    EdgeType *edge_types;
+    uint32_t edge_count;
+    uint32_t edge_capacity;
+    bool *is_leader;
+    uint32_t leader_capacity;
+    bool failed;
+} CFGArena;
+
+static void cfg_arena_free(CFGArena *arena) {
+    free(arena->blocks);
+    free(arena->edges);
+    free(arena->edge_types);
+    free(arena->is_leader);
+    memset(arena, 0, sizeof(*arena));
+}
+
+/* Room for block_count more blocks with up to two successors each. */
+static bool cfg_arena_reserve(CFGArena *arena, uint32_t block_count) {
+    uint32_t needed = arena->count + block_count;
+    if (needed > arena->capacity) {
+        uint32_t new_capacity = arena->capacity ? arena->capacity * 2 : 256;
+        while (new_capacity < needed) new_capacity *= 2;
+        BasicBlock *blocks = (BasicBlock*)realloc(arena->blocks, new_capacity * sizeof(BasicBlock));
+        if (!blocks) return false;
+        arena->blocks = blocks;
+        arena->capacity = new_capacity;
+    }
+    
+    needed = arena->edge_count + 2 * block_count;
+    if (needed > arena->edge_capacity) {
+        uint32_t new_capacity = arena->edge_capacity ? arena->edge_capacity * 2 : 512;
+        while (new_capacity < needed) new_capacity *= 2;
+        uint32_t *edges = (uint32_t*)realloc(arena->edges, new_capacity * sizeof(uint32_t));
+        if (!edges) return false;
+        arena->edges = edges;
+        EdgeType *types = (EdgeType*)realloc(arena->edge_types, new_capacity * sizeof(EdgeType));
+        if (!types) return false;
+        arena->edge_types = types;
+        arena->edge_capacity = new_capacity;
+    }
+    return true;
+}
+
+static void cfg_arena_link(CFGArena *arena, uint32_t from, uint32_t to, EdgeType edge_type) {
+    arena->edges[arena->edge_count] = to;
+    arena->edge_types[arena->edge_count] = edge_type;
+    arena->edge_count++;
+    arena->blocks[from].successor_count++;
+}
+
+/* Block among [first, end) holding instruction index; blocks are in
+   instruction order and cover the function without gaps. */
+static uint32_t cfg_arena_block_at(const CFGArena *arena, uint32_t first, uint32_t end, uint32_t index) {
+    uint32_t lo = first, hi = end;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (arena->blocks[mid].instruction_start <= index) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo - 1;
+}
+
+/* Instruction index of a branch target inside [first, last), or -1. */
+static int64_t cfg_target_index(DisassemblyContext *disasm, const DisasmSemantics *inst,
+                                uint32_t first, uint32_t last) {
+    if (!(inst->attrs & DISASM_ATTR_HAS_BRANCH_TARGET)) return -1;
+    int32_t target = disasm_find_by_address(disasm, inst->branch_target);
+    if (target < 0 || (uint32_t)target < first || (uint32_t)target >= last) return -1;
+    return target;
+}
+
+/* Builds the CFG of instructions [first, last) into the arena. Every branch
+   ends a block; edges only connect blocks of this function. */
+static bool cfg_build_range(CFGArena *arena, DisassemblyContext *disasm, uint32_t first, uint32_t last) {
+    uint32_t n = last - first;
+    if (n == 0) return true;
+    
+    if (n > arena->leader_capacity) {
+        bool *leaders = (bool*)realloc(arena->is_leader, n * sizeof(bool));
+        if (!leaders) return false;
+        arena->is_leader = leaders;
+        arena->leader_capacity = n;
+    }
+    bool *is_leader = arena->is_leader;
+    memset(is_leader, 0, n * sizeof(bool));
+    is_leader[0] = true;
+    
+    DisasmSemantics inst;
+    for (uint32_t i = first; i < last; i++) {
+        disasm_get_semantics(disasm, i, &inst);
+        if (inst.branch_type == BRANCH_NONE) continue;
+        
+        int64_t target = cfg_target_index(disasm, &inst, first, last);
+        if (target >= 0) is_leader[target - first] = true;
+        if (i + 1 < last) is_leader[i + 1 - first] = true;
+    }
+    
+    // Size the function once; blocks and edges are then filled in place.
+    uint32_t leader_count = 0;
+    for (uint32_t i = 0; i < n; i++) leader_count += is_leader[i];
+    if (!cfg_arena_reserve(arena, leader_count)) return false;
+    
+    uint32_t base = arena->count;
+    uint32_t block_start = first;
+    for (uint32_t i = first + 1; i <= last; i++) {
+        if (i < last && !is_leader[i - first]) continue;
+        
+        disasm_get_semantics(disasm, i - 1, &inst);
+        BasicBlock *block = &arena->blocks[arena->count++];
+        cfg_init_block(block, disasm_address_at(disasm, block_start), inst.address + inst.length);
+        block->instruction_start = block_start;
+        block->instruction_count = i - block_start;
+        block->is_entry = (block_start == first);
+        block_start = i;
+    }
+    uint32_t end = arena->count;
+    
+    for (uint32_t b = base; b < end; b++) {
+        BasicBlock *block = &arena->blocks[b];
+        disasm_get_semantics(disasm, block->instruction_start + block->instruction_count - 1, &inst);
+        
+        int64_t target = cfg_target_index(disasm, &inst, first, last);
+        uint32_t target_block = (target >= 0) ? cfg_arena_block_at(arena, base, end, (uint32_t)target) : 0;
+        bool has_next = (b + 1 < end);
+        
+        switch (inst.branch_type) {
+            case BRANCH_UNCONDITIONAL:
+                if (target >= 0) cfg_arena_link(arena, b, target_block, EDGE_UNCONDITIONAL);
+                break;
+            case BRANCH_CALL:
+                if (target >= 0) cfg_arena_link(arena, b, target_block, EDGE_CALL);
+                if (has_next) cfg_arena_link(arena, b, b + 1, EDGE_UNCONDITIONAL);
+                break;
+            case BRANCH_CONDITIONAL:
+                if (target >= 0) cfg_arena_link(arena, b, target_block, EDGE_CONDITIONAL_TRUE);
+                if (has_next) cfg_arena_link(arena, b, b + 1, EDGE_CONDITIONAL_FALSE);
+                break;
+            case BRANCH_RETURN:
+                block->is_exit = true;
+                break;
+            default:
+                if (has_next) cfg_arena_link(arena, b, b + 1, EDGE_UNCONDITIONAL);
+                break;
+        }
+    }
+    
+    return true;
+}
+
+static bool cfg_reserve_functions(CFGContext *ctx, uint32_t extra) {
+    uint32_t needed = ctx->function_count + extra;
+    if (needed <= ctx->function_capacity) return true;
+    
+    uint32_t new_capacity = ctx->function_capacity ? ctx->function_capacity : 16;
+    while (new_capacity < needed) new_capacity *= 2;
+    CFGFunction *functions = (CFGFunction*)realloc(ctx->functions, new_capacity * sizeof(CFGFunction));
+    if (!functions) return false;
+    ctx->functions = functions;
+    ctx->function_capacity = new_capacity;
+    return true;
+}
+
+static bool cfg_reserve_blocks(CFGContext *ctx, uint32_t extra) {
+    uint32_t needed = ctx->block_count + extra;
+    if (needed <= ctx->block_capacity) return true;
+    
+    uint32_t new_capacity = ctx->block_capacity ? ctx->block_capacity : 256;
+    while (new_capacity < needed) new_capacity *= 2;
+    BasicBlock *blocks = (BasicBlock*)realloc(ctx->blocks, new_capacity * sizeof(BasicBlock));
+    if (!blocks) return false;
+    ctx->blocks = blocks;
+    ctx->block_capacity = new_capacity;
+    return true;
+}
+
+/* Copies blocks [first, first + count) of an arena, whose successors
+   start at arena edge first_edge, to the end of the context as one
+   function. Its edges are laid out in the edge arena as CSR: every
+   block's successors, then every block's predecessors. The caller
+   reserves the blocks, the function and 2 * edge_count arena slots. */
+static void cfg_append_function(CFGContext *ctx, const CFGArena *arena, uint32_t first, uint32_t count,
+                                uint32_t first_edge, uint32_t edge_count,
+                                uint64_t start_addr, uint64_t end_addr) {
+    uint32_t base = ctx->block_count;
+    memcpy(&ctx->blocks[base], &arena->blocks[first], count * sizeof(BasicBlock));
+    
+    uint32_t *succs = ctx->edge_pool + ctx->edge_pool_count;
+    EdgeType *types = ctx->edge_pool_types + ctx->edge_pool_count;
+    uint32_t *preds = succs + edge_count;
+    for (uint32_t e = 0; e < edge_count; e++) {
+        succs[e] = arena->edges[first_edge + e] - first + base;
+        types[e] = arena->edge_types[first_edge + e];
+    }
+    ctx->edge_pool_count += 2 * edge_count;
+    
+    uint32_t offset = 0;
+    for (uint32_t b = base; b < base + count; b++) {
+        BasicBlock *block = &ctx->blocks[b];
+        block->successors = block->successor_count ? succs + offset : NULL;
+        block->successor_edge_types = block->successor_count ? types + offset : NULL;
+        block->successor_capacity = block->successor_count;
+        offset += block->successor_count;
+    }
+    
+    for (uint32_t e = 0; e < edge_count; e++) ctx->blocks[succs[e]].predecessor_count++;
+    offset = 0;
+    for (uint32_t b = base; b < base + count; b++) {
+        BasicBlock *block = &ctx->blocks[b];
+        block->predecessors = block->predecessor_count ? preds + offset : NULL;
+        block->predecessor_capacity = block->predecessor_count;
+        offset += block->predecessor_count;
+        block->predecessor_count = 0;
+    }
+    for (uint32_t b = base; b < base + count; b++) {
+        const BasicBlock *block = &ctx->blocks[b];
+        for (uint32_t j = 0; j < block->successor_count; j++) {
+            BasicBlock *dst = &ctx->blocks[block->successors[j]];
+            dst->predecessors[dst->predecessor_count++] = b;
+        }
+    }
+    
+    if (ctx->block_count > 0 && count > 0 &&
+        ctx->blocks[base].start_address < ctx->blocks[base - 1].start_address) {
+        ctx->blocks_ordered = false;
+    } else if (ctx->block_count == 0) {
+        ctx->blocks_ordered = true;
+    }
+    ctx->block_count += count;
+    
+    CFGFunction *function = &ctx->functions[ctx->function_count++];
+    function->start_address = start_addr;
+    function->end_address = end_addr;
+    function->first_block = base;
+    function->block_count = count;
+}
+
+static void cfg_finish_build(CFGContext *ctx) {
+    ctx->entry_block = (ctx->function_count > 0 && ctx->functions[0].block_count > 0)
+                     ? &ctx->blocks[ctx->functions[0].first_block] : NULL;
+    ctx->has_dominance = false;
+    ctx->has_post_dominance = false;
+    ctx->has_loops = false;
+}
+
+/* First instruction index whose address is at least address. */
+static uint32_t cfg_lower_bound_index(const DisassemblyContext *disasm, uint64_t address) {
+    uint32_t lo = 0, hi = disasm->instruction_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (disasm_address_at(disasm, mid) < address) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
 bool cfg_build_function(CFGContext *ctx, uint64_t func_start, uint64_t func_end) {
-    if (!ctx || !ctx->disasm_ctx || !ctx->disasm_ctx->instructions) return false;
+    if (!ctx || !ctx->disasm_ctx || ctx->disasm_ctx->instruction_count == 0) return false;
+    DisassemblyContext *disasm = ctx->disasm_ctx;
     
     ctx->function_start = func_start;
     ctx->function_end = func_end;
     
-    bool *is_leader = (bool*)calloc(ctx->disasm_ctx->instruction_count, sizeof(bool));
-    if (!is_leader) return false;
+    uint32_t first = cfg_lower_bound_index(disasm, func_start);
+    uint32_t last = cfg_lower_bound_index(disasm, func_end);
+    if (first >= last) return false;
     
-    is_leader[0] = true;
+    if (!disasm->index_valid) disasm_build_address_index(disasm);
+    
+    CFGArena arena = {0};
+    if (!cfg_build_range(&arena, disasm, first, last) ||
+        !cfg_reserve_blocks(ctx, arena.count) || !cfg_reserve_functions(ctx, 1) ||
+        !cfg_reserve_edge_pool(ctx, 2 * arena.edge_count)) {
+        cfg_arena_free(&arena);
+        return false;
+    }
     
-    for (uint32_t i = 0; i < ctx->disasm_ctx->instruction_count; i++) {
-        DisassembledInstruction *inst = &ctx->disasm_ctx->instructions[i];
+    cfg_append_function(ctx, &arena, 0, arena.count, 0, arena.edge_count, func_start, func_end);
+    cfg_arena_free(&arena);
+    cfg_finish_build(ctx);
+    return true;
+}
+
+#pragma mark - Parallel CFG Building
+
+#define CFG_MAX_THREADS 16
+#define CFG_MIN_PER_THREAD (32 * 1024)   // instructions
+
+typedef struct {
+    uint32_t worker;
+    uint32_t first_block;       // in that worker's arena
+    uint32_t block_count;
+    uint32_t first_edge;
+    uint32_t edge_count;
+} CFGFunctionSlot;
+
+/* Work-stealing deque over function indices [head, tail): the owner takes
+   from head, thieves take the back half from tail. */
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t head;
+    uint32_t tail;
+} CFGDeque;
+
+typedef struct CFGBuildShared CFGBuildShared;
+
+typedef struct {
+    CFGBuildShared *shared;
+    uint32_t id;
+    CFGArena arena;
+} CFGWorker;
+
+struct CFGBuildShared {
+    DisassemblyContext *disasm;
+    const uint32_t *starts;     // function i is instructions [starts[i], starts[i + 1])
+    uint32_t function_count;
+    CFGFunctionSlot *slots;
+    CFGDeque deques[CFG_MAX_THREADS];
+    CFGWorker workers[CFG_MAX_THREADS];
+    uint32_t worker_count;
+};
+
+static bool cfg_deque_pop(CFGDeque *deque, uint32_t *function) {
+    pthread_mutex_lock(&deque->lock);
+    bool found = deque->head < deque->tail;
+    if (found) *function = deque->head++;
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static bool cfg_steal(CFGBuildShared *shared, uint32_t thief) {
+    for (uint32_t k = 1; k < shared->worker_count; k++) {
+        CFGDeque *victim = &shared->deques[(thief + k) % shared->worker_count];
         
-        if (inst->address < func_start || inst->address >= func_end) continue;
+        pthread_mutex_lock(&victim->lock);
+        uint32_t available = victim->tail - victim->head;
+        uint32_t take = (available + 1) / 2;
+        uint32_t head = victim->tail - take;
+        if (take > 0) victim->tail = head;
+        pthread_mutex_unlock(&victim->lock);
         
-        if (inst->branch_type != BRANCH_NONE && inst->has_branch_target) {
-            int32_t target_idx = disasm_find_by_address(ctx->disasm_ctx, inst->branch_target);
-            if (target_idx >= 0) {
-                is_leader[target_idx] = true;
-            }
-            
-            if (i + 1 < ctx->disasm_ctx->instruction_count) {
-                is_leader[i + 1] = true;
-            }
+        if (take > 0) {
+            CFGDeque *own = &shared->deques[thief];
+            pthread_mutex_lock(&own->lock);
+            own->head = head;
+            own->tail = head + take;
+            pthread_mutex_unlock(&own->lock);
+            return true;
         }
     }
+    return false;
+}
+
+static void* cfg_build_worker(void *arg) {
+    CFGWorker *worker = (CFGWorker*)arg;
+    CFGBuildShared *shared = worker->shared;
+    CFGArena *arena = &worker->arena;
     
-    uint32_t block_start_idx = 0;
-    for (uint32_t i = 1; i <= ctx->disasm_ctx->instruction_count; i++) {
-        if (i == ctx->disasm_ctx->instruction_count || is_leader[i]) {
-            if (i > block_start_idx) {
-                uint64_t start_addr = ctx->disasm_ctx->instructions[block_start_idx].address;
-                uint64_t end_addr = ctx->disasm_ctx->instructions[i - 1].address + 
-                                    ctx->disasm_ctx->instructions[i - 1].length;
-                
-                if (start_addr >= func_start && start_addr < func_end) {
-                    BasicBlock *block = cfg_add_block(ctx, start_addr, end_addr);
-                    if (block) {
-                        block->instruction_start = block_start_idx;
-                        block->instruction_count = i - block_start_idx;
-                        
-                        if (block_start_idx == 0) {
-                            block->is_entry = true;
-                            ctx->entry_block = block;
-                        }
-                    }
-                }
+    uint32_t f;
+    do {
+        while (cfg_deque_pop(&shared->deques[worker->id], &f)) {
+            uint32_t first_block = arena->count;
+            uint32_t first_edge = arena->edge_count;
+            if (!arena->failed && !cfg_build_range(arena, shared->disasm, shared->starts[f], shared->starts[f + 1])) {
+                arena->failed = true;
             }
-            block_start_idx = i;
+            // A failed build leaves its partial blocks unreferenced; they are
+            // freed with the arena.
+            CFGFunctionSlot *slot = &shared->slots[f];
+            slot->worker = worker->id;
+            slot->first_block = first_block;
+            slot->block_count = arena->failed ? 0 : arena->count - first_block;
+            slot->first_edge = first_edge;
+            slot->edge_count = arena->failed ? 0 : arena->edge_count - first_edge;
         }
+    } while (cfg_steal(shared, worker->id));
+    
+    return NULL;
+}
+
+/* Builds one function per [starts[i], starts[i + 1]) instruction range,
+   appending them to the context in order. */
+static uint32_t cfg_build_ranges(CFGContext *ctx, const uint32_t *starts, uint32_t function_count,
+                                 uint32_t thread_count) {
+    DisassemblyContext *disasm = ctx->disasm_ctx;
+    if (function_count == 0) return ctx->block_count;
+    
+    // disasm_find_by_address only reads the index once it is built.
+    if (!disasm->index_valid) disasm_build_address_index(disasm);
+    
+    uint32_t total = starts[function_count] - starts[0];
+    if (thread_count > CFG_MAX_THREADS) thread_count = CFG_MAX_THREADS;
+    if (thread_count > total / CFG_MIN_PER_THREAD) thread_count = total / CFG_MIN_PER_THREAD;
+    if (thread_count > function_count) thread_count = function_count;
+    if (thread_count == 0) thread_count = 1;
+    
+    CFGBuildShared *shared = (CFGBuildShared*)calloc(1, sizeof(CFGBuildShared));
+    CFGFunctionSlot *slots = (CFGFunctionSlot*)calloc(function_count, sizeof(CFGFunctionSlot));
+    if (!shared || !slots) {
+        free(shared);
+        free(slots);
+        return ctx->block_count;
     }
+    shared->disasm = disasm;
+    shared->starts = starts;
+    shared->function_count = function_count;
+    shared->slots = slots;
+    shared->worker_count = thread_count;
     
-    for (uint32_t i = 0; i < ctx->block_count; i++) {
-        BasicBlock *block = &ctx->blocks[i];
-        
-        uint32_t last_idx = block->instruction_start + block->instruction_count - 1;
-        DisassembledInstruction *last_inst = &ctx->disasm_ctx->instructions[last_idx];
+    // Seed each deque with a contiguous run of about total/thread_count
+    // instructions; stealing evens out whatever the estimate misses.
+    uint32_t f = 0;
+    for (uint32_t t = 0; t < thread_count; t++) {
+        CFGDeque *deque = &shared->deques[t];
+        pthread_mutex_init(&deque->lock, NULL);
+        deque->head = f;
+        uint64_t budget = (uint64_t)total * (t + 1) / thread_count;
+        while (f < function_count && (t == thread_count - 1 || starts[f] - starts[0] < budget)) f++;
+        deque->tail = f;
+        shared->workers[t].shared = shared;
+        shared->workers[t].id = t;
+    }
+    
+    pthread_t threads[CFG_MAX_THREADS];
+    bool started[CFG_MAX_THREADS] = {false};
+    for (uint32_t t = 1; t < thread_count; t++) {
+        started[t] = (pthread_create(&threads[t], NULL, cfg_build_worker, &shared->workers[t]) == 0);
+    }
+    cfg_build_worker(&shared->workers[0]);
+    for (uint32_t t = 1; t < thread_count; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+    }
+    // Deques of workers that failed to start are drained by stealing, but
+    // only while others are still running; finish any leftovers here.
+    for (uint32_t t = 1; t < thread_count; t++) {
+        if (!started[t]) cfg_build_worker(&shared->workers[t]);
+    }
+    
+    // Size the context once for every function, then copy without allocating.
+    uint32_t new_blocks = 0;
+    uint64_t new_edges = 0;
+    for (uint32_t i = 0; i < function_count; i++) {
+        new_blocks += slots[i].block_count;
+        new_edges += 2 * (uint64_t)slots[i].edge_count;
+    }
+    
+    bool reserved = new_edges <= UINT32_MAX - ctx->edge_pool_count &&
+                    cfg_reserve_blocks(ctx, new_blocks) && cfg_reserve_functions(ctx, function_count) &&
+                    cfg_reserve_edge_pool(ctx, (uint32_t)new_edges);
+    for (uint32_t i = 0; i < function_count; i++) {
+        CFGFunctionSlot *slot = &slots[i];
+        if (!reserved || slot->block_count == 0) continue;
         
-        if (last_inst->branch_type == BRANCH_UNCONDITIONAL || last_inst->branch_type == BRANCH_CALL) {
-            if (last_inst->has_branch_target) {
-                BasicBlock *target = cfg_find_block(ctx, last_inst->branch_target);
-                if (target) {
-                    EdgeType edge_type = (last_inst->branch_type == BRANCH_CALL) ? EDGE_CALL : EDGE_UNCONDITIONAL;
-                    cfg_add_edge(block, target, edge_type);
+        DisasmSemantics last;
+        disasm_get_semantics(disasm, starts[i + 1] - 1, &last);
+        cfg_append_function(ctx, &shared->workers[slot->worker].arena, slot->first_block, slot->block_count,
+                            slot->first_edge, slot->edge_count,
+                            disasm_address_at(disasm, starts[i]), last.address + last.length);
+    }
+    
+    for (uint32_t t = 0; t < thread_count; t++) {
+        cfg_arena_free(&shared->workers[t].arena);
+        pthread_mutex_destroy(&shared->deques[t].lock);
+    }
+    free(slots);
+    free(shared);
+    
+    cfg_finish_build(ctx);
+    return ctx->block_count;
+}
+
+static int compare_indices(const void *a, const void *b) {
+    uint32_t ia = *(const uint32_t*)a, ib = *(const uint32_t*)b;
+    return (ia > ib) - (ia < ib);
+}
+
+uint32_t cfg_build_functions(CFGContext *ctx, const uint64_t *starts, uint32_t count, uint32_t thread_count) {
+    if (!ctx || !ctx->disasm_ctx || ctx->disasm_ctx->instruction_count == 0 || !starts) return 0;
+    DisassemblyContext *disasm = ctx->disasm_ctx;
+    
+    uint32_t *indices = (uint32_t*)malloc(((size_t)count + 1) * sizeof(uint32_t));
+    if (!indices) return ctx->block_count;
+    
+    if (!disasm->index_valid) disasm_build_address_index(disasm);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t index = disasm_find_by_address(disasm, starts[i]);
+        if (index >= 0) indices[n++] = (uint32_t)index;
+    }
+    qsort(indices, n, sizeof(uint32_t), compare_indices);
+    
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (unique == 0 || indices[i] != indices[unique - 1]) indices[unique++] = indices[i];
+    }
+    indices[unique] = disasm->instruction_count;
+    
+    uint32_t blocks = cfg_build_ranges(ctx, indices, unique, thread_count);
+    free(indices);
+    return blocks;
+}
+
+uint32_t cfg_build_all_parallel(CFGContext *ctx, uint32_t thread_count) {
+    if (!ctx || !ctx->disasm_ctx || ctx->disasm_ctx->instruction_count == 0) return 0;
+    DisassemblyContext *disasm = ctx->disasm_ctx;
+    uint32_t count = disasm->instruction_count;
+    
+    uint32_t n = 1;
+    DisasmSemantics inst;
+    for (uint32_t i = 1; i < count; i++) {
+        disasm_get_semantics(disasm, i, &inst);
+        if (inst.attrs & DISASM_ATTR_FUNCTION_START) n++;
+    }
+    
+    uint32_t *starts = (uint32_t*)malloc(((size_t)n + 1) * sizeof(uint32_t));
+    if (!starts) return ctx->block_count;
+    
+    n = 0;
+    starts[n++] = 0;
+    for (uint32_t i = 1; i < count; i++) {
+        disasm_get_semantics(disasm, i, &inst);
+        if (inst.attrs & DISASM_ATTR_FUNCTION_START) starts[n++] = i;
+    }
+    starts[n] = count;
+    
+    ctx->function_start = disasm_address_at(disasm, 0);
+    ctx->function_end = ctx->disasm_ctx->code_base_addr + ctx->disasm_ctx->code_size;
+    
+    uint32_t blocks = cfg_build_ranges(ctx, starts, n, thread_count);
+    free(starts);
+    return blocks;
+}
+
+uint32_t cfg_build_all(CFGContext *ctx) {
+    return cfg_build_all_parallel(ctx, 1);
+}
+
+#pragma mark - Analysis
+
+/* Dominator trees are computed with the iterative algorithm of Cooper,
+   Harvey and Kennedy ("A Simple, Fast Dominance Algorithm") over reverse
+   postorder, and frontiers with their predecessor walk. Both directions
+   run on a CSR copy of the block graph without call edges, rooted at a
+   virtual node (index block_count). Forward, it precedes the entry block
+   of every function, so each function gets its own tree; reversed, it
+   follows every block with no successors, so functions with several
+   returns get one post-dominator tree. */
+
+#define CFG_UNDEFINED UINT32_MAX
+
+typedef struct {
+    uint32_t node_count;
+    uint32_t root;
+    uint32_t *succ_offsets;
+    uint32_t *succs;
+    uint32_t *pred_offsets;
+    uint32_t *preds;
+} CFGDomGraph;
+
+static void cfg_dom_graph_free(CFGDomGraph *graph) {
+    free(graph->succ_offsets);
+    free(graph->succs);
+    free(graph->pred_offsets);
+    free(graph->preds);
+}
+
+static bool cfg_is_flow_exit(const BasicBlock *block) {
+    for (uint32_t j = 0; j < block->successor_count; j++) {
+        if (block->successor_edge_types[j] != EDGE_CALL) return false;
+    }
+    return true;
+}
+
+/* Whether block i hangs off the virtual root in the given direction. */
+static bool cfg_is_dom_anchor(const CFGContext *ctx, const bool *is_entry, uint32_t i, bool reverse) {
+    return reverse ? cfg_is_flow_exit(&ctx->blocks[i]) : is_entry[i];
+}
+
+/* Forward: successors as-is. Reverse: edges flipped, plus the virtual exit. */
+static bool cfg_dom_graph_build(const CFGContext *ctx, bool reverse, CFGDomGraph *graph) {
+    uint32_t n = ctx->block_count;
+    uint32_t nodes = n + 1;
+    memset(graph, 0, sizeof(*graph));
+    graph->node_count = nodes;
+    graph->root = n;
+    
+    // Function entries, or the single entry of a hand-built graph.
+    bool *is_entry = (bool*)calloc(n, sizeof(bool));
+    if (!is_entry) return false;
+    if (ctx->function_count > 0) {
+        for (uint32_t f = 0; f < ctx->function_count; f++) {
+            if (ctx->functions[f].block_count > 0) is_entry[ctx->functions[f].first_block] = true;
+        }
+    } else {
+        is_entry[ctx->entry_block ? (uint32_t)(ctx->entry_block - ctx->blocks) : 0] = true;
+    }
+    
+    uint32_t edge_count = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const BasicBlock *block = &ctx->blocks[i];
+        for (uint32_t j = 0; j < block->successor_count; j++) {
+            if (block->successor_edge_types[j] != EDGE_CALL) edge_count++;
+        }
+        if (cfg_is_dom_anchor(ctx, is_entry, i, reverse)) edge_count++;
+    }
+    
+    graph->succ_offsets = (uint32_t*)calloc(nodes + 1, sizeof(uint32_t));
+    graph->pred_offsets = (uint32_t*)calloc(nodes + 1, sizeof(uint32_t));
+    graph->succs = (uint32_t*)malloc((edge_count ? edge_count : 1) * sizeof(uint32_t));
+    graph->preds = (uint32_t*)malloc((edge_count ? edge_count : 1) * sizeof(uint32_t));
+    if (!graph->succ_offsets || !graph->pred_offsets || !graph->succs || !graph->preds) {
+        free(is_entry);
+        cfg_dom_graph_free(graph);
+        return false;
+    }
+    
+    // Count, prefix-sum, then fill both directions from one edge walk.
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t i = 0; i < n; i++) {
+            const BasicBlock *block = &ctx->blocks[i];
+            for (uint32_t j = 0; j <= block->successor_count; j++) {
+                uint32_t from, to;
+                if (j < block->successor_count) {
+                    if (block->successor_edge_types[j] == EDGE_CALL) continue;
+                    from = reverse ? block->successors[j] : i;
+                    to = reverse ? i : block->successors[j];
+                } else {
+                    if (!cfg_is_dom_anchor(ctx, is_entry, i, reverse)) continue;
+                    from = n;
+                    to = i;
                 }
-            }
-            
-            if (last_inst->branch_type == BRANCH_CALL && i + 1 < ctx->block_count) {
-                cfg_add_edge(block, &ctx->blocks[i + 1], EDGE_UNCONDITIONAL);
-            }
-        } else if (last_inst->branch_type == BRANCH_CONDITIONAL) {
-            if (last_inst->has_branch_target) {
-                BasicBlock *target = cfg_find_block(ctx, last_inst->branch_target);
-                if (target) {
-                    cfg_add_edge(block, target, EDGE_CONDITIONAL_TRUE);
+                
+                if (pass == 0) {
+                    graph->succ_offsets[from + 1]++;
+                    graph->pred_offsets[to + 1]++;
+                } else {
+                    graph->succs[graph->succ_offsets[from]++] = to;
+                    graph->preds[graph->pred_offsets[to]++] = from;
                 }
             }
-            
-            if (i + 1 < ctx->block_count) {
-                cfg_add_edge(block, &ctx->blocks[i + 1], EDGE_CONDITIONAL_FALSE);
+        }
+        
+        if (pass == 0) {
+            for (uint32_t v = 0; v < nodes; v++) {
+                graph->succ_offsets[v + 1] += graph->succ_offsets[v];
+                graph->pred_offsets[v + 1] += graph->pred_offsets[v];
             }
-        } else if (last_inst->branch_type == BRANCH_RETURN) {
-            block->is_exit = true;
         } else {
-            if (i + 1 < ctx->block_count) {
-                cfg_add_edge(block, &ctx->blocks[i + 1], EDGE_UNCONDITIONAL);
+            // Filling advanced each offset to the next row's start; shift back.
+            for (uint32_t v = nodes; v > 0; v--) {
+                graph->succ_offsets[v] = graph->succ_offsets[v - 1];
+                graph->pred_offsets[v] = graph->pred_offsets[v - 1];
             }
+            graph->succ_offsets[0] = 0;
+            graph->pred_offsets[0] = 0;
         }
     }
     
-    free(is_leader);
+    free(is_entry);
     return true;
 }
 
-uint32_t cfg_build_all(CFGContext *ctx) {
-    if (!ctx || !ctx->disasm_ctx) return 0;
+/* Fills rpo with the nodes reachable from the root in reverse postorder and
+   postorder numbers in po (CFG_UNDEFINED when unreachable). */
+static uint32_t cfg_dom_graph_rpo(const CFGDomGraph *graph, uint32_t *rpo, uint32_t *po) {
+    uint32_t nodes = graph->node_count;
+    uint32_t *stack = (uint32_t*)malloc(nodes * sizeof(uint32_t));
+    uint32_t *next_edge = (uint32_t*)malloc(nodes * sizeof(uint32_t));
+    if (!stack || !next_edge) {
+        free(stack);
+        free(next_edge);
+        return 0;
+    }
     
-    uint64_t start = ctx->disasm_ctx->code_base_addr;
-    uint64_t end = start + ctx->disasm_ctx->code_size;
+    for (uint32_t v = 0; v < nodes; v++) po[v] = CFG_UNDEFINED;
     
-    cfg_build_function(ctx, start, end);
+    uint32_t depth = 0, order = 0;
+    stack[depth++] = graph->root;
+    next_edge[graph->root] = graph->succ_offsets[graph->root];
+    po[graph->root] = CFG_UNDEFINED - 1;   // on stack
     
-    return ctx->block_count;
+    while (depth > 0) {
+        uint32_t v = stack[depth - 1];
+        if (next_edge[v] < graph->succ_offsets[v + 1]) {
+            uint32_t w = graph->succs[next_edge[v]++];
+            if (po[w] == CFG_UNDEFINED) {
+                po[w] = CFG_UNDEFINED - 1;
+                next_edge[w] = graph->succ_offsets[w];
+                stack[depth++] = w;
+            }
+        } else {
+            po[v] = order++;
+            depth--;
+        }
+    }
+    
+    for (uint32_t v = 0; v < nodes; v++) {
+        if (po[v] != CFG_UNDEFINED) rpo[order - 1 - po[v]] = v;
+    }
+    
+    free(stack);
+    free(next_edge);
+    return order;
 }
 
-#pragma mark - Analysis
+static uint32_t cfg_dom_intersect(const uint32_t *idom, const uint32_t *po, uint32_t a, uint32_t b) {
+    while (a != b) {
+        while (po[a] < po[b]) a = idom[a];
+        while (po[b] < po[a]) b = idom[b];
+    }
+    return a;
+}
 
-bool cfg_compute_dominance(CFGContext *ctx) {
-    if (!ctx || !ctx->blocks || ctx->block_count == 0) return false;
+/* idom[root] is the root itself; unreachable nodes stay CFG_UNDEFINED. */
+static bool cfg_dom_tree(const CFGDomGraph *graph, uint32_t *idom, uint32_t *level) {
+    uint32_t nodes = graph->node_count;
+    uint32_t *rpo = (uint32_t*)malloc(nodes * sizeof(uint32_t));
+    uint32_t *po = (uint32_t*)malloc(nodes * sizeof(uint32_t));
+    if (!rpo || !po) {
+        free(rpo);
+        free(po);
+        return false;
+    }
     
-    uint32_t **dom_sets = calloc(ctx->block_count, sizeof(uint32_t*));
-    if (!dom_sets) return false;
+    uint32_t reached = cfg_dom_graph_rpo(graph, rpo, po);
     
-    uint32_t words_needed = (ctx->block_count + 31) / 32;
-    for (uint32_t i = 0; i < ctx->block_count; i++) {
-        dom_sets[i] = calloc(words_needed, sizeof(uint32_t));
-        if (!dom_sets[i]) {
-            for (uint32_t j = 0; j < i; j++) free(dom_sets[j]);
-            free(dom_sets);
-            return false;
+    for (uint32_t v = 0; v < nodes; v++) idom[v] = CFG_UNDEFINED;
+    idom[graph->root] = graph->root;
+    
+    bool changed = reached > 0;
+    while (changed) {
+        changed = false;
+        for (uint32_t k = 1; k < reached; k++) {
+            uint32_t v = rpo[k];
+            uint32_t new_idom = CFG_UNDEFINED;
+            for (uint32_t e = graph->pred_offsets[v]; e < graph->pred_offsets[v + 1]; e++) {
+                uint32_t p = graph->preds[e];
+                if (idom[p] == CFG_UNDEFINED) continue;
+                new_idom = (new_idom == CFG_UNDEFINED) ? p : cfg_dom_intersect(idom, po, p, new_idom);
+            }
+            if (new_idom != idom[v]) {
+                idom[v] = new_idom;
+                changed = true;
+            }
         }
     }
     
-#define SET_BIT(set, bit) ((set)[(bit) / 32] |= (1U << ((bit) % 32)))
-#define CLEAR_BIT(set, bit) ((set)[(bit) / 32] &= ~(1U << ((bit) % 32)))
-#define TEST_BIT(set, bit) (((set)[(bit) / 32] & (1U << ((bit) % 32))) != 0)
+    for (uint32_t v = 0; v < nodes; v++) level[v] = CFG_UNDEFINED;
+    for (uint32_t k = 0; k < reached; k++) {
+        uint32_t v = rpo[k];
+        level[v] = (v == graph->root) ? 0 : level[idom[v]] + 1;
+    }
+    
+    free(rpo);
+    free(po);
+    return true;
+}
 
-    SET_BIT(dom_sets[0], 0);
-    for (uint32_t i = 1; i < ctx->block_count; i++) {
-        for (uint32_t j = 0; j < ctx->block_count; j++) {
-            SET_BIT(dom_sets[i], j);
+/* Frontier of each block as CSR arrays. A join node v is in the
+   frontier of every node on the idom chain from each predecessor up to,
+   but not including, idom(v). Entry blocks joined by a back edge count
+   the virtual root as a predecessor. */
+static bool cfg_dom_frontiers(const CFGDomGraph *graph, const uint32_t *idom, uint32_t block_count,
+                              uint32_t **out_offsets, uint32_t **out_frontier) {
+    uint32_t nodes = graph->node_count;
+    uint32_t *offsets = (uint32_t*)calloc(block_count + 1, sizeof(uint32_t));
+    uint32_t *last = (uint32_t*)malloc(nodes * sizeof(uint32_t));
+    uint32_t *frontier = NULL;
+    if (!offsets || !last) goto fail;
+    
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t v = 0; v < nodes; v++) last[v] = CFG_UNDEFINED;
+        
+        for (uint32_t v = 0; v < block_count; v++) {
+            uint32_t first = graph->pred_offsets[v], end = graph->pred_offsets[v + 1];
+            if (end - first < 2 || idom[v] == CFG_UNDEFINED) continue;
+            
+            for (uint32_t e = first; e < end; e++) {
+                uint32_t runner = graph->preds[e];
+                if (idom[runner] == CFG_UNDEFINED) continue;
+                
+                while (runner != idom[v] && last[runner] != v) {
+                    last[runner] = v;
+                    if (runner < block_count) {
+                        if (pass == 0) offsets[runner + 1]++;
+                        else frontier[offsets[runner]++] = v;
+                    }
+                    if (runner == graph->root) break;
+                    runner = idom[runner];
+                }
+            }
+        }
+        
+        if (pass == 0) {
+            for (uint32_t v = 0; v < block_count; v++) offsets[v + 1] += offsets[v];
+            frontier = (uint32_t*)malloc((offsets[block_count] ? offsets[block_count] : 1) * sizeof(uint32_t));
+            if (!frontier) goto fail;
+        } else {
+            for (uint32_t v = block_count; v > 0; v--) offsets[v] = offsets[v - 1];
+            offsets[0] = 0;
         }
     }
     
-    bool changed = true;
-    int iterations = 0;
-    while (changed && iterations < 100) {
-        changed = false;
-        iterations++;
-        
-        for (uint32_t i = 1; i < ctx->block_count; i++) {
+    free(last);
+    *out_offsets = offsets;
+    *out_frontier = frontier;
+    return true;
+    
+fail:
+    free(offsets);
+    free(last);
+    free(frontier);
+    return false;
+}
+
+static bool cfg_compute_dom_direction(CFGContext *ctx, bool reverse) {
+    uint32_t n = ctx->block_count;
+    
+    CFGDomGraph graph;
+    if (!cfg_dom_graph_build(ctx, reverse, &graph)) return false;
+    
+    uint32_t *idom = (uint32_t*)malloc(graph.node_count * sizeof(uint32_t));
+    uint32_t *level = (uint32_t*)malloc(graph.node_count * sizeof(uint32_t));
+    uint32_t *offsets = NULL, *frontier = NULL;
+    bool ok = idom && level &&
+              cfg_dom_tree(&graph, idom, level) &&
+              cfg_dom_frontiers(&graph, idom, n, &offsets, &frontier);
+    
+    if (ok) {
+        for (uint32_t i = 0; i < n; i++) {
             BasicBlock *block = &ctx->blocks[i];
+            // Children of the virtual root are the tree roots, at level 0.
+            bool has_parent = idom[i] < n;
+            BasicBlock *parent = has_parent ? &ctx->blocks[idom[i]] : NULL;
+            uint32_t depth = level[i];
+            if (depth != CFG_UNDEFINED) depth--;
             
-            uint32_t *new_doms = calloc(words_needed, sizeof(uint32_t));
-            if (!new_doms) continue;
-            
-            for (uint32_t w = 0; w < words_needed; w++) {
-                new_doms[w] = 0xFFFFFFFF;
+            if (reverse) {
+                block->immediate_post_dominator = parent;
+                block->post_dom_level = depth;
+            } else {
+                block->immediate_dominator = parent;
+                block->dom_level = depth;
             }
+        }
+        
+        if (reverse) {
+            free(ctx->post_dom_frontier_offsets);
+            free(ctx->post_dom_frontier);
+            ctx->post_dom_frontier_offsets = offsets;
+            ctx->post_dom_frontier = frontier;
+            ctx->has_post_dominance = true;
+        } else {
+            free(ctx->dom_frontier_offsets);
+            free(ctx->dom_frontier);
+            ctx->dom_frontier_offsets = offsets;
+            ctx->dom_frontier = frontier;
+            ctx->has_dominance = true;
+        }
+    }
+    
+    free(idom);
+    free(level);
+    cfg_dom_graph_free(&graph);
+    return ok;
+}
+
+bool cfg_compute_dominance(CFGContext *ctx) {
+    if (!ctx || !ctx->blocks || ctx->block_count == 0) return false;
+    return cfg_compute_dom_direction(ctx, false);
+}
+
+bool cfg_compute_post_dominance(CFGContext *ctx) {
+    if (!ctx || !ctx->blocks || ctx->block_count == 0) return false;
+    return cfg_compute_dom_direction(ctx, true);
+}
+
+static bool cfg_tree_contains(const BasicBlock *ancestor, const BasicBlock *block, bool post) {
+    uint32_t target = post ? ancestor->post_dom_level : ancestor->dom_level;
+    uint32_t depth = post ? block->post_dom_level : block->dom_level;
+    if (target == CFG_LEVEL_UNREACHABLE || depth == CFG_LEVEL_UNREACHABLE) return false;
+    
+    while (block && depth > target) {
+        block = post ? block->immediate_post_dominator : block->immediate_dominator;
+        depth--;
+    }
+    return block == ancestor;
+}
+
+bool cfg_dominates(const CFGContext *ctx, uint32_t a, uint32_t b) {
+    if (!ctx || !ctx->has_dominance || a >= ctx->block_count || b >= ctx->block_count) return false;
+    return cfg_tree_contains(&ctx->blocks[a], &ctx->blocks[b], false);
+}
+
+bool cfg_post_dominates(const CFGContext *ctx, uint32_t a, uint32_t b) {
+    if (!ctx || !ctx->has_post_dominance || a >= ctx->block_count || b >= ctx->block_count) return false;
+    return cfg_tree_contains(&ctx->blocks[a], &ctx->blocks[b], true);
+}
+
+const uint32_t* cfg_dominance_frontier(const CFGContext *ctx, uint32_t block, uint32_t *count) {
+    if (count) *count = 0;
+    if (!ctx || !ctx->has_dominance || block >= ctx->block_count) return NULL;
+    if (count) *count = ctx->dom_frontier_offsets[block + 1] - ctx->dom_frontier_offsets[block];
+    return ctx->dom_frontier + ctx->dom_frontier_offsets[block];
+}
+
+const uint32_t* cfg_post_dominance_frontier(const CFGContext *ctx, uint32_t block, uint32_t *count) {
+    if (count) *count = 0;
+    if (!ctx || !ctx->has_post_dominance || block >= ctx->block_count) return NULL;
+    if (count) *count = ctx->post_dom_frontier_offsets[block + 1] - ctx->post_dom_frontier_offsets[block];
+    return ctx->post_dom_frontier + ctx->post_dom_frontier_offsets[block];
+}
+
+/* The loop nesting forest follows Havlak's definition computed the
+   SCC way (Sreedhar/Steensgaard): every strongly connected region of the
+   call-free graph with a cycle is a loop; its headers are the blocks
+   entered from outside it (function entries are entered from the virtual
+   root). Removing the headers and repeating on what is left of the region
+   yields the nested loops. A loop with several headers is irreducible.
+   Each level is one iterative Tarjan pass over its region, and regions
+   stay contiguous ranges of one block permutation, so every loop body is
+   a slice of loop_blocks. */
+
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+    int32_t parent;
+} CFGLoopRegion;
+
+typedef struct {
+    const CFGDomGraph *graph;
+    uint32_t *region;           // region tag of each block
+    uint32_t *index;            // Tarjan discovery index, CFG_UNDEFINED when unvisited
+    uint32_t *low;
+    uint32_t *scc_stack;
+    uint32_t *call_stack;
+    uint32_t *edge_pos;
+    uint32_t *out;              // SCC members in completion order
+    uint32_t *scc_bounds;
+    bool *on_stack;
+} CFGLoopScratch;
+
+/* Splits nodes[0, count) (all tagged tag) into SCCs, rewriting nodes so
+   each SCC is contiguous; SCC k is [scc_bounds[k], scc_bounds[k + 1]). */
+static uint32_t cfg_loop_sccs(CFGLoopScratch *s, uint32_t *nodes, uint32_t count, uint32_t tag) {
+    const CFGDomGraph *graph = s->graph;
+    uint32_t next_index = 0, sp = 0, out_count = 0, scc_count = 0;
+    
+    for (uint32_t k = 0; k < count; k++) s->index[nodes[k]] = CFG_UNDEFINED;
+    
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t root = nodes[k];
+        if (s->index[root] != CFG_UNDEFINED) continue;
+        
+        uint32_t cp = 0;
+        s->index[root] = s->low[root] = next_index++;
+        s->edge_pos[root] = graph->succ_offsets[root];
+        s->scc_stack[sp++] = root;
+        s->on_stack[root] = true;
+        s->call_stack[cp++] = root;
+        
+        while (cp > 0) {
+            uint32_t v = s->call_stack[cp - 1];
             
-            if (block->predecessor_count > 0) {
-                for (uint32_t p = 0; p < block->predecessor_count; p++) {
-                    BasicBlock *pred = block->predecessors[p];
-                    int pred_idx = -1;
-                    for (uint32_t k = 0; k < ctx->block_count; k++) {
-                        if (&ctx->blocks[k] == pred) {
-                            pred_idx = k;
-                            break;
-                        }
-                    }
-                    
-                    if (pred_idx >= 0) {
-                        for (uint32_t w = 0; w < words_needed; w++) {
-                            new_doms[w] &= dom_sets[pred_idx][w];
-                        }
-                    }
+            if (s->edge_pos[v] < graph->succ_offsets[v + 1]) {
+                uint32_t w = graph->succs[s->edge_pos[v]++];
+                if (s->region[w] != tag) continue;
+                
+                if (s->index[w] == CFG_UNDEFINED) {
+                    s->index[w] = s->low[w] = next_index++;
+                    s->edge_pos[w] = graph->succ_offsets[w];
+                    s->scc_stack[sp++] = w;
+                    s->on_stack[w] = true;
+                    s->call_stack[cp++] = w;
+                } else if (s->on_stack[w] && s->index[w] < s->low[v]) {
+                    s->low[v] = s->index[w];
                 }
+                continue;
             }
             
-            SET_BIT(new_doms, i);
-            
-            for (uint32_t w = 0; w < words_needed; w++) {
-                if (new_doms[w] != dom_sets[i][w]) {
-                    changed = true;
-                    dom_sets[i][w] = new_doms[w];
-                }
+            cp--;
+            if (cp > 0) {
+                uint32_t u = s->call_stack[cp - 1];
+                if (s->low[v] < s->low[u]) s->low[u] = s->low[v];
             }
             
-            free(new_doms);
+            if (s->low[v] == s->index[v]) {
+                s->scc_bounds[scc_count++] = out_count;
+                uint32_t w;
+                do {
+                    w = s->scc_stack[--sp];
+                    s->on_stack[w] = false;
+                    s->out[out_count++] = w;
+                } while (w != v);
+            }
         }
     }
     
-    for (uint32_t i = 0; i < ctx->block_count; i++) {
-        free(dom_sets[i]);
+    s->scc_bounds[scc_count] = out_count;
+    memcpy(nodes, s->out, count * sizeof(uint32_t));
+    return scc_count;
+}
+
+static bool cfg_has_self_edge(const CFGDomGraph *graph, uint32_t v) {
+    for (uint32_t e = graph->succ_offsets[v]; e < graph->succ_offsets[v + 1]; e++) {
+        if (graph->succs[e] == v) return true;
     }
-    free(dom_sets);
+    return false;
+}
+
+/* Exit blocks of each loop: successors of its body outside it. */
+static bool cfg_loop_exits(CFGContext *ctx, const CFGDomGraph *graph, uint32_t *stamp) {
+    uint32_t n = ctx->block_count;
+    uint32_t total = 0;
+    uint32_t *exits = NULL;
     
-    #undef SET_BIT
-    #undef CLEAR_BIT
-    #undef TEST_BIT
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t v = 0; v < n; v++) stamp[v] = CFG_UNDEFINED;
+        
+        uint32_t written = 0;
+        for (uint32_t l = 0; l < ctx->loop_count; l++) {
+            CFGLoop *loop = &ctx->loops[l];
+            if (pass == 1) loop->exit_start = written;
+            
+            for (uint32_t k = loop->body_start; k < loop->body_start + loop->body_count; k++) {
+                uint32_t v = ctx->loop_blocks[k];
+                for (uint32_t e = graph->succ_offsets[v]; e < graph->succ_offsets[v + 1]; e++) {
+                    uint32_t w = graph->succs[e];
+                    uint32_t slot = ctx->loop_block_slot[w];
+                    if (slot >= loop->body_start && slot < loop->body_start + loop->body_count) continue;
+                    if (stamp[w] == l) continue;
+                    stamp[w] = l;
+                    if (pass == 1) exits[written] = w;
+                    written++;
+                }
+            }
+            
+            if (pass == 1) loop->exit_count = written - loop->exit_start;
+        }
+        
+        if (pass == 0) {
+            total = written;
+            exits = (uint32_t*)malloc((total ? total : 1) * sizeof(uint32_t));
+            if (!exits) return false;
+        }
+    }
     
+    free(ctx->loop_exits);
+    ctx->loop_exits = exits;
     return true;
 }
 
-uint32_t cfg_detect_loops(CFGContext *ctx) {
-    if (!ctx || !ctx->blocks) return 0;
+bool cfg_compute_loops(CFGContext *ctx) {
+    if (!ctx || !ctx->blocks || ctx->block_count == 0) return false;
+    uint32_t n = ctx->block_count;
     
-    uint32_t loop_count = 0;
+    CFGDomGraph graph;
+    if (!cfg_dom_graph_build(ctx, false, &graph)) return false;
     
-    for (uint32_t i = 0; i < ctx->block_count; i++) {
-        BasicBlock *block = &ctx->blocks[i];
-        for (uint32_t j = 0; j < block->successor_count; j++) {
-            BasicBlock *succ = block->successors[j];
+    CFGLoopScratch s = { .graph = &graph };
+    s.region = (uint32_t*)malloc(graph.node_count * sizeof(uint32_t));
+    s.index = (uint32_t*)malloc(n * sizeof(uint32_t));
+    s.low = (uint32_t*)malloc(n * sizeof(uint32_t));
+    s.scc_stack = (uint32_t*)malloc(n * sizeof(uint32_t));
+    s.call_stack = (uint32_t*)malloc(n * sizeof(uint32_t));
+    s.edge_pos = (uint32_t*)malloc(n * sizeof(uint32_t));
+    s.out = (uint32_t*)malloc(n * sizeof(uint32_t));
+    s.scc_bounds = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+    s.on_stack = (bool*)calloc(n, sizeof(bool));
+    CFGLoopRegion *regions = (CFGLoopRegion*)malloc((n + 1) * sizeof(CFGLoopRegion));
+    CFGLoop *loops = (CFGLoop*)malloc(n * sizeof(CFGLoop));
+    uint32_t *order = (uint32_t*)malloc(n * sizeof(uint32_t));
+    uint32_t *slot = (uint32_t*)malloc(n * sizeof(uint32_t));
+    int32_t *block_loop = (int32_t*)malloc(n * sizeof(int32_t));
+    
+    bool ok = s.region && s.index && s.low && s.scc_stack && s.call_stack && s.edge_pos &&
+              s.out && s.scc_bounds && s.on_stack && regions && loops && order && slot && block_loop;
+    
+    if (ok) {
+        uint32_t loop_count = 0;
+        uint32_t tag = 0;
+        uint32_t region_count = 0;
+        
+        // The virtual root is never in a region, so entry edges always come
+        // from outside the SCC being examined.
+        for (uint32_t v = 0; v < graph.node_count; v++) s.region[v] = CFG_UNDEFINED;
+        for (uint32_t v = 0; v < n; v++) {
+            order[v] = v;
+            block_loop[v] = -1;
+            ctx->blocks[v].is_loop_header = false;
+        }
+        regions[region_count++] = (CFGLoopRegion){ 0, n, -1 };
+        
+        while (region_count > 0) {
+            CFGLoopRegion region = regions[--region_count];
+            uint32_t *nodes = order + region.start;
+            uint32_t count = region.end - region.start;
+            uint32_t depth = region.parent >= 0 ? loops[region.parent].depth + 1 : 1;
             
-            bool is_back_edge = false;
-            BasicBlock *dom = block->immediate_dominator;
+            tag++;
+            for (uint32_t k = 0; k < count; k++) s.region[nodes[k]] = tag;
+            uint32_t scc_count = cfg_loop_sccs(&s, nodes, count, tag);
             
-            while (dom) {
-                if (dom == succ) {
-                    is_back_edge = true;
-                    break;
+            for (uint32_t c = 0; c < scc_count; c++) {
+                uint32_t first = s.scc_bounds[c];
+                uint32_t size = s.scc_bounds[c + 1] - first;
+                if (size == 1 && !cfg_has_self_edge(&graph, nodes[first])) continue;
+                
+                // Tag the SCC on its own, then move blocks entered from
+                // outside it (the headers) to the front.
+                tag++;
+                for (uint32_t k = first; k < first + size; k++) s.region[nodes[k]] = tag;
+                
+                uint32_t header_count = 0;
+                for (uint32_t k = first; k < first + size; k++) {
+                    uint32_t v = nodes[k];
+                    bool entered = false;
+                    for (uint32_t e = graph.pred_offsets[v]; e < graph.pred_offsets[v + 1] && !entered; e++) {
+                        entered = s.region[graph.preds[e]] != tag;
+                    }
+                    if (!entered) continue;
+                    
+                    uint32_t swap = nodes[first + header_count];
+                    nodes[first + header_count] = v;
+                    nodes[k] = swap;
+                    header_count++;
+                }
+                
+                // A cycle nothing enters (dead code): head it at its lowest block.
+                if (header_count == 0) {
+                    uint32_t lowest = first;
+                    for (uint32_t k = first + 1; k < first + size; k++) {
+                        if (nodes[k] < nodes[lowest]) lowest = k;
+                    }
+                    uint32_t swap = nodes[first];
+                    nodes[first] = nodes[lowest];
+                    nodes[lowest] = swap;
+                    header_count = 1;
+                }
+                
+                uint32_t id = loop_count++;
+                loops[id] = (CFGLoop){
+                    .parent = region.parent,
+                    .depth = depth,
+                    .body_start = region.start + first,
+                    .body_count = size,
+                    .header_count = header_count,
+                    .is_irreducible = header_count > 1,
+                };
+                
+                for (uint32_t k = first; k < first + size; k++) block_loop[nodes[k]] = (int32_t)id;
+                for (uint32_t k = first; k < first + header_count; k++) ctx->blocks[nodes[k]].is_loop_header = true;
+                
+                if (size > header_count) {
+                    regions[region_count++] = (CFGLoopRegion){
+                        region.start + first + header_count, region.start + first + size, (int32_t)id
+                    };
                 }
-                dom = dom->immediate_dominator;
-            }
-            
-            if (block == succ) {
-                is_back_edge = true;
-            }
-            
-            if (is_back_edge) {
-                succ->is_loop_header = true;
-                loop_count++;
             }
         }
+        
+        for (uint32_t k = 0; k < n; k++) slot[order[k]] = k;
+        
+        free(ctx->loops);
+        free(ctx->loop_blocks);
+        free(ctx->loop_block_slot);
+        free(ctx->block_loop);
+        ctx->loops = loops;
+        ctx->loop_count = loop_count;
+        ctx->loop_blocks = order;
+        ctx->loop_block_slot = slot;
+        ctx->block_loop = block_loop;
+        loops = NULL;
+        order = slot = NULL;
+        block_loop = NULL;
+        
+        ok = cfg_loop_exits(ctx, &graph, s.index);
+        ctx->has_loops = ok;
     }
     
-    return loop_count;
+    free(s.region);
+    free(s.index);
+    free(s.low);
+    free(s.scc_stack);
+    free(s.call_stack);
+    free(s.edge_pos);
+    free(s.out);
+    free(s.scc_bounds);
+    free(s.on_stack);
+    free(regions);
+    free(loops);
+    free(order);
+    free(slot);
+    free(block_loop);
+    cfg_dom_graph_free(&graph);
+    return ok;
+}
+
+bool cfg_loop_contains(const CFGContext *ctx, uint32_t loop, uint32_t block) {
+    if (!ctx || !ctx->has_loops || loop >= ctx->loop_count || block >= ctx->block_count) return false;
+    const CFGLoop *l = &ctx->loops[loop];
+    uint32_t slot = ctx->loop_block_slot[block];
+    return slot >= l->body_start && slot < l->body_start + l->body_count;
+}
+
+uint32_t cfg_loop_depth(const CFGContext *ctx, uint32_t block) {
+    if (!ctx || !ctx->has_loops || block >= ctx->block_count || ctx->block_loop[block] < 0) return 0;
+    return ctx->loops[ctx->block_loop[block]].depth;
+}
+
+bool cfg_is_back_edge(const CFGContext *ctx, uint32_t from, uint32_t to) {
+    if (!ctx || !ctx->has_loops || to >= ctx->block_count || !ctx->blocks[to].is_loop_header) return false;
+    // A header's innermost loop is the one it heads.
+    return cfg_loop_contains(ctx, (uint32_t)ctx->block_loop[to], from);
+}
+
+uint32_t cfg_detect_loops(CFGContext *ctx) {
+    if (!ctx || !ctx->blocks) return 0;
+    if (!ctx->has_loops && !cfg_compute_loops(ctx)) return 0;
+    return ctx->loop_count;
 }
 
 #pragma mark - Export
@@ -363,15 +1484,7 @@ bool cfg_export_dot(CFGContext *ctx, FILE *output) {
     for (uint32_t i = 0; i < ctx->block_count; i++) {
         BasicBlock *block = &ctx->blocks[i];
         for (uint32_t j = 0; j < block->successor_count; j++) {
-            BasicBlock *succ = block->successors[j];
-            
-            uint32_t succ_idx = 0;
-            for (uint32_t k = 0; k < ctx->block_count; k++) {
-                if (&ctx->blocks[k] == succ) {
-                    succ_idx = k;
-                    break;
-                }
-            }
+            uint32_t succ_idx = block->successors[j];
             
             fprintf(output, "  bb_%u -> bb_%u", i, succ_idx);
             
@@ -8,6 +8,8 @@
 
 #pragma mark - Basic Block Structure
 
+#define CFG_LEVEL_UNREACHABLE UINT32_MAX
+
 typedef enum {
     EDGE_UNCONDITIONAL,
     EDGE_CONDITIONAL_TRUE,
@@ -22,23 +24,63 @@ typedef struct BasicBlock {
     uint32_t instruction_start;
     uint32_t instruction_count;
     
-    struct BasicBlock **successors;
+    // Edges are indices into CFGContext.blocks, so they stay valid when
+    // the block array grows. The lists are slices of CFGContext.edge_pool.
+    uint32_t *successors;
     uint32_t successor_count;
+    uint32_t successor_capacity;
     EdgeType *successor_edge_types;
     
-    struct BasicBlock **predecessors;
+    uint32_t *predecessors;
     uint32_t predecessor_count;
+    uint32_t predecessor_capacity;
     
     bool is_entry;
     bool is_exit;
     bool is_loop_header;
     bool visited;
     
+    // Filled by cfg_compute_dominance: NULL for the entry and for blocks
+    // it cannot reach (dom_level CFG_LEVEL_UNREACHABLE); entry is level 0.
     struct BasicBlock *immediate_dominator;
     uint32_t dom_level;
     
+    // Filled by cfg_compute_post_dominance: NULL for exit blocks (no
+    // successors besides calls, level 0) and for blocks that never reach
+    // one (post_dom_level CFG_LEVEL_UNREACHABLE).
+    struct BasicBlock *immediate_post_dominator;
+    uint32_t post_dom_level;
+    
 } BasicBlock;
 
+typedef struct {
+    uint64_t address;
+    uint32_t block;
+} CFGBlockOrderEntry;
+
+/* One function's CFG: blocks [first_block, first_block + block_count) of
+   CFGContext.blocks, with edges only between those blocks. */
+typedef struct {
+    uint64_t start_address;
+    uint64_t end_address;
+    uint32_t first_block;
+    uint32_t block_count;
+} CFGFunction;
+
+/* One loop of the nesting forest. Its body, nested loops included, is
+   loop_blocks[body_start .. body_start + body_count) with the headers
+   first; a loop with more than one header is irreducible. */
+typedef struct {
+    int32_t parent;             // enclosing loop, -1 for an outermost loop
+    uint32_t depth;             // 1 for an outermost loop
+    uint32_t body_start;
+    uint32_t body_count;
+    uint32_t header_count;
+    uint32_t exit_start;        // blocks outside the loop its body branches to:
+    uint32_t exit_count;        // loop_exits[exit_start .. exit_start + exit_count)
+    bool is_irreducible;
+} CFGLoop;
+
 typedef struct {
     DisassemblyContext *disasm_ctx;
     
@@ -46,32 +88,132 @@ typedef struct {
     uint32_t block_count;
     uint32_t block_capacity;
     
+    // Edge arena holding every block's successor and predecessor slices in
+    // one allocation (edge_pool_types is the same buffer, parallel to
+    // edge_pool). Built functions are laid out as CSR, sized exactly;
+    // cfg_add_edge moves a full slice to the end, growing by doubling.
+    uint32_t *edge_pool;
+    EdgeType *edge_pool_types;
+    uint32_t edge_pool_count;
+    uint32_t edge_pool_capacity;
+    
+    // Block lookup by address. While blocks are added in address order
+    // (as cfg_build_function does) they are searched in place; otherwise
+    // block_order sorts them by start address, rebuilt on the next lookup
+    // after a block is added.
+    bool blocks_ordered;
+    CFGBlockOrderEntry *block_order;
+    uint32_t block_order_count;
+    
+    // One entry per built function, in address order; entry_block is the
+    // first function's entry.
+    CFGFunction *functions;
+    uint32_t function_count;
+    uint32_t function_capacity;
+    
     BasicBlock *entry_block;
     BasicBlock **exit_blocks;
     uint32_t exit_block_count;
     uint64_t function_start;
     uint64_t function_end;
     
+    // Dominance frontiers as CSR: the frontier of block i is
+    // dom_frontier[dom_frontier_offsets[i] .. dom_frontier_offsets[i + 1]).
+    // The post-dominance frontier (control dependence) uses the same layout.
+    // Adding blocks or edges clears the has_ flags until the next compute.
+    bool has_dominance;
+    uint32_t *dom_frontier_offsets;
+    uint32_t *dom_frontier;
+    
+    bool has_post_dominance;
+    uint32_t *post_dom_frontier_offsets;
+    uint32_t *post_dom_frontier;
+    
+    // Loop nesting forest, parents before children. loop_blocks is a
+    // permutation of the blocks in which every loop body is a contiguous
+    // range; loop_block_slot is its inverse and block_loop holds each
+    // block's innermost loop (-1 outside loops).
+    bool has_loops;
+    CFGLoop *loops;
+    uint32_t loop_count;
+    uint32_t *loop_blocks;
+    uint32_t *loop_block_slot;
+    int32_t *block_loop;
+    uint32_t *loop_exits;
+    
 } CFGContext;
 
 #pragma mark - Function Declarations
 
 CFGContext* cfg_create(DisassemblyContext *disasm_ctx);
 
+/* Builds the CFG of the instructions in [func_start, func_end) and appends
+   it as one function. */
 bool cfg_build_function(CFGContext *ctx, uint64_t func_start, uint64_t func_end);
 
+/* Splits the disassembly into functions at each DISASM_ATTR_FUNCTION_START
+   (and the first instruction) and builds them all. Returns block_count. */
 uint32_t cfg_build_all(CFGContext *ctx);
 
+/* Same output as cfg_build_all, with functions built on up to thread_count
+   threads (at most 16, one per 32K instructions). Each thread owns a
+   deque of functions and a block arena; idle threads steal half of
+   another's remaining functions, and arenas are merged in address order. */
+uint32_t cfg_build_all_parallel(CFGContext *ctx, uint32_t thread_count);
+
+/* Like cfg_build_all_parallel with caller-supplied function start addresses
+   (e.g. symbols or LC_FUNCTION_STARTS), in any order. Each function runs
+   to the next start or the end of the disassembly; addresses that are not
+   an instruction are ignored. */
+uint32_t cfg_build_functions(CFGContext *ctx, const uint64_t *starts, uint32_t count, uint32_t thread_count);
+
 BasicBlock* cfg_add_block(CFGContext *ctx, uint64_t start_addr, uint64_t end_addr);
 
-bool cfg_add_edge(BasicBlock *from, BasicBlock *to, EdgeType edge_type);
+bool cfg_add_edge(CFGContext *ctx, uint32_t from, uint32_t to, EdgeType edge_type);
+
+/* Index of the block containing address, or -1. O(log B). */
+int32_t cfg_find_block_index(CFGContext *ctx, uint64_t address);
 
 BasicBlock* cfg_find_block(CFGContext *ctx, uint64_t address);
 
+/* Immediate dominators, dom_level and dominance frontiers from each
+   function's first block (or entry_block when no functions were built),
+   ignoring call edges. Near-linear (Cooper-Harvey-Kennedy). */
 bool cfg_compute_dominance(CFGContext *ctx);
 
+/* The same over reversed edges, rooted at a virtual exit that follows
+   every exit block. */
+bool cfg_compute_post_dominance(CFGContext *ctx);
+
+/* Whether block a (post-)dominates block b; every block dominates itself.
+   False until the matching compute call has run. */
+bool cfg_dominates(const CFGContext *ctx, uint32_t a, uint32_t b);
+
+bool cfg_post_dominates(const CFGContext *ctx, uint32_t a, uint32_t b);
+
+/* Block indices in the frontier of block; NULL with *count 0 before the
+   matching compute call. */
+const uint32_t* cfg_dominance_frontier(const CFGContext *ctx, uint32_t block, uint32_t *count);
+
+const uint32_t* cfg_post_dominance_frontier(const CFGContext *ctx, uint32_t block, uint32_t *count);
+
+/* Builds the loop nesting forest of the call-free graph: each strongly
+   connected region with a cycle is a loop headed by the blocks entered
+   from outside it, and loops inside it are found again without its
+   headers. Sets is_loop_header. Needs no dominance information. */
+bool cfg_compute_loops(CFGContext *ctx);
+
+/* Computes the forest if needed; returns loop_count. */
 uint32_t cfg_detect_loops(CFGContext *ctx);
 
+bool cfg_loop_contains(const CFGContext *ctx, uint32_t loop, uint32_t block);
+
+/* Number of loops containing block; 0 outside loops. */
+uint32_t cfg_loop_depth(const CFGContext *ctx, uint32_t block);
+
+/* Whether from -> to re-enters a loop at one of its headers from inside it. */
+bool cfg_is_back_edge(const CFGContext *ctx, uint32_t from, uint32_t to);
+
 bool cfg_export_dot(CFGContext *ctx, FILE *output);
 
 const char* cfg_edge_type_string(EdgeType type);
@@ -110,6 +110,126 @@ class FunctionXrefs: NSObject {
     }
 }
 
+// MARK: - Xref Index
+
+@objc class XrefIndex: NSObject, NSSecureCoding {
+    static var supportsSecureCoding: Bool { true }
+    
+    static let kinds: [XrefType] = [.call, .jump, .conditionalJump, .dataRead, .dataWrite, .addressLoad, .unknown]
+    
+    private let sourceAddresses: [UInt64]
+    private let targetAddresses: [UInt64]
+    private let kindCodes: [UInt8]
+    private let sortedTargets: [UInt64]
+    private let targetOrder: [UInt32]
+    
+    init(sources: [UInt64], targets: [UInt64], kindCodes: [UInt8], targetOrder: [UInt32]) {
+        self.sourceAddresses = sources
+        self.targetAddresses = targets
+        self.kindCodes = kindCodes
+        self.targetOrder = targetOrder
+        self.sortedTargets = targetOrder.map { targets[Int($0)] }
+        super.init()
+    }
+    
+    convenience init(xrefs: [CrossReference]) {
+        let codes = xrefs.map { xref in
+            UInt8(XrefIndex.kinds.firstIndex(of: xref.xrefType) ?? XrefIndex.kinds.count - 1)
+        }
+        let order = xrefs.indices.sorted {
+            (xrefs[$0].toAddress, $0) < (xrefs[$1].toAddress, $1)
+        }.map { UInt32($0) }
+        self.init(sources: xrefs.map { $0.fromAddress }, targets: xrefs.map { $0.toAddress },
+                  kindCodes: codes, targetOrder: order)
+    }
+    
+    required convenience init?(coder: NSCoder) {
+        guard let sources: [UInt64] = XrefIndex.decode(coder, key: "sources"),
+              let targets: [UInt64] = XrefIndex.decode(coder, key: "targets"),
+              let kindCodes: [UInt8] = XrefIndex.decode(coder, key: "kinds"),
+              let targetOrder: [UInt32] = XrefIndex.decode(coder, key: "targetOrder"),
+              targets.count == sources.count, kindCodes.count == sources.count,
+              targetOrder.count == sources.count,
+              kindCodes.allSatisfy({ Int($0) < XrefIndex.kinds.count }),
+              zip(sources, sources.dropFirst()).allSatisfy({ $0 <= $1 }),
+              XrefIndex.isTargetOrder(targetOrder, of: targets) else {
+            return nil
+        }
+        self.init(sources: sources, targets: targets, kindCodes: kindCodes, targetOrder: targetOrder)
+    }
+    
+    func encode(with coder: NSCoder) {
+        XrefIndex.encode(sourceAddresses, coder, key: "sources")
+        XrefIndex.encode(targetAddresses, coder, key: "targets")
+        XrefIndex.encode(kindCodes, coder, key: "kinds")
+        XrefIndex.encode(targetOrder, coder, key: "targetOrder")
+    }
+    
+    @objc var count: Int { sourceAddresses.count }
+    
+    func source(at entry: Int) -> UInt64 { sourceAddresses[entry] }
+    func target(at entry: Int) -> UInt64 { targetAddresses[entry] }
+    func kind(at entry: Int) -> XrefType { XrefIndex.kinds[Int(kindCodes[entry])] }
+    
+    /// Entries whose source lies in [start, end), in source order
+    func entries(from start: UInt64, to end: UInt64) -> Range<Int> {
+        let first = XrefIndex.lowerBound(sourceAddresses, start)
+        return first..<max(first, XrefIndex.lowerBound(sourceAddresses, end))
+    }
+    
+    /// Entries whose target lies in [start, end), in target order
+    func entries(targeting start: UInt64, to end: UInt64) -> [Int] {
+        let first = XrefIndex.lowerBound(sortedTargets, start)
+        let last = max(first, XrefIndex.lowerBound(sortedTargets, end))
+        return targetOrder[first..<last].map { Int($0) }
+    }
+    
+    /// Source addresses of every xref to address, e.g. the users of a string or selector
+    @objc func sources(referencing address: UInt64) -> [UInt64] {
+        return entries(targeting: address, to: address &+ 1).map { sourceAddresses[$0] }
+    }
+    
+    /// Target addresses of every xref made by the instruction at address
+    @objc func targets(referencedFrom address: UInt64) -> [UInt64] {
+        return entries(from: address, to: address &+ 1).map { targetAddresses[$0] }
+    }
+    
+    /// Whether order lists every entry once, sorted by target with ties in entry order.
+    /// Strictly increasing (target, entry) pairs are distinct, so one per entry is a permutation.
+    private static func isTargetOrder(_ order: [UInt32], of targets: [UInt64]) -> Bool {
+        guard order.count == targets.count, order.allSatisfy({ Int($0) < targets.count }) else {
+            return false
+        }
+        return zip(order, order.dropFirst()).allSatisfy { a, b in
+            (targets[Int(a)], a) < (targets[Int(b)], b)
+        }
+    }
+    
+    private static func lowerBound(_ sorted: [UInt64], _ value: UInt64) -> Int {
+        var lo = 0
+        var hi = sorted.count
+        while lo < hi {
+            let mid = (lo + hi) / 2
+            if sorted[mid] < value { lo = mid + 1 } else { hi = mid }
+        }
+        return lo
+    }
+    
+    private static func encode<T: FixedWidthInteger>(_ values: [T], _ coder: NSCoder, key: String) {
+        coder.encode(values.withUnsafeBufferPointer { Data(buffer: $0) }, forKey: key)
+    }
+    
+    private static func decode<T: FixedWidthInteger>(_ coder: NSCoder, key: String) -> [T]? {
+        guard let data = coder.decodeObject(of: NSData.self, forKey: key) as Data?,
+              data.count % MemoryLayout<T>.stride == 0 else {
+            return nil
+        }
+        var values = [T](repeating: 0, count: data.count / MemoryLayout<T>.stride)
+        _ = values.withUnsafeMutableBytes { data.copyBytes(to: $0) }
+        return values
+    }
+}
+
 // MARK: - Xref Analysis Result
 
 @objc class XrefAnalysisResult: NSObject {
@@ -119,14 +239,17 @@ class FunctionXrefs: NSObject {
     @objc let totalDataRefs: Int
     @objc let functionXrefs: [String: FunctionXrefs]  
     @objc let allXrefs: [CrossReference]
+    @objc let index: XrefIndex
+    @objc var callGraph: CallGraphResult?
     
-    init(totalXrefs: Int, totalCalls: Int, totalJumps: Int, totalDataRefs: Int, functionXrefs: [String: FunctionXrefs], allXrefs: [CrossReference]) {
+    init(totalXrefs: Int, totalCalls: Int, totalJumps: Int, totalDataRefs: Int, functionXrefs: [String: FunctionXrefs], allXrefs: [CrossReference], index: XrefIndex) {
         self.totalXrefs = totalXrefs
         self.totalCalls = totalCalls
         self.totalJumps = totalJumps
         self.totalDataRefs = totalDataRefs
         self.functionXrefs = functionXrefs
         self.allXrefs = allXrefs
+        self.index = index
         super.init()
     }
     
@@ -135,12 +258,34 @@ class FunctionXrefs: NSObject {
         return functionXrefs[key]
     }
     
+    @objc func xrefs(from start: UInt64, to end: UInt64) -> [CrossReference] {
+        return Array(allXrefs[index.entries(from: start, to: end)])
+    }
+    
+    @objc func xrefs(targeting start: UInt64, to end: UInt64) -> [CrossReference] {
+        return index.entries(targeting: start, to: end).map { allXrefs[$0] }
+    }
+    
     @objc func getCallersOfFunction(address: UInt64) -> [CrossReference] {
-        return allXrefs.filter { $0.toAddress == address && $0.xrefType == .call }
+        return xrefs(targeting: address, to: address &+ 1).filter { $0.xrefType == .call }
     }
     
     @objc func getCalledByFunction(address: UInt64) -> [CrossReference] {
-        return allXrefs.filter { $0.fromAddress == address && $0.xrefType == .call }
+        return xrefs(from: address, to: address &+ 1).filter { $0.xrefType == .call }
+    }
+    
+    @objc func callerFunctions(ofFunction address: UInt64) -> [UInt64] {
+        if let graph = callGraph, let node = graph.node(containing: address) {
+            return graph.callers(of: node).map { $0.address }
+        }
+        return getCallersOfFunction(address: address).map { $0.fromAddress }
+    }
+    
+    @objc func calleeFunctions(ofFunction address: UInt64) -> [UInt64] {
+        if let graph = callGraph, let node = graph.node(containing: address) {
+            return graph.callees(of: node).map { $0.address }
+        }
+        return getCalledByFunction(address: address).map { $0.toAddress }
     }
 }
 
@@ -72,6 +72,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, copy) NSString *section;
 @property (nonatomic, assign) BOOL isCString;
 @property (nonatomic, assign) BOOL isUnicode;
+@property (nonatomic, assign) uint64_t cfstringAddress;
 
 @end
 
@@ -1,6 +1,7 @@
 #include "DisassemblyEngine.h"
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #pragma mark - String Helpers
 
@@ -26,23 +27,153 @@ const char* disasm_branch_type_string(BranchType type) {
 }
 
 const char* arm64_register_name(uint8_t reg, bool is_64bit) {
-    static const char* x_regs[] = {"X0", "X1", "X2", "X3", "X4", "X5", "X6", "X7",
-                                    "X8", "X9", "X10", "X11", "X12", "X13", "X14", "X15",
-                                    "X16", "X17", "X18", "X19", "X20", "X21", "X22", "X23",
-                                    "X24", "X25", "X26", "X27", "X28", "X29", "X30", "SP"};
-    static const char* w_regs[] = {"W0", "W1", "W2", "W3", "W4", "W5", "W6", "W7",
-                                    "W8", "W9", "W10", "W11", "W12", "W13", "W14", "W15",
-                                    "W16", "W17", "W18", "W19", "W20", "W21", "W22", "W23",
-                                    "W24", "W25", "W26", "W27", "W28", "W29", "W30", "WSP"};
-    
-    if (reg > 31) return "???";
-    return is_64bit ? x_regs[reg] : w_regs[reg];
+    ARM64Register r = { reg, is_64bit ? ARM64_REG_XSP : ARM64_REG_WSP };
+    return arm64dec_register_name(r);
 }
 
 const char* arm64_condition_string(uint8_t cond) {
-    static const char* conditions[] = {"EQ", "NE", "CS", "CC", "MI", "PL", "VS", "VC",
-                                        "HI", "LS", "GE", "LT", "GT", "LE", "AL", "NV"};
-    return (cond < 16) ? conditions[cond] : "??";
+    return (cond < 16) ? arm64dec_condition_name((ARM64Condition)cond) : "??";
+}
+
+#pragma mark - Compact Store
+
+static void disasm_compact_reset(DisasmCompactStore *store) {
+    free(store->raw_words);
+    free(store->offsets);
+    free(store->lengths);
+    free(store->opcodes);
+    free(store->kinds);
+    free(store->attrs);
+    free(store->flags_written);
+    free(store->branch_targets);
+    free(store->regs_read);
+    free(store->regs_written);
+    free(store->mnemonics);
+    free(store->mnemonic_slots);
+    memset(store, 0, sizeof(DisasmCompactStore));
+}
+
+#define DISASM_GROW_ARRAY(field, count) do { \
+        void *grown = realloc((field), (size_t)(count) * sizeof(*(field))); \
+        if (!grown) return false; \
+        (field) = grown; \
+    } while (0)
+
+static bool disasm_compact_reserve(DisasmCompactStore *store, uint32_t capacity, bool variable_width) {
+    if (capacity <= store->capacity) return true;
+    
+    DISASM_GROW_ARRAY(store->raw_words, capacity);
+    DISASM_GROW_ARRAY(store->opcodes, capacity);
+    DISASM_GROW_ARRAY(store->kinds, capacity);
+    DISASM_GROW_ARRAY(store->attrs, capacity);
+    DISASM_GROW_ARRAY(store->flags_written, capacity);
+    DISASM_GROW_ARRAY(store->branch_targets, capacity);
+    DISASM_GROW_ARRAY(store->regs_read, capacity);
+    DISASM_GROW_ARRAY(store->regs_written, capacity);
+    if (variable_width) {
+        DISASM_GROW_ARRAY(store->offsets, capacity);
+        DISASM_GROW_ARRAY(store->lengths, capacity);
+    }
+    
+    store->capacity = capacity;
+    return true;
+}
+
+static uint32_t disasm_mnemonic_hash(const char *mnemonic) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char*)mnemonic; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+static bool disasm_mnemonic_table_grow(DisasmCompactStore *store) {
+    uint32_t slot_count = store->mnemonic_slots ? (store->mnemonic_slot_mask + 1) * 2 : 256;
+    if (slot_count / 2 > UINT16_MAX) return false;
+    
+    uint16_t *slots = (uint16_t*)calloc(slot_count, sizeof(uint16_t));
+    if (!slots) return false;
+    char (*mnemonics)[32] = realloc(store->mnemonics, (slot_count / 2) * sizeof(*store->mnemonics));
+    if (!mnemonics) {
+        free(slots);
+        return false;
+    }
+    store->mnemonics = mnemonics;
+    
+    for (uint32_t id = 0; id < store->mnemonic_count; id++) {
+        uint32_t slot = disasm_mnemonic_hash(store->mnemonics[id]) & (slot_count - 1);
+        while (slots[slot]) slot = (slot + 1) & (slot_count - 1);
+        slots[slot] = (uint16_t)(id + 1);
+    }
+    
+    free(store->mnemonic_slots);
+    store->mnemonic_slots = slots;
+    store->mnemonic_slot_mask = slot_count - 1;
+    return true;
+}
+
+/* Maps a mnemonic to a small per-context opcode id. Slots hold id + 1 so
+   zero marks an empty slot. Returns UINT16_MAX if the table cannot grow. */
+static uint16_t disasm_compact_opcode(DisasmCompactStore *store, const char *mnemonic) {
+    if ((store->mnemonic_count + 1) * 2 > (store->mnemonic_slots ? store->mnemonic_slot_mask + 1 : 0) &&
+        !disasm_mnemonic_table_grow(store)) {
+        return UINT16_MAX;
+    }
+    
+    uint32_t slot = disasm_mnemonic_hash(mnemonic) & store->mnemonic_slot_mask;
+    while (store->mnemonic_slots[slot]) {
+        uint16_t id = store->mnemonic_slots[slot] - 1;
+        if (strcmp(store->mnemonics[id], mnemonic) == 0) return id;
+        slot = (slot + 1) & store->mnemonic_slot_mask;
+    }
+    
+    uint16_t id = (uint16_t)store->mnemonic_count++;
+    strncpy(store->mnemonics[id], mnemonic, sizeof(store->mnemonics[id]) - 1);
+    store->mnemonics[id][sizeof(store->mnemonics[id]) - 1] = '\0';
+    store->mnemonic_slots[slot] = (uint16_t)(id + 1);
+    return id;
+}
+
+/* Fills slot i from a decoded instruction. Offsets and lengths are the
+   caller's business; opcode is an id from disasm_compact_opcode. */
+static void disasm_compact_set(DisasmCompactStore *store, uint32_t i, const DisassembledInstruction *inst,
+                               uint16_t opcode) {
+    uint8_t attrs = 0;
+    if (inst->is_valid) attrs |= DISASM_ATTR_VALID;
+    if (inst->is_function_start) attrs |= DISASM_ATTR_FUNCTION_START;
+    if (inst->is_function_end) attrs |= DISASM_ATTR_FUNCTION_END;
+    if (inst->updates_pc) attrs |= DISASM_ATTR_UPDATES_PC;
+    if (inst->has_branch) attrs |= DISASM_ATTR_HAS_BRANCH;
+    if (inst->has_branch_target) attrs |= DISASM_ATTR_HAS_BRANCH_TARGET;
+    
+    store->raw_words[i] = inst->raw_bytes;
+    store->branch_targets[i] = inst->has_branch_target ? inst->branch_target : 0;
+    store->opcodes[i] = opcode;
+    store->kinds[i] = (uint8_t)((inst->category & 0xF) | ((inst->branch_type & 0xF) << 4));
+    store->attrs[i] = attrs;
+    store->flags_written[i] = inst->flags_written;
+    store->regs_read[i] = (uint32_t)inst->regs_read;
+    store->regs_written[i] = (uint32_t)inst->regs_written;
+}
+
+static bool disasm_compact_push(DisasmCompactStore *store, const DisassembledInstruction *inst, bool variable_width) {
+    if (store->count >= store->capacity &&
+        !disasm_compact_reserve(store, store->capacity ? store->capacity * 2 : 1024, variable_width)) {
+        return false;
+    }
+    
+    uint32_t i = store->count;
+    if (i == 0) store->base_addr = inst->address;
+    if (variable_width) {
+        uint64_t offset = inst->address - store->base_addr;
+        if (offset > UINT32_MAX) return false;
+        store->offsets[i] = (uint32_t)offset;
+        store->lengths[i] = inst->length;
+    }
+    
+    disasm_compact_set(store, i, inst, disasm_compact_opcode(store, inst->mnemonic));
+    store->count++;
+    return true;
 }
 
 #pragma mark - Context Management
@@ -94,8 +225,10 @@ void disasm_disable_flag(DisassemblyContext *ctx, uint32_t flag) {
 
 void disasm_free(DisassemblyContext *ctx) {
     if (!ctx) return;
-    if (ctx->code_data) free(ctx->code_data);
+    macho_span_release(ctx->macho_ctx, ctx->code_window);
     if (ctx->instructions) free(ctx->instructions);
+    if (ctx->index_offsets) free(ctx->index_offsets);
+    disasm_compact_reset(&ctx->compact);
     free(ctx);
 }
 
@@ -144,19 +277,16 @@ bool disasm_load_section(DisassemblyContext *ctx, const char *section_name) {
     for (uint32_t i = 0; i < mctx->section_count; i++) {
         SectionInfo *sect = &mctx->sections[i];
         if (strncmp(sect->sectname, section_name, 16) == 0) {
-            ctx->code_size = sect->size;
-            ctx->code_base_addr = sect->addr;
+            if (sect->offset > mctx->slice_size || sect->size > mctx->slice_size - sect->offset) return false;
             
-            ctx->code_data = (uint8_t*)malloc(ctx->code_size);
-            if (!ctx->code_data) return false;
+            macho_span_release(mctx, ctx->code_window);
+            ctx->code_window = NULL;
+            ctx->code_window_start = 0;
+            ctx->code_window_size = 0;
             
-            fseek(mctx->file, sect->offset, SEEK_SET);
-            size_t read = fread(ctx->code_data, 1, ctx->code_size, mctx->file);
-            if (read != ctx->code_size) {
-                free(ctx->code_data);
-                ctx->code_data = NULL;
-                return false;
-            }
+            ctx->code_offset = sect->offset;
+            ctx->code_size = sect->size;
+            ctx->code_base_addr = sect->addr;
             
             return true;
         }
@@ -165,839 +295,162 @@ bool disasm_load_section(DisassemblyContext *ctx, const char *section_name) {
     return false;
 }
 
-#pragma mark - ARM64 Instruction Decoding
+/* Copies up to size code bytes at section offset into out, sliding the pinned
+   code window forward when the request falls outside it. Returns the number of
+   bytes available (short only at the end of the section). */
+static size_t disasm_fetch_code(DisassemblyContext *ctx, uint64_t offset, uint8_t *out, size_t size) {
+    if (offset >= ctx->code_size) return 0;
+    if (size > ctx->code_size - offset) size = (size_t)(ctx->code_size - offset);
+    
+    if (!ctx->code_window || offset < ctx->code_window_start ||
+        offset + size > ctx->code_window_start + ctx->code_window_size) {
+        macho_span_release(ctx->macho_ctx, ctx->code_window);
+        
+        uint64_t window = ctx->code_size - offset;
+        if (window > DISASM_CODE_WINDOW_SIZE) window = DISASM_CODE_WINDOW_SIZE;
+        ctx->code_window = (const uint8_t*)macho_span_acquire(ctx->macho_ctx, ctx->code_offset + offset, window);
+        ctx->code_window_start = offset;
+        ctx->code_window_size = ctx->code_window ? window : 0;
+        if (!ctx->code_window) return 0;
+    }
+    
+    memcpy(out, ctx->code_window + (offset - ctx->code_window_start), size);
+    return size;
+}
+
+#pragma mark - ARM64 Decoder
+
+/* STP/LDP of X29 and X30 (either order), any addressing mode. */
+static bool a64_is_frame_pair(uint32_t bytes, bool is_load) {
+    if ((bytes & 0xFE400000) != (is_load ? 0xA8400000 : 0xA8000000)) return false;
+    uint8_t rt = bytes & 0x1F;
+    uint8_t rt2 = (bytes >> 10) & 0x1F;
+    return (rt == 29 && rt2 == 30) || (rt == 30 && rt2 == 29);
+}
 
 bool arm64_is_prologue(const DisassemblyContext *ctx, const DisassembledInstruction *inst) {
     if (!inst) return false;
     if (!ctx || !(ctx->flags & DISASM_FLAG_PROLOGUE_EPILOGUE_HEURISTICS)) {
         return false;
     }
-    if (strstr(inst->mnemonic, "STP") &&
-        strstr(inst->operands, "X29") && 
-        strstr(inst->operands, "X30") &&
-        strstr(inst->operands, "#-")) {
-        return true;
-    }
-    return false;
+    /* STP X29, X30, [SP, #-n]{!} */
+    return a64_is_frame_pair(inst->raw_bytes, false) && ((inst->raw_bytes >> 21) & 1);
 }
 
 bool arm64_is_epilogue(const DisassemblyContext *ctx, const DisassembledInstruction *inst) {
     if (!inst) return false;
-    /* Always treat RET as an epilogue (function end). */
-    if (strcmp(inst->mnemonic, "RET") == 0) return true;
+    /* Always treat RET (and RETAA/RETAB) as an epilogue (function end). */
+    if ((inst->raw_bytes & 0xFFFFFC1F) == 0xD65F0000 ||
+        inst->raw_bytes == 0xD65F0BFF || inst->raw_bytes == 0xD65F0FFF) {
+        return true;
+    }
 
     /* LDP based epilogue detection is heuristic-controlled. */
     if (!ctx || !(ctx->flags & DISASM_FLAG_PROLOGUE_EPILOGUE_HEURISTICS)) return false;
 
-    if (strstr(inst->mnemonic, "LDP") && strstr(inst->operands, "X29") && strstr(inst->operands, "X30")) {
-        return true;
-    }
-    return false;
+    return a64_is_frame_pair(inst->raw_bytes, true);
 }
 
-/**
- * disasm_arm64
- *
- * Decode a single 32-bit AArch64 instruction word into a DisassembledInstruction
- * structure. This is a light-weight, hand-written decoder intended to recognize
- * a useful subset of ARMv8-A (AArch64) instructions commonly encountered in
- * binaries (branches, basic data-processing, loads/stores, system instructions,
- * simple SIMD/FP patterns, and a few prologue/epilogue heuristics).
- *
- * The decoder:
- *  - Assumes 'bytes' is a 32-bit little-endian encoded AArch64 instruction
- *    word (the raw instruction bits).
- *  - Sets inst->address to the provided address and inst->raw_bytes to bytes.
- *  - Sets inst->length = 4 and populates fields on inst to describe the
- *    decoded instruction when possible.
- *
- * Recognized categories and behaviors:
- *  - Branches:
- *      - B/BL (imm26), conditional branches (B.<cond>), CBZ/CBNZ (imm19),
- *        BR/BLR/RET and other indirect control-transfer encodings.
- *      - Computes branch target (inst->branch_target) and offset (inst->branch_offset)
- *        with proper sign-extension for immediates and sets has_branch/has_branch_target.
- *      - Marks branch_type: BRANCH_CALL for BL/BLR, BRANCH_RETURN for RET,
- *        BRANCH_CONDITIONAL/BRANCH_UNCONDITIONAL otherwise.
- *      - On BL/BLR sets regs_written to the link register bit (x30).
- *      - Sets updates_pc when instruction changes PC.
- *
- *  - Load/Store:
- *      - Handles pair loads/stores (LDP/STP), immediate-offset LDR/STR, LDUR/STUR,
- *        PC-relative literal LDR, and falls back to generic LDR/STR descriptors
- *        when exact encodings are not matched.
- *      - Computes immediate offsets with appropriate sign-extension and scaling.
- *
- *  - Data-processing (integer):
- *      - ADD/SUB (imm12 shifted), MOV{Z,N,K} (wide imm variants), logical/bitfield ops
- *        (AND/ORR/EOR/BIC/... and BFM/SBFM/UBFM), multiply/add variants (MUL/MADD/MSUB/...),
- *        shifts/rotate pseudo-ops (LSL/LSR/ASR/ROR), compare/test encodings (CMP/CMN/CCMP).
- *      - Extracts register operands (rd,rn,rm,ra) and immediate fields (imm12/imm16/imm7/...).
- *      - Sets regs_read/regs_written bitmasks when it can determine simple single register
- *        reads/writes (note: this uses 1U<<reg index and does not attempt to represent
- *        multiple-bit wide registers or complex read/write sets).
- *
- *  - System instructions:
- *      - Decodes a few common system hints (YIELD/WFE/WFI/SEV/SEVL) and barriers (DSB/DMB/ISB)
- *        with CRM/op2 extraction for barrier imm printing.
- *      - Decodes simple MRS/MSR patterns and formats a system-register name using the
- *        op-fields (S<op0>_<op1>_c<CRn>_c<CRm>_<op2>).
- *
- *  - SIMD/Floating point:
- *      - Recognizes a small set (FMOV register) and otherwise falls back to generic SIMD tag.
- *
- *  - Fall-through/fallback:
- *      - If the decoder cannot produce a precise mnemonic/operands it will produce a
- *        conservative human-readable fallback (e.g., "LDR <r>, [<rn>, ...]") or finally
- *        emit ".word 0xXXXXXXXX" for totally unknown encodings.
- *
- * Side effects / fields set in DisassembledInstruction (non-exhaustive):
- *  - mnemonic: null-terminated instruction mnemonic string.
- *  - operands: textual operands string (null-terminated).
- *  - full_disasm: formatted "0xADDR: MNEMONIC OPERANDS" line.
- *  - category: one of INST_CATEGORY_* (branch, load/store, data-processing, simd, system, unknown).
- *  - is_valid: set to true if some disassembly text was produced (always true on return).
- *  - has_branch / has_branch_target / branch_target / branch_offset / branch_type:
- *      populated for branch-like instructions.
- *  - updates_pc: set for instructions that change PC (direct/indirect branches).
- *  - regs_read / regs_written: simple bitmasks using (1U << reg) for detected single-register
- *      reads/writes in a limited set of patterns (not an exhaustive or precise liveness analysis).
- *  - is_function_start / is_function_end: heuristically set by arm64_is_prologue / arm64_is_epilogue
- *      after constructing the textual disasm.
- *
- * Important implementation notes & limitations:
- *  - This is not a complete ARM instruction decoder. It intentionally matches a
- *    pragmatic subset useful for static analysis and display. Many encodings are
- *    approximated or given a generic fallback mnemonic.
- *  - Immediate sign-extension: various immediate fields are sign-extended manually
- *    (imm26, imm19, imm9, imm7, etc.) and scaled by instruction-specific factors
- *    (e.g., *4 for branch immediates, *8 for some pair loads).
- *  - Register bitmasks: uses 32-bit masks; for x30 the code uses bit 30. This scheme
- *    will not express flags, vector lanes, or multiple register writes beyond simple cases.
- *  - Endianness: the function expects the 32-bit instruction word in host-endian
- *    layout consistent with how 'bytes' is provided by the caller.
- *  - The decoder relies on helper functions:
- *      - arm64_register_name(reg, is_64bit) for textual register formatting.
- *      - arm64_condition_string(cond) for condition code names.
- *      - arm64_is_prologue(inst) / arm64_is_epilogue(inst) for function boundary heuristics.
- *    Ensure these helpers are available to produce meaningful output.
- *
- * Thread-safety:
- *  - The function itself does not use global mutable state; it writes into the
- *    provided DisassembledInstruction structure. Caller must provide a valid inst
- *    pointer. The helper functions called may impose additional constraints.
- *
- * Parameters:
- *  - bytes:   32-bit instruction word to decode.
- *  - address: virtual address of the instruction (used for PC-relative targets).
- *  - inst:    pointer to a DisassembledInstruction structure to populate. The
- *             structure is zeroed at function entry and populated by this routine.
- *
- * Return:
- *  - true if a (possibly heuristic) disassembly was produced and inst was populated.
- *    The implementation currently always sets inst->is_valid (and returns true)
- *    after producing either a specific mnemonic or a fallback representation.
- *
- * Usage:
- *  - Call for each 32-bit instruction in a binary region. After the call, consult
- *    inst->full_disasm for display, and inst->branch_target / branch_type for control-flow analysis.
- *
- * TODO / Potential improvements:
- *  - Expand decoding coverage for more ARM instructions and accurate operand
- *    extraction (shifts, rotated immediates, register shifts with amounts).
- *  - Improve regs_read/regs_written accuracy to cover multiple registers and
- *    to represent flag updates where relevant.
- *  - Add feature flags to control how aggressive heuristics/probing should be.
- */
-bool disasm_arm64(DisassemblyContext *ctx, uint32_t bytes, uint64_t address, DisassembledInstruction *inst) 
-{
-    memset(inst, 0, sizeof(DisassembledInstruction));
-    inst->address = address;
-    inst->raw_bytes = bytes;
-    inst->length = 4;
-    inst->is_valid = false;
-    
-    uint8_t op0 = (bytes >> 25) & 0xF;
-    uint8_t op1 = (bytes >> 19) & 0x3F;
-    
-    if (((bytes >> 26) & 0x3F) == 0x5 || ((bytes >> 26) & 0x3F) == 0x25) {
-        bool is_link = ((bytes >> 31) & 0x1) == 1;
-        int32_t imm26 = bytes & 0x3FFFFFF;
-        if (imm26 & 0x2000000) imm26 |= 0xFC000000;
-        int64_t offset = (int64_t)imm26 * 4;
-        
-        strcpy(inst->mnemonic, is_link ? "BL" : "B");
-        inst->branch_target = address + offset;
-        inst->branch_offset = offset;
-        inst->has_branch_target = true;
-        inst->has_branch = true;
-        inst->branch_type = is_link ? BRANCH_CALL : BRANCH_UNCONDITIONAL;
-        
-        snprintf(inst->operands, sizeof(inst->operands), "0x%llx", inst->branch_target);
-        inst->category = INST_CATEGORY_BRANCH;
-        inst->is_valid = true;
-        inst->updates_pc = true;
-        
-        if (is_link) {
-            inst->regs_written |= (1ULL << 30);
-        }
-    }
-    
-    /* ADR / ADRP: PC-relative addressing (immlo:immhi) */
-    else if ((bytes & 0x9F000000) == 0x10000000 || (bytes & 0x9F000000) == 0x90000000) {
-        bool is_adrp = (bytes & 0x80000000) != 0;
-        uint32_t immlo = (bytes >> 29) & 0x3;
-        uint32_t immhi = (bytes >> 5) & 0x7FFFF; // 19 bits
-        uint32_t imm = (immhi << 2) | immlo;     // 21-bit signed immediate (low 2 bits are immlo)
-
-        // sign extend 21-bit
-        if (imm & (1u << 20)) imm |= 0xFFF00000u;
-
-        int64_t offset;
-        uint64_t target;
-        if (is_adrp) {
-            offset = ((int64_t)imm) << 12;
-            uint64_t page = address & ~0xFFFULL;
-            target = page + offset;
-            strcpy(inst->mnemonic, "ADRP");
-        } else {
-            offset = (int64_t)imm;
-            target = address + offset;
-            strcpy(inst->mnemonic, "ADR");
-        }
-
-        uint8_t rd = bytes & 0x1F;
-        snprintf(inst->operands, sizeof(inst->operands), "%s, 0x%llx",
-                 arm64_register_name(rd, true), target);
-        inst->category = INST_CATEGORY_DATA_PROCESSING;
-        inst->is_valid = true;
-        /* ADR/ADRP writes the destination register. */
-        inst->regs_written |= (1ULL << rd);
-        inst->has_branch = false;
-        inst->has_branch_target = true;
-        inst->branch_target = target;
-        inst->branch_offset = offset;
-    }
-    
-    else if (((bytes >> 21) & 0x7FF) >= 0x6B0 && ((bytes >> 21) & 0x7FF) <= 0x6B3) {
-        uint8_t rn = (bytes >> 5) & 0x1F;
-        uint8_t opc = (bytes >> 21) & 0x3;
-        
-        if (opc == 0) strcpy(inst->mnemonic, "BR");
-        else if (opc == 1) strcpy(inst->mnemonic, "BLR");
-        else if (opc == 2) strcpy(inst->mnemonic, "RET");
-        else strcpy(inst->mnemonic, "BRAA");
-        
-        // RET may optionally take a register (e.g., RET X1). Always show the
-        // register operand to make explicit when a non-default link register
-        // is used; show X30 when present as well.
-        snprintf(inst->operands, sizeof(inst->operands), "%s", arm64_register_name(rn, true));
-        
-        inst->has_branch = true;
-        inst->branch_type = (opc == 2) ? BRANCH_RETURN : ((opc == 1) ? BRANCH_CALL : BRANCH_UNCONDITIONAL);
-        inst->category = INST_CATEGORY_BRANCH;
-        inst->is_valid = true;
-        inst->updates_pc = true;
-        
-        inst->regs_read |= (1ULL << rn);
-        if (opc == 1) {
-            inst->regs_written |= (1ULL << 30);
-        } else if (opc == 2) {
-            inst->is_function_end = true;
-            inst->has_branch = true;
-            inst->branch_type = BRANCH_RETURN;
-            inst->updates_pc = true;
-        }
-    }
-    
-    else if (((bytes >> 22) & 0x3FF) >= 0x290 && ((bytes >> 22) & 0x3FF) <= 0x2BF) {
-        bool is_load = ((bytes >> 22) & 0x1) == 1;
-        bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-        uint8_t rt = bytes & 0x1F;
-        uint8_t rt2 = (bytes >> 10) & 0x1F;
-        uint8_t rn = (bytes >> 5) & 0x1F;
-        int16_t imm7 = (bytes >> 15) & 0x7F;
-        if (imm7 & 0x40) imm7 |= 0xFF80;
-        int32_t offset = (int32_t)imm7 * (is_64bit ? 8 : 4);
-        
-        strcpy(inst->mnemonic, is_load ? "LDP" : "STP");
-        
-        uint8_t idx = (bytes >> 23) & 0x3;
-        if (idx == 0x3) {
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, [%s, #%d]!",
-                     arm64_register_name(rt, is_64bit),
-                     arm64_register_name(rt2, is_64bit),
-                     arm64_register_name(rn, true),
-                     offset);
-        } else if (idx == 0x1) {
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, [%s], #%d",
-                     arm64_register_name(rt, is_64bit),
-                     arm64_register_name(rt2, is_64bit),
-                     arm64_register_name(rn, true),
-                     offset);
-        } else {
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, [%s, #%d]",
-                     arm64_register_name(rt, is_64bit),
-                     arm64_register_name(rt2, is_64bit),
-                     arm64_register_name(rn, true),
-                     offset);
-        }
-        
-        inst->category = INST_CATEGORY_LOAD_STORE;
-        inst->is_valid = true;
-        /* register usage: pair loads write two regs, pair stores read two regs */
-        if (is_load) {
-            inst->regs_written |= (1ULL << rt) | (1ULL << rt2);
-            inst->regs_read |= (1ULL << rn);
-        } else {
-            inst->regs_read |= (1ULL << rt) | (1ULL << rt2) | (1ULL << rn);
-        }
-    }
-    
-    else if ((op0 & 0x8) == 0x8) {
-        uint8_t opc = (bytes >> 29) & 0x7;
-        
-        if (((bytes >> 23) & 0x3F) == 0x22 || ((bytes >> 23) & 0x3F) == 0x32) {
-            bool is_sub = ((bytes >> 30) & 0x1) == 1;
-            bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-            uint8_t rd = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            uint16_t imm12 = (bytes >> 10) & 0xFFF;
-            uint8_t shift = (bytes >> 22) & 0x3;
-            uint32_t imm = imm12 << (shift * 12);
-            
-            strcpy(inst->mnemonic, is_sub ? "SUB" : "ADD");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, #%u",
-                     arm64_register_name(rd, is_64bit),
-                     arm64_register_name(rn, is_64bit),
-                     imm);
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-                inst->regs_read |= (1ULL << rn);
-                inst->regs_written |= (1ULL << rd);
-                /* Check S-bit (setflags) for ADD/SUB immediate variants (bit 20). */
-                if (((bytes >> 20) & 0x1) == 1) {
-                    inst->flags_written = 0xF; /* NZCV */
-                }
-        }
-        else if (((bytes >> 23) & 0x3F) == 0x25 || ((bytes >> 23) & 0x3F) == 0x05 || ((bytes >> 23) & 0x3F) == 0x35) {
-            uint8_t opc = (bytes >> 29) & 0x3;
-            bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-            uint8_t rd = bytes & 0x1F;
-            uint16_t imm16 = (bytes >> 5) & 0xFFFF;
-            
-            if (opc == 0x2) strcpy(inst->mnemonic, "MOVZ");
-            else if (opc == 0x0) strcpy(inst->mnemonic, "MOVN");
-            else if (opc == 0x3) strcpy(inst->mnemonic, "MOVK");
-            else strcpy(inst->mnemonic, "MOV");
-            
-            snprintf(inst->operands, sizeof(inst->operands), "%s, #0x%X",
-                     arm64_register_name(rd, is_64bit), imm16);
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-            
-            if (opc == 0x3) {
-                inst->regs_read |= (1ULL << rd);
-                inst->regs_written |= (1ULL << rd);
-            } else {
-                inst->regs_read = 0ULL;
-                inst->regs_written |= (1ULL << rd);
-            }
-        }
+static InstructionCategory arm64_category(ARM64InstructionCategory category) {
+    switch (category) {
+        case ARM64_INS_DATA_PROCESSING_IMM:
+        case ARM64_INS_DATA_PROCESSING_REG: return INST_CATEGORY_DATA_PROCESSING;
+        case ARM64_INS_LOAD_STORE: return INST_CATEGORY_LOAD_STORE;
+        case ARM64_INS_BRANCH: return INST_CATEGORY_BRANCH;
+        case ARM64_INS_SYSTEM: return INST_CATEGORY_SYSTEM;
+        case ARM64_INS_DATA_PROCESSING_SIMD: return INST_CATEGORY_SIMD;
+        default: return INST_CATEGORY_UNKNOWN;
     }
-    
-    else if ((op0 & 0xE) == 0xA) {
-        
-        if (((bytes >> 24) & 0xFF) == 0x54) {
-            uint8_t cond = bytes & 0xF;
-            int32_t imm19 = (bytes >> 5) & 0x7FFFF;
-            if (imm19 & 0x40000) imm19 |= 0xFFF80000;
-            int64_t offset = (int64_t)imm19 * 4;
-            
-            snprintf(inst->mnemonic, sizeof(inst->mnemonic), "B.%s", arm64_condition_string(cond));
-            inst->branch_target = address + offset;
-            inst->branch_offset = offset;
-            inst->has_branch_target = true;
-            inst->has_branch = true;
-            inst->branch_type = BRANCH_CONDITIONAL;
-            
-            snprintf(inst->operands, sizeof(inst->operands), "0x%llx", inst->branch_target);
-            inst->category = INST_CATEGORY_BRANCH;
-            inst->is_valid = true;
-            inst->updates_pc = true;
-        }
-        else if (((bytes >> 24) & 0x7F) == 0x34 || ((bytes >> 24) & 0x7F) == 0x35) {
-            bool is_cbnz = ((bytes >> 24) & 0x1) == 1;
-            bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-            uint8_t rt = bytes & 0x1F;
-            int32_t imm19 = (bytes >> 5) & 0x7FFFF;
-            if (imm19 & 0x40000) imm19 |= 0xFFF80000;
-            int64_t offset = (int64_t)imm19 * 4;
-            
-            strcpy(inst->mnemonic, is_cbnz ? "CBNZ" : "CBZ");
-            inst->branch_target = address + offset;
-            inst->branch_offset = offset;
-            inst->has_branch_target = true;
-            inst->has_branch = true;
-            inst->branch_type = BRANCH_CONDITIONAL;
-            
-            snprintf(inst->operands, sizeof(inst->operands), "%s, 0x%llx",
-                     arm64_register_name(rt, is_64bit), inst->branch_target);
-            inst->category = INST_CATEGORY_BRANCH;
-            inst->is_valid = true;
-            inst->updates_pc = true;
-            inst->regs_read |= (1ULL << rt);
-        }
-        else if (((bytes >> 24) & 0x7F) == 0x36 || ((bytes >> 24) & 0x7F) == 0x37) {
-            bool is_tbnz = ((bytes >> 24) & 0x1) == 1;
-            bool is_64bit_op = ((bytes >> 31) & 0x1) == 1;
-            uint8_t rt = bytes & 0x1F;
-            uint8_t bit_pos = ((bytes >> 19) & 0x1F) | (((bytes >> 31) & 0x1) << 5);
-            int16_t imm14 = (bytes >> 5) & 0x3FFF;
-            if (imm14 & 0x2000) imm14 |= 0xC000;
-            int64_t offset = (int64_t)imm14 * 4;
-
-            strcpy(inst->mnemonic, is_tbnz ? "TBNZ" : "TBZ");
-            inst->branch_target = address + offset;
-            inst->branch_offset = offset;
-            inst->has_branch_target = true;
-            inst->has_branch = true;
-            inst->branch_type = BRANCH_CONDITIONAL;
+}
 
-            snprintf(inst->operands, sizeof(inst->operands), "%s, #%u, 0x%llx",
-                     arm64_register_name(rt, is_64bit_op), bit_pos, inst->branch_target);
-            inst->category = INST_CATEGORY_BRANCH;
-            inst->is_valid = true;
-            inst->updates_pc = true;
-        }
-    }
-    
-    else if ((op0 & 0xB) == 0x8) {
-        uint8_t size = (bytes >> 30) & 0x3;
-        
-        if ((bytes >> 24) == 0xB9 || (bytes >> 24) == 0xF9 ||
-            (bytes >> 24) == 0x39 || (bytes >> 24) == 0x79) {
-            bool is_load = ((bytes >> 22) & 0x1) == 1;
-            bool is_64bit = (size == 0x3);
-            uint8_t rt = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            uint16_t imm12 = (bytes >> 10) & 0xFFF;
-            uint32_t offset = imm12 << size;
-            
-            strcpy(inst->mnemonic, is_load ? "LDR" : "STR");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, [%s, #%u]",
-                     arm64_register_name(rt, is_64bit),
-                     arm64_register_name(rn, true),
-                     offset);
-            inst->category = INST_CATEGORY_LOAD_STORE;
-            inst->is_valid = true;
-        }
-        
-        else if (((bytes >> 21) & 0x7FF) == 0x1C0 || ((bytes >> 21) & 0x7FF) == 0x1C1 ||
-                 ((bytes >> 21) & 0x7FF) == 0x3C0 || ((bytes >> 21) & 0x7FF) == 0x3C1) {
-            bool is_load = ((bytes >> 22) & 0x1) == 1;
-            bool is_64bit = (size >= 0x2);
-            uint8_t rt = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            int16_t imm9 = (bytes >> 12) & 0x1FF;
-            if (imm9 & 0x100) imm9 |= 0xFE00;
-            
-            strcpy(inst->mnemonic, is_load ? "LDUR" : "STUR");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, [%s, #%d]",
-                     arm64_register_name(rt, is_64bit),
-                     arm64_register_name(rn, true),
-                     imm9);
-            inst->category = INST_CATEGORY_LOAD_STORE;
-            inst->is_valid = true;
-        }
-        
-        else if ((bytes >> 24) == 0x18 || (bytes >> 24) == 0x58 ||
-                 (bytes >> 24) == 0x98 || (bytes >> 24) == 0xD8) {
-            uint8_t rt = bytes & 0x1F;
-            int32_t imm19 = (bytes >> 5) & 0x7FFFF;
-            if (imm19 & 0x40000) imm19 |= 0xFFF80000;
-            int64_t offset = (int64_t)imm19 * 4;
-            uint64_t target = address + offset;
-            
-            strcpy(inst->mnemonic, "LDR");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, 0x%llx",
-                     arm64_register_name(rt, true), target);
-            inst->category = INST_CATEGORY_LOAD_STORE;
-            inst->is_valid = true;
-            inst->regs_written |= (1ULL << rt);
-        }
-    }
-    
-    else if ((op0 & 0xE) == 0xA) {
-        if (((bytes >> 21) & 0xFF) >= 0x0 && ((bytes >> 21) & 0xFF) <= 0x77) {
-            uint8_t opc = (bytes >> 29) & 0x3;
-            bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-            uint8_t rd = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            uint8_t rm = (bytes >> 16) & 0x1F;
-            bool N = ((bytes >> 21) & 0x1) == 1;
-            
-            if (opc == 0) strcpy(inst->mnemonic, N ? "BIC" : "AND");
-            else if (opc == 1) strcpy(inst->mnemonic, N ? "ORN" : "ORR");
-            else if (opc == 2) strcpy(inst->mnemonic, N ? "EON" : "EOR");
-            else strcpy(inst->mnemonic, N ? "BICS" : "ANDS");
-            
-                uint8_t imm6 = (bytes >> 10) & 0x3F; /* possible shift immediate */
-                uint8_t shift_type = (bytes >> 22) & 0x3;
-                const char *shift_name = (shift_type == 0) ? "LSL" : (shift_type == 1) ? "LSR" : (shift_type == 2) ? "ASR" : "ROR";
-
-                if (!N && opc == 1 && rn == 31) {
-                    strcpy(inst->mnemonic, "MOV");
-                    snprintf(inst->operands, sizeof(inst->operands), "%s, %s",
-                             arm64_register_name(rd, is_64bit),
-                             arm64_register_name(rm, is_64bit));
-                    inst->regs_read |= (1ULL << rm);
-                    inst->regs_written |= (1ULL << rd);
-                } else {
-                    if (imm6 != 0) {
-                        snprintf(inst->operands, sizeof(inst->operands), "%s, %s, %s, %s #%u",
-                                 arm64_register_name(rd, is_64bit),
-                                 arm64_register_name(rn, is_64bit),
-                                 arm64_register_name(rm, is_64bit),
-                                 shift_name, imm6);
-                    } else {
-                        snprintf(inst->operands, sizeof(inst->operands), "%s, %s, %s",
-                                 arm64_register_name(rd, is_64bit),
-                                 arm64_register_name(rn, is_64bit),
-                                 arm64_register_name(rm, is_64bit));
-                    }
-                    inst->regs_read |= (1ULL << rn) | (1ULL << rm);
-                    inst->regs_written |= (1ULL << rd);
-                    /* Logical ops setflags is encoded in bit 20 for this class. */
-                    if (((bytes >> 20) & 0x1) == 1) {
-                        inst->flags_written = 0xF; /* NZCV */
-                    }
-                }
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-        }
-        else if (((bytes >> 22) & 0x3FF) >= 0x340 && ((bytes >> 22) & 0x3FF) <= 0x34F) {
-            bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-            uint8_t opc = (bytes >> 29) & 0x3;
-            uint8_t rd = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            uint8_t immr = (bytes >> 16) & 0x3F;
-            uint8_t imms = (bytes >> 10) & 0x3F;
-
-            if (opc == 0x0 && !is_64bit) strcpy(inst->mnemonic, "BFM");
-            else if (opc == 0x1 && is_64bit) strcpy(inst->mnemonic, "SBFM");
-            else if (opc == 0x2 && is_64bit) strcpy(inst->mnemonic, "UBFM");
-            else strcpy(inst->mnemonic, "BFM"); // Generic fallback
-
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, #%u, #%u",
-                     arm64_register_name(rd, is_64bit),
-                     arm64_register_name(rn, is_64bit), immr, imms);
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-        }
-        
-        else if (((bytes >> 21) & 0xFF) >= 0x1B && ((bytes >> 21) & 0xFF) <= 0x1F) {
-            bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-            uint8_t rd = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            uint8_t rm = (bytes >> 16) & 0x1F;
-            uint8_t ra = (bytes >> 10) & 0x1F;
-            uint8_t op = (bytes >> 21) & 0x7;
-            
-            if (op == 0x0) strcpy(inst->mnemonic, "MADD");
-            else if (op == 0x1) strcpy(inst->mnemonic, "MSUB");
-            else if (op == 0x2) strcpy(inst->mnemonic, "SMULL");
-            else if (op == 0x3) strcpy(inst->mnemonic, "SMULH");
-            else if (op == 0x2) strcpy(inst->mnemonic, "UDIV");
-            else if (op == 0x3) strcpy(inst->mnemonic, "SDIV");
-            else strcpy(inst->mnemonic, "MUL");
-            
-            if (ra == 31 && op == 0x0) {
-                strcpy(inst->mnemonic, "MUL");
-                snprintf(inst->operands, sizeof(inst->operands), "%s, %s, %s",
-                         arm64_register_name(rd, is_64bit),
-                         arm64_register_name(rn, is_64bit),
-                         arm64_register_name(rm, is_64bit));
-            } else {
-                snprintf(inst->operands, sizeof(inst->operands), "%s, %s, %s, %s",
-                         arm64_register_name(rd, is_64bit),
-                         arm64_register_name(rn, is_64bit),
-                         arm64_register_name(rm, is_64bit),
-                         arm64_register_name(ra, is_64bit));
-            }
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-        }
-    }
-    
-    else if (((bytes >> 24) & 0xFF) == 0xF1 || ((bytes >> 24) & 0xFF) == 0x71 ||
-             ((bytes >> 24) & 0xFF) == 0xEB || ((bytes >> 24) & 0xFF) == 0x6B) {
-        bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-        uint8_t rn = (bytes >> 5) & 0x1F;
-        
-        if (((bytes >> 24) & 0xFF) == 0xF1 || ((bytes >> 24) & 0xFF) == 0x71) {
-            bool is_sub = ((bytes >> 30) & 0x1) == 1;
-            uint16_t imm12 = (bytes >> 10) & 0xFFF;
-            
-            strcpy(inst->mnemonic, is_sub ? "CMP" : "CMN");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, #%u",
-                     arm64_register_name(rn, is_64bit), imm12);
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-            inst->regs_read |= (1ULL << rn);
-            inst->flags_written = 0xF; /* CMP/CMN update NZCV */
-        }
-        
-        else if (((bytes >> 24) & 0xFF) == 0xEB || ((bytes >> 24) & 0xFF) == 0x6B) {
-            bool is_sub = ((bytes >> 30) & 0x1) == 1;
-            uint8_t rm = (bytes >> 16) & 0x1F;
-            
-            strcpy(inst->mnemonic, is_sub ? "CMP" : "CMN");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s",
-                     arm64_register_name(rn, is_64bit),
-                     arm64_register_name(rm, is_64bit));
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-            inst->regs_read |= (1ULL << rn) | (1ULL << rm);
-            inst->flags_written = 0xF; /* CMP/CMN update NZCV */
-        }
-    }
-    
-    else if (((bytes >> 21) & 0x7FF) >= 0x69A && ((bytes >> 21) & 0x7FF) <= 0x69F) {
-        bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-        uint8_t rd = bytes & 0x1F;
-        uint8_t rn = (bytes >> 5) & 0x1F;
-        uint8_t rm = (bytes >> 16) & 0x1F;
-        uint8_t shift_type = (bytes >> 22) & 0x3;
-        uint8_t imm6 = (bytes >> 10) & 0x3F; /* shift immediate when applicable */
-        const char *shift_name;
-        if (shift_type == 0x0) shift_name = "LSL";
-        else if (shift_type == 0x1) shift_name = "LSR";
-        else if (shift_type == 0x2) shift_name = "ASR";
-        else shift_name = "ROR";
-
-        if (imm6 != 0) {
-            strcpy(inst->mnemonic, shift_name);
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, #%u",
-                     arm64_register_name(rd, is_64bit),
-                     arm64_register_name(rn, is_64bit),
-                     imm6);
-        } else {
-            strcpy(inst->mnemonic, shift_name);
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, %s",
-                     arm64_register_name(rd, is_64bit),
-                     arm64_register_name(rn, is_64bit),
-                     arm64_register_name(rm, is_64bit));
-        }
-        inst->category = INST_CATEGORY_DATA_PROCESSING;
-        inst->is_valid = true;
-    }
+/* Copies a decoder result, keeping its structured operands; the text
+   fields stay empty until disasm_render_text. This is what the bulk sweeps
+   store. */
+static void disasm_arm64_store(const DisassemblyContext *ctx, const ARM64DecodedInstruction *decoded,
+                               DisassembledInstruction *inst) {
+    inst->address = decoded->address;
+    inst->raw_bytes = decoded->raw;
+    inst->length = 4;
+    memcpy(inst->mnemonic, decoded->mnemonic, sizeof(decoded->mnemonic));
+    inst->operands[0] = '\0';
+    inst->full_disasm[0] = '\0';
+    inst->comment[0] = '\0';
     
-    else if (((bytes >> 21) & 0x7FF) >= 0x3A2 && ((bytes >> 21) & 0x7FF) <= 0x3A3) {
-        bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-        uint8_t rn = (bytes >> 5) & 0x1F;
-        uint8_t rm = (bytes >> 16) & 0x1F;
-        uint8_t nzcv = bytes & 0xF;
-        uint8_t cond = (bytes >> 12) & 0xF;
-        
-        strcpy(inst->mnemonic, "CCMP");
-        snprintf(inst->operands, sizeof(inst->operands), "%s, %s, #%u, %s",
-                 arm64_register_name(rn, is_64bit),
-                 arm64_register_name(rm, is_64bit),
-                 nzcv,
-                 arm64_condition_string(cond));
-        inst->category = INST_CATEGORY_DATA_PROCESSING;
-        inst->is_valid = true;
-        /* CCMP/CCMN read the registers and update NZCV condition flags. */
-        inst->regs_read |= (1ULL << rn) | (1ULL << rm);
-        inst->flags_written = 0xF; /* NZCV */
-    }
+    inst->category = arm64_category(decoded->category);
+    inst->branch_type = (BranchType)decoded->branch_kind;
+    inst->has_branch_target = decoded->has_target;
+    inst->branch_target = decoded->target;
+    inst->branch_offset = decoded->target_offset;
+    inst->regs_read = decoded->regs_read;
+    inst->regs_written = decoded->regs_written;
+    inst->flags_written = decoded->flags_written;
     
-    else if (bytes == 0xD503201F) {
-        strcpy(inst->mnemonic, "NOP");
-        inst->operands[0] = '\0';
-        inst->category = INST_CATEGORY_SYSTEM;
-        inst->is_valid = true;
-    }
-    else if ((bytes >> 12) == 0xD503301) {
-        uint8_t crm = (bytes >> 8) & 0xF;
-        uint8_t op2 = (bytes >> 5) & 0x7;
-        
-        if (crm == 0x0 && op2 == 0x1) strcpy(inst->mnemonic, "YIELD");
-        else if (crm == 0x0 && op2 == 0x2) strcpy(inst->mnemonic, "WFE");
-        else if (crm == 0x0 && op2 == 0x3) strcpy(inst->mnemonic, "WFI");
-        else if (crm == 0x0 && op2 == 0x4) strcpy(inst->mnemonic, "SEV");
-        else if (crm == 0x0 && op2 == 0x5) strcpy(inst->mnemonic, "SEVL");
-        else strcpy(inst->mnemonic, "HINT");
-        
-        inst->operands[0] = '\0';
-        inst->category = INST_CATEGORY_SYSTEM;
-        inst->is_valid = true;
-    }
+    memcpy(inst->arm64_operands, decoded->operands, decoded->operand_count * sizeof(ARM64Operand));
+    inst->arm64_operand_count = decoded->operand_count;
+    inst->has_text = false;
     
-    else if ((bytes >> 12) == 0xD503309) {
-        uint8_t crm = (bytes >> 8) & 0xF;
-        uint8_t op2 = (bytes >> 5) & 0x7;
-        
-        if (op2 == 0x4) strcpy(inst->mnemonic, "DSB");
-        else if (op2 == 0x5) strcpy(inst->mnemonic, "DMB");
-        else if (op2 == 0x6) strcpy(inst->mnemonic, "ISB");
-        else strcpy(inst->mnemonic, "BARRIER");
-        
-        snprintf(inst->operands, sizeof(inst->operands), "#%u", crm);
-        inst->category = INST_CATEGORY_SYSTEM;
-        inst->is_valid = true;
-    }
-    else if ((bytes >> 21) == 0x6A1) { // MSR/MRS
-        bool is_read = ((bytes >> 21) & 0x1) == 1;
-        uint8_t rt = bytes & 0x1F;
-        // System register encoding: op0[1:0], op1[2:0], CRn[3:0], CRm[3:0], op2[2:0]
-        uint16_t sysreg = ((bytes >> 5) & 0xFFFF);
-
-        if (is_read) {
-            strcpy(inst->mnemonic, "MRS");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, S%u_%u_c%u_c%u_%u",
-                     arm64_register_name(rt, true),
-                     (sysreg >> 14) & 0x3, (sysreg >> 11) & 0x7, (sysreg >> 7) & 0xF, (sysreg >> 3) & 0xF, sysreg & 0x7);
-        } else {
-            strcpy(inst->mnemonic, "MSR");
-            snprintf(inst->operands, sizeof(inst->operands), "S%u_%u_c%u_c%u_%u, %s",
-                     (sysreg >> 14) & 0x3, (sysreg >> 11) & 0x7, (sysreg >> 7) & 0xF, (sysreg >> 3) & 0xF, sysreg & 0x7,
-                     arm64_register_name(rt, true));
-        }
+    inst->is_valid = true;
+    inst->has_branch = inst->updates_pc = (decoded->branch_kind != ARM64_BRANCH_NONE);
+    inst->is_function_start = arm64_is_prologue(ctx, inst);
+    inst->is_function_end = arm64_is_epilogue(ctx, inst);
+}
 
-        inst->category = INST_CATEGORY_SYSTEM;
-        inst->is_valid = true;
-    }
-    
-    if (!inst->is_valid) {
-        uint8_t op0 = (bytes >> 25) & 0xF;
-        
-        if ((op0 & 0xB) == 0x8 || (op0 & 0xB) == 0x9) {
-            bool is_load = ((bytes >> 22) & 0x1) == 1;
-            uint8_t rt = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            uint8_t size = (bytes >> 30) & 0x3;
-            bool is_64bit = (size >= 0x2);
-            
-            strcpy(inst->mnemonic, is_load ? "LDR" : "STR");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, [%s, ...]",
-                     arm64_register_name(rt, is_64bit),
-                     arm64_register_name(rn, true));
-            inst->category = INST_CATEGORY_LOAD_STORE;
-            inst->is_valid = true;
-        }
-        
-        else if (op0 == 0xB) {
-            uint8_t rd = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            uint8_t rm = (bytes >> 16) & 0x1F;
-            bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-            
-            strcpy(inst->mnemonic, "DP3SRC");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, %s, ...",
-                     arm64_register_name(rd, is_64bit),
-                     arm64_register_name(rn, is_64bit),
-                     arm64_register_name(rm, is_64bit));
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-        }
-        
-        else if ((op0 & 0x7) == 0x7 || (op0 & 0xE) == 0xE) {
-            // Check for FMOV (register)
-            if (((bytes >> 21) & 0x7FF) == 0x3C0) {
-                uint8_t rd = bytes & 0x1F;
-                uint8_t rn = (bytes >> 5) & 0x1F;
-                strcpy(inst->mnemonic, "FMOV");
-                snprintf(inst->operands, sizeof(inst->operands), "D%u, D%u", rd, rn);
-                inst->category = INST_CATEGORY_SIMD;
-                inst->is_valid = true;
-                return inst->is_valid;
-            }
-            strcpy(inst->mnemonic, "SIMD");
-            snprintf(inst->operands, sizeof(inst->operands), "...");
-            inst->category = INST_CATEGORY_SIMD;
-            inst->is_valid = true;
-        }
-        
-        else if ((op0 & 0xE) == 0xA) {
-            uint8_t rd = bytes & 0x1F;
-            uint8_t rn = (bytes >> 5) & 0x1F;
-            bool is_64bit = ((bytes >> 31) & 0x1) == 1;
-            
-            strcpy(inst->mnemonic, "DPREG");
-            snprintf(inst->operands, sizeof(inst->operands), "%s, %s, ...",
-                     arm64_register_name(rd, is_64bit),
-                     arm64_register_name(rn, is_64bit));
-            inst->category = INST_CATEGORY_DATA_PROCESSING;
-            inst->is_valid = true;
-        }
-        
-        else if (op0 == 0xD) {
-            strcpy(inst->mnemonic, "SYS");
-            snprintf(inst->operands, sizeof(inst->operands), "...");
-            inst->category = INST_CATEGORY_SYSTEM;
-            inst->is_valid = true;
-        }
-    }
+static void disasm_arm64_decode(const DisassemblyContext *ctx, uint32_t bytes, uint64_t address,
+                                DisassembledInstruction *inst) {
+    ARM64DecodedInstruction decoded;
+    arm64dec_decode_instruction(bytes, address, &decoded);
+    disasm_arm64_store(ctx, &decoded, inst);
+}
 
-    /* Post-process: convert ORR Xd, XZR, Xm (or Wd, WSP, Wm) into MOV alias */
-    if (inst->is_valid && strcmp(inst->mnemonic, "ORR") == 0) {
-        char *first_comma = strchr(inst->operands, ',');
-        if (first_comma) {
-            char *second_comma = strchr(first_comma + 1, ',');
-            if (second_comma) {
-                // extract middle operand (between commas)
-                char mid[32];
-                size_t len = (size_t)(second_comma - (first_comma + 1));
-                if (len < sizeof(mid)) {
-                    // copy and trim spaces
-                    char *s = first_comma + 1;
-                    while (len > 0 && (*s == ' ' || *s == '\t')) { s++; len--; }
-                    size_t copy_len = len;
-                    while (copy_len > 0 && (s[copy_len - 1] == ' ' || s[copy_len - 1] == '\t')) copy_len--;
-                    memcpy(mid, s, copy_len);
-                    mid[copy_len] = '\0';
-
-                    if (strcmp(mid, "SP") == 0 || strcmp(mid, "WSP") == 0 || strcmp(mid, "XZR") == 0 || strcmp(mid, "WZR") == 0) {
-                        // convert to MOV by keeping rd and rm
-                        // find rd (start) and rm (after second comma)
-                        char rd[16];
-                        char rm[16];
-                        size_t rd_len = (size_t)(first_comma - inst->operands);
-                        if (rd_len >= sizeof(rd)) rd_len = sizeof(rd) - 1;
-                        memcpy(rd, inst->operands, rd_len);
-                        rd[rd_len] = '\0';
-
-                        char *rm_src = second_comma + 1;
-                        while (*rm_src == ' ' || *rm_src == '\t') rm_src++;
-                        size_t rm_len = strcspn(rm_src, "\n\r\0");
-                        if (rm_len >= sizeof(rm)) rm_len = sizeof(rm) - 1;
-                        memcpy(rm, rm_src, rm_len);
-                        rm[rm_len] = '\0';
-
-                        strcpy(inst->mnemonic, "MOV");
-                        snprintf(inst->operands, sizeof(inst->operands), "%s, %s", rd, rm);
-                        inst->category = INST_CATEGORY_DATA_PROCESSING;
-                    }
-                }
-            }
-        }
-    }
-    
-    if (!inst->is_valid) {
-        strcpy(inst->mnemonic, ".word");
-        snprintf(inst->operands, sizeof(inst->operands), "0x%08X", bytes);
-        inst->category = INST_CATEGORY_UNKNOWN;
-        inst->is_valid = true;
-    }
+void disasm_render_text(DisassembledInstruction *inst) {
+    if (!inst || inst->has_text) return;
     
-    snprintf(inst->full_disasm, sizeof(inst->full_disasm), "0x%llx: %s %s",
-             inst->address, inst->mnemonic, inst->operands);
+    size_t operands_len = arm64dec_format_operands(inst->arm64_operands, inst->arm64_operand_count,
+                                                   inst->operands, sizeof(inst->operands));
     
-    inst->is_function_start = arm64_is_prologue(ctx, inst);
-    inst->is_function_end = arm64_is_epilogue(ctx, inst);
+    /* "0x<address>: MNEMONIC operands", built by hand as this runs once per
+       displayed instruction. */
+    char *out = inst->full_disasm;
+    char digits[16];
+    int n = 0;
+    uint64_t address = inst->address;
+    do {
+        digits[n++] = "0123456789abcdef"[address & 0xF];
+        address >>= 4;
+    } while (address);
+    *out++ = '0';
+    *out++ = 'x';
+    while (n) *out++ = digits[--n];
+    *out++ = ':';
+    *out++ = ' ';
+    size_t mnemonic_len = strlen(inst->mnemonic);
+    memcpy(out, inst->mnemonic, mnemonic_len);
+    out += mnemonic_len;
+    *out++ = ' ';
+    memcpy(out, inst->operands, operands_len + 1);
+    inst->has_text = true;
+}
 
+/**
+ * disasm_arm64
+ *
+ * Decode a single 32-bit AArch64 instruction word into a DisassembledInstruction.
+ *
+ * The word goes through arm64dec_decode_instruction (ARM64InstructionDecoder),
+ * the one ARM64 decoder in the tree, which produces the mnemonic, structured
+ * operands, branch target, register read/write masks and NZCV writes. They
+ * are copied here together with the prologue/epilogue heuristics and the
+ * operands are rendered into `operands` and `full_disasm` (uppercase
+ * mnemonics, `#` immediates, `0x` addresses).
+ *
+ * The decoder only reads ctx->flags (for the prologue/epilogue heuristics)
+ * and is safe to call concurrently on one context. Always returns true.
+ */
+bool disasm_arm64(DisassemblyContext *ctx, uint32_t bytes, uint64_t address, DisassembledInstruction *inst)
+{
+    memset(inst, 0, sizeof(DisassembledInstruction));
+    disasm_arm64_decode(ctx, bytes, address, inst);
+    disasm_render_text(inst);
     return inst->is_valid;
 }
 
@@ -1074,6 +527,7 @@ static uint32_t calculate_x86_64_length(const uint8_t *bytes, uint32_t max_len,
 
 bool disasm_x86_64(const uint8_t *bytes, uint64_t address, DisassembledInstruction *inst) {
     memset(inst, 0, sizeof(DisassembledInstruction));
+    inst->has_text = true;
     inst->address = address;
     inst->is_valid = false;
     inst->length = 1;
@@ -1380,23 +834,29 @@ bool disasm_x86_64(const uint8_t *bytes, uint64_t address, DisassembledInstructi
 
 #pragma mark - High-Level Disassembly
 
-bool disasm_instruction(DisassemblyContext *ctx, DisassembledInstruction *inst) {
-    if (!ctx || !ctx->code_data || ctx->current_offset >= ctx->code_size) return false;
+/* Decodes the instruction at current_offset and advances past it. ARM64
+   text is left for disasm_render_text. */
+static bool disasm_next(DisassemblyContext *ctx, DisassembledInstruction *inst) {
+    if (!ctx || ctx->current_offset >= ctx->code_size) return false;
     
     uint64_t addr = ctx->code_base_addr + ctx->current_offset;
     
     if (ctx->arch == ARCH_ARM64) {
         if (ctx->current_offset + 4 > ctx->code_size) return false;
-        uint32_t bytes = *(uint32_t*)(ctx->code_data + ctx->current_offset);
+        uint32_t bytes;
+        if (disasm_fetch_code(ctx, ctx->current_offset, (uint8_t*)&bytes, 4) != 4) return false;
         
         if (ctx->macho_ctx && ctx->macho_ctx->header.is_swapped) {
             bytes = swap_uint32(bytes);
         }
         
         ctx->current_offset += 4;
-        return disasm_arm64(ctx, bytes, addr, inst);
+        disasm_arm64_decode(ctx, bytes, addr, inst);
+        return true;
     } else if (ctx->arch == ARCH_X86_64) {
-        bool result = disasm_x86_64(ctx->code_data + ctx->current_offset, addr, inst);
+        uint8_t code[MAX_INSTRUCTION_LENGTH] = {0};
+        if (disasm_fetch_code(ctx, ctx->current_offset, code, sizeof(code)) == 0) return false;
+        bool result = disasm_x86_64(code, addr, inst);
         ctx->current_offset += inst->length;
         return result;
     }
@@ -1404,81 +864,289 @@ bool disasm_instruction(DisassemblyContext *ctx, DisassembledInstruction *inst)
     return false;
 }
 
-uint32_t disasm_range(DisassemblyContext *ctx, uint64_t start_addr, uint64_t end_addr) {
-    if (!ctx || start_addr >= end_addr) return 0;
+bool disasm_instruction(DisassemblyContext *ctx, DisassembledInstruction *inst) {
+    if (!disasm_next(ctx, inst)) return false;
+    disasm_render_text(inst);
+    return true;
+}
+
+#define DISASM_DECODE_BATCH 128
+
+/* ARM64 words decoded ahead of a linear sweep by arm64dec_decode_batch. */
+typedef struct {
+    ARM64DecodedInstruction decoded[DISASM_DECODE_BATCH];
+    uint32_t count;
+    uint32_t next;
+} DisasmArm64Batch;
+
+/* Decodes the ARM64 words from current_offset up to end_offset, at most
+   DISASM_DECODE_BATCH of them, into batch. */
+static bool disasm_arm64_refill(DisassemblyContext *ctx, uint64_t end_offset, DisasmArm64Batch *batch) {
+    uint64_t offset = ctx->current_offset;
+    batch->count = 0;
+    batch->next = 0;
+    if (offset >= end_offset || offset + 4 > ctx->code_size) return false;
     
-    uint64_t start_offset = start_addr - ctx->code_base_addr;
-    uint64_t end_offset = end_addr - ctx->code_base_addr;
+    uint64_t count = (end_offset - offset + 3) / 4;
+    if (count > (ctx->code_size - offset) / 4) count = (ctx->code_size - offset) / 4;
+    if (count > DISASM_DECODE_BATCH) count = DISASM_DECODE_BATCH;
     
-    if (start_offset >= ctx->code_size) return 0;
-    if (end_offset > ctx->code_size) end_offset = ctx->code_size;
+    uint32_t words[DISASM_DECODE_BATCH];
+    if (disasm_fetch_code(ctx, offset, (uint8_t*)words, (size_t)count * 4) != count * 4) return false;
+    if (ctx->macho_ctx && ctx->macho_ctx->header.is_swapped) {
+        for (uint64_t i = 0; i < count; i++) words[i] = swap_uint32(words[i]);
+    }
     
-    uint64_t range_size = end_offset - start_offset;
-    uint32_t estimated = (uint32_t)(range_size / 4);
+    arm64dec_decode_batch(words, (size_t)count, ctx->code_base_addr + offset, batch->decoded);
+    batch->count = (uint32_t)count;
+    return true;
+}
+
+/* Next instruction of a linear sweep that stops at end_offset. */
+static bool disasm_sweep_next(DisassemblyContext *ctx, uint64_t end_offset, DisasmArm64Batch *batch,
+                              DisassembledInstruction *inst) {
+    if (ctx->arch != ARCH_ARM64) {
+        return ctx->current_offset < end_offset && disasm_next(ctx, inst);
+    }
+    
+    if (batch->next == batch->count && !disasm_arm64_refill(ctx, end_offset, batch)) return false;
+    disasm_arm64_store(ctx, &batch->decoded[batch->next++], inst);
+    ctx->current_offset = inst->address - ctx->code_base_addr + 4;
+    return true;
+}
+
+static void disasm_reset_instructions(DisassemblyContext *ctx) {
+    free(ctx->instructions);
+    ctx->instructions = NULL;
+    ctx->instruction_count = 0;
+    ctx->instruction_capacity = 0;
+    ctx->index_valid = false;
+    disasm_compact_reset(&ctx->compact);
+}
+
+/* Decodes section offsets [start_offset, end_offset) into `instructions`,
+   or into the compact store when DISASM_FLAG_COMPACT is set, replacing
+   whatever an earlier pass produced. */
+static uint32_t disasm_decode_span(DisassemblyContext *ctx, uint64_t start_offset, uint64_t end_offset) {
+    disasm_reset_instructions(ctx);
+    
+    uint32_t estimated = (uint32_t)((end_offset - start_offset) / 4);
     if (estimated == 0) estimated = 1;
     
-    ctx->instructions = (DisassembledInstruction*)malloc(estimated * sizeof(DisassembledInstruction));
-    if (!ctx->instructions) return 0;
+    bool compact = (ctx->flags & DISASM_FLAG_COMPACT) != 0;
+    bool variable_width = (ctx->arch != ARCH_ARM64);
+    if (compact) {
+        if (!disasm_compact_reserve(&ctx->compact, estimated, variable_width)) return 0;
+    } else {
+        ctx->instructions = (DisassembledInstruction*)malloc(estimated * sizeof(DisassembledInstruction));
+        if (!ctx->instructions) return 0;
+        ctx->instruction_capacity = estimated;
+    }
     
-    ctx->instruction_capacity = estimated;
-    ctx->instruction_count = 0;
+    DisassembledInstruction scratch;
+    DisasmArm64Batch batch;
+    batch.count = batch.next = 0;
     ctx->current_offset = start_offset;
     
-    while (ctx->current_offset < end_offset) {
-        if (ctx->instruction_count >= ctx->instruction_capacity) {
-            ctx->instruction_capacity *= 2;
-            DisassembledInstruction *new_ptr = (DisassembledInstruction*)realloc(
-                ctx->instructions,
-                ctx->instruction_capacity * sizeof(DisassembledInstruction)
-            );
-            if (!new_ptr) {
-                return ctx->instruction_count;
+    for (;;) {
+        if (compact) {
+            if (!disasm_sweep_next(ctx, end_offset, &batch, &scratch) ||
+                !disasm_compact_push(&ctx->compact, &scratch, variable_width)) {
+                break;
+            }
+        } else {
+            if (ctx->instruction_count >= ctx->instruction_capacity) {
+                DisassembledInstruction *new_ptr = (DisassembledInstruction*)realloc(
+                    ctx->instructions,
+                    ctx->instruction_capacity * 2 * sizeof(DisassembledInstruction)
+                );
+                if (!new_ptr) break;
+                ctx->instructions = new_ptr;
+                ctx->instruction_capacity *= 2;
+            }
+            
+            if (!disasm_sweep_next(ctx, end_offset, &batch, &ctx->instructions[ctx->instruction_count])) {
+                break;
             }
-            ctx->instructions = new_ptr;
-        }
-        
-        if (!disasm_instruction(ctx, &ctx->instructions[ctx->instruction_count])) {
-            break;
         }
         ctx->instruction_count++;
     }
     
+    disasm_build_address_index(ctx);
     return ctx->instruction_count;
 }
 
-uint32_t disasm_all(DisassemblyContext *ctx) {
-    if (!ctx || !ctx->code_data) return 0;
+uint32_t disasm_range(DisassemblyContext *ctx, uint64_t start_addr, uint64_t end_addr) {
+    if (!ctx || start_addr >= end_addr) return 0;
     
-    ctx->current_offset = 0;
-    uint32_t estimated = ctx->code_size / 4;
+    uint64_t start_offset = start_addr - ctx->code_base_addr;
+    uint64_t end_offset = end_addr - ctx->code_base_addr;
     
-    ctx->instructions = (DisassembledInstruction*)malloc(estimated * sizeof(DisassembledInstruction));
-    if (!ctx->instructions) return 0;
+    if (start_offset >= ctx->code_size) return 0;
+    if (end_offset > ctx->code_size) end_offset = ctx->code_size;
     
-    ctx->instruction_capacity = estimated;
-    ctx->instruction_count = 0;
+    return disasm_decode_span(ctx, start_offset, end_offset);
+}
+
+uint32_t disasm_all(DisassemblyContext *ctx) {
+    if (!ctx || ctx->code_size == 0) return 0;
     
-    while (ctx->current_offset < ctx->code_size) {
-        if (ctx->instruction_count >= ctx->instruction_capacity) {
-            ctx->instruction_capacity *= 2;
-            ctx->instructions = (DisassembledInstruction*)realloc(ctx->instructions,
-                                                                   ctx->instruction_capacity * sizeof(DisassembledInstruction));
-            if (!ctx->instructions) return 0;
+    return disasm_decode_span(ctx, 0, ctx->code_size);
+}
+
+#pragma mark - Parallel Disassembly
+
+#define DISASM_MAX_THREADS 16
+#define DISASM_MIN_PER_THREAD (64 * 1024)
+
+typedef struct {
+    DisassemblyContext *ctx;
+    uint32_t first;
+    uint32_t count;
+    uint32_t decoded;
+    DisasmCompactStore mnemonics;   // per-thread opcode ids, remapped on merge
+} DisasmDecodeJob;
+
+/* Decodes ARM64 instructions [first, first + count) straight into their
+   final slots. Each worker streams its own span of the section; the decoder
+   only reads ctx->flags, and the window cache is internally locked. */
+static void* disasm_decode_worker(void *arg) {
+    DisasmDecodeJob *job = (DisasmDecodeJob*)arg;
+    DisassemblyContext *ctx = job->ctx;
+    bool compact = (ctx->flags & DISASM_FLAG_COMPACT) != 0;
+    bool is_swapped = ctx->macho_ctx->header.is_swapped;
+    uint32_t words_per_window = DISASM_CODE_WINDOW_SIZE / 4;
+    DisassembledInstruction scratch;
+    uint32_t words[DISASM_DECODE_BATCH];
+    ARM64DecodedInstruction batch[DISASM_DECODE_BATCH];
+    
+    while (job->decoded < job->count) {
+        uint32_t first = job->first + job->decoded;
+        uint32_t n = job->count - job->decoded;
+        if (n > words_per_window) n = words_per_window;
+        
+        const uint8_t *code = (const uint8_t*)macho_span_acquire(ctx->macho_ctx,
+                                                                 ctx->code_offset + (uint64_t)first * 4,
+                                                                 (uint64_t)n * 4);
+        if (!code) break;
+        
+        for (uint32_t k = 0; k < n; k += DISASM_DECODE_BATCH) {
+            uint32_t batch_count = n - k;
+            if (batch_count > DISASM_DECODE_BATCH) batch_count = DISASM_DECODE_BATCH;
+            memcpy(words, code + (size_t)k * 4, (size_t)batch_count * 4);
+            if (is_swapped) {
+                for (uint32_t j = 0; j < batch_count; j++) words[j] = swap_uint32(words[j]);
+            }
+            arm64dec_decode_batch(words, batch_count, ctx->code_base_addr + (uint64_t)(first + k) * 4, batch);
+            
+            for (uint32_t j = 0; j < batch_count; j++) {
+                uint32_t i = first + k + j;
+                if (compact) {
+                    disasm_arm64_store(ctx, &batch[j], &scratch);
+                    disasm_compact_set(&ctx->compact, i, &scratch, disasm_compact_opcode(&job->mnemonics, scratch.mnemonic));
+                } else {
+                    disasm_arm64_store(ctx, &batch[j], &ctx->instructions[i]);
+                }
+            }
         }
         
-        if (!disasm_instruction(ctx, &ctx->instructions[ctx->instruction_count])) {
-            break;
+        macho_span_release(ctx->macho_ctx, code);
+        job->decoded += n;
+    }
+    
+    return NULL;
+}
+
+uint32_t disasm_all_parallel(DisassemblyContext *ctx, uint32_t thread_count) {
+    if (!ctx || ctx->code_size == 0) return 0;
+    
+    /* x86_64 instruction boundaries are only known by decoding from the
+       start, so only fixed-width ARM64 code can be partitioned. */
+    uint64_t total = ctx->code_size / 4;
+    if (thread_count > DISASM_MAX_THREADS) thread_count = DISASM_MAX_THREADS;
+    if (thread_count > total / DISASM_MIN_PER_THREAD) thread_count = (uint32_t)(total / DISASM_MIN_PER_THREAD);
+    if (ctx->arch != ARCH_ARM64 || thread_count <= 1 || total > UINT32_MAX) return disasm_all(ctx);
+    
+    disasm_reset_instructions(ctx);
+    uint32_t count = (uint32_t)total;
+    bool compact = (ctx->flags & DISASM_FLAG_COMPACT) != 0;
+    if (compact) {
+        if (!disasm_compact_reserve(&ctx->compact, count, false)) return 0;
+    } else {
+        ctx->instructions = (DisassembledInstruction*)malloc((size_t)count * sizeof(DisassembledInstruction));
+        if (!ctx->instructions) return 0;
+        ctx->instruction_capacity = count;
+    }
+    
+    DisasmDecodeJob jobs[DISASM_MAX_THREADS];
+    pthread_t threads[DISASM_MAX_THREADS];
+    bool started[DISASM_MAX_THREADS] = {false};
+    uint32_t per_thread = (count + thread_count - 1) / thread_count;
+    
+    for (uint32_t t = 0; t < thread_count; t++) {
+        memset(&jobs[t], 0, sizeof(DisasmDecodeJob));
+        jobs[t].ctx = ctx;
+        jobs[t].first = t * per_thread;
+        jobs[t].count = (jobs[t].first < count) ? count - jobs[t].first : 0;
+        if (jobs[t].count > per_thread) jobs[t].count = per_thread;
+        started[t] = (pthread_create(&threads[t], NULL, disasm_decode_worker, &jobs[t]) == 0);
+        if (!started[t]) disasm_decode_worker(&jobs[t]);
+    }
+    
+    /* Keep the longest fully decoded prefix, as the serial sweep would stop
+       at the first unreadable window. Opcode ids are merged in thread order,
+       which reproduces the serial first-seen numbering. */
+    uint32_t decoded = 0;
+    bool complete = true;
+    for (uint32_t t = 0; t < thread_count; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+        if (complete) decoded += jobs[t].decoded;
+        complete = complete && (jobs[t].decoded == jobs[t].count);
+    }
+    
+    for (uint32_t t = 0; t < thread_count; t++) {
+        DisasmCompactStore *local = &jobs[t].mnemonics;
+        if (compact && jobs[t].first < decoded) {
+            uint16_t *remap = (uint16_t*)malloc((local->mnemonic_count + 1) * sizeof(uint16_t));
+            if (remap) {
+                for (uint32_t id = 0; id < local->mnemonic_count; id++) {
+                    remap[id] = disasm_compact_opcode(&ctx->compact, local->mnemonics[id]);
+                }
+            }
+            uint32_t end = jobs[t].first + jobs[t].decoded;
+            if (end > decoded) end = decoded;
+            for (uint32_t i = jobs[t].first; i < end; i++) {
+                uint16_t id = ctx->compact.opcodes[i];
+                ctx->compact.opcodes[i] = (remap && id < local->mnemonic_count) ? remap[id] : UINT16_MAX;
+            }
+            free(remap);
         }
-        ctx->instruction_count++;
+        disasm_compact_reset(local);
+    }
+    
+    if (compact) {
+        ctx->compact.count = decoded;
+        ctx->compact.base_addr = ctx->code_base_addr;
     }
+    ctx->instruction_count = decoded;
+    ctx->current_offset = (uint64_t)decoded * 4;
     
+    disasm_build_address_index(ctx);
     return ctx->instruction_count;
 }
 
 uint32_t disasm_detect_functions(DisassemblyContext *ctx) {
-    if (!ctx || !ctx->instructions) return 0;
+    if (!ctx) return 0;
     
     uint32_t func_count = 0;
+    if (ctx->compact.count > 0) {
+        for (uint32_t i = 0; i < ctx->compact.count; i++) {
+            if (ctx->compact.attrs[i] & DISASM_ATTR_FUNCTION_START) func_count++;
+        }
+        return func_count;
+    }
+    
+    if (!ctx->instructions) return 0;
     for (uint32_t i = 0; i < ctx->instruction_count; i++) {
         if (ctx->instructions[i].is_function_start) {
             func_count++;
@@ -1488,11 +1156,91 @@ uint32_t disasm_detect_functions(DisassemblyContext *ctx) {
     return func_count;
 }
 
+#pragma mark - Address Index
+
+void disasm_build_address_index(DisassemblyContext *ctx) {
+    if (!ctx) return;
+    
+    if (ctx->index_offsets) free(ctx->index_offsets);
+    ctx->index_offsets = NULL;
+    ctx->index_valid = false;
+    ctx->index_fixed_width = false;
+    ctx->index_stride = 0;
+    
+    uint32_t count = ctx->instruction_count;
+    if (count == 0) return;
+    ctx->index_base_addr = disasm_address_at(ctx, 0);
+    
+    /* The compact store only keeps offsets for variable-width code. */
+    if (ctx->compact.count > 0 && !ctx->compact.offsets) {
+        ctx->index_fixed_width = true;
+        ctx->index_stride = 4;
+        ctx->index_valid = true;
+        return;
+    }
+    
+    uint32_t stride = (count > 1) ? (uint32_t)(disasm_address_at(ctx, 1) - ctx->index_base_addr) : 4;
+    bool fixed = (stride > 0);
+    for (uint32_t i = 1; i < count && fixed; i++) {
+        fixed = (disasm_address_at(ctx, i) == ctx->index_base_addr + (uint64_t)i * stride);
+    }
+    
+    if (fixed) {
+        ctx->index_fixed_width = true;
+        ctx->index_stride = stride;
+        ctx->index_valid = true;
+        return;
+    }
+    
+    /* Variable-width code: a dense offset table keeps the binary search on
+       contiguous 4-byte keys instead of striding through whole instructions. */
+    ctx->index_offsets = (uint32_t*)malloc((size_t)count * sizeof(uint32_t));
+    if (!ctx->index_offsets) return;
+    
+    uint64_t prev = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t address = disasm_address_at(ctx, i);
+        uint64_t delta = address - ctx->index_base_addr;
+        if (address < ctx->index_base_addr || delta > UINT32_MAX || (i > 0 && address <= prev)) {
+            free(ctx->index_offsets);
+            ctx->index_offsets = NULL;
+            return;
+        }
+        ctx->index_offsets[i] = (uint32_t)delta;
+        prev = address;
+    }
+    ctx->index_valid = true;
+}
+
+static int32_t disasm_index_lookup(const DisassemblyContext *ctx, uint64_t address) {
+    if (address < ctx->index_base_addr) return -1;
+    uint64_t delta = address - ctx->index_base_addr;
+    
+    if (ctx->index_fixed_width) {
+        if (delta % ctx->index_stride != 0) return -1;
+        uint64_t idx = delta / ctx->index_stride;
+        return (idx < ctx->instruction_count) ? (int32_t)idx : -1;
+    }
+    
+    if (delta > UINT32_MAX) return -1;
+    uint32_t key = (uint32_t)delta;
+    uint32_t lo = 0, hi = ctx->instruction_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (ctx->index_offsets[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < ctx->instruction_count && ctx->index_offsets[lo] == key) ? (int32_t)lo : -1;
+}
+
 int32_t disasm_find_by_address(DisassemblyContext *ctx, uint64_t address) {
-    if (!ctx || !ctx->instructions) return -1;
+    if (!ctx || ctx->instruction_count == 0) return -1;
+    
+    if (!ctx->index_valid) disasm_build_address_index(ctx);
+    if (ctx->index_valid) return disasm_index_lookup(ctx, address);
     
     for (uint32_t i = 0; i < ctx->instruction_count; i++) {
-        if (ctx->instructions[i].address == address) {
+        if (disasm_address_at(ctx, i) == address) {
             return (int32_t)i;
         }
     }
@@ -1500,14 +1248,113 @@ int32_t disasm_find_by_address(DisassemblyContext *ctx, uint64_t address) {
     return -1;
 }
 
+uint32_t disasm_find_by_addresses(DisassemblyContext *ctx, const uint64_t *addresses,
+                                  int32_t *out_indices, uint32_t count) {
+    if (!addresses || !out_indices) return 0;
+    
+    uint32_t found = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        out_indices[i] = disasm_find_by_address(ctx, addresses[i]);
+        if (out_indices[i] >= 0) found++;
+    }
+    
+    return found;
+}
+
 void disasm_format_instruction(const DisassembledInstruction *inst, char *buffer, size_t buffer_size) {
     if (!inst || !buffer) return;
     
+    const char *operands = inst->operands;
+    char rendered[MAX_OPERAND_STRING];
+    if (!inst->has_text) {
+        arm64dec_format_operands(inst->arm64_operands, inst->arm64_operand_count, rendered, sizeof(rendered));
+        operands = rendered;
+    }
+    
     if (inst->comment[0] != '\0') {
         snprintf(buffer, buffer_size, "0x%llx: %08X  %-8s %-32s ; %s",
-                 inst->address, inst->raw_bytes, inst->mnemonic, inst->operands, inst->comment);
+                 inst->address, inst->raw_bytes, inst->mnemonic, operands, inst->comment);
     } else {
         snprintf(buffer, buffer_size, "0x%llx: %08X  %-8s %s",
-                 inst->address, inst->raw_bytes, inst->mnemonic, inst->operands);
+                 inst->address, inst->raw_bytes, inst->mnemonic, operands);
+    }
+}
+
+#pragma mark - Instruction Access
+
+uint64_t disasm_address_at(const DisassemblyContext *ctx, uint32_t index) {
+    const DisasmCompactStore *store = &ctx->compact;
+    if (store->count > 0) {
+        return store->base_addr + (store->offsets ? store->offsets[index] : (uint64_t)index * 4);
+    }
+    return ctx->instructions[index].address;
+}
+
+bool disasm_get_semantics(const DisassemblyContext *ctx, uint32_t index, DisasmSemantics *out) {
+    if (!ctx || !out || index >= ctx->instruction_count) return false;
+    
+    const DisasmCompactStore *store = &ctx->compact;
+    if (store->count > 0) {
+        out->address = disasm_address_at(ctx, index);
+        out->length = store->lengths ? store->lengths[index] : 4;
+        out->raw_bytes = store->raw_words[index];
+        out->category = (InstructionCategory)(store->kinds[index] & 0xF);
+        out->branch_type = (BranchType)(store->kinds[index] >> 4);
+        out->attrs = store->attrs[index];
+        out->branch_target = store->branch_targets[index];
+        out->regs_read = store->regs_read[index];
+        out->regs_written = store->regs_written[index];
+        out->flags_written = store->flags_written[index];
+        return true;
+    }
+    
+    const DisassembledInstruction *inst = &ctx->instructions[index];
+    out->address = inst->address;
+    out->length = inst->length;
+    out->raw_bytes = inst->raw_bytes;
+    out->category = inst->category;
+    out->branch_type = inst->branch_type;
+    out->attrs = (inst->is_valid ? DISASM_ATTR_VALID : 0) |
+                 (inst->is_function_start ? DISASM_ATTR_FUNCTION_START : 0) |
+                 (inst->is_function_end ? DISASM_ATTR_FUNCTION_END : 0) |
+                 (inst->updates_pc ? DISASM_ATTR_UPDATES_PC : 0) |
+                 (inst->has_branch ? DISASM_ATTR_HAS_BRANCH : 0) |
+                 (inst->has_branch_target ? DISASM_ATTR_HAS_BRANCH_TARGET : 0);
+    out->branch_target = inst->has_branch_target ? inst->branch_target : 0;
+    out->regs_read = inst->regs_read;
+    out->regs_written = inst->regs_written;
+    out->flags_written = inst->flags_written;
+    return true;
+}
+
+bool disasm_get_instruction(DisassemblyContext *ctx, uint32_t index, DisassembledInstruction *out) {
+    if (!ctx || !out || index >= ctx->instruction_count) return false;
+    
+    if (ctx->compact.count == 0) {
+        *out = ctx->instructions[index];
+        disasm_render_text(out);
+        return true;
+    }
+    
+    uint64_t address = disasm_address_at(ctx, index);
+    if (ctx->arch == ARCH_ARM64) {
+        return disasm_arm64(ctx, ctx->compact.raw_words[index], address, out);
     }
+    
+    uint8_t code[MAX_INSTRUCTION_LENGTH] = {0};
+    if (disasm_fetch_code(ctx, address - ctx->code_base_addr, code, sizeof(code)) == 0) return false;
+    return disasm_x86_64(code, address, out);
+}
+
+const char* disasm_opcode_name(const DisassemblyContext *ctx, uint16_t opcode) {
+    if (!ctx || opcode >= ctx->compact.mnemonic_count) return "";
+    return ctx->compact.mnemonics[opcode];
+}
+
+bool disasm_format_instruction_at(DisassemblyContext *ctx, uint32_t index, char *buffer, size_t buffer_size) {
+    DisassembledInstruction inst;
+    if (!buffer || !disasm_get_instruction(ctx, index, &inst)) return false;
+    
+    disasm_format_instruction(&inst, buffer, buffer_size);
+    return true;
 }
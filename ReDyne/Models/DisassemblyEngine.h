@@ -5,12 +5,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "MachOHeader.h"
+#include "ARM64InstructionDecoder.h"
 
 #pragma mark - Constants
 
 #define MAX_INSTRUCTION_LENGTH 16
 #define MAX_DISASM_STRING 256
 #define MAX_OPERAND_STRING 128
+#define DISASM_CODE_WINDOW_SIZE (1024 * 1024)
 
 typedef enum {
     ARCH_ARM64,
@@ -66,22 +68,98 @@ typedef struct {
     bool updates_pc;
     bool has_branch;
     
+    /* ARM64 operands as decoded by ARM64InstructionDecoder. Bulk decoding
+       stores these and leaves operands/full_disasm empty (has_text false)
+       until disasm_render_text; x86_64 always has text. */
+    ARM64Operand arm64_operands[ARM64_MAX_OPERANDS];
+    uint8_t arm64_operand_count;
+    bool has_text;
+    
 } DisassembledInstruction;
 
+/* Instruction attribute bits used by the compact store. */
+enum {
+    DISASM_ATTR_VALID             = (1u << 0),
+    DISASM_ATTR_FUNCTION_START    = (1u << 1),
+    DISASM_ATTR_FUNCTION_END      = (1u << 2),
+    DISASM_ATTR_UPDATES_PC        = (1u << 3),
+    DISASM_ATTR_HAS_BRANCH        = (1u << 4),
+    DISASM_ATTR_HAS_BRANCH_TARGET = (1u << 5),
+};
+
+/* Structure-of-arrays instruction store filled instead of `instructions`
+   when DISASM_FLAG_COMPACT is set: 25 bytes per ARM64 instruction
+   against ~750 for DisassembledInstruction. Text is not kept; it is
+   re-decoded from the raw word by disasm_get_instruction. Entry i lives at
+   base_addr + 4*i for fixed-width code; variable-width code also fills
+   offsets (from base_addr) and lengths. */
+typedef struct {
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t base_addr;
+    
+    uint32_t *raw_words;
+    uint32_t *offsets;
+    uint8_t *lengths;
+    uint16_t *opcodes;          // index into mnemonics
+    uint8_t *kinds;             // InstructionCategory | BranchType << 4
+    uint8_t *attrs;             // DISASM_ATTR_* bits
+    uint8_t *flags_written;
+    uint64_t *branch_targets;   // valid when DISASM_ATTR_HAS_BRANCH_TARGET is set
+    uint32_t *regs_read;        // X0..X31 / the 16 x86 GPRs fit in 32 bits
+    uint32_t *regs_written;
+    
+    char (*mnemonics)[32];
+    uint32_t mnemonic_count;
+    uint16_t *mnemonic_slots;
+    uint32_t mnemonic_slot_mask;
+} DisasmCompactStore;
+
+/* Text-free view of an instruction, available in either storage mode. */
+typedef struct {
+    uint64_t address;
+    uint64_t branch_target;
+    uint64_t regs_read;
+    uint64_t regs_written;
+    uint32_t raw_bytes;
+    uint8_t length;
+    uint8_t flags_written;
+    InstructionCategory category;
+    BranchType branch_type;
+    uint8_t attrs;
+} DisasmSemantics;
+
 typedef struct {
     MachOContext *macho_ctx;
     Architecture arch;
     
-    uint8_t *code_data;
+    /* The loaded section is streamed through a pinned window of the image
+       (code_window covers section offsets [code_window_start, +code_window_size))
+       so large sections never need to be resident at once. */
+    uint64_t code_offset;
     uint64_t code_size;
     uint64_t code_base_addr;
     uint64_t current_offset;
+    const uint8_t *code_window;
+    uint64_t code_window_start;
+    uint64_t code_window_size;
     
     DisassembledInstruction *instructions;
     uint32_t instruction_count;
     uint32_t instruction_capacity;
     uint32_t flags;
     
+    /* Address -> instruction index, rebuilt after disasm_all/disasm_range.
+       Contiguous fixed-width runs are resolved arithmetically; otherwise
+       index_offsets holds (address - index_base_addr) for binary search. */
+    bool index_valid;
+    bool index_fixed_width;
+    uint32_t index_stride;
+    uint64_t index_base_addr;
+    uint32_t *index_offsets;
+    
+    DisasmCompactStore compact;
+    
 } DisassemblyContext;
 
 #pragma mark - Function Declarations
@@ -96,20 +174,47 @@ uint32_t disasm_range(DisassemblyContext *ctx, uint64_t start_addr, uint64_t end
 
 uint32_t disasm_all(DisassemblyContext *ctx);
 
+/* Same output as disasm_all. ARM64 sections are split into equal index
+   ranges decoded on up to thread_count threads (at most 16, and only for
+   sections of at least 128K instructions); anything else runs serially. */
+uint32_t disasm_all_parallel(DisassemblyContext *ctx, uint32_t thread_count);
+
 bool disasm_arm64(DisassemblyContext *ctx, uint32_t bytes, uint64_t address, DisassembledInstruction *inst);
 
+/* Fills operands and full_disasm from arm64_operands if not done yet.
+   disasm_instruction, disasm_arm64 and disasm_get_instruction return
+   rendered instructions; entries read straight from `instructions` may not be. */
+void disasm_render_text(DisassembledInstruction *inst);
+
 bool disasm_x86_64(const uint8_t *bytes, uint64_t address, DisassembledInstruction *inst);
 
 uint32_t disasm_detect_functions(DisassemblyContext *ctx);
 
+void disasm_build_address_index(DisassemblyContext *ctx);
+
 int32_t disasm_find_by_address(DisassemblyContext *ctx, uint64_t address);
 
+uint32_t disasm_find_by_addresses(DisassemblyContext *ctx, const uint64_t *addresses,
+                                  int32_t *out_indices, uint32_t count);
+
 const char* disasm_category_string(InstructionCategory category);
 
 const char* disasm_branch_type_string(BranchType type);
 
 void disasm_format_instruction(const DisassembledInstruction *inst, char *buffer, size_t buffer_size);
 
+/* Index-based accessors that work in both storage modes. In compact mode
+   disasm_get_instruction re-decodes the instruction to recover its text. */
+bool disasm_get_instruction(DisassemblyContext *ctx, uint32_t index, DisassembledInstruction *out);
+
+bool disasm_get_semantics(const DisassemblyContext *ctx, uint32_t index, DisasmSemantics *out);
+
+uint64_t disasm_address_at(const DisassemblyContext *ctx, uint32_t index);
+
+const char* disasm_opcode_name(const DisassemblyContext *ctx, uint16_t opcode);
+
+bool disasm_format_instruction_at(DisassemblyContext *ctx, uint32_t index, char *buffer, size_t buffer_size);
+
 void disasm_free(DisassemblyContext *ctx);
 
 #pragma mark - ARM64 Specific Helpers
@@ -123,6 +228,7 @@ enum {
     DISASM_FLAG_PROLOGUE_EPILOGUE_HEURISTICS = (1u << 0),
     DISASM_FLAG_EXTENDED_DECODING            = (1u << 1),
     DISASM_FLAG_DETAILED_REGS                = (1u << 2),
+    DISASM_FLAG_COMPACT                      = (1u << 3),
 };
 
 bool arm64_is_prologue(const DisassemblyContext *ctx, const DisassembledInstruction *inst);
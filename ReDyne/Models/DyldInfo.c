@@ -1,7 +1,6 @@
 #include "DyldInfo.h"
 #include <stdlib.h>
 #include <string.h>
-#include <mach-o/loader.h>
 
 #define MAX_IMPORTS 10000
 #define MAX_EXPORTS 10000
@@ -61,25 +60,16 @@ LibraryList* dyld_parse_libraries(MachOContext *ctx) {
     list->compatibility_versions = (uint32_t*)calloc(MAX_LIBRARIES, sizeof(uint32_t));
     list->library_count = 0;
     
-    uint32_t header_size = ctx->header.is_64bit ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
-    fseek(ctx->file, header_size, SEEK_SET);
+    uint64_t cmd_start = ctx->header.is_64bit ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
     
     for (uint32_t i = 0; i < ctx->header.ncmds; i++) {
-        uint32_t cmd, cmdsize;
-        long cmd_start = ftell(ctx->file);
-        
-        fread(&cmd, sizeof(uint32_t), 1, ctx->file);
-        fread(&cmdsize, sizeof(uint32_t), 1, ctx->file);
-        
-        if (ctx->header.is_swapped) {
-            cmd = __builtin_bswap32(cmd);
-            cmdsize = __builtin_bswap32(cmdsize);
-        }
+        uint32_t cmd = macho_read_uint32(ctx, cmd_start);
+        uint32_t cmdsize = macho_read_uint32(ctx, cmd_start + 4);
+        if (cmdsize < 8) break;
         
         if (cmd == LC_LOAD_DYLIB || cmd == LC_LOAD_WEAK_DYLIB || cmd == LC_REEXPORT_DYLIB) {
             struct dylib_command dylib_cmd;
-            fseek(ctx->file, cmd_start, SEEK_SET);
-            fread(&dylib_cmd, sizeof(struct dylib_command), 1, ctx->file);
+            if (!macho_read(ctx, cmd_start, &dylib_cmd, sizeof(struct dylib_command))) break;
             
             if (ctx->header.is_swapped) {
                 dylib_cmd.dylib.name.offset = __builtin_bswap32(dylib_cmd.dylib.name.offset);
@@ -88,9 +78,9 @@ LibraryList* dyld_parse_libraries(MachOContext *ctx) {
                 dylib_cmd.dylib.compatibility_version = __builtin_bswap32(dylib_cmd.dylib.compatibility_version);
             }
             
-            fseek(ctx->file, cmd_start + dylib_cmd.dylib.name.offset, SEEK_SET);
             list->library_names[list->library_count] = (char*)calloc(256, 1);
-            fgets(list->library_names[list->library_count], 255, ctx->file);
+            macho_copy_string(ctx, cmd_start + dylib_cmd.dylib.name.offset,
+                              list->library_names[list->library_count], 256);
             
             list->timestamps[list->library_count] = dylib_cmd.dylib.timestamp;
             list->current_versions[list->library_count] = dylib_cmd.dylib.current_version;
@@ -100,7 +90,7 @@ LibraryList* dyld_parse_libraries(MachOContext *ctx) {
             if (list->library_count >= MAX_LIBRARIES) break;
         }
         
-        fseek(ctx->file, cmd_start + cmdsize, SEEK_SET);
+        cmd_start += cmdsize;
     }
     
     printf("   Found %d linked libraries\n", list->library_count);
@@ -128,9 +118,11 @@ ImportList* dyld_parse_imports(MachOContext *ctx) {
     uint32_t bind_offset = ctx->bind_off;
     uint32_t bind_size = ctx->bind_size;
     
-    uint8_t *bind_data = (uint8_t*)malloc(bind_size);
-    fseek(ctx->file, bind_offset, SEEK_SET);
-    fread(bind_data, 1, bind_size, ctx->file);
+    const uint8_t *bind_data = (const uint8_t*)macho_span_acquire(ctx, bind_offset, bind_size);
+    if (!bind_data) {
+        printf("   Binding info lies outside the file\n");
+        return list;
+    }
     
     const uint8_t *ptr = bind_data;
     const uint8_t *end = bind_data + bind_size;
@@ -199,7 +191,7 @@ ImportList* dyld_parse_imports(MachOContext *ctx) {
         }
     }
     
-    free(bind_data);
+    macho_span_release(ctx, bind_data);
     printf("   Found %d imports\n", list->import_count);
     return list;
 }
@@ -327,9 +319,11 @@ ExportList* dyld_parse_exports(MachOContext *ctx) {
     
     uint32_t export_offset = ctx->export_off;
     uint32_t export_size = ctx->export_size;
-    uint8_t *export_data = (uint8_t*)malloc(export_size);
-    fseek(ctx->file, export_offset, SEEK_SET);
-    fread(export_data, 1, export_size, ctx->file);
+    const uint8_t *export_data = (const uint8_t*)macho_span_acquire(ctx, export_offset, export_size);
+    if (!export_data) {
+        printf("   Export info lies outside the file\n");
+        return list;
+    }
     
     TrieContext tctx = {
         .data = export_data,
@@ -342,10 +336,10 @@ ExportList* dyld_parse_exports(MachOContext *ctx) {
         traverse_export_trie(&tctx, export_data, "", 0);
     }
     
+    macho_span_release(ctx, export_data);
     list->export_count = tctx.export_count;
     printf("   Parsed %u exports from trie\n", list->export_count);
     
-    free(export_data);
     return list;
 }
 
@@ -1,7 +1,10 @@
 #include "MachOHeader.h"
 #include <stdlib.h>
 #include <string.h>
-#include <mach/machine.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #pragma mark - Byte Swapping Utilities
 
@@ -47,13 +50,11 @@ const char* macho_magic_string(uint32_t magic) {
 #pragma mark - String Helpers
 
 const char* macho_cpu_type_string(uint32_t cputype) {
-    uint32_t base_type = cputype & 0x00FFFFFF;
+    if (cputype == 0x0200000C) return "ARM64_32";
     
-    switch (base_type) {
+    switch (cputype) {
         case CPU_TYPE_ARM: return "ARM";
-        case CPU_TYPE_ARM64:
-            if (cputype == 0x0200000C) return "ARM64_32";
-            return "ARM64";
+        case CPU_TYPE_ARM64: return "ARM64";
         case CPU_TYPE_X86: return "i386";
         case CPU_TYPE_X86_64: return "x86_64";
         case CPU_TYPE_POWERPC: return "PowerPC";
@@ -131,54 +132,55 @@ MachOContext* macho_open(const char *filepath, char *error_msg) {
         return NULL;
     }
     
-    ctx->file = fopen(filepath, "rb");
-    if (!ctx->file) {
+    ctx->fd = open(filepath, O_RDONLY);
+    if (ctx->fd < 0) {
         if (error_msg) strcpy(error_msg, "Failed to open file - file may not exist or you don't have permission");
         free(ctx);
         return NULL;
     }
     
-    fseek(ctx->file, 0, SEEK_END);
-    ctx->file_size = ftell(ctx->file);
-    fseek(ctx->file, 0, SEEK_SET);
+    struct stat st;
+    if (fstat(ctx->fd, &st) != 0) {
+        if (error_msg) strcpy(error_msg, "Failed to read file attributes");
+        close(ctx->fd);
+        free(ctx);
+        return NULL;
+    }
+    ctx->file_size = (long)st.st_size;
     
     if (ctx->file_size <= 0) {
         if (error_msg) strcpy(error_msg, "File is empty");
-        fclose(ctx->file);
+        close(ctx->fd);
         free(ctx);
         return NULL;
     }
     
     if (ctx->file_size < 4) {
         if (error_msg) strcpy(error_msg, "File too small to be a valid Mach-O binary");
-        fclose(ctx->file);
+        close(ctx->fd);
         free(ctx);
         return NULL;
     }
     
-    if (ctx->file_size > MAX_FILE_SIZE) {
-        if (error_msg) sprintf(error_msg, "File too large: %ld bytes (max: %d MB)", ctx->file_size, MAX_FILE_SIZE / (1024 * 1024));
-        fclose(ctx->file);
-        free(ctx);
-        return NULL;
-    }
+    pthread_mutex_init(&ctx->window_lock, NULL);
+    ctx->window_size = MACHO_DEFAULT_WINDOW_SIZE;
+    ctx->memory_budget = MACHO_DEFAULT_MEMORY_BUDGET;
+    ctx->slice_offset = 0;
+    ctx->slice_size = (uint64_t)ctx->file_size;
     
-    uint32_t magic;
-    if (fread(&magic, sizeof(uint32_t), 1, ctx->file) != 1) {
-        if (error_msg) strcpy(error_msg, "Failed to read magic number from file");
-        fclose(ctx->file);
-        free(ctx);
+    uint32_t magic = 0;
+    if (!macho_read(ctx, 0, &magic, sizeof(uint32_t))) {
+        if (error_msg) strcpy(error_msg, "Failed to map file into memory");
+        macho_close(ctx);
         return NULL;
     }
-    fseek(ctx->file, 0, SEEK_SET);
     
     if (!macho_is_valid_magic(magic)) {
         if (error_msg) {
             sprintf(error_msg, "Invalid magic number: 0x%08X (%s)\nExpected Mach-O or Universal Binary format", 
                     magic, macho_magic_string(magic));
         }
-        fclose(ctx->file);
-        free(ctx);
+        macho_close(ctx);
         return NULL;
     }
     
@@ -188,7 +190,13 @@ MachOContext* macho_open(const char *filepath, char *error_msg) {
 void macho_close(MachOContext *ctx) {
     if (!ctx) return;
     
-    if (ctx->file) fclose(ctx->file);
+    for (uint32_t i = 0; i < ctx->window_count; i++) {
+        munmap((void*)ctx->windows[i].base, ctx->windows[i].length);
+    }
+    free(ctx->windows);
+    pthread_mutex_destroy(&ctx->window_lock);
+    if (ctx->fd >= 0) close(ctx->fd);
+    
     if (ctx->load_commands) {
         for (uint32_t i = 0; i < ctx->load_command_count; i++) {
             if (ctx->load_commands[i].data) free(ctx->load_commands[i].data);
@@ -201,26 +209,197 @@ void macho_close(MachOContext *ctx) {
     free(ctx);
 }
 
+#pragma mark - Windowed Image Access
+
+void macho_set_memory_budget(MachOContext *ctx, size_t memory_budget, size_t window_size) {
+    if (!ctx) return;
+    
+    size_t page = (size_t)getpagesize();
+    if (window_size < page) window_size = page;
+    window_size = (window_size + page - 1) / page * page;
+    if (memory_budget < window_size) memory_budget = window_size;
+    
+    pthread_mutex_lock(&ctx->window_lock);
+    ctx->window_size = window_size;
+    ctx->memory_budget = memory_budget;
+    pthread_mutex_unlock(&ctx->window_lock);
+}
+
+static void macho_evict_windows(MachOContext *ctx) {
+    while (ctx->resident_bytes > ctx->memory_budget) {
+        int32_t victim = -1;
+        for (uint32_t i = 0; i < ctx->window_count; i++) {
+            if (ctx->windows[i].pin_count > 0) continue;
+            if (victim < 0 || ctx->windows[i].last_used < ctx->windows[victim].last_used) {
+                victim = (int32_t)i;
+            }
+        }
+        if (victim < 0) return;
+        
+        munmap((void*)ctx->windows[victim].base, ctx->windows[victim].length);
+        ctx->resident_bytes -= ctx->windows[victim].length;
+        ctx->windows[victim] = ctx->windows[--ctx->window_count];
+    }
+}
+
+/* Caller holds window_lock. Returns a window covering the absolute file range
+   [file_offset, file_offset + size), mapping a new one when none is resident. */
+static MachOWindow* macho_window_for(MachOContext *ctx, uint64_t file_offset, uint64_t size) {
+    for (uint32_t i = 0; i < ctx->window_count; i++) {
+        MachOWindow *w = &ctx->windows[i];
+        if (file_offset >= w->file_offset && file_offset + size <= w->file_offset + w->length) {
+            w->last_used = ++ctx->window_clock;
+            return w;
+        }
+    }
+    
+    uint64_t page = (uint64_t)getpagesize();
+    uint64_t file_end = (uint64_t)ctx->file_size;
+    uint64_t map_start = file_offset - file_offset % ctx->window_size;
+    uint64_t map_end = map_start + ctx->window_size;
+    uint64_t need_end = (file_offset + size + page - 1) / page * page;
+    if (need_end > map_end) map_end = need_end;
+    if (map_end > file_end) map_end = file_end;
+    if (map_end <= map_start || (uint64_t)(size_t)(map_end - map_start) != map_end - map_start) return NULL;
+    
+    if (ctx->window_count == ctx->window_capacity) {
+        uint32_t capacity = ctx->window_capacity ? ctx->window_capacity * 2 : 16;
+        MachOWindow *windows = realloc(ctx->windows, capacity * sizeof(MachOWindow));
+        if (!windows) return NULL;
+        ctx->windows = windows;
+        ctx->window_capacity = capacity;
+    }
+    
+    size_t length = (size_t)(map_end - map_start);
+    void *base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, ctx->fd, (off_t)map_start);
+    if (base == MAP_FAILED) return NULL;
+    
+    MachOWindow *w = &ctx->windows[ctx->window_count++];
+    w->file_offset = map_start;
+    w->length = length;
+    w->base = (const uint8_t*)base;
+    w->pin_count = 1;
+    w->last_used = ++ctx->window_clock;
+    ctx->resident_bytes += length;
+    
+    /* Pin while evicting so the new window can't be chosen as the victim,
+       then re-locate it: eviction compacts the array. */
+    macho_evict_windows(ctx);
+    for (uint32_t i = 0; i < ctx->window_count; i++) {
+        if (ctx->windows[i].base == base) {
+            ctx->windows[i].pin_count--;
+            return &ctx->windows[i];
+        }
+    }
+    return NULL;
+}
+
+const void* macho_span_acquire(MachOContext *ctx, uint64_t offset, uint64_t size) {
+    if (!ctx || ctx->fd < 0) return NULL;
+    if (offset > ctx->slice_size || size > ctx->slice_size - offset) return NULL;
+    
+    uint64_t file_offset = ctx->slice_offset + offset;
+    const void *span = NULL;
+    
+    pthread_mutex_lock(&ctx->window_lock);
+    MachOWindow *w = macho_window_for(ctx, file_offset, size ? size : 1);
+    if (w) {
+        w->pin_count++;
+        span = w->base + (file_offset - w->file_offset);
+    }
+    pthread_mutex_unlock(&ctx->window_lock);
+    
+    return span;
+}
+
+void macho_span_release(MachOContext *ctx, const void *span) {
+    if (!ctx || !span) return;
+    
+    const uint8_t *p = (const uint8_t*)span;
+    pthread_mutex_lock(&ctx->window_lock);
+    for (uint32_t i = 0; i < ctx->window_count; i++) {
+        MachOWindow *w = &ctx->windows[i];
+        if (p >= w->base && p < w->base + w->length) {
+            if (w->pin_count > 0) w->pin_count--;
+            break;
+        }
+    }
+    macho_evict_windows(ctx);
+    pthread_mutex_unlock(&ctx->window_lock);
+}
+
+static bool macho_read_file(MachOContext *ctx, uint64_t file_offset, void *out, uint64_t size) {
+    if (file_offset > (uint64_t)ctx->file_size || size > (uint64_t)ctx->file_size - file_offset) return false;
+    if (size == 0) return true;
+    
+    pthread_mutex_lock(&ctx->window_lock);
+    MachOWindow *w = macho_window_for(ctx, file_offset, size);
+    if (w) memcpy(out, w->base + (file_offset - w->file_offset), (size_t)size);
+    pthread_mutex_unlock(&ctx->window_lock);
+    
+    return w != NULL;
+}
+
+bool macho_read(MachOContext *ctx, uint64_t offset, void *out, uint64_t size) {
+    if (!ctx || ctx->fd < 0 || !out) return false;
+    if (offset > ctx->slice_size || size > ctx->slice_size - offset) return false;
+    return macho_read_file(ctx, ctx->slice_offset + offset, out, size);
+}
+
+uint32_t macho_read_uint32(MachOContext *ctx, uint64_t offset) {
+    uint32_t value = 0;
+    if (!macho_read(ctx, offset, &value, sizeof(value))) return 0;
+    return ctx->header.is_swapped ? swap_uint32(value) : value;
+}
+
+uint64_t macho_read_uint64(MachOContext *ctx, uint64_t offset) {
+    uint64_t value = 0;
+    if (!macho_read(ctx, offset, &value, sizeof(value))) return 0;
+    return ctx->header.is_swapped ? swap_uint64(value) : value;
+}
+
+size_t macho_copy_string(MachOContext *ctx, uint64_t offset, char *buffer, size_t buffer_size) {
+    if (!buffer || buffer_size == 0) return 0;
+    buffer[0] = '\0';
+    if (!ctx || offset >= ctx->slice_size) return 0;
+    
+    size_t length = 0;
+    while (length < buffer_size - 1 && offset < ctx->slice_size) {
+        uint64_t chunk = buffer_size - 1 - length;
+        if (chunk > 256) chunk = 256;
+        if (chunk > ctx->slice_size - offset) chunk = ctx->slice_size - offset;
+        
+        if (!macho_read(ctx, offset, buffer + length, chunk)) break;
+        const char *nul = memchr(buffer + length, '\0', (size_t)chunk);
+        if (nul) {
+            length = (size_t)(nul - buffer);
+            break;
+        }
+        length += (size_t)chunk;
+        offset += chunk;
+    }
+    
+    buffer[length] = '\0';
+    return length;
+}
+
 #pragma mark - Fat Binary Handling
 
 bool macho_is_fat_binary(MachOContext *ctx) {
-    uint32_t magic;
-    fseek(ctx->file, 0, SEEK_SET);
-    if (fread(&magic, sizeof(uint32_t), 1, ctx->file) != 1) return false;
+    if (!ctx || ctx->fd < 0) return false;
+    uint32_t magic = 0;
+    if (!macho_read_file(ctx, 0, &magic, sizeof(uint32_t))) return false;
     return (magic == FAT_MAGIC || magic == FAT_CIGAM || 
             magic == 0xcafebabf || magic == 0xbfbafeca);
 }
 
-uint64_t macho_select_architecture(MachOContext *ctx) {
+static uint64_t macho_select_slice(MachOContext *ctx, uint64_t *slice_size) {
+    uint64_t file_size = (uint64_t)ctx->file_size;
+    *slice_size = file_size;
     if (!macho_is_fat_binary(ctx)) return 0;
     
-    fseek(ctx->file, 0, SEEK_SET);
-    uint32_t magic;
-    if (fread(&magic, sizeof(uint32_t), 1, ctx->file) != 1) return 0;
-    fseek(ctx->file, 0, SEEK_SET);
-    
     struct fat_header fheader;
-    if (fread(&fheader, sizeof(struct fat_header), 1, ctx->file) != 1) return 0;
+    if (!macho_read_file(ctx, 0, &fheader, sizeof(struct fat_header))) return 0;
     
     bool swap = (fheader.magic == FAT_CIGAM || fheader.magic == 0xbfbafeca);
     bool is_64 = (fheader.magic == 0xcafebabf || fheader.magic == 0xbfbafeca);
@@ -228,105 +407,109 @@ uint64_t macho_select_architecture(MachOContext *ctx) {
     
     if (nfat_arch > 20) return 0;
     
-    uint64_t offset = 0;
+    uint64_t offset = 0, size = 0;
     uint64_t arm64_offset = 0, arm64e_offset = 0, x86_64_offset = 0, arm_offset = 0, i386_offset = 0;
-    
-    if (is_64) {
-        struct fat_arch_64 {
-            uint32_t cputype;
-            uint32_t cpusubtype;
-            uint64_t offset;
-            uint64_t size;
-            uint32_t align;
-            uint32_t reserved;
-        } *archs_64 = malloc(sizeof(struct fat_arch_64) * nfat_arch);
-        
-        if (!archs_64) return 0;
-        if (fread(archs_64, sizeof(struct fat_arch_64), nfat_arch, ctx->file) != nfat_arch) {
-            free(archs_64);
-            return 0;
-        }
+    uint64_t arm64_size = 0, arm64e_size = 0, x86_64_size = 0, arm_size = 0, i386_size = 0;
+    
+    struct fat_arch_64 {
+        uint32_t cputype;
+        uint32_t cpusubtype;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t align;
+        uint32_t reserved;
+    };
+    
+    size_t entry_size = is_64 ? sizeof(struct fat_arch_64) : sizeof(struct fat_arch);
+    uint64_t entries = sizeof(struct fat_header);
+    
+    for (uint32_t i = 0; i < nfat_arch; i++) {
+        uint32_t cputype, cpusubtype;
+        uint64_t arch_offset, arch_size;
         
-        for (uint32_t i = 0; i < nfat_arch; i++) {
-            uint32_t cputype = swap ? swap_uint32(archs_64[i].cputype) : archs_64[i].cputype;
-            uint32_t cpusubtype = swap ? swap_uint32(archs_64[i].cpusubtype) : archs_64[i].cpusubtype;
-            uint64_t arch_offset = swap ? swap_uint64(archs_64[i].offset) : archs_64[i].offset;
-            
-            cpusubtype &= ~CPU_SUBTYPE_MASK;
-            
-            if (cputype == CPU_TYPE_ARM64) {
-                if (cpusubtype == 2) {
-                    arm64e_offset = arch_offset;
-                } else if (arm64_offset == 0) {
-                    arm64_offset = arch_offset;
-                }
-            } else if (cputype == CPU_TYPE_X86_64 && x86_64_offset == 0) {
-                x86_64_offset = arch_offset;
-            } else if (cputype == CPU_TYPE_ARM && arm_offset == 0) {
-                arm_offset = arch_offset;
-            } else if (cputype == CPU_TYPE_X86 && i386_offset == 0) {
-                i386_offset = arch_offset;
-            }
+        if (is_64) {
+            struct fat_arch_64 arch;
+            if (!macho_read_file(ctx, entries + i * entry_size, &arch, sizeof(arch))) return 0;
+            cputype = swap ? swap_uint32(arch.cputype) : arch.cputype;
+            cpusubtype = swap ? swap_uint32(arch.cpusubtype) : arch.cpusubtype;
+            arch_offset = swap ? swap_uint64(arch.offset) : arch.offset;
+            arch_size = swap ? swap_uint64(arch.size) : arch.size;
+        } else {
+            struct fat_arch arch;
+            if (!macho_read_file(ctx, entries + i * entry_size, &arch, sizeof(arch))) return 0;
+            cputype = swap ? swap_uint32(arch.cputype) : arch.cputype;
+            cpusubtype = swap ? swap_uint32(arch.cpusubtype) : arch.cpusubtype;
+            arch_offset = swap ? swap_uint32(arch.offset) : arch.offset;
+            arch_size = swap ? swap_uint32(arch.size) : arch.size;
         }
-        free(archs_64);
-    } else {
-        struct fat_arch *archs = malloc(sizeof(struct fat_arch) * nfat_arch);
-        if (!archs) return 0;
         
-        if (fread(archs, sizeof(struct fat_arch), nfat_arch, ctx->file) != nfat_arch) {
-            free(archs);
-            return 0;
-        }
+        cpusubtype &= ~CPU_SUBTYPE_MASK;
         
-        for (uint32_t i = 0; i < nfat_arch; i++) {
-            uint32_t cputype = swap ? swap_uint32(archs[i].cputype) : archs[i].cputype;
-            uint32_t cpusubtype = swap ? swap_uint32(archs[i].cpusubtype) : archs[i].cpusubtype;
-            uint32_t arch_offset = swap ? swap_uint32(archs[i].offset) : archs[i].offset;
-            
-            cpusubtype &= ~CPU_SUBTYPE_MASK;
-            
-            if (cputype == CPU_TYPE_ARM64) {
-                if (cpusubtype == 2) {
-                    arm64e_offset = arch_offset;
-                } else if (arm64_offset == 0) {
-                    arm64_offset = arch_offset;
-                }
-            } else if (cputype == CPU_TYPE_X86_64 && x86_64_offset == 0) {
-                x86_64_offset = arch_offset;
-            } else if (cputype == CPU_TYPE_ARM && arm_offset == 0) {
-                arm_offset = arch_offset;
-            } else if (cputype == CPU_TYPE_X86 && i386_offset == 0) {
-                i386_offset = arch_offset;
+        if (cputype == CPU_TYPE_ARM64) {
+            if (cpusubtype == 2) {
+                arm64e_offset = arch_offset;
+                arm64e_size = arch_size;
+            } else if (arm64_offset == 0) {
+                arm64_offset = arch_offset;
+                arm64_size = arch_size;
             }
+        } else if (cputype == CPU_TYPE_X86_64 && x86_64_offset == 0) {
+            x86_64_offset = arch_offset;
+            x86_64_size = arch_size;
+        } else if (cputype == CPU_TYPE_ARM && arm_offset == 0) {
+            arm_offset = arch_offset;
+            arm_size = arch_size;
+        } else if (cputype == CPU_TYPE_X86 && i386_offset == 0) {
+            i386_offset = arch_offset;
+            i386_size = arch_size;
         }
-        free(archs);
     }
     
     if (arm64e_offset > 0) {
         offset = arm64e_offset;
+        size = arm64e_size;
     } else if (arm64_offset > 0) {
         offset = arm64_offset;
+        size = arm64_size;
     } else if (x86_64_offset > 0) {
         offset = x86_64_offset;
+        size = x86_64_size;
     } else if (arm_offset > 0) {
         offset = arm_offset;
+        size = arm_size;
     } else if (i386_offset > 0) {
         offset = i386_offset;
+        size = i386_size;
     }
     
+    if (offset >= file_size) {
+        *slice_size = 0;
+        return offset;
+    }
+    if (size == 0 || size > file_size - offset) size = file_size - offset;
+    *slice_size = size;
     return offset;
 }
 
+uint64_t macho_select_architecture(MachOContext *ctx) {
+    if (!ctx) return 0;
+    uint64_t slice_size;
+    return macho_select_slice(ctx, &slice_size);
+}
+
 #pragma mark - Header Parsing
 
 bool macho_parse_header(MachOContext *ctx) {
-    if (!ctx || !ctx->file) return false;
+    if (!ctx || ctx->fd < 0) return false;
     
-    uint64_t arch_offset = macho_select_architecture(ctx);
-    fseek(ctx->file, arch_offset, SEEK_SET);
+    uint64_t slice_size = 0;
+    uint64_t arch_offset = macho_select_slice(ctx, &slice_size);
+    if (slice_size < sizeof(uint32_t)) return false;
     
-    if (fread(&ctx->header.magic, sizeof(uint32_t), 1, ctx->file) != 1) return false;
-    fseek(ctx->file, arch_offset, SEEK_SET);
+    ctx->slice_offset = arch_offset;
+    ctx->slice_size = slice_size;
+    
+    if (!macho_read(ctx, 0, &ctx->header.magic, sizeof(uint32_t))) return false;
     
     if (!macho_is_valid_magic(ctx->header.magic)) return false;
     
@@ -335,7 +518,7 @@ bool macho_parse_header(MachOContext *ctx) {
     
     if (ctx->header.is_64bit) {
         struct mach_header_64 header;
-        if (fread(&header, sizeof(struct mach_header_64), 1, ctx->file) != 1) return false;
+        if (!macho_read(ctx, 0, &header, sizeof(struct mach_header_64))) return false;
         
         if (ctx->header.is_swapped) {
             ctx->header.cputype = swap_uint32(header.cputype);
@@ -356,7 +539,7 @@ bool macho_parse_header(MachOContext *ctx) {
         }
     } else {
         struct mach_header header;
-        if (fread(&header, sizeof(struct mach_header), 1, ctx->file) != 1) return false;
+        if (!macho_read(ctx, 0, &header, sizeof(struct mach_header))) return false;
         
         if (ctx->header.is_swapped) {
             ctx->header.cputype = swap_uint32(header.cputype);
@@ -382,30 +565,30 @@ bool macho_parse_header(MachOContext *ctx) {
 #pragma mark - Load Command Parsing
 
 bool macho_parse_load_commands(MachOContext *ctx) {
-    if (!ctx || !ctx->file || ctx->header.ncmds == 0) return false;
+    if (!ctx || ctx->fd < 0 || ctx->header.ncmds == 0) return false;
     
     ctx->load_command_count = ctx->header.ncmds;
     ctx->load_commands = calloc(ctx->load_command_count, sizeof(LoadCommandInfo));
     if (!ctx->load_commands) return false;
     
+    uint64_t cmd_offset = ctx->header.is_64bit ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
+    
     for (uint32_t i = 0; i < ctx->header.ncmds; i++) {
         struct load_command lc;
-        long cmd_offset = ftell(ctx->file);
-        
-        if (fread(&lc, sizeof(struct load_command), 1, ctx->file) != 1) return false;
+        if (!macho_read(ctx, cmd_offset, &lc, sizeof(struct load_command))) return false;
         
         if (ctx->header.is_swapped) {
             lc.cmd = swap_uint32(lc.cmd);
             lc.cmdsize = swap_uint32(lc.cmdsize);
         }
+        if (lc.cmdsize < sizeof(struct load_command)) return false;
         
         ctx->load_commands[i].cmd = lc.cmd;
         ctx->load_commands[i].cmdsize = lc.cmdsize;
         ctx->load_commands[i].data = malloc(lc.cmdsize);
         if (!ctx->load_commands[i].data) return false;
         
-        fseek(ctx->file, cmd_offset, SEEK_SET);
-        if (fread(ctx->load_commands[i].data, lc.cmdsize, 1, ctx->file) != 1) return false;
+        if (!macho_read(ctx, cmd_offset, ctx->load_commands[i].data, lc.cmdsize)) return false;
         
         switch (lc.cmd) {
             case LC_SYMTAB: {
@@ -417,8 +600,7 @@ bool macho_parse_load_commands(MachOContext *ctx) {
                 break;
             }
             case LC_DYSYMTAB: {
-                struct dysymtab_command *dysym = (struct dysymtab_command*)ctx->load_commands[i].data;
-                ctx->dysymtab_offset = ftell(ctx->file);
+                ctx->dysymtab_offset = (uint32_t)cmd_offset;
                 break;
             }
             case LC_DYLD_INFO:
@@ -449,6 +631,8 @@ bool macho_parse_load_commands(MachOContext *ctx) {
                 break;
             }
         }
+        
+        cmd_offset += lc.cmdsize;
     }
     
     return true;
@@ -535,6 +719,8 @@ uint32_t macho_extract_sections(MachOContext *ctx) {
                 info->offset = ctx->header.is_swapped ? swap_uint32(sections[j].offset) : sections[j].offset;
                 info->align = ctx->header.is_swapped ? swap_uint32(sections[j].align) : sections[j].align;
                 info->flags = ctx->header.is_swapped ? swap_uint32(sections[j].flags) : sections[j].flags;
+                info->reserved1 = ctx->header.is_swapped ? swap_uint32(sections[j].reserved1) : sections[j].reserved1;
+                info->reserved2 = ctx->header.is_swapped ? swap_uint32(sections[j].reserved2) : sections[j].reserved2;
             }
         }
     }
@@ -4,13 +4,16 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <mach-o/loader.h>
-#include <mach-o/fat.h>
-#include <mach-o/nlist.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "MachOTypes.h"
 
 #pragma mark - Constants
 
-#define MAX_FILE_SIZE (200 * 1024 * 1024)
+/* Files are never mapped whole. Reads go through fixed-size windows kept in
+   an LRU; the budget bounds the bytes mapped at once (pinned spans excepted). */
+#define MACHO_DEFAULT_WINDOW_SIZE (8 * 1024 * 1024)
+#define MACHO_DEFAULT_MEMORY_BUDGET (256 * 1024 * 1024)
 #define PREFERRED_ARCH_ARM64E CPU_TYPE_ARM64
 #define PREFERRED_ARCH_ARM64 CPU_TYPE_ARM64
 #define PREFERRED_ARCH_X86_64 CPU_TYPE_X86_64
@@ -52,6 +55,8 @@ typedef struct {
     uint32_t reloff;
     uint32_t nreloc;
     uint32_t flags;
+    uint32_t reserved1;         // S_SYMBOL_STUBS: first indirect symbol index
+    uint32_t reserved2;         // S_SYMBOL_STUBS: stub size
 } SectionInfo;
 
 typedef struct {
@@ -61,8 +66,35 @@ typedef struct {
 } LoadCommandInfo;
 
 typedef struct {
-    FILE *file;
+    uint64_t file_offset;
+    size_t length;
+    const uint8_t *base;
+    uint32_t pin_count;
+    uint64_t last_used;
+} MachOWindow;
+
+typedef struct {
     long file_size;
+    
+    /* slice_offset/slice_size describe the architecture selected by
+       macho_parse_header (the whole file for thin binaries); every offset
+       passed to the macho_* accessors is relative to the slice, matching the
+       offsets stored in load commands. */
+    int fd;
+    uint64_t slice_offset;
+    uint64_t slice_size;
+    
+    /* Read-only mapped windows, evicted least-recently-used once
+       resident_bytes exceeds memory_budget. Guarded by window_lock. */
+    MachOWindow *windows;
+    uint32_t window_count;
+    uint32_t window_capacity;
+    size_t window_size;
+    size_t memory_budget;
+    size_t resident_bytes;
+    uint64_t window_clock;
+    pthread_mutex_t window_lock;
+    
     MachOHeaderInfo header;
     
     uint32_t load_command_count;
@@ -124,6 +156,25 @@ const char* macho_filetype_string(uint32_t filetype);
 
 void macho_close(MachOContext *ctx);
 
+#pragma mark - Windowed Image Access
+
+void macho_set_memory_budget(MachOContext *ctx, size_t memory_budget, size_t window_size);
+
+/* Returns a read-only view of [offset, offset + size) that stays valid until
+   the matching macho_span_release. Keep spans short-lived: a pinned window
+   cannot be evicted. */
+const void* macho_span_acquire(MachOContext *ctx, uint64_t offset, uint64_t size);
+
+void macho_span_release(MachOContext *ctx, const void *span);
+
+bool macho_read(MachOContext *ctx, uint64_t offset, void *out, uint64_t size);
+
+uint32_t macho_read_uint32(MachOContext *ctx, uint64_t offset);
+
+uint64_t macho_read_uint64(MachOContext *ctx, uint64_t offset);
+
+size_t macho_copy_string(MachOContext *ctx, uint64_t offset, char *buffer, size_t buffer_size);
+
 uint16_t swap_uint16(uint16_t val);
 uint32_t swap_uint32(uint32_t val);
 uint64_t swap_uint64(uint64_t val);
@@ -0,0 +1,345 @@
+#ifndef MachOTypes_h
+#define MachOTypes_h
+
+/*
+ * Mach-O structures and constants used by the parsers.
+ *
+ * Apple SDK builds use the SDK's mach-o headers. Elsewhere (the Linux CLI
+ * and benchmark builds) the subset below is used instead; layouts and
+ * values match the SDK headers. Define REDYNE_BUNDLED_MACHO_TYPES to force
+ * the bundled copy.
+ */
+
+#include <stdint.h>
+
+#if defined(__APPLE__) && !defined(REDYNE_BUNDLED_MACHO_TYPES)
+
+#include <mach/machine.h>
+#include <mach-o/loader.h>
+#include <mach-o/fat.h>
+#include <mach-o/nlist.h>
+#include <mach-o/stab.h>
+
+#else
+
+#pragma mark - CPU Types
+
+typedef int cpu_type_t;
+typedef int cpu_subtype_t;
+typedef int vm_prot_t;
+
+#define CPU_ARCH_ABI64          0x01000000
+#define CPU_SUBTYPE_MASK        0xff000000
+
+#define CPU_TYPE_X86            ((cpu_type_t)7)
+#define CPU_TYPE_X86_64         (CPU_TYPE_X86 | CPU_ARCH_ABI64)
+#define CPU_TYPE_ARM            ((cpu_type_t)12)
+#define CPU_TYPE_ARM64          (CPU_TYPE_ARM | CPU_ARCH_ABI64)
+#define CPU_TYPE_POWERPC        ((cpu_type_t)18)
+#define CPU_TYPE_POWERPC64      (CPU_TYPE_POWERPC | CPU_ARCH_ABI64)
+
+#pragma mark - Headers
+
+#define FAT_MAGIC               0xcafebabe
+#define FAT_CIGAM               0xbebafeca
+
+struct fat_header {
+    uint32_t magic;
+    uint32_t nfat_arch;
+};
+
+struct fat_arch {
+    cpu_type_t cputype;
+    cpu_subtype_t cpusubtype;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t align;
+};
+
+#define MH_MAGIC                0xfeedface
+#define MH_CIGAM                0xcefaedfe
+#define MH_MAGIC_64             0xfeedfacf
+#define MH_CIGAM_64             0xcffaedfe
+
+#define MH_OBJECT               0x1
+#define MH_EXECUTE              0x2
+#define MH_FVMLIB               0x3
+#define MH_CORE                 0x4
+#define MH_PRELOAD              0x5
+#define MH_DYLIB                0x6
+#define MH_DYLINKER             0x7
+#define MH_BUNDLE               0x8
+#define MH_DYLIB_STUB           0x9
+#define MH_DSYM                 0xa
+#define MH_KEXT_BUNDLE          0xb
+
+struct mach_header {
+    uint32_t magic;
+    cpu_type_t cputype;
+    cpu_subtype_t cpusubtype;
+    uint32_t filetype;
+    uint32_t ncmds;
+    uint32_t sizeofcmds;
+    uint32_t flags;
+};
+
+struct mach_header_64 {
+    uint32_t magic;
+    cpu_type_t cputype;
+    cpu_subtype_t cpusubtype;
+    uint32_t filetype;
+    uint32_t ncmds;
+    uint32_t sizeofcmds;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+#pragma mark - Load Commands
+
+#define LC_REQ_DYLD             0x80000000
+
+#define LC_SEGMENT              0x1
+#define LC_SYMTAB               0x2
+#define LC_DYSYMTAB             0xb
+#define LC_LOAD_DYLIB           0xc
+#define LC_ID_DYLIB             0xd
+#define LC_LOAD_WEAK_DYLIB      (0x18 | LC_REQ_DYLD)
+#define LC_SEGMENT_64           0x19
+#define LC_UUID                 0x1b
+#define LC_CODE_SIGNATURE       0x1d
+#define LC_REEXPORT_DYLIB       (0x1f | LC_REQ_DYLD)
+#define LC_ENCRYPTION_INFO      0x21
+#define LC_DYLD_INFO            0x22
+#define LC_DYLD_INFO_ONLY       (0x22 | LC_REQ_DYLD)
+#define LC_FUNCTION_STARTS      0x26
+#define LC_MAIN                 (0x28 | LC_REQ_DYLD)
+#define LC_ENCRYPTION_INFO_64   0x2c
+#define LC_DYLD_EXPORTS_TRIE    (0x33 | LC_REQ_DYLD)
+#define LC_DYLD_CHAINED_FIXUPS  (0x34 | LC_REQ_DYLD)
+
+struct load_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+};
+
+union lc_str {
+    uint32_t offset;
+};
+
+struct segment_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    char segname[16];
+    uint32_t vmaddr;
+    uint32_t vmsize;
+    uint32_t fileoff;
+    uint32_t filesize;
+    vm_prot_t maxprot;
+    vm_prot_t initprot;
+    uint32_t nsects;
+    uint32_t flags;
+};
+
+struct segment_command_64 {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    char segname[16];
+    uint64_t vmaddr;
+    uint64_t vmsize;
+    uint64_t fileoff;
+    uint64_t filesize;
+    vm_prot_t maxprot;
+    vm_prot_t initprot;
+    uint32_t nsects;
+    uint32_t flags;
+};
+
+struct section {
+    char sectname[16];
+    char segname[16];
+    uint32_t addr;
+    uint32_t size;
+    uint32_t offset;
+    uint32_t align;
+    uint32_t reloff;
+    uint32_t nreloc;
+    uint32_t flags;
+    uint32_t reserved1;
+    uint32_t reserved2;
+};
+
+struct section_64 {
+    char sectname[16];
+    char segname[16];
+    uint64_t addr;
+    uint64_t size;
+    uint32_t offset;
+    uint32_t align;
+    uint32_t reloff;
+    uint32_t nreloc;
+    uint32_t flags;
+    uint32_t reserved1;
+    uint32_t reserved2;
+    uint32_t reserved3;
+};
+
+#define SECTION_TYPE                0x000000ff
+#define S_CSTRING_LITERALS          0x2
+#define S_SYMBOL_STUBS              0x8
+#define S_ATTR_PURE_INSTRUCTIONS    0x80000000
+#define S_ATTR_SOME_INSTRUCTIONS    0x00000400
+
+struct dylib {
+    union lc_str name;
+    uint32_t timestamp;
+    uint32_t current_version;
+    uint32_t compatibility_version;
+};
+
+struct dylib_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    struct dylib dylib;
+};
+
+struct symtab_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint32_t symoff;
+    uint32_t nsyms;
+    uint32_t stroff;
+    uint32_t strsize;
+};
+
+#define INDIRECT_SYMBOL_LOCAL   0x80000000
+#define INDIRECT_SYMBOL_ABS     0x40000000
+
+struct dysymtab_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint32_t ilocalsym;
+    uint32_t nlocalsym;
+    uint32_t iextdefsym;
+    uint32_t nextdefsym;
+    uint32_t iundefsym;
+    uint32_t nundefsym;
+    uint32_t tocoff;
+    uint32_t ntoc;
+    uint32_t modtaboff;
+    uint32_t nmodtab;
+    uint32_t extrefsymoff;
+    uint32_t nextrefsyms;
+    uint32_t indirectsymoff;
+    uint32_t nindirectsyms;
+    uint32_t extreloff;
+    uint32_t nextrel;
+    uint32_t locreloff;
+    uint32_t nlocrel;
+};
+
+struct uuid_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint8_t uuid[16];
+};
+
+struct linkedit_data_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint32_t dataoff;
+    uint32_t datasize;
+};
+
+struct encryption_info_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint32_t cryptoff;
+    uint32_t cryptsize;
+    uint32_t cryptid;
+};
+
+struct encryption_info_command_64 {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint32_t cryptoff;
+    uint32_t cryptsize;
+    uint32_t cryptid;
+    uint32_t pad;
+};
+
+struct dyld_info_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint32_t rebase_off;
+    uint32_t rebase_size;
+    uint32_t bind_off;
+    uint32_t bind_size;
+    uint32_t weak_bind_off;
+    uint32_t weak_bind_size;
+    uint32_t lazy_bind_off;
+    uint32_t lazy_bind_size;
+    uint32_t export_off;
+    uint32_t export_size;
+};
+
+struct entry_point_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint64_t entryoff;
+    uint64_t stacksize;
+};
+
+#pragma mark - Dyld Info Opcodes
+
+#define REBASE_TYPE_POINTER                     1
+#define REBASE_TYPE_TEXT_ABSOLUTE32             2
+#define REBASE_TYPE_TEXT_PCREL32                3
+
+#define BIND_TYPE_POINTER                       1
+
+#define EXPORT_SYMBOL_FLAGS_KIND_MASK           0x03
+#define EXPORT_SYMBOL_FLAGS_KIND_THREAD_LOCAL   0x01
+#define EXPORT_SYMBOL_FLAGS_WEAK_DEFINITION     0x04
+#define EXPORT_SYMBOL_FLAGS_REEXPORT            0x08
+#define EXPORT_SYMBOL_FLAGS_STUB_AND_RESOLVER   0x10
+
+#pragma mark - Symbols
+
+struct nlist {
+    union {
+        uint32_t n_strx;
+    } n_un;
+    uint8_t n_type;
+    uint8_t n_sect;
+    int16_t n_desc;
+    uint32_t n_value;
+};
+
+struct nlist_64 {
+    union {
+        uint32_t n_strx;
+    } n_un;
+    uint8_t n_type;
+    uint8_t n_sect;
+    uint16_t n_desc;
+    uint64_t n_value;
+};
+
+#define N_STAB                  0xe0
+#define N_PEXT                  0x10
+#define N_TYPE                  0x0e
+#define N_EXT                   0x01
+
+#define N_UNDF                  0x0
+#define N_ABS                   0x2
+#define N_SECT                  0xe
+#define N_PBUD                  0xc
+#define N_INDR                  0xa
+
+#define N_ARM_THUMB_DEF         0x0008
+#define N_WEAK_REF              0x0040
+#define N_WEAK_DEF              0x0080
+
+#endif
+
+#endif
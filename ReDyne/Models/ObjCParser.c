@@ -10,38 +10,18 @@ static bool is_valid_address(MachOContext *ctx, uint64_t addr) {
 }
 
 static uint64_t read_ptr_at_offset(MachOContext *ctx, uint64_t file_offset) {
-    if (!ctx || !ctx->file) return 0;
-    
-    uint64_t value = 0;
-    fseek(ctx->file, file_offset, SEEK_SET);
-    fread(&value, sizeof(uint64_t), 1, ctx->file);
-    
-    return ctx->header.is_swapped ? __builtin_bswap64(value) : value;
+    if (!ctx) return 0;
+    return macho_read_uint64(ctx, file_offset);
 }
 
 static uint32_t read_uint32_at_offset(MachOContext *ctx, uint64_t file_offset) {
-    if (!ctx || !ctx->file) return 0;
-    
-    uint32_t value = 0;
-    fseek(ctx->file, file_offset, SEEK_SET);
-    fread(&value, sizeof(uint32_t), 1, ctx->file);
-    
-    return ctx->header.is_swapped ? __builtin_bswap32(value) : value;
+    if (!ctx) return 0;
+    return macho_read_uint32(ctx, file_offset);
 }
 
 static void read_string_at_offset(MachOContext *ctx, uint64_t file_offset, char *buffer, size_t max_len) {
-    if (!ctx || !ctx->file || !buffer) return;
-    
-    memset(buffer, 0, max_len);
-    fseek(ctx->file, file_offset, SEEK_SET);
-    
-    size_t i = 0;
-    while (i < max_len - 1) {
-        char c = fgetc(ctx->file);
-        if (c == 0 || c == EOF) break;
-        buffer[i++] = c;
-    }
-    buffer[i] = '\0';
+    if (!ctx || !buffer) return;
+    macho_copy_string(ctx, file_offset, buffer, max_len);
 }
 
 static uint64_t vm_addr_to_file_offset(MachOContext *ctx, uint64_t vm_addr) {
@@ -124,9 +104,8 @@ static uint32_t parse_protocol_list(MachOContext *ctx, uint64_t protocol_list_ad
             continue;
         }
         
-        objc_protocol_64_t protocol;
-        fseek(ctx->file, protocol_offset, SEEK_SET);
-        fread(&protocol, sizeof(objc_protocol_64_t), 1, ctx->file);
+        objc_protocol_64_t protocol = {0};
+        macho_read(ctx, protocol_offset, &protocol, sizeof(objc_protocol_64_t));
         
         if (ctx->header.is_swapped) {
             protocol.name_ptr = __builtin_bswap64(protocol.name_ptr);
@@ -176,9 +155,8 @@ static int parse_method_list(MachOContext *ctx, uint64_t method_list_vm_addr, Ob
     
     uint64_t method_offset = file_offset + 8;
     for (uint32_t i = 0; i < count; i++) {
-        objc_method_64_t method;
-        fseek(ctx->file, method_offset, SEEK_SET);
-        fread(&method, sizeof(objc_method_64_t), 1, ctx->file);
+        objc_method_64_t method = {0};
+        macho_read(ctx, method_offset, &method, sizeof(objc_method_64_t));
         
         if (ctx->header.is_swapped) {
             method.name_ptr = __builtin_bswap64(method.name_ptr);
@@ -240,9 +218,8 @@ static int parse_property_list(MachOContext *ctx, uint64_t property_list_vm_addr
     
     uint64_t property_offset = file_offset + 8;
     for (uint32_t i = 0; i < count; i++) {
-        objc_property_64_t property;
-        fseek(ctx->file, property_offset, SEEK_SET);
-        fread(&property, sizeof(objc_property_64_t), 1, ctx->file);
+        objc_property_64_t property = {0};
+        macho_read(ctx, property_offset, &property, sizeof(objc_property_64_t));
         
         if (ctx->header.is_swapped) {
             property.name_ptr = __builtin_bswap64(property.name_ptr);
@@ -300,9 +277,8 @@ static int parse_ivar_list(MachOContext *ctx, uint64_t ivar_list_vm_addr, ObjCIv
     
     uint64_t ivar_offset = file_offset + 8;
     for (uint32_t i = 0; i < count; i++) {
-        objc_ivar_64_t ivar;
-        fseek(ctx->file, ivar_offset, SEEK_SET);
-        fread(&ivar, sizeof(objc_ivar_64_t), 1, ctx->file);
+        objc_ivar_64_t ivar = {0};
+        macho_read(ctx, ivar_offset, &ivar, sizeof(objc_ivar_64_t));
         
         if (ctx->header.is_swapped) {
             ivar.offset_ptr = __builtin_bswap64(ivar.offset_ptr);
@@ -349,8 +325,7 @@ static bool parse_category(MachOContext *ctx, uint64_t cat_vm_addr, ObjCCategory
     if (cat_file_offset == 0) return false;
     
     objc_category_64_t cat_struct;
-    fseek(ctx->file, cat_file_offset, SEEK_SET);
-    fread(&cat_struct, sizeof(objc_category_64_t), 1, ctx->file);
+    if (!macho_read(ctx, cat_file_offset, &cat_struct, sizeof(objc_category_64_t))) return false;
     
     if (ctx->header.is_swapped) {
         cat_struct.name_ptr = __builtin_bswap64(cat_struct.name_ptr);
@@ -373,9 +348,8 @@ static bool parse_category(MachOContext *ctx, uint64_t cat_vm_addr, ObjCCategory
     if (is_valid_address(ctx, cat_struct.class_ptr)) {
         uint64_t class_file_offset = vm_addr_to_file_offset(ctx, cat_struct.class_ptr);
         if (class_file_offset > 0) {
-            objc_class_64_t class_struct;
-            fseek(ctx->file, class_file_offset, SEEK_SET);
-            fread(&class_struct, sizeof(objc_class_64_t), 1, ctx->file);
+            objc_class_64_t class_struct = {0};
+            macho_read(ctx, class_file_offset, &class_struct, sizeof(objc_class_64_t));
             
             if (ctx->header.is_swapped) {
                 class_struct.data_ptr = __builtin_bswap64(class_struct.data_ptr);
@@ -385,9 +359,8 @@ static bool parse_category(MachOContext *ctx, uint64_t cat_vm_addr, ObjCCategory
             if (is_valid_address(ctx, ro_vm_addr)) {
                 uint64_t ro_file_offset = vm_addr_to_file_offset(ctx, ro_vm_addr);
                 if (ro_file_offset > 0) {
-                    objc_class_ro_64_t ro;
-                    fseek(ctx->file, ro_file_offset, SEEK_SET);
-                    fread(&ro, sizeof(objc_class_ro_64_t), 1, ctx->file);
+                    objc_class_ro_64_t ro = {0};
+                    macho_read(ctx, ro_file_offset, &ro, sizeof(objc_class_ro_64_t));
                     
                     if (ctx->header.is_swapped) {
                         ro.name_ptr = __builtin_bswap64(ro.name_ptr);
@@ -448,8 +421,7 @@ static bool parse_class(MachOContext *ctx, uint64_t class_vm_addr, ObjCClassInfo
     if (class_file_offset == 0) return false;
     
     objc_class_64_t class_struct;
-    fseek(ctx->file, class_file_offset, SEEK_SET);
-    fread(&class_struct, sizeof(objc_class_64_t), 1, ctx->file);
+    if (!macho_read(ctx, class_file_offset, &class_struct, sizeof(objc_class_64_t))) return false;
     
     if (ctx->header.is_swapped) {
         class_struct.isa = __builtin_bswap64(class_struct.isa);
@@ -466,8 +438,7 @@ static bool parse_class(MachOContext *ctx, uint64_t class_vm_addr, ObjCClassInfo
     if (ro_file_offset == 0) return false;
     
     objc_class_ro_64_t ro;
-    fseek(ctx->file, ro_file_offset, SEEK_SET);
-    fread(&ro, sizeof(objc_class_ro_64_t), 1, ctx->file);
+    if (!macho_read(ctx, ro_file_offset, &ro, sizeof(objc_class_ro_64_t))) return false;
     
     if (ctx->header.is_swapped) {
         ro.flags = __builtin_bswap32(ro.flags);
@@ -489,9 +460,8 @@ static bool parse_class(MachOContext *ctx, uint64_t class_vm_addr, ObjCClassInfo
     if (is_valid_address(ctx, class_struct.superclass)) {
         uint64_t super_file_offset = vm_addr_to_file_offset(ctx, class_struct.superclass);
         if (super_file_offset > 0) {
-            objc_class_64_t super_class;
-            fseek(ctx->file, super_file_offset, SEEK_SET);
-            fread(&super_class, sizeof(objc_class_64_t), 1, ctx->file);
+            objc_class_64_t super_class = {0};
+            macho_read(ctx, super_file_offset, &super_class, sizeof(objc_class_64_t));
             
             if (ctx->header.is_swapped) {
                 super_class.data_ptr = __builtin_bswap64(super_class.data_ptr);
@@ -500,9 +470,8 @@ static bool parse_class(MachOContext *ctx, uint64_t class_vm_addr, ObjCClassInfo
             uint64_t super_ro_addr = super_class.data_ptr & ~0x7ULL;
             uint64_t super_ro_offset = vm_addr_to_file_offset(ctx, super_ro_addr);
             if (super_ro_offset > 0) {
-                objc_class_ro_64_t super_ro;
-                fseek(ctx->file, super_ro_offset, SEEK_SET);
-                fread(&super_ro, sizeof(objc_class_ro_64_t), 1, ctx->file);
+                objc_class_ro_64_t super_ro = {0};
+                macho_read(ctx, super_ro_offset, &super_ro, sizeof(objc_class_ro_64_t));
                 
                 if (ctx->header.is_swapped) {
                     super_ro.name_ptr = __builtin_bswap64(super_ro.name_ptr);
@@ -526,9 +495,8 @@ static bool parse_class(MachOContext *ctx, uint64_t class_vm_addr, ObjCClassInfo
     if (is_valid_address(ctx, class_struct.isa)) {
         uint64_t metaclass_file_offset = vm_addr_to_file_offset(ctx, class_struct.isa);
         if (metaclass_file_offset > 0) {
-            objc_class_64_t metaclass;
-            fseek(ctx->file, metaclass_file_offset, SEEK_SET);
-            fread(&metaclass, sizeof(objc_class_64_t), 1, ctx->file);
+            objc_class_64_t metaclass = {0};
+            macho_read(ctx, metaclass_file_offset, &metaclass, sizeof(objc_class_64_t));
             
             if (ctx->header.is_swapped) {
                 metaclass.data_ptr = __builtin_bswap64(metaclass.data_ptr);
@@ -537,9 +505,8 @@ static bool parse_class(MachOContext *ctx, uint64_t class_vm_addr, ObjCClassInfo
             uint64_t meta_ro_addr = metaclass.data_ptr & ~0x7ULL;
             uint64_t meta_ro_offset = vm_addr_to_file_offset(ctx, meta_ro_addr);
             if (meta_ro_offset > 0) {
-                objc_class_ro_64_t meta_ro;
-                fseek(ctx->file, meta_ro_offset, SEEK_SET);
-                fread(&meta_ro, sizeof(objc_class_ro_64_t), 1, ctx->file);
+                objc_class_ro_64_t meta_ro = {0};
+                macho_read(ctx, meta_ro_offset, &meta_ro, sizeof(objc_class_ro_64_t));
                 
                 if (ctx->header.is_swapped) {
                     meta_ro.baseMethods_ptr = __builtin_bswap64(meta_ro.baseMethods_ptr);
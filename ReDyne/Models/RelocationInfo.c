@@ -1,7 +1,6 @@
 #include "RelocationInfo.h"
 #include <stdlib.h>
 #include <string.h>
-#include <mach-o/loader.h>
 
 #pragma mark - Context Management
 
@@ -59,15 +58,10 @@ bool reloc_parse_rebase(RelocationContext *ctx) {
     if (!ctx || !ctx->macho_ctx || !ctx->macho_ctx->has_dyld_info) return false;
     if (ctx->macho_ctx->rebase_size == 0) return true;
     
-    uint8_t *rebase_data = (uint8_t*)malloc(ctx->macho_ctx->rebase_size);
+    const uint8_t *rebase_data = (const uint8_t*)macho_span_acquire(ctx->macho_ctx, ctx->macho_ctx->rebase_off,
+                                                                    ctx->macho_ctx->rebase_size);
     if (!rebase_data) return false;
     
-    fseek(ctx->macho_ctx->file, ctx->macho_ctx->rebase_off, SEEK_SET);
-    if (fread(rebase_data, 1, ctx->macho_ctx->rebase_size, ctx->macho_ctx->file) != ctx->macho_ctx->rebase_size) {
-        free(rebase_data);
-        return false;
-    }
-    
     uint32_t estimated_count = 10000;
     ctx->rebases = (RebaseEntry*)calloc(estimated_count, sizeof(RebaseEntry));
     ctx->rebase_count = 0;
@@ -185,7 +179,7 @@ bool reloc_parse_rebase(RelocationContext *ctx) {
     }
     
 done_rebase:
-    free(rebase_data);
+    macho_span_release(ctx->macho_ctx, rebase_data);
     return true;
 }
 
@@ -199,9 +193,9 @@ bool reloc_parse_bind(RelocationContext *ctx) {
     ctx->binds = (BindEntry*)calloc(estimated_count, sizeof(BindEntry));
     ctx->bind_count = 0;
     
-    fseek(ctx->macho_ctx->file, ctx->macho_ctx->bind_off, SEEK_SET);
-    uint8_t *bind_data = malloc(ctx->macho_ctx->bind_size);
-    fread(bind_data, 1, ctx->macho_ctx->bind_size, ctx->macho_ctx->file);
+    const uint8_t *bind_data = (const uint8_t*)macho_span_acquire(ctx->macho_ctx, ctx->macho_ctx->bind_off,
+                                                                  ctx->macho_ctx->bind_size);
+    if (!bind_data) return false;
     
     BindType type = REDYNE_BIND_TYPE_POINTER;
     int32_t library_ordinal = 0;
@@ -371,7 +365,7 @@ bool reloc_parse_bind(RelocationContext *ctx) {
     }
     
 done_bind:
-    free(bind_data);
+    macho_span_release(ctx->macho_ctx, bind_data);
     return true;
 }
 
@@ -383,9 +377,9 @@ bool reloc_parse_lazy_bind(RelocationContext *ctx) {
     ctx->lazy_binds = (BindEntry*)calloc(estimated_count, sizeof(BindEntry));
     ctx->lazy_bind_count = 0;
     
-    fseek(ctx->macho_ctx->file, ctx->macho_ctx->lazy_bind_off, SEEK_SET);
-    uint8_t *lazy_data = malloc(ctx->macho_ctx->lazy_bind_size);
-    fread(lazy_data, 1, ctx->macho_ctx->lazy_bind_size, ctx->macho_ctx->file);
+    const uint8_t *lazy_data = (const uint8_t*)macho_span_acquire(ctx->macho_ctx, ctx->macho_ctx->lazy_bind_off,
+                                                                  ctx->macho_ctx->lazy_bind_size);
+    if (!lazy_data) return false;
     
     BindType type = REDYNE_BIND_TYPE_POINTER;
     int32_t library_ordinal = 0;
@@ -448,7 +442,7 @@ bool reloc_parse_lazy_bind(RelocationContext *ctx) {
         }
     }
     
-    free(lazy_data);
+    macho_span_release(ctx->macho_ctx, lazy_data);
     return true;
 }
 
@@ -460,9 +454,9 @@ bool reloc_parse_weak_bind(RelocationContext *ctx) {
     ctx->weak_binds = (BindEntry*)calloc(estimated_count, sizeof(BindEntry));
     ctx->weak_bind_count = 0;
     
-    fseek(ctx->macho_ctx->file, ctx->macho_ctx->weak_bind_off, SEEK_SET);
-    uint8_t *weak_data = malloc(ctx->macho_ctx->weak_bind_size);
-    fread(weak_data, 1, ctx->macho_ctx->weak_bind_size, ctx->macho_ctx->file);
+    const uint8_t *weak_data = (const uint8_t*)macho_span_acquire(ctx->macho_ctx, ctx->macho_ctx->weak_bind_off,
+                                                                  ctx->macho_ctx->weak_bind_size);
+    if (!weak_data) return false;
     
     BindType type = REDYNE_BIND_TYPE_POINTER;
     int32_t library_ordinal = 0;
@@ -607,7 +601,7 @@ bool reloc_parse_weak_bind(RelocationContext *ctx) {
     }
     
 done_weak:
-    free(weak_data);
+    macho_span_release(ctx->macho_ctx, weak_data);
     return true;
 }
 
@@ -683,20 +677,15 @@ bool reloc_parse_exports(RelocationContext *ctx) {
     ctx->exports = (ExportEntry*)calloc(estimated_count, sizeof(ExportEntry));
     ctx->export_count = 0;
     
-    fseek(ctx->macho_ctx->file, ctx->macho_ctx->export_off, SEEK_SET);
-    uint8_t *export_data = malloc(ctx->macho_ctx->export_size);
+    const uint8_t *export_data = (const uint8_t*)macho_span_acquire(ctx->macho_ctx, ctx->macho_ctx->export_off,
+                                                                    ctx->macho_ctx->export_size);
     if (!export_data) return false;
     
-    if (fread(export_data, 1, ctx->macho_ctx->export_size, ctx->macho_ctx->file) != ctx->macho_ctx->export_size) {
-        free(export_data);
-        return false;
-    }
-    
     char symbol_buffer[256] = {0};
     walk_export_trie(export_data, export_data, export_data + ctx->macho_ctx->export_size,
                     symbol_buffer, 0, ctx->exports, &ctx->export_count, estimated_count);
     
-    free(export_data);
+    macho_span_release(ctx->macho_ctx, export_data);
     return true;
 }
 
@@ -2,9 +2,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define STRING_SCAN_NEON 1
+#elif defined(__x86_64__) || defined(__SSE2__)
+#include <immintrin.h>
+#define STRING_SCAN_SSE2 1
+#endif
 
 #define MIN_STRING_LENGTH 4
 #define MAX_STRING_LENGTH 4096
+#define STRING_SCAN_CHUNK (1024 * 1024)
+#define STRING_PARALLEL_CHUNK (1024 * 1024)
+#define STRING_MAX_WORKERS 16
 
 #pragma mark - Helper Functions
 
@@ -17,9 +30,104 @@ static void string_context_resize(StringContext *ctx) {
     ctx->strings = realloc(ctx->strings, ctx->capacity * sizeof(StringInfo));
 }
 
-static void add_string(StringContext *ctx, uint64_t address, uint64_t offset, 
-                      const char *content, uint32_t length, const char *section_name,
-                      bool is_cstring) {
+#pragma mark - Content Arena
+
+#define STRING_ARENA_BLOCK_SIZE (256 * 1024)
+
+struct StringArenaBlock {
+    struct StringArenaBlock *next;
+    size_t used;
+    size_t size;
+    char data[];
+};
+
+struct StringInternSlot {
+    const char *content;
+    uint32_t hash;
+    uint32_t length;
+};
+
+static uint32_t string_content_hash(const char *content, uint32_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)content[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static char* string_arena_alloc(StringContext *ctx, size_t size) {
+    struct StringArenaBlock *block = ctx->arena;
+    if (!block || block->size - block->used < size) {
+        size_t block_size = size > STRING_ARENA_BLOCK_SIZE ? size : STRING_ARENA_BLOCK_SIZE;
+        block = (struct StringArenaBlock*)malloc(sizeof(struct StringArenaBlock) + block_size);
+        if (!block) return NULL;
+        block->next = ctx->arena;
+        block->used = 0;
+        block->size = block_size;
+        ctx->arena = block;
+    }
+    
+    char *p = block->data + block->used;
+    block->used += size;
+    ctx->arena_bytes += size;
+    return p;
+}
+
+static bool string_intern_grow(StringContext *ctx) {
+    uint32_t capacity = ctx->intern_slots ? (ctx->intern_mask + 1) * 2 : 1024;
+    struct StringInternSlot *slots = (struct StringInternSlot*)calloc(capacity, sizeof(struct StringInternSlot));
+    if (!slots) return false;
+    
+    if (ctx->intern_slots) {
+        for (uint32_t i = 0; i <= ctx->intern_mask; i++) {
+            struct StringInternSlot *old = &ctx->intern_slots[i];
+            if (!old->content) continue;
+            uint32_t slot = old->hash & (capacity - 1);
+            while (slots[slot].content) slot = (slot + 1) & (capacity - 1);
+            slots[slot] = *old;
+        }
+        free(ctx->intern_slots);
+    }
+    
+    ctx->intern_slots = slots;
+    ctx->intern_mask = capacity - 1;
+    return true;
+}
+
+/* Returns the arena copy of content, storing it on first sight. Identical
+   strings found by different passes (a __cstring literal and the same bytes
+   seen by the segment scan) end up sharing one copy. */
+static const char* string_context_intern(StringContext *ctx, const char *content, uint32_t length) {
+    if ((ctx->intern_count + 1) * 2 > (ctx->intern_slots ? ctx->intern_mask + 1 : 0) &&
+        !string_intern_grow(ctx)) {
+        return NULL;
+    }
+    
+    uint32_t hash = string_content_hash(content, length);
+    uint32_t slot = hash & ctx->intern_mask;
+    while (ctx->intern_slots[slot].content) {
+        struct StringInternSlot *entry = &ctx->intern_slots[slot];
+        if (entry->hash == hash && entry->length == length && memcmp(entry->content, content, length) == 0) {
+            return entry->content;
+        }
+        slot = (slot + 1) & ctx->intern_mask;
+    }
+    
+    char *copy = string_arena_alloc(ctx, (size_t)length + 1);
+    if (!copy) return NULL;
+    memcpy(copy, content, length);
+    copy[length] = '\0';
+    
+    ctx->intern_slots[slot].content = copy;
+    ctx->intern_slots[slot].hash = hash;
+    ctx->intern_slots[slot].length = length;
+    ctx->intern_count++;
+    return copy;
+}
+
+static StringInfo* add_string(StringContext *ctx, uint64_t address, uint64_t offset, 
+                              const char *content, uint32_t length, const char *section_name,
+                              bool is_cstring) {
     if (ctx->count >= ctx->capacity) {
         string_context_resize(ctx);
     }
@@ -30,13 +138,12 @@ static void add_string(StringContext *ctx, uint64_t address, uint64_t offset,
     info->length = length;
     info->is_cstring = is_cstring;
     info->is_unicode = false;
-    
-    info->content = malloc(length + 1);
-    memcpy(info->content, content, length);
-    info->content[length] = '\0';
+    info->cfstring_address = 0;
+    info->content = string_context_intern(ctx, content, length);
     
     strncpy(info->section, section_name, sizeof(info->section) - 1);
     info->section[sizeof(info->section) - 1] = '\0';
+    return info;
 }
 
 #pragma mark - Public Functions
@@ -57,113 +164,1077 @@ StringContext* string_context_create(uint32_t initial_capacity) {
     return ctx;
 }
 
-uint32_t string_extract_from_data(StringContext *ctx, const uint8_t *data, size_t size,
-                                   uint64_t base_address, const char *section_name,
-                                   uint32_t min_length) {
-    if (!ctx || !data || size == 0) return 0;
-    if (min_length < MIN_STRING_LENGTH) min_length = MIN_STRING_LENGTH;
-    
-    uint32_t found = 0;
+/* Printable-run scanner state, carried across chunk boundaries when a
+   region is streamed through the windowed reader. */
+typedef struct {
     char buffer[MAX_STRING_LENGTH];
-    uint32_t buf_pos = 0;
-    uint64_t string_start = 0;
+    uint32_t buf_pos;
+    uint64_t string_start;
+} PrintableRunState;
+
+static uint32_t scan_printable_runs_scalar(StringContext *ctx, PrintableRunState *state,
+                                           const uint8_t *data, size_t size, uint64_t data_offset,
+                                           uint64_t base_address, const char *section_name,
+                                           uint32_t min_length) {
+    uint32_t found = 0;
     
     for (size_t i = 0; i < size; i++) {
         uint8_t byte = data[i];
         
         if (is_printable((char)byte)) {
-            if (buf_pos == 0) {
-                string_start = i;
+            if (state->buf_pos == 0) {
+                state->string_start = data_offset + i;
             }
             
-            if (buf_pos < MAX_STRING_LENGTH - 1) {
-                buffer[buf_pos++] = (char)byte;
+            if (state->buf_pos < MAX_STRING_LENGTH - 1) {
+                state->buffer[state->buf_pos++] = (char)byte;
             }
-        } else if (byte == 0 && buf_pos >= min_length) {
-            buffer[buf_pos] = '\0';
+        } else if (byte == 0 && state->buf_pos >= min_length) {
+            state->buffer[state->buf_pos] = '\0';
             
-            add_string(ctx, base_address + string_start, string_start,
-                      buffer, buf_pos, section_name, false);
+            add_string(ctx, base_address + state->string_start, state->string_start,
+                      state->buffer, state->buf_pos, section_name, false);
             
             found++;
-            buf_pos = 0;
+            state->buf_pos = 0;
         } else {
-            buf_pos = 0;
+            state->buf_pos = 0;
         }
     }
     
     return found;
 }
 
-uint32_t string_extract_cstrings(StringContext *ctx, FILE *file, uint64_t offset,
+#pragma mark - Vectorized Scanning
+
+/* Each kernel returns a bitmask with bit i set when p[i] is printable
+   (0x20-0x7E, tab, LF or CR), 32 bytes per call. */
+typedef uint32_t (*PrintableMaskFn)(const uint8_t *p);
+
+#if STRING_SCAN_NEON
+
+static inline uint32_t neon_movemask(uint8x16_t mask) {
+    static const uint8_t bit_weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t bits = vandq_u8(mask, vld1q_u8(bit_weights));
+    return (uint32_t)vaddv_u8(vget_low_u8(bits)) | ((uint32_t)vaddv_u8(vget_high_u8(bits)) << 8);
+}
+
+static inline uint32_t neon_printable_mask16(const uint8_t *p) {
+    uint8x16_t v = vld1q_u8(p);
+    uint8x16_t ascii = vandq_u8(vcgeq_u8(v, vdupq_n_u8(0x20)), vcleq_u8(v, vdupq_n_u8(0x7E)));
+    uint8x16_t space = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('\t')), vceqq_u8(v, vdupq_n_u8('\n'))),
+                                vceqq_u8(v, vdupq_n_u8('\r')));
+    return neon_movemask(vorrq_u8(ascii, space));
+}
+
+static uint32_t printable_mask_neon(const uint8_t *p) {
+    return neon_printable_mask16(p) | (neon_printable_mask16(p + 16) << 16);
+}
+
+#elif STRING_SCAN_SSE2
+
+static inline uint32_t sse2_printable_mask16(const uint8_t *p) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    /* Signed compares: bytes >= 0x80 are negative and fall out of the range. */
+    __m128i ascii = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1F)),
+                                  _mm_cmplt_epi8(v, _mm_set1_epi8(0x7F)));
+    __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')),
+                                              _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+    return (uint32_t)_mm_movemask_epi8(_mm_or_si128(ascii, space));
+}
+
+static uint32_t printable_mask_sse2(const uint8_t *p) {
+    return sse2_printable_mask16(p) | (sse2_printable_mask16(p + 16) << 16);
+}
+
+__attribute__((target("avx2")))
+static uint32_t printable_mask_avx2(const uint8_t *p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)p);
+    __m256i ascii = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(0x1F)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7F), v));
+    __m256i space = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')),
+                                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))),
+                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+    return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(ascii, space));
+}
+
+#endif
+
+static PrintableMaskFn printable_mask_kernel(const char **name) {
+#if STRING_SCAN_NEON
+    if (name) *name = "neon";
+    return printable_mask_neon;
+#elif STRING_SCAN_SSE2
+    if (__builtin_cpu_supports("avx2")) {
+        if (name) *name = "avx2";
+        return printable_mask_avx2;
+    }
+    if (name) *name = "sse2";
+    return printable_mask_sse2;
+#else
+    if (name) *name = "scalar";
+    return NULL;
+#endif
+}
+
+const char* string_scan_kernel_name(void) {
+    const char *name = "scalar";
+    printable_mask_kernel(&name);
+    return name;
+}
+
+/* Same state machine as scan_printable_runs_scalar, but walks printable runs
+   32 bytes at a time: blocks outside a run with no printable byte are skipped
+   whole, and run bytes are appended with one memcpy per run segment. */
+static uint32_t scan_printable_runs_vector(StringContext *ctx, PrintableRunState *state, PrintableMaskFn mask_fn,
+                                           const uint8_t *data, size_t size, uint64_t data_offset,
+                                           uint64_t base_address, const char *section_name,
+                                           uint32_t min_length) {
+    uint32_t found = 0;
+    size_t i = 0;
+    
+    for (; i + 32 <= size; i += 32) {
+        uint32_t printable = mask_fn(data + i);
+        uint32_t j = 0;
+        
+        while (j < 32) {
+            if (state->buf_pos == 0) {
+                uint32_t ahead = printable >> j;
+                if (!ahead) break;
+                j += (uint32_t)__builtin_ctz(ahead);
+                state->string_start = data_offset + i + j;
+            }
+            
+            uint32_t stops = ~printable >> j;
+            uint32_t run_end = stops ? j + (uint32_t)__builtin_ctz(stops) : 32;
+            
+            uint32_t room = MAX_STRING_LENGTH - 1 - state->buf_pos;
+            uint32_t take = run_end - j;
+            if (take > room) take = room;
+            memcpy(state->buffer + state->buf_pos, data + i + j, take);
+            state->buf_pos += take;
+            
+            if (run_end == 32) break;
+            
+            if (data[i + run_end] == 0 && state->buf_pos >= min_length) {
+                state->buffer[state->buf_pos] = '\0';
+                add_string(ctx, base_address + state->string_start, state->string_start,
+                          state->buffer, state->buf_pos, section_name, false);
+                found++;
+            }
+            state->buf_pos = 0;
+            j = run_end + 1;
+        }
+    }
+    
+    return found + scan_printable_runs_scalar(ctx, state, data + i, size - i, data_offset + i,
+                                              base_address, section_name, min_length);
+}
+
+static uint32_t scan_printable_runs(StringContext *ctx, PrintableRunState *state,
+                                    const uint8_t *data, size_t size, uint64_t data_offset,
+                                    uint64_t base_address, const char *section_name,
+                                    uint32_t min_length) {
+    PrintableMaskFn mask_fn = (ctx->scan_mode == STRING_SCAN_SCALAR) ? NULL : printable_mask_kernel(NULL);
+    if (!mask_fn) {
+        return scan_printable_runs_scalar(ctx, state, data, size, data_offset,
+                                          base_address, section_name, min_length);
+    }
+    return scan_printable_runs_vector(ctx, state, mask_fn, data, size, data_offset,
+                                      base_address, section_name, min_length);
+}
+
+uint32_t string_extract_from_data(StringContext *ctx, const uint8_t *data, size_t size,
+                                   uint64_t base_address, const char *section_name,
+                                   uint32_t min_length) {
+    if (!ctx || !data || size == 0) return 0;
+    if (min_length < MIN_STRING_LENGTH) min_length = MIN_STRING_LENGTH;
+    
+    PrintableRunState state;
+    state.buf_pos = 0;
+    state.string_start = 0;
+    
+    return scan_printable_runs(ctx, &state, data, size, 0, base_address, section_name, min_length);
+}
+
+/* Scans [lo, hi) of a region starting at file offset `offset`. Positions
+   reported in StringInfo stay relative to the region, so a region split into
+   sub-ranges produces exactly what one pass over it would. */
+static uint32_t extract_printable_range(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
+                                        uint64_t lo, uint64_t hi, uint64_t base_address,
+                                        const char *section_name, uint32_t min_length) {
+    PrintableRunState state;
+    state.buf_pos = 0;
+    state.string_start = 0;
+    
+    uint32_t found = 0;
+    for (uint64_t pos = lo; pos < hi; pos += STRING_SCAN_CHUNK) {
+        uint64_t chunk = hi - pos;
+        if (chunk > STRING_SCAN_CHUNK) chunk = STRING_SCAN_CHUNK;
+        
+        const uint8_t *data = (const uint8_t*)macho_span_acquire(macho_ctx, offset + pos, chunk);
+        if (!data) break;
+        found += scan_printable_runs(ctx, &state, data, (size_t)chunk, pos, base_address, section_name, min_length);
+        macho_span_release(macho_ctx, data);
+    }
+    
+    return found;
+}
+
+static uint32_t extract_cstring_range(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
+                                      uint64_t lo, uint64_t hi, uint64_t vmaddr) {
+    uint32_t found = 0;
+    uint64_t pos = lo;
+    bool skipping = false;
+    
+    while (pos < hi) {
+        uint64_t chunk = hi - pos;
+        if (chunk > STRING_SCAN_CHUNK) chunk = STRING_SCAN_CHUNK;
+        bool last_chunk = (pos + chunk == hi);
+        
+        const uint8_t *data = (const uint8_t*)macho_span_acquire(macho_ctx, offset + pos, chunk);
+        if (!data) break;
+        
+        uint64_t cur = 0;
+        if (skipping) {
+            const uint8_t *nul = memchr(data, 0, (size_t)chunk);
+            cur = nul ? (uint64_t)(nul - data) + 1 : chunk;
+            skipping = (nul == NULL);
+        }
+        
+        while (cur < chunk) {
+            const char *str = (const char *)(data + cur);
+            size_t len = strnlen(str, (size_t)(chunk - cur));
+            
+            // A string running into the next chunk is rescanned from its start
+            // there; one already too long to keep is skipped up to its NUL.
+            if (cur + len == chunk && !last_chunk) {
+                if (len >= MAX_STRING_LENGTH) {
+                    skipping = true;
+                    cur = chunk;
+                }
+                break;
+            }
+            
+            if (len >= MIN_STRING_LENGTH && len < MAX_STRING_LENGTH) {
+                bool all_printable = true;
+                for (size_t i = 0; i < len; i++) {
+                    if (!is_printable(str[i])) {
+                        all_printable = false;
+                        break;
+                    }
+                }
+                
+                if (all_printable) {
+                    // Safely convert size_t -> uint32_t to avoid implicit narrowing warning.
+                    uint32_t ulen = (len > UINT32_MAX) ? UINT32_MAX : (uint32_t)len;
+                    add_string(ctx, vmaddr + pos + cur, offset + pos + cur, str, ulen, "__cstring", true);
+                    found++;
+                }
+            }
+            cur += len + 1;
+        }
+        
+        macho_span_release(macho_ctx, data);
+        pos += cur;
+    }
+    
+    return found;
+}
+
+#pragma mark - Parallel Extraction
+
+typedef enum {
+    STRING_REGION_PRINTABLE,
+    STRING_REGION_CSTRING
+} StringRegionKind;
+
+typedef struct {
+    StringRegionKind kind;
+    MachOContext *macho_ctx;
+    uint64_t offset;
+    uint64_t base_address;
+    const char *section_name;
+    uint32_t min_length;
+    StringScanMode scan_mode;
+    
+    uint64_t *bounds;
+    StringContext **results;
+    uint32_t chunk_count;
+    uint32_t next_chunk;
+    bool failed;
+} StringRegionJob;
+
+/* Moves a nominal chunk boundary forward to the first position whose
+   preceding byte ends a run (a NUL for C strings, any non-printable byte for
+   printable runs). Scanning from there with fresh state is then exactly what
+   a single pass would have done at that point. */
+static uint64_t snap_chunk_boundary(MachOContext *macho_ctx, uint64_t offset, uint64_t size,
+                                    uint64_t pos, StringRegionKind kind) {
+    uint64_t at = pos - 1;
+    
+    while (at < size) {
+        uint64_t n = size - at;
+        if (n > 4096) n = 4096;
+        
+        const uint8_t *data = (const uint8_t*)macho_span_acquire(macho_ctx, offset + at, n);
+        if (!data) return size;
+        for (uint64_t i = 0; i < n; i++) {
+            bool ends_run = (kind == STRING_REGION_CSTRING) ? (data[i] == 0) : !is_printable((char)data[i]);
+            if (ends_run) {
+                macho_span_release(macho_ctx, data);
+                return at + i + 1;
+            }
+        }
+        macho_span_release(macho_ctx, data);
+        at += n;
+    }
+    
+    return size;
+}
+
+static void* string_region_worker(void *arg) {
+    StringRegionJob *job = (StringRegionJob*)arg;
+    
+    for (;;) {
+        if (__atomic_load_n(&job->failed, __ATOMIC_RELAXED)) break;
+        uint32_t idx = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (idx >= job->chunk_count) break;
+        
+        StringContext *local = string_context_create(256);
+        if (!local) {
+            __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+            break;
+        }
+        local->scan_mode = job->scan_mode;
+        
+        uint64_t lo = job->bounds[idx], hi = job->bounds[idx + 1];
+        if (job->kind == STRING_REGION_CSTRING) {
+            extract_cstring_range(local, job->macho_ctx, job->offset, lo, hi, job->base_address);
+        } else {
+            extract_printable_range(local, job->macho_ctx, job->offset, lo, hi, job->base_address,
+                                    job->section_name, job->min_length);
+        }
+        job->results[idx] = local;
+    }
+    
+    return NULL;
+}
+
+/* Grows ctx so it holds at least count entries. On failure ctx is unchanged. */
+static bool string_context_reserve(StringContext *ctx, uint64_t count) {
+    if (count <= ctx->capacity) return true;
+    if (count > UINT32_MAX) return false;
+    
+    uint64_t capacity = ctx->capacity ? ctx->capacity : 256;
+    while (capacity < count) capacity *= 2;
+    if (capacity > UINT32_MAX) capacity = UINT32_MAX;
+    StringInfo *strings = realloc(ctx->strings, capacity * sizeof(StringInfo));
+    if (!strings) return false;
+    ctx->strings = strings;
+    ctx->capacity = (uint32_t)capacity;
+    return true;
+}
+
+/* Moves every entry of src onto the end of ctx, re-interning the contents
+   into ctx's arena so strings shared between chunks are stored once. ctx
+   must already have room for them. */
+static void string_context_take(StringContext *ctx, StringContext *src) {
+    for (uint32_t i = 0; i < src->count; i++) {
+        StringInfo *info = &ctx->strings[ctx->count++];
+        *info = src->strings[i];
+        if (info->content) {
+            info->content = string_context_intern(ctx, info->content, (uint32_t)strlen(info->content));
+        }
+    }
+    string_context_free(src);
+}
+
+static uint32_t string_context_workers(const StringContext *ctx) {
+    if (ctx->worker_count > 0) return ctx->worker_count;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (uint32_t)cpus : 1;
+}
+
+/* Splits a region into boundary-snapped chunks, scans them on a small worker
+   pool and appends the per-chunk results in chunk order, so the output is
+   identical to the sequential scan. Returns false, leaving ctx untouched,
+   when the region is too small to be worth splitting, the pool could not be
+   set up, or a chunk could not be scanned or merged; the caller then scans
+   sequentially. */
+static bool extract_region_parallel(StringContext *ctx, StringRegionJob *job, uint64_t size, uint32_t *found) {
+    uint32_t workers = string_context_workers(ctx);
+    if (workers > STRING_MAX_WORKERS) workers = STRING_MAX_WORKERS;
+    if (workers <= 1 || size < 2 * STRING_PARALLEL_CHUNK) return false;
+    
+    uint64_t nominal = size / ((uint64_t)workers * 4);
+    if (nominal < STRING_PARALLEL_CHUNK) nominal = STRING_PARALLEL_CHUNK;
+    uint32_t chunk_count = (uint32_t)((size + nominal - 1) / nominal);
+    
+    job->bounds = (uint64_t*)malloc((chunk_count + 1) * sizeof(uint64_t));
+    job->results = (StringContext**)calloc(chunk_count, sizeof(StringContext*));
+    if (!job->bounds || !job->results) {
+        free(job->bounds);
+        free(job->results);
+        return false;
+    }
+    
+    job->bounds[0] = 0;
+    for (uint32_t i = 1; i < chunk_count; i++) {
+        uint64_t bound = snap_chunk_boundary(job->macho_ctx, job->offset, size, i * nominal, job->kind);
+        job->bounds[i] = (bound > job->bounds[i - 1]) ? bound : job->bounds[i - 1];
+    }
+    job->bounds[chunk_count] = size;
+    job->chunk_count = chunk_count;
+    job->next_chunk = 0;
+    job->failed = false;
+    
+    if (workers > chunk_count) workers = chunk_count;
+    pthread_t threads[STRING_MAX_WORKERS];
+    uint32_t started = 0;
+    for (uint32_t t = 1; t < workers; t++) {
+        if (pthread_create(&threads[started], NULL, string_region_worker, job) == 0) started++;
+    }
+    string_region_worker(job);
+    for (uint32_t t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    
+    // Every chunk must have been scanned and fit before any is merged.
+    uint64_t total = 0;
+    bool complete = !job->failed;
+    for (uint32_t i = 0; i < chunk_count && complete; i++) {
+        if (!job->results[i]) complete = false;
+        else total += job->results[i]->count;
+    }
+    if (complete) complete = string_context_reserve(ctx, (uint64_t)ctx->count + total);
+    
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        if (!job->results[i]) continue;
+        if (complete) string_context_take(ctx, job->results[i]);
+        else string_context_free(job->results[i]);
+    }
+    *found = complete ? (uint32_t)total : 0;
+    
+    free(job->bounds);
+    free(job->results);
+    return complete;
+}
+
+uint32_t string_extract_from_image(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
+                                    uint64_t size, uint64_t base_address, const char *section_name,
+                                    uint32_t min_length) {
+    if (!ctx || !macho_ctx || size == 0) return 0;
+    if (min_length < MIN_STRING_LENGTH) min_length = MIN_STRING_LENGTH;
+    
+    StringRegionJob job = {
+        .kind = STRING_REGION_PRINTABLE,
+        .macho_ctx = macho_ctx,
+        .offset = offset,
+        .base_address = base_address,
+        .section_name = section_name,
+        .min_length = min_length,
+        .scan_mode = ctx->scan_mode
+    };
+    uint32_t found = 0;
+    if (extract_region_parallel(ctx, &job, size, &found)) return found;
+    
+    return extract_printable_range(ctx, macho_ctx, offset, 0, size, base_address, section_name, min_length);
+}
+
+uint32_t string_extract_cstrings(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
                                   uint64_t size, uint64_t vmaddr) {
-    if (!ctx || !file || size == 0) return 0;
+    if (!ctx || !macho_ctx || size == 0) return 0;
+    
+    StringRegionJob job = {
+        .kind = STRING_REGION_CSTRING,
+        .macho_ctx = macho_ctx,
+        .offset = offset,
+        .base_address = vmaddr,
+        .scan_mode = ctx->scan_mode
+    };
+    uint32_t found = 0;
+    if (extract_region_parallel(ctx, &job, size, &found)) return found;
+    
+    return extract_cstring_range(ctx, macho_ctx, offset, 0, size, vmaddr);
+}
+
+uint32_t string_extract_all(StringContext *ctx, MachOContext *macho_ctx) {
+    if (!ctx || !macho_ctx) return 0;
+    uint32_t before = ctx->count;
+    
+    for (uint32_t i = 0; i < macho_ctx->section_count; i++) {
+        SectionInfo *sect = &macho_ctx->sections[i];
+        if (strcmp(sect->sectname, "__cstring") == 0) {
+            string_extract_cstrings(ctx, macho_ctx, sect->offset, sect->size, sect->addr);
+        } else if (strcmp(sect->sectname, "__ustring") == 0) {
+            string_extract_ustrings(ctx, macho_ctx, sect->offset, sect->size, sect->addr);
+        }
+    }
+    
+    for (uint32_t i = 0; i < macho_ctx->section_count; i++) {
+        SectionInfo *sect = &macho_ctx->sections[i];
+        if (strcmp(sect->sectname, "__cfstring") == 0) {
+            string_extract_cfstrings(ctx, macho_ctx, sect->offset, sect->size, sect->addr);
+        }
+    }
+    
+    for (uint32_t i = 0; i < macho_ctx->segment_count; i++) {
+        SegmentInfo *seg = &macho_ctx->segments[i];
+        if ((seg->initprot & 0x01) && seg->filesize > 0) {
+            string_extract_from_image(ctx, macho_ctx, seg->fileoff, seg->filesize,
+                                      seg->vmaddr, seg->segname, 4);
+        }
+    }
+    
+    string_context_sort(ctx);
+    return ctx->count - before;
+}
+
+void string_context_set_workers(StringContext *ctx, uint32_t worker_count) {
+    if (!ctx) return;
+    ctx->worker_count = worker_count;
+}
+
+#pragma mark - Sorting
+
+typedef struct {
+    uint64_t address;
+    uint32_t index;
+} StringSortKey;
+
+static int compare_string_sort_keys(const void *a, const void *b) {
+    const StringSortKey *ka = (const StringSortKey *)a;
+    const StringSortKey *kb = (const StringSortKey *)b;
     
-    uint8_t *data = malloc(size);
-    if (!data) return 0;
+    if (ka->address != kb->address) return (ka->address < kb->address) ? -1 : 1;
+    return (ka->index < kb->index) ? -1 : (ka->index > kb->index);
+}
+
+/* Stable: strings sharing an address keep their extraction order, so the
+   sorted output does not depend on how extraction was split up. */
+void string_context_sort(StringContext *ctx) {
+    if (!ctx || ctx->count == 0) return;
     
-    fseek(file, offset, SEEK_SET);
-    if (fread(data, 1, size, file) != size) {
-        free(data);
+    StringSortKey *keys = (StringSortKey*)malloc(ctx->count * sizeof(StringSortKey));
+    StringInfo *sorted = (StringInfo*)malloc(ctx->capacity * sizeof(StringInfo));
+    if (!keys || !sorted) {
+        free(keys);
+        free(sorted);
+        return;
+    }
+    
+    for (uint32_t i = 0; i < ctx->count; i++) {
+        keys[i].address = ctx->strings[i].address;
+        keys[i].index = i;
+    }
+    qsort(keys, ctx->count, sizeof(StringSortKey), compare_string_sort_keys);
+    
+    for (uint32_t i = 0; i < ctx->count; i++) {
+        sorted[i] = ctx->strings[keys[i].index];
+    }
+    free(ctx->strings);
+    ctx->strings = sorted;
+    free(keys);
+}
+
+#pragma mark - UTF-16 Scanning
+
+/* A UTF-16 code unit that can appear in a string on its own: printable ASCII,
+   tab/LF/CR, or a BMP character outside C1 controls, surrogates and the
+   U+FFFE/U+FFFF non-characters. Surrogates are only accepted as pairs. */
+static inline bool utf16_is_plain(uint16_t u) {
+    return (u >= 0x20 && u <= 0x7E) || u == '\t' || u == '\n' || u == '\r' ||
+           (u >= 0xA0 && u <= 0xD7FF) || (u >= 0xE000 && u <= 0xFFFD);
+}
+
+static inline uint16_t utf16_unit_at(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t utf8_encode(uint32_t cp, char *out) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/* Decodes `units` UTF-16LE code units into NUL-terminated UTF-8, replacing
+   unpaired surrogates with U+FFFD. Returns the number of bytes written. */
+static uint32_t utf16_decode(const uint8_t *data, size_t units, char *out, size_t out_size) {
+    uint32_t len = 0;
+    
+    for (size_t i = 0; i < units && len + 4 < out_size; i++) {
+        uint32_t cp = utf16_unit_at(data + i * 2);
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < units) {
+            uint16_t low = utf16_unit_at(data + (i + 1) * 2);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            } else {
+                cp = 0xFFFD;
+            }
+        } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+            cp = 0xFFFD;
+        }
+        len += utf8_encode(cp, out + len);
+    }
+    
+    out[len] = '\0';
+    return len;
+}
+
+/* UTF-16 run scanner state. The run is kept as UTF-8; `units` counts the
+   code units it covers and `pending_high` holds a high surrogate whose low
+   half has not been seen yet (possibly in the next chunk). */
+typedef struct {
+    char buffer[MAX_STRING_LENGTH];
+    uint32_t buf_pos;
+    uint32_t units;
+    uint64_t string_start;
+    uint16_t pending_high;
+} Utf16RunState;
+
+static inline void utf16_run_append(Utf16RunState *state, uint32_t cp, uint32_t units) {
+    if (state->buf_pos + 4 >= MAX_STRING_LENGTH) return;
+    state->buf_pos += utf8_encode(cp, state->buffer + state->buf_pos);
+    state->units += units;
+}
+
+static inline void utf16_run_reset(Utf16RunState *state) {
+    state->buf_pos = 0;
+    state->units = 0;
+    state->pending_high = 0;
+}
+
+/* Feeds one code unit at byte position `pos`. A run is reported when it is
+   terminated by U+0000 and spans at least min_length code units; any other
+   unit that cannot be part of a string ends the run silently. */
+static uint32_t utf16_run_step(StringContext *ctx, Utf16RunState *state, uint16_t u, uint64_t pos,
+                               uint64_t base_address, const char *section_name, uint32_t min_length) {
+    if (state->pending_high) {
+        uint16_t high = state->pending_high;
+        state->pending_high = 0;
+        if (u >= 0xDC00 && u <= 0xDFFF) {
+            utf16_run_append(state, 0x10000 + ((uint32_t)(high - 0xD800) << 10) + (u - 0xDC00), 2);
+            return 0;
+        }
+        utf16_run_reset(state);
+    }
+    
+    if (utf16_is_plain(u) || (u >= 0xD800 && u <= 0xDBFF)) {
+        if (state->units == 0) {
+            state->string_start = pos;
+        }
+        if (utf16_is_plain(u)) {
+            utf16_run_append(state, u, 1);
+        } else {
+            state->pending_high = u;
+        }
         return 0;
     }
     
     uint32_t found = 0;
-    uint64_t pos = 0;
+    if (u == 0 && state->units >= min_length) {
+        state->buffer[state->buf_pos] = '\0';
+        StringInfo *info = add_string(ctx, base_address + state->string_start, state->string_start,
+                                      state->buffer, state->buf_pos, section_name, false);
+        info->length = state->units * 2;
+        info->is_unicode = true;
+        found = 1;
+    }
+    utf16_run_reset(state);
+    return found;
+}
+
+static uint32_t scan_utf16_runs_scalar(StringContext *ctx, Utf16RunState *state,
+                                       const uint8_t *data, size_t size, uint64_t data_offset,
+                                       uint64_t base_address, const char *section_name,
+                                       uint32_t min_length) {
+    uint32_t found = 0;
     
-    while (pos < size) {
-        const char *str = (const char *)(data + pos);
-        size_t len = strnlen(str, size - pos);
+    for (size_t i = 0; i + 2 <= size; i += 2) {
+        found += utf16_run_step(ctx, state, utf16_unit_at(data + i), data_offset + i,
+                                base_address, section_name, min_length);
+    }
+    
+    return found;
+}
+
+/* Each kernel classifies 16 code units (32 bytes): bit i is set when unit i
+   passes utf16_is_plain, bit 16+i when it is a surrogate. */
+typedef uint32_t (*Utf16MaskFn)(const uint8_t *p);
+
+#if STRING_SCAN_NEON
+
+static inline uint16x8_t neon_in_range_u16(uint16x8_t v, uint16_t lo, uint16_t hi) {
+    return vandq_u16(vcgeq_u16(v, vdupq_n_u16(lo)), vcleq_u16(v, vdupq_n_u16(hi)));
+}
+
+static inline uint16x8_t neon_utf16_plain(uint16x8_t v) {
+    uint16x8_t space = vorrq_u16(vorrq_u16(vceqq_u16(v, vdupq_n_u16('\t')), vceqq_u16(v, vdupq_n_u16('\n'))),
+                                 vceqq_u16(v, vdupq_n_u16('\r')));
+    uint16x8_t bmp = vorrq_u16(neon_in_range_u16(v, 0xA0, 0xD7FF), neon_in_range_u16(v, 0xE000, 0xFFFD));
+    return vorrq_u16(vorrq_u16(neon_in_range_u16(v, 0x20, 0x7E), space), bmp);
+}
+
+static uint32_t utf16_mask_neon(const uint8_t *p) {
+    uint16x8_t lo = vreinterpretq_u16_u8(vld1q_u8(p));
+    uint16x8_t hi = vreinterpretq_u16_u8(vld1q_u8(p + 16));
+    uint8x16_t plain = vcombine_u8(vmovn_u16(neon_utf16_plain(lo)), vmovn_u16(neon_utf16_plain(hi)));
+    uint8x16_t surrogate = vcombine_u8(vmovn_u16(neon_in_range_u16(lo, 0xD800, 0xDFFF)),
+                                       vmovn_u16(neon_in_range_u16(hi, 0xD800, 0xDFFF)));
+    return neon_movemask(plain) | (neon_movemask(surrogate) << 16);
+}
+
+#elif STRING_SCAN_SSE2
+
+/* SSE2/AVX2 only have signed 16-bit compares, so units are biased by 0x8000
+   first to make unsigned ranges compare correctly. */
+#define UTF16_BIAS(u) ((short)((u) ^ 0x8000))
+
+static inline __m128i sse2_in_range_u16(__m128i biased, uint16_t lo, uint16_t hi) {
+    return _mm_and_si128(_mm_cmpgt_epi16(biased, _mm_set1_epi16(UTF16_BIAS(lo - 1))),
+                         _mm_cmplt_epi16(biased, _mm_set1_epi16(UTF16_BIAS(hi + 1))));
+}
+
+static inline __m128i sse2_utf16_plain(__m128i v, __m128i biased) {
+    __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16('\t')),
+                                              _mm_cmpeq_epi16(v, _mm_set1_epi16('\n'))),
+                                 _mm_cmpeq_epi16(v, _mm_set1_epi16('\r')));
+    __m128i bmp = _mm_or_si128(sse2_in_range_u16(biased, 0xA0, 0xD7FF), sse2_in_range_u16(biased, 0xE000, 0xFFFD));
+    return _mm_or_si128(_mm_or_si128(sse2_in_range_u16(biased, 0x20, 0x7E), space), bmp);
+}
+
+static uint32_t utf16_mask_sse2(const uint8_t *p) {
+    __m128i lo = _mm_loadu_si128((const __m128i*)p);
+    __m128i hi = _mm_loadu_si128((const __m128i*)(p + 16));
+    __m128i bias = _mm_set1_epi16(UTF16_BIAS(0));
+    __m128i lo_biased = _mm_xor_si128(lo, bias);
+    __m128i hi_biased = _mm_xor_si128(hi, bias);
+    
+    __m128i plain = _mm_packs_epi16(sse2_utf16_plain(lo, lo_biased), sse2_utf16_plain(hi, hi_biased));
+    __m128i surrogate = _mm_packs_epi16(sse2_in_range_u16(lo_biased, 0xD800, 0xDFFF),
+                                        sse2_in_range_u16(hi_biased, 0xD800, 0xDFFF));
+    return (uint32_t)_mm_movemask_epi8(plain) | ((uint32_t)_mm_movemask_epi8(surrogate) << 16);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_in_range_u16(__m256i biased, uint16_t lo, uint16_t hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi16(biased, _mm256_set1_epi16(UTF16_BIAS(lo - 1))),
+                            _mm256_cmpgt_epi16(_mm256_set1_epi16(UTF16_BIAS(hi + 1)), biased));
+}
+
+__attribute__((target("avx2")))
+static uint32_t utf16_mask_avx2(const uint8_t *p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)p);
+    __m256i biased = _mm256_xor_si256(v, _mm256_set1_epi16(UTF16_BIAS(0)));
+    __m256i space = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi16(v, _mm256_set1_epi16('\t')),
+                                                    _mm256_cmpeq_epi16(v, _mm256_set1_epi16('\n'))),
+                                    _mm256_cmpeq_epi16(v, _mm256_set1_epi16('\r')));
+    __m256i bmp = _mm256_or_si256(avx2_in_range_u16(biased, 0xA0, 0xD7FF), avx2_in_range_u16(biased, 0xE000, 0xFFFD));
+    __m256i plain = _mm256_or_si256(_mm256_or_si256(avx2_in_range_u16(biased, 0x20, 0x7E), space), bmp);
+    __m256i surrogate = avx2_in_range_u16(biased, 0xD800, 0xDFFF);
+    
+    /* packs works per 128-bit lane; restore unit order before the movemask. */
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(plain, surrogate), 0xD8);
+    return (uint32_t)_mm256_movemask_epi8(packed);
+}
+
+#endif
+
+static Utf16MaskFn utf16_mask_kernel(void) {
+#if STRING_SCAN_NEON
+    return utf16_mask_neon;
+#elif STRING_SCAN_SSE2
+    return __builtin_cpu_supports("avx2") ? utf16_mask_avx2 : utf16_mask_sse2;
+#else
+    return NULL;
+#endif
+}
+
+/* Same state machine as scan_utf16_runs_scalar, 16 code units at a time:
+   runs of plain units are appended without per-unit classification, and
+   only surrogates, terminators and other breaks go through utf16_run_step. */
+static uint32_t scan_utf16_runs_vector(StringContext *ctx, Utf16RunState *state, Utf16MaskFn mask_fn,
+                                       const uint8_t *data, size_t size, uint64_t data_offset,
+                                       uint64_t base_address, const char *section_name,
+                                       uint32_t min_length) {
+    uint32_t found = 0;
+    size_t i = 0;
+    
+    for (; i + 32 <= size; i += 32) {
+        uint32_t mask = mask_fn(data + i);
+        uint32_t plain = mask & 0xFFFF;
+        uint32_t surrogate = mask >> 16;
+        uint32_t j = 0;
         
-        if (len >= MIN_STRING_LENGTH && len < MAX_STRING_LENGTH) {
-            bool all_printable = true;
-            for (size_t i = 0; i < len; i++) {
-                if (!is_printable(str[i])) {
-                    all_printable = false;
-                    break;
+        while (j < 16) {
+            if (state->pending_high) {
+                found += utf16_run_step(ctx, state, utf16_unit_at(data + i + j * 2), data_offset + i + j * 2,
+                                        base_address, section_name, min_length);
+                j++;
+                continue;
+            }
+            
+            if (state->units == 0) {
+                uint32_t ahead = (plain | surrogate) >> j;
+                if (!ahead) break;
+                j += (uint32_t)__builtin_ctz(ahead);
+                if (!((plain >> j) & 1)) {
+                    found += utf16_run_step(ctx, state, utf16_unit_at(data + i + j * 2), data_offset + i + j * 2,
+                                            base_address, section_name, min_length);
+                    j++;
+                    continue;
                 }
+                state->string_start = data_offset + i + j * 2;
             }
             
-            if (all_printable) {
-                // Safely convert size_t -> uint32_t to avoid implicit narrowing warning.
-                uint32_t ulen = (len > UINT32_MAX) ? UINT32_MAX : (uint32_t)len;
-                add_string(ctx, vmaddr + pos, offset + pos, str, ulen, "__cstring", true);
-                found++;
+            uint32_t stops = (~plain & 0xFFFF) >> j;
+            uint32_t run_end = stops ? j + (uint32_t)__builtin_ctz(stops) : 16;
+            for (uint32_t k = j; k < run_end; k++) {
+                utf16_run_append(state, utf16_unit_at(data + i + k * 2), 1);
             }
+            if (run_end == 16) break;
+            
+            found += utf16_run_step(ctx, state, utf16_unit_at(data + i + run_end * 2), data_offset + i + run_end * 2,
+                                    base_address, section_name, min_length);
+            j = run_end + 1;
         }
-        pos += len + 1;
     }
     
-    free(data);
+    return found + scan_utf16_runs_scalar(ctx, state, data + i, size - i, data_offset + i,
+                                          base_address, section_name, min_length);
+}
+
+static uint32_t scan_utf16_runs(StringContext *ctx, Utf16RunState *state,
+                                const uint8_t *data, size_t size, uint64_t data_offset,
+                                uint64_t base_address, const char *section_name,
+                                uint32_t min_length) {
+    Utf16MaskFn mask_fn = (ctx->scan_mode == STRING_SCAN_SCALAR) ? NULL : utf16_mask_kernel();
+    if (!mask_fn) {
+        return scan_utf16_runs_scalar(ctx, state, data, size, data_offset,
+                                      base_address, section_name, min_length);
+    }
+    return scan_utf16_runs_vector(ctx, state, mask_fn, data, size, data_offset,
+                                  base_address, section_name, min_length);
+}
+
+uint32_t string_extract_utf16_from_data(StringContext *ctx, const uint8_t *data, size_t size,
+                                         uint64_t base_address, const char *section_name,
+                                         uint32_t min_length) {
+    if (!ctx || !data || size < 2) return 0;
+    if (min_length < MIN_STRING_LENGTH) min_length = MIN_STRING_LENGTH;
+    
+    Utf16RunState state;
+    utf16_run_reset(&state);
+    state.string_start = 0;
+    
+    return scan_utf16_runs(ctx, &state, data, size, 0, base_address, section_name, min_length);
+}
+
+uint32_t string_extract_ustrings(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
+                                  uint64_t size, uint64_t vmaddr) {
+    if (!ctx || !macho_ctx || size < 2) return 0;
+    
+    Utf16RunState state;
+    utf16_run_reset(&state);
+    state.string_start = 0;
+    
+    // Positions are file offsets here, matching string_extract_cstrings.
+    uint32_t found = 0;
+    for (uint64_t pos = 0; pos + 2 <= size; pos += STRING_SCAN_CHUNK) {
+        uint64_t chunk = size - pos;
+        if (chunk > STRING_SCAN_CHUNK) chunk = STRING_SCAN_CHUNK;
+        
+        const uint8_t *data = (const uint8_t*)macho_span_acquire(macho_ctx, offset + pos, chunk);
+        if (!data) break;
+        found += scan_utf16_runs(ctx, &state, data, (size_t)chunk, offset + pos, vmaddr - offset,
+                                 "__ustring", MIN_STRING_LENGTH);
+        macho_span_release(macho_ctx, data);
+    }
+    
     return found;
 }
 
-static int compare_strings_by_address(const void *a, const void *b) {
-    const StringInfo *sa = (const StringInfo *)a;
-    const StringInfo *sb = (const StringInfo *)b;
+#pragma mark - CFString Decoding
+
+#define CFSTRING_FLAG_UNICODE 0x10
+
+static const SectionInfo* section_for_address(MachOContext *macho_ctx, uint64_t vmaddr) {
+    for (uint32_t i = 0; i < macho_ctx->section_count; i++) {
+        const SectionInfo *sect = &macho_ctx->sections[i];
+        if (sect->offset != 0 && vmaddr >= sect->addr && vmaddr < sect->addr + sect->size) {
+            return sect;
+        }
+    }
+    return NULL;
+}
+
+/* CFString data pointers are plain addresses in classic images. With chained
+   fixups they hold a rebase instead, whose target is either the low 36 bits
+   (DYLD_CHAINED_PTR_64) or a 32-bit offset from the image base (the _OFFSET
+   and arm64e formats). Returns 0 when no reading lands in a file section. */
+static uint64_t resolve_image_pointer(MachOContext *macho_ctx, uint64_t raw) {
+    if (section_for_address(macho_ctx, raw)) return raw;
+    
+    uint64_t target = raw & 0xFFFFFFFFFULL;
+    if (section_for_address(macho_ctx, target)) return target;
+    
+    for (uint32_t i = 0; i < macho_ctx->segment_count; i++) {
+        const SegmentInfo *seg = &macho_ctx->segments[i];
+        if (seg->fileoff == 0 && seg->filesize > 0) {
+            target = seg->vmaddr + (raw & 0xFFFFFFFFULL);
+            return section_for_address(macho_ctx, target) ? target : 0;
+        }
+    }
     
-    if (sa->address < sb->address) return -1;
-    if (sa->address > sb->address) return 1;
     return 0;
 }
 
-void string_context_sort(StringContext *ctx) {
-    if (!ctx || ctx->count == 0) return;
-    qsort(ctx->strings, ctx->count, sizeof(StringInfo), compare_strings_by_address);
+/* Tags every entry at `address` with the CFString that references it.
+   `keys` is the sorted address index of the entries already extracted. */
+static bool tag_cfstring_storage(StringContext *ctx, const StringSortKey *keys, uint32_t key_count,
+                                 uint64_t address, uint64_t cfstring_address) {
+    uint32_t lo = 0, hi = key_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (keys[mid].address < address) lo = mid + 1;
+        else hi = mid;
+    }
+    
+    bool tagged = false;
+    for (; lo < key_count && keys[lo].address == address; lo++) {
+        ctx->strings[keys[lo].index].cfstring_address = cfstring_address;
+        tagged = true;
+    }
+    return tagged;
 }
 
-void string_context_free(StringContext *ctx) {
-    if (!ctx) return;
+static bool add_cfstring_storage(StringContext *ctx, MachOContext *macho_ctx, uint64_t address,
+                                 uint64_t units, bool unicode, uint64_t cfstring_address) {
+    const SectionInfo *sect = section_for_address(macho_ctx, address);
+    if (!sect || units == 0) return false;
+    
+    uint64_t bytes = unicode ? units * 2 : units;
+    uint64_t available = sect->addr + sect->size - address;
+    if (bytes > available) bytes = unicode ? available & ~1ULL : available;
+    if (bytes > 2 * MAX_STRING_LENGTH) bytes = 2 * MAX_STRING_LENGTH;
+    if (bytes == 0) return false;
+    
+    uint64_t file_offset = sect->offset + (address - sect->addr);
+    const uint8_t *data = (const uint8_t*)macho_span_acquire(macho_ctx, file_offset, bytes);
+    if (!data) return false;
+    
+    char content[MAX_STRING_LENGTH];
+    uint32_t len;
+    if (unicode) {
+        len = utf16_decode(data, (size_t)(bytes / 2), content, sizeof(content));
+    } else {
+        len = (uint32_t)(bytes < MAX_STRING_LENGTH ? bytes : MAX_STRING_LENGTH - 1);
+        memcpy(content, data, len);
+    }
+    macho_span_release(macho_ctx, data);
+    
+    StringInfo *info = add_string(ctx, address, file_offset, content, len, sect->sectname, !unicode);
+    info->length = (uint32_t)bytes;
+    info->is_unicode = unicode;
+    info->cfstring_address = cfstring_address;
+    return true;
+}
+
+uint32_t string_extract_cfstrings(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
+                                   uint64_t size, uint64_t vmaddr) {
+    if (!ctx || !macho_ctx || size == 0) return 0;
     
-    if (ctx->strings) {
-        for (uint32_t i = 0; i < ctx->count; i++) {
-            if (ctx->strings[i].content) {
-                free(ctx->strings[i].content);
+    bool is_64bit = macho_ctx->header.is_64bit;
+    uint32_t entry_size = is_64bit ? 32 : 16;
+    
+    uint32_t key_count = ctx->count;
+    StringSortKey *keys = (StringSortKey*)malloc((key_count ? key_count : 1) * sizeof(StringSortKey));
+    if (!keys) return 0;
+    for (uint32_t i = 0; i < key_count; i++) {
+        keys[i].address = ctx->strings[i].address;
+        keys[i].index = i;
+    }
+    qsort(keys, key_count, sizeof(StringSortKey), compare_string_sort_keys);
+    
+    uint32_t found = 0;
+    uint64_t chunk_size = STRING_SCAN_CHUNK - (STRING_SCAN_CHUNK % entry_size);
+    for (uint64_t pos = 0; pos + entry_size <= size; pos += chunk_size) {
+        uint64_t chunk = size - pos;
+        if (chunk > chunk_size) chunk = chunk_size;
+        chunk -= chunk % entry_size;
+        
+        const uint8_t *data = (const uint8_t*)macho_span_acquire(macho_ctx, offset + pos, chunk);
+        if (!data) break;
+        
+        for (uint64_t cur = 0; cur < chunk; cur += entry_size) {
+            const uint8_t *entry = data + cur;
+            uint32_t flags;
+            uint64_t raw_ptr = 0, length = 0;
+            
+            // { isa, flags, data, length } with pointer-sized fields.
+            if (is_64bit) {
+                memcpy(&flags, entry + 8, sizeof(flags));
+                memcpy(&raw_ptr, entry + 16, sizeof(raw_ptr));
+                memcpy(&length, entry + 24, sizeof(length));
+            } else {
+                uint32_t ptr32, len32;
+                memcpy(&flags, entry + 4, sizeof(flags));
+                memcpy(&ptr32, entry + 8, sizeof(ptr32));
+                memcpy(&len32, entry + 12, sizeof(len32));
+                raw_ptr = ptr32;
+                length = len32;
+            }
+            
+            uint64_t target = resolve_image_pointer(macho_ctx, raw_ptr);
+            if (!target) continue;
+            
+            uint64_t cfstring_address = vmaddr + pos + cur;
+            bool unicode = (flags & CFSTRING_FLAG_UNICODE) != 0;
+            if (tag_cfstring_storage(ctx, keys, key_count, target, cfstring_address) ||
+                add_cfstring_storage(ctx, macho_ctx, target, length, unicode, cfstring_address)) {
+                found++;
             }
         }
-        free(ctx->strings);
+        
+        macho_span_release(macho_ctx, data);
+    }
+    
+    free(keys);
+    return found;
+}
+
+void string_context_free(StringContext *ctx) {
+    if (!ctx) return;
+    
+    struct StringArenaBlock *block = ctx->arena;
+    while (block) {
+        struct StringArenaBlock *next = block->next;
+        free(block);
+        block = next;
     }
     
+    free(ctx->intern_slots);
+    free(ctx->strings);
     free(ctx);
 }
 
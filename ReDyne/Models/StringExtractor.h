@@ -4,23 +4,40 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "MachOHeader.h"
 
 #pragma mark - String Information
 
 typedef struct {
     uint64_t address;
     uint64_t offset;
-    char *content;
+    const char *content;    // interned in the context's arena
     uint32_t length;
     char section[64];
     bool is_cstring;
     bool is_unicode;
+    uint64_t cfstring_address;
 } StringInfo;
 
+/* STRING_SCAN_AUTO uses the widest printable-run kernel the CPU supports
+   (AVX2/SSE2 or NEON); STRING_SCAN_SCALAR forces the byte-at-a-time path. */
+typedef enum {
+    STRING_SCAN_AUTO = 0,
+    STRING_SCAN_SCALAR
+} StringScanMode;
+
 typedef struct {
     StringInfo *strings;
     uint32_t count;
     uint32_t capacity;
+    StringScanMode scan_mode;
+    uint32_t worker_count;
+    
+    struct StringArenaBlock *arena;
+    struct StringInternSlot *intern_slots;
+    uint32_t intern_mask;
+    uint32_t intern_count;
+    size_t arena_bytes;
 } StringContext;
 
 #pragma mark - Function Declarations
@@ -31,14 +48,44 @@ uint32_t string_extract_from_data(StringContext *ctx, const uint8_t *data, size_
                                    uint64_t base_address, const char *section_name, 
                                    uint32_t min_length);
 
-uint32_t string_extract_cstrings(StringContext *ctx, FILE *file, uint64_t offset, 
+uint32_t string_extract_from_image(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
+                                    uint64_t size, uint64_t base_address, const char *section_name,
+                                    uint32_t min_length);
+
+uint32_t string_extract_cstrings(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset, 
+                                  uint64_t size, uint64_t vmaddr);
+
+/* UTF-16LE counterparts of string_extract_from_data and the __cstring pass.
+   Results are converted to UTF-8 with is_unicode set; their length is the
+   size of the UTF-16 storage in bytes. */
+uint32_t string_extract_utf16_from_data(StringContext *ctx, const uint8_t *data, size_t size,
+                                         uint64_t base_address, const char *section_name,
+                                         uint32_t min_length);
+
+uint32_t string_extract_ustrings(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
                                   uint64_t size, uint64_t vmaddr);
 
+/* Decodes a __cfstring section. Strings already extracted at a CFString's
+   backing address get its cfstring_address; storage no earlier pass found
+   is added. Run this after the __cstring/__ustring passes. */
+uint32_t string_extract_cfstrings(StringContext *ctx, MachOContext *macho_ctx, uint64_t offset,
+                                   uint64_t size, uint64_t vmaddr);
+
+/* The app's full pass over a parsed image: __cstring/__ustring, then
+   __cfstring, then every readable segment (minimum length 4), then sort. */
+uint32_t string_extract_all(StringContext *ctx, MachOContext *macho_ctx);
+
+/* Regions of 2 MB or more are split across worker_count threads
+   (0 = one per online CPU, 1 = sequential); results are identical either way. */
+void string_context_set_workers(StringContext *ctx, uint32_t worker_count);
+
 void string_context_sort(StringContext *ctx);
 
 void string_context_free(StringContext *ctx);
 
 bool is_printable(char c);
 
+const char* string_scan_kernel_name(void);
+
 #endif
 
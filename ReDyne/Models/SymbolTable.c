@@ -1,8 +1,9 @@
 #include "SymbolTable.h"
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
-#include <mach-o/nlist.h>
-#include <mach-o/stab.h>
+#include <unistd.h>
+#include <pthread.h>
 
 #pragma mark - String Helpers
 
@@ -29,6 +30,19 @@ const char* symbol_scope_string(SymbolScope scope) {
 
 #pragma mark - Context Management
 
+static void symbol_table_drop_indices(SymbolTableContext *ctx) {
+    free(ctx->name_slots);
+    free(ctx->name_slot_hashes);
+    free(ctx->address_index);
+    free(ctx->range_index);
+    ctx->name_slots = NULL;
+    ctx->name_slot_hashes = NULL;
+    ctx->name_slot_mask = 0;
+    ctx->address_index = NULL;
+    ctx->range_index = NULL;
+    ctx->range_count = 0;
+}
+
 SymbolTableContext* symbol_table_create(MachOContext *macho_ctx) {
     if (!macho_ctx || macho_ctx->nsyms == 0) return NULL;
     
@@ -50,14 +64,10 @@ SymbolTableContext* symbol_table_create(MachOContext *macho_ctx) {
 void symbol_table_free(SymbolTableContext *ctx) {
     if (!ctx) return;
     
-    if (ctx->symbols) {
-        for (uint32_t i = 0; i < ctx->symbol_count; i++) {
-            if (ctx->symbols[i].name) free(ctx->symbols[i].name);
-        }
-        free(ctx->symbols);
-    }
+    if (ctx->symbols) free(ctx->symbols);
     
-    if (ctx->string_table) free(ctx->string_table);
+    macho_span_release(ctx->macho_ctx, ctx->string_table);
+    symbol_table_drop_indices(ctx);
     if (ctx->defined_indices) free(ctx->defined_indices);
     if (ctx->undefined_indices) free(ctx->undefined_indices);
     if (ctx->external_indices) free(ctx->external_indices);
@@ -69,146 +79,200 @@ void symbol_table_free(SymbolTableContext *ctx) {
 #pragma mark - String Table Loading
 
 bool symbol_table_load_strings(SymbolTableContext *ctx) {
-    if (!ctx || !ctx->macho_ctx || !ctx->macho_ctx->file) return false;
+    if (!ctx || !ctx->macho_ctx) return false;
     
     MachOContext *mctx = ctx->macho_ctx;
     if (mctx->strsize == 0) return false;
     
-    ctx->string_table_size = mctx->strsize;
-    ctx->string_table = (char*)malloc(ctx->string_table_size);
-    if (!ctx->string_table) return false;
-    
-    fseek(mctx->file, mctx->stroff, SEEK_SET);
-    size_t read = fread(ctx->string_table, 1, ctx->string_table_size, mctx->file);
+    const char *strings = (const char*)macho_span_acquire(mctx, mctx->stroff, mctx->strsize);
+    if (!strings) return false;
     
-    if (read != ctx->string_table_size) {
-        free(ctx->string_table);
-        ctx->string_table = NULL;
-        return false;
-    }
+    macho_span_release(mctx, ctx->string_table);
+    ctx->string_table = strings;
+    ctx->string_table_size = mctx->strsize;
+    ctx->string_table_terminated = (strings[mctx->strsize - 1] == '\0');
     
     return true;
 }
 
 const char* symbol_table_get_string(SymbolTableContext *ctx, uint32_t strx) {
     if (!ctx || !ctx->string_table || strx >= ctx->string_table_size) return NULL;
-    return ctx->string_table + strx;
+    
+    const char *str = ctx->string_table + strx;
+    if (!ctx->string_table_terminated && !memchr(str, '\0', ctx->string_table_size - strx)) return NULL;
+    return str;
 }
 
 #pragma mark - Symbol Parsing
 
-bool symbol_table_parse(SymbolTableContext *ctx) {
-    if (!ctx || !ctx->macho_ctx || !ctx->macho_ctx->file) return false;
-    
-    if (!symbol_table_load_strings(ctx)) return false;
-    
+#define SYMBOL_NLIST_BATCH 4096
+#define SYMBOL_PARALLEL_THRESHOLD (256 * 1024)
+#define SYMBOL_MAX_DECODE_THREADS 8
+
+/* Decodes nlist entries [first, first + count) from a contiguous block of raw
+   entries. Names are borrowed from the pinned string table, never copied. */
+static void symbol_table_decode_range(SymbolTableContext *ctx, const uint8_t *entries,
+                                      uint32_t first, uint32_t count) {
     MachOContext *mctx = ctx->macho_ctx;
-    
-    fseek(mctx->file, mctx->symtab_offset, SEEK_SET);
-    
-    if (mctx->header.is_64bit) {
-        for (uint32_t i = 0; i < ctx->symbol_count; i++) {
+    bool is_64bit = mctx->header.is_64bit;
+    bool is_swapped = mctx->header.is_swapped;
+    bool is_arm = (mctx->header.cputype == CPU_TYPE_ARM);
+    size_t entry_size = is_64bit ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    
+    for (uint32_t k = 0; k < count; k++) {
+        const uint8_t *entry = entries + (size_t)k * entry_size;
+        uint32_t strx;
+        uint8_t n_type, n_sect;
+        uint16_t n_desc;
+        uint64_t n_value;
+        
+        if (is_64bit) {
             struct nlist_64 nlist;
-            if (fread(&nlist, sizeof(struct nlist_64), 1, mctx->file) != 1) return false;
-            
-            if (mctx->header.is_swapped) {
-                nlist.n_un.n_strx = swap_uint32(nlist.n_un.n_strx);
-                nlist.n_desc = swap_uint16(nlist.n_desc);
-                nlist.n_value = swap_uint64(nlist.n_value);
-            }
-            
-            SymbolInfo *sym = &ctx->symbols[i];
-            
-            const char *name = symbol_table_get_string(ctx, nlist.n_un.n_strx);
-            if (name) {
-                sym->name = strdup(name);
-            } else {
-                sym->name = strdup("");
-            }
-            
-            sym->n_type = nlist.n_type;
-            sym->desc = nlist.n_desc;
-            sym->address = nlist.n_value;
-            sym->section = nlist.n_sect;
-            
-            uint8_t type_mask = nlist.n_type & N_TYPE;
-            switch (type_mask) {
-                case N_UNDF: sym->type = SYMBOL_TYPE_UNDEFINED; break;
-                case N_ABS: sym->type = SYMBOL_TYPE_ABSOLUTE; break;
-                case N_SECT: sym->type = SYMBOL_TYPE_SECTION; break;
-                case N_PBUD: sym->type = SYMBOL_TYPE_PREBOUND; break;
-                case N_INDR: sym->type = SYMBOL_TYPE_INDIRECT; break;
-                default: sym->type = SYMBOL_TYPE_UNDEFINED; break;
-            }
-            
-            sym->is_external = (nlist.n_type & N_EXT) != 0;
-            sym->is_debug = (nlist.n_type & N_STAB) != 0;
-            sym->is_defined = (type_mask != N_UNDF);
-            sym->is_weak = ((nlist.n_desc & N_WEAK_DEF) != 0) || ((nlist.n_desc & N_WEAK_REF) != 0);
-            
-            if (sym->is_weak) {
-                sym->scope = SYMBOL_SCOPE_WEAK;
-            } else if (sym->is_external) {
-                sym->scope = SYMBOL_SCOPE_EXTERNAL;
-            } else if (nlist.n_type & N_PEXT) {
-                sym->scope = SYMBOL_SCOPE_GLOBAL;
-            } else {
-                sym->scope = SYMBOL_SCOPE_LOCAL;
-            }
-            
-            if (mctx->header.cputype == CPU_TYPE_ARM && (nlist.n_desc & N_ARM_THUMB_DEF)) {
-                sym->is_thumb = true;
-            }
-            sym->size = 0;
-        }
-    } else {
-        for (uint32_t i = 0; i < ctx->symbol_count; i++) {
+            memcpy(&nlist, entry, sizeof(struct nlist_64));
+            strx = nlist.n_un.n_strx;
+            n_type = nlist.n_type;
+            n_sect = nlist.n_sect;
+            n_desc = nlist.n_desc;
+            n_value = is_swapped ? swap_uint64(nlist.n_value) : nlist.n_value;
+        } else {
             struct nlist nlist;
-            if (fread(&nlist, sizeof(struct nlist), 1, mctx->file) != 1) return false;
-            
-            if (mctx->header.is_swapped) {
-                nlist.n_un.n_strx = swap_uint32(nlist.n_un.n_strx);
-                nlist.n_desc = swap_uint16(nlist.n_desc);
-                nlist.n_value = swap_uint32(nlist.n_value);
-            }
-            
-            SymbolInfo *sym = &ctx->symbols[i];
-            const char *name = symbol_table_get_string(ctx, nlist.n_un.n_strx);
-            sym->name = name ? strdup(name) : strdup("");
-            
-            sym->n_type = nlist.n_type;
-            sym->desc = nlist.n_desc;
-            sym->address = nlist.n_value;
-            sym->section = nlist.n_sect;
-            
-            uint8_t type_mask = nlist.n_type & N_TYPE;
-            switch (type_mask) {
-                case N_UNDF: sym->type = SYMBOL_TYPE_UNDEFINED; break;
-                case N_ABS: sym->type = SYMBOL_TYPE_ABSOLUTE; break;
-                case N_SECT: sym->type = SYMBOL_TYPE_SECTION; break;
-                case N_PBUD: sym->type = SYMBOL_TYPE_PREBOUND; break;
-                case N_INDR: sym->type = SYMBOL_TYPE_INDIRECT; break;
-                default: sym->type = SYMBOL_TYPE_UNDEFINED; break;
-            }
-            
-            sym->is_external = (nlist.n_type & N_EXT) != 0;
-            sym->is_debug = (nlist.n_type & N_STAB) != 0;
-            sym->is_defined = (type_mask != N_UNDF);
-            sym->is_weak = ((nlist.n_desc & N_WEAK_DEF) != 0) || ((nlist.n_desc & N_WEAK_REF) != 0);
-            
-            if (sym->is_weak) {
-                sym->scope = SYMBOL_SCOPE_WEAK;
-            } else if (sym->is_external) {
-                sym->scope = SYMBOL_SCOPE_EXTERNAL;
-            } else {
-                sym->scope = SYMBOL_SCOPE_LOCAL;
-            }
+            memcpy(&nlist, entry, sizeof(struct nlist));
+            strx = nlist.n_un.n_strx;
+            n_type = nlist.n_type;
+            n_sect = nlist.n_sect;
+            n_desc = (uint16_t)nlist.n_desc;
+            n_value = is_swapped ? swap_uint32(nlist.n_value) : nlist.n_value;
+        }
+        if (is_swapped) {
+            strx = swap_uint32(strx);
+            n_desc = swap_uint16(n_desc);
+        }
+        
+        SymbolInfo *sym = &ctx->symbols[first + k];
+        
+        const char *name = symbol_table_get_string(ctx, strx);
+        sym->name = name ? name : "";
+        
+        sym->n_type = n_type;
+        sym->desc = n_desc;
+        sym->address = n_value;
+        sym->section = n_sect;
+        
+        uint8_t type_mask = n_type & N_TYPE;
+        switch (type_mask) {
+            case N_UNDF: sym->type = SYMBOL_TYPE_UNDEFINED; break;
+            case N_ABS: sym->type = SYMBOL_TYPE_ABSOLUTE; break;
+            case N_SECT: sym->type = SYMBOL_TYPE_SECTION; break;
+            case N_PBUD: sym->type = SYMBOL_TYPE_PREBOUND; break;
+            case N_INDR: sym->type = SYMBOL_TYPE_INDIRECT; break;
+            default: sym->type = SYMBOL_TYPE_UNDEFINED; break;
+        }
+        
+        sym->is_external = (n_type & N_EXT) != 0;
+        sym->is_debug = (n_type & N_STAB) != 0;
+        sym->is_defined = (type_mask != N_UNDF);
+        sym->is_weak = ((n_desc & N_WEAK_DEF) != 0) || ((n_desc & N_WEAK_REF) != 0);
+        
+        if (sym->is_weak) {
+            sym->scope = SYMBOL_SCOPE_WEAK;
+        } else if (sym->is_external) {
+            sym->scope = SYMBOL_SCOPE_EXTERNAL;
+        } else if (is_64bit && (n_type & N_PEXT)) {
+            sym->scope = SYMBOL_SCOPE_GLOBAL;
+        } else {
+            sym->scope = SYMBOL_SCOPE_LOCAL;
         }
+        
+        sym->is_thumb = is_64bit && is_arm && (n_desc & N_ARM_THUMB_DEF);
+        sym->size = 0;
+    }
+}
+
+/* Streams symbols [first, first + count) through the windowed reader one
+   batch at a time, so only SYMBOL_NLIST_BATCH raw entries are pinned. */
+static bool symbol_table_decode_symbols(SymbolTableContext *ctx, uint32_t first, uint32_t count) {
+    MachOContext *mctx = ctx->macho_ctx;
+    size_t entry_size = mctx->header.is_64bit ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    
+    for (uint32_t done = 0; done < count; done += SYMBOL_NLIST_BATCH) {
+        uint32_t batch = count - done;
+        if (batch > SYMBOL_NLIST_BATCH) batch = SYMBOL_NLIST_BATCH;
+        
+        uint64_t offset = mctx->symtab_offset + (uint64_t)(first + done) * entry_size;
+        const uint8_t *entries = (const uint8_t*)macho_span_acquire(mctx, offset, (uint64_t)batch * entry_size);
+        if (!entries) return false;
+        
+        symbol_table_decode_range(ctx, entries, first + done, batch);
+        macho_span_release(mctx, entries);
     }
     
     return true;
 }
 
+typedef struct {
+    SymbolTableContext *ctx;
+    uint32_t first;
+    uint32_t count;
+    bool ok;
+} SymbolDecodeJob;
+
+static void* symbol_decode_worker(void *arg) {
+    SymbolDecodeJob *job = (SymbolDecodeJob*)arg;
+    job->ok = symbol_table_decode_symbols(job->ctx, job->first, job->count);
+    return NULL;
+}
+
+bool symbol_table_parse_parallel(SymbolTableContext *ctx, uint32_t thread_count) {
+    if (!ctx || !ctx->macho_ctx || !ctx->symbols) return false;
+    
+    if (!symbol_table_load_strings(ctx)) return false;
+    symbol_table_drop_indices(ctx);
+    
+    if (thread_count > SYMBOL_MAX_DECODE_THREADS) thread_count = SYMBOL_MAX_DECODE_THREADS;
+    if (thread_count > ctx->symbol_count / SYMBOL_NLIST_BATCH) thread_count = ctx->symbol_count / SYMBOL_NLIST_BATCH;
+    if (thread_count <= 1) return symbol_table_decode_symbols(ctx, 0, ctx->symbol_count);
+    
+    /* Each worker owns a disjoint slice of ctx->symbols; the string table is
+       shared read-only and the window cache is internally locked. */
+    SymbolDecodeJob jobs[SYMBOL_MAX_DECODE_THREADS];
+    pthread_t threads[SYMBOL_MAX_DECODE_THREADS];
+    bool started[SYMBOL_MAX_DECODE_THREADS] = {false};
+    uint32_t per_thread = (ctx->symbol_count + thread_count - 1) / thread_count;
+    
+    for (uint32_t t = 0; t < thread_count; t++) {
+        uint32_t first = t * per_thread;
+        jobs[t].ctx = ctx;
+        jobs[t].first = first;
+        jobs[t].count = (first < ctx->symbol_count) ? ctx->symbol_count - first : 0;
+        if (jobs[t].count > per_thread) jobs[t].count = per_thread;
+        jobs[t].ok = false;
+        started[t] = (pthread_create(&threads[t], NULL, symbol_decode_worker, &jobs[t]) == 0);
+        if (!started[t]) symbol_decode_worker(&jobs[t]);
+    }
+    
+    bool ok = true;
+    for (uint32_t t = 0; t < thread_count; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+        ok = ok && jobs[t].ok;
+    }
+    
+    return ok;
+}
+
+bool symbol_table_parse(SymbolTableContext *ctx) {
+    if (!ctx || !ctx->macho_ctx) return false;
+    
+    if (ctx->symbol_count >= SYMBOL_PARALLEL_THRESHOLD) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        return symbol_table_parse_parallel(ctx, cpus > 0 ? (uint32_t)cpus : 1);
+    }
+    
+    if (!symbol_table_load_strings(ctx)) return false;
+    symbol_table_drop_indices(ctx);
+    
+    return symbol_table_decode_symbols(ctx, 0, ctx->symbol_count);
+}
+
 #pragma mark - Symbol Categorization
 
 bool symbol_table_categorize(SymbolTableContext *ctx) {
@@ -276,11 +340,158 @@ uint32_t symbol_table_extract_functions(SymbolTableContext *ctx) {
     return ctx->function_count;
 }
 
+#pragma mark - Lookup Indexes
+
+static uint32_t symbol_name_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char*)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+/* Open addressing with linear probing. Slots hold symbol index + 1 so zero
+   marks an empty slot; only the first symbol of each name is inserted, which
+   keeps the old "lowest index wins" behaviour of the linear search. */
+static bool symbol_table_build_name_index(SymbolTableContext *ctx) {
+    uint32_t capacity = 16;
+    while (capacity < ctx->symbol_count * 2 && capacity < (1u << 31)) capacity <<= 1;
+    
+    ctx->name_slots = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    ctx->name_slot_hashes = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+    if (!ctx->name_slots || !ctx->name_slot_hashes) {
+        free(ctx->name_slots);
+        free(ctx->name_slot_hashes);
+        ctx->name_slots = NULL;
+        ctx->name_slot_hashes = NULL;
+        return false;
+    }
+    ctx->name_slot_mask = capacity - 1;
+    
+    for (uint32_t i = 0; i < ctx->symbol_count; i++) {
+        const char *name = ctx->symbols[i].name;
+        if (!name) continue;
+        
+        uint32_t hash = symbol_name_hash(name);
+        uint32_t slot = hash & ctx->name_slot_mask;
+        while (ctx->name_slots[slot]) {
+            uint32_t existing = ctx->name_slots[slot] - 1;
+            if (ctx->name_slot_hashes[slot] == hash && strcmp(ctx->symbols[existing].name, name) == 0) break;
+            slot = (slot + 1) & ctx->name_slot_mask;
+        }
+        if (!ctx->name_slots[slot]) {
+            ctx->name_slots[slot] = i + 1;
+            ctx->name_slot_hashes[slot] = hash;
+        }
+    }
+    
+    return true;
+}
+
+static int compare_address_entries(const void *a, const void *b) {
+    const SymbolAddressEntry *ea = (const SymbolAddressEntry*)a;
+    const SymbolAddressEntry *eb = (const SymbolAddressEntry*)b;
+    if (ea->address != eb->address) return (ea->address < eb->address) ? -1 : 1;
+    return (ea->symbol < eb->symbol) ? -1 : (ea->symbol > eb->symbol);
+}
+
+static int compare_range_entries(const void *a, const void *b) {
+    const SymbolRangeEntry *ea = (const SymbolRangeEntry*)a;
+    const SymbolRangeEntry *eb = (const SymbolRangeEntry*)b;
+    if (ea->start != eb->start) return (ea->start < eb->start) ? -1 : 1;
+    return (ea->symbol < eb->symbol) ? -1 : (ea->symbol > eb->symbol);
+}
+
+/* address_index orders every symbol by (address, index) for nearest-preceding
+   queries. range_index covers defined section symbols only; symbols without
+   an n_desc size extend to the next higher symbol in the same section, or to
+   the end of that section. */
+static bool symbol_table_build_address_index(SymbolTableContext *ctx) {
+    ctx->address_index = (SymbolAddressEntry*)malloc((size_t)ctx->symbol_count * sizeof(SymbolAddressEntry));
+    if (!ctx->address_index) return false;
+    
+    uint32_t range_count = 0;
+    for (uint32_t i = 0; i < ctx->symbol_count; i++) {
+        ctx->address_index[i].address = ctx->symbols[i].address;
+        ctx->address_index[i].symbol = i;
+        
+        const SymbolInfo *sym = &ctx->symbols[i];
+        if (sym->type == SYMBOL_TYPE_SECTION && sym->address > 0 && !sym->is_debug) range_count++;
+    }
+    qsort(ctx->address_index, ctx->symbol_count, sizeof(SymbolAddressEntry), compare_address_entries);
+    
+    if (range_count == 0) return true;
+    ctx->range_index = (SymbolRangeEntry*)malloc((size_t)range_count * sizeof(SymbolRangeEntry));
+    if (!ctx->range_index) return false;
+    
+    for (uint32_t i = 0; i < ctx->symbol_count; i++) {
+        const SymbolInfo *sym = &ctx->symbols[i];
+        if (sym->type != SYMBOL_TYPE_SECTION || sym->address == 0 || sym->is_debug) continue;
+        SymbolRangeEntry *entry = &ctx->range_index[ctx->range_count++];
+        entry->start = sym->address;
+        entry->end = 0;
+        entry->symbol = i;
+    }
+    qsort(ctx->range_index, ctx->range_count, sizeof(SymbolRangeEntry), compare_range_entries);
+    
+    MachOContext *mctx = ctx->macho_ctx;
+    for (uint32_t i = 0; i < ctx->range_count; i++) {
+        SymbolRangeEntry *entry = &ctx->range_index[i];
+        const SymbolInfo *sym = &ctx->symbols[entry->symbol];
+        
+        if (sym->size > 0) {
+            entry->end = entry->start + sym->size;
+            continue;
+        }
+        
+        uint64_t section_end = 0;
+        if (mctx && sym->section > 0 && sym->section <= mctx->section_count) {
+            const SectionInfo *sect = &mctx->sections[sym->section - 1];
+            section_end = sect->addr + sect->size;
+        }
+        
+        uint64_t next = 0;
+        for (uint32_t j = i + 1; j < ctx->range_count; j++) {
+            if (ctx->range_index[j].start > entry->start) {
+                if (ctx->symbols[ctx->range_index[j].symbol].section == sym->section) {
+                    next = ctx->range_index[j].start;
+                }
+                break;
+            }
+        }
+        
+        if (next && (!section_end || next < section_end)) entry->end = next;
+        else if (section_end > entry->start) entry->end = section_end;
+        else entry->end = entry->start + 1;
+    }
+    
+    return true;
+}
+
+void symbol_table_build_indices(SymbolTableContext *ctx) {
+    if (!ctx || !ctx->symbols) return;
+    if (!ctx->name_slots) symbol_table_build_name_index(ctx);
+    if (!ctx->address_index) symbol_table_build_address_index(ctx);
+}
+
 #pragma mark - Symbol Search
 
 int32_t symbol_table_find_by_name(SymbolTableContext *ctx, const char *name) {
     if (!ctx || !ctx->symbols || !name) return -1;
     
+    if (ctx->name_slots || symbol_table_build_name_index(ctx)) {
+        uint32_t hash = symbol_name_hash(name);
+        uint32_t slot = hash & ctx->name_slot_mask;
+        while (ctx->name_slots[slot]) {
+            uint32_t index = ctx->name_slots[slot] - 1;
+            if (ctx->name_slot_hashes[slot] == hash && strcmp(ctx->symbols[index].name, name) == 0) {
+                return (int32_t)index;
+            }
+            slot = (slot + 1) & ctx->name_slot_mask;
+        }
+        return -1;
+    }
+    
     for (uint32_t i = 0; i < ctx->symbol_count; i++) {
         if (ctx->symbols[i].name && strcmp(ctx->symbols[i].name, name) == 0) {
             return (int32_t)i;
@@ -290,9 +501,35 @@ int32_t symbol_table_find_by_name(SymbolTableContext *ctx, const char *name) {
     return -1;
 }
 
+/* Index of the first entry whose address is greater than address. */
+static uint32_t address_index_upper_bound(const SymbolAddressEntry *entries, uint32_t count, uint64_t address) {
+    uint32_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (entries[mid].address <= address) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
 int32_t symbol_table_find_by_address(SymbolTableContext *ctx, uint64_t address) {
     if (!ctx || !ctx->symbols) return -1;
     
+    if (ctx->address_index || symbol_table_build_address_index(ctx)) {
+        uint32_t pos = address_index_upper_bound(ctx->address_index, ctx->symbol_count, address);
+        if (pos == 0) return -1;
+        
+        /* Step back to the lowest symbol index sharing that address. */
+        uint64_t found = ctx->address_index[pos - 1].address;
+        uint32_t lo = 0, hi = pos - 1;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (ctx->address_index[mid].address < found) lo = mid + 1;
+            else hi = mid;
+        }
+        return (int32_t)ctx->address_index[lo].symbol;
+    }
+    
     int32_t best = -1;
     uint64_t best_diff = UINT64_MAX;
     
@@ -309,6 +546,26 @@ int32_t symbol_table_find_by_address(SymbolTableContext *ctx, uint64_t address)
     return best;
 }
 
+int32_t symbol_table_find_containing(SymbolTableContext *ctx, uint64_t address) {
+    if (!ctx || !ctx->symbols) return -1;
+    if (!ctx->address_index && !symbol_table_build_address_index(ctx)) return -1;
+    if (ctx->range_count == 0) return -1;
+    
+    uint32_t lo = 0, hi = ctx->range_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (ctx->range_index[mid].start <= address) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return -1;
+    
+    uint32_t pos = lo - 1;
+    while (pos > 0 && ctx->range_index[pos - 1].start == ctx->range_index[pos].start) pos--;
+    
+    const SymbolRangeEntry *entry = &ctx->range_index[pos];
+    return (address < entry->end) ? (int32_t)entry->symbol : -1;
+}
+
 #pragma mark - Sorting
 
 static int compare_symbols_by_address(const void *a, const void *b) {
@@ -329,11 +586,13 @@ static int compare_symbols_by_name(const void *a, const void *b) {
 
 void symbol_table_sort_by_address(SymbolTableContext *ctx) {
     if (!ctx || !ctx->symbols) return;
+    symbol_table_drop_indices(ctx);
     qsort(ctx->symbols, ctx->symbol_count, sizeof(SymbolInfo), compare_symbols_by_address);
 }
 
 void symbol_table_sort_by_name(SymbolTableContext *ctx) {
     if (!ctx || !ctx->symbols) return;
+    symbol_table_drop_indices(ctx);
     qsort(ctx->symbols, ctx->symbol_count, sizeof(SymbolInfo), compare_symbols_by_name);
 }
 
@@ -342,24 +601,16 @@ void symbol_table_sort_by_name(SymbolTableContext *ctx) {
 bool symbol_table_parse_dysymtab(SymbolTableContext *ctx) {
     if (!ctx || !ctx->macho_ctx) return false;
     
-    FILE *file = ctx->macho_ctx->file;
-    bool is_64bit = ctx->macho_ctx->header.is_64bit;
-    bool is_swapped = ctx->macho_ctx->header.is_swapped;
+    MachOContext *mctx = ctx->macho_ctx;
+    bool is_64bit = mctx->header.is_64bit;
+    bool is_swapped = mctx->header.is_swapped;
     
-    uint32_t header_size = is_64bit ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
-    fseek(file, header_size, SEEK_SET);
+    uint64_t cmd_start = is_64bit ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
     
-    for (uint32_t i = 0; i < ctx->macho_ctx->header.ncmds; i++) {
-        uint32_t cmd, cmdsize;
-        long cmd_start = ftell(file);
-        
-        fread(&cmd, sizeof(uint32_t), 1, file);
-        fread(&cmdsize, sizeof(uint32_t), 1, file);
-        
-        if (is_swapped) {
-            cmd = __builtin_bswap32(cmd);
-            cmdsize = __builtin_bswap32(cmdsize);
-        }
+    for (uint32_t i = 0; i < mctx->header.ncmds; i++) {
+        uint32_t cmd = macho_read_uint32(mctx, cmd_start);
+        uint32_t cmdsize = macho_read_uint32(mctx, cmd_start + 4);
+        if (cmdsize < 8) break;
         
         if (cmd == LC_DYSYMTAB) {
             struct {
@@ -383,7 +634,7 @@ bool symbol_table_parse_dysymtab(SymbolTableContext *ctx) {
                 uint32_t nlocrel;
             } dysymtab;
             
-            fread(&dysymtab, sizeof(dysymtab), 1, file);
+            if (!macho_read(mctx, cmd_start + 8, &dysymtab, sizeof(dysymtab))) return false;
             
             if (is_swapped) {
                 dysymtab.ilocalsym = __builtin_bswap32(dysymtab.ilocalsym);
@@ -421,12 +672,43 @@ bool symbol_table_parse_dysymtab(SymbolTableContext *ctx) {
             return true;
         }
         
-        fseek(file, cmd_start + cmdsize, SEEK_SET);
+        cmd_start += cmdsize;
     }
     
     return false;
 }
 
+const char* symbol_table_stub_name(SymbolTableContext *ctx, uint64_t address) {
+    if (!ctx || !ctx->macho_ctx || !ctx->string_table) return NULL;
+    MachOContext *mctx = ctx->macho_ctx;
+    if (mctx->dysymtab_offset == 0 || mctx->nsyms == 0) return NULL;
+    
+    for (uint32_t i = 0; i < mctx->section_count; i++) {
+        const SectionInfo *sect = &mctx->sections[i];
+        if ((sect->flags & SECTION_TYPE) != S_SYMBOL_STUBS || sect->reserved2 == 0) continue;
+        if (address < sect->addr || address >= sect->addr + sect->size) continue;
+        if ((address - sect->addr) % sect->reserved2 != 0) return NULL;
+        
+        uint64_t dysymtab = mctx->dysymtab_offset;
+        uint32_t indirect_off = macho_read_uint32(mctx, dysymtab + offsetof(struct dysymtab_command, indirectsymoff));
+        uint32_t indirect_count = macho_read_uint32(mctx, dysymtab + offsetof(struct dysymtab_command, nindirectsyms));
+        
+        uint64_t entry = sect->reserved1 + (address - sect->addr) / sect->reserved2;
+        if (entry >= indirect_count) return NULL;
+        
+        uint32_t symbol = macho_read_uint32(mctx, indirect_off + entry * sizeof(uint32_t));
+        if (symbol & (INDIRECT_SYMBOL_LOCAL | INDIRECT_SYMBOL_ABS) || symbol >= mctx->nsyms) return NULL;
+        
+        // Indirect entries index the on-disk symbol table, which the
+        // parsed array no longer matches once sorted; read the nlist.
+        size_t entry_size = mctx->header.is_64bit ? sizeof(struct nlist_64) : sizeof(struct nlist);
+        uint32_t strx = macho_read_uint32(mctx, mctx->symtab_offset + (uint64_t)symbol * entry_size);
+        return symbol_table_get_string(ctx, strx);
+    }
+    
+    return NULL;
+}
+
 bool symbol_table_parse_dyld_info(SymbolTableContext *ctx) {
     if (!ctx || !ctx->macho_ctx) return false;
     //dyldinfo.c has it
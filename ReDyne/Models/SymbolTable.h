@@ -25,8 +25,10 @@ typedef enum {
 
 #pragma mark - Symbol Information Structure
 
+/* name points into the symbol table context's string table and stays valid
+   until symbol_table_free. */
 typedef struct {
-    char *name;
+    const char *name;
     uint64_t address;
     uint64_t size;
     SymbolType type;
@@ -41,13 +43,25 @@ typedef struct {
     bool is_weak;
 } SymbolInfo;
 
+typedef struct {
+    uint64_t address;
+    uint32_t symbol;
+} SymbolAddressEntry;
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint32_t symbol;
+} SymbolRangeEntry;
+
 typedef struct {
     MachOContext *macho_ctx;
     SymbolInfo *symbols;
     uint32_t symbol_count;
     
-    char *string_table;
+    const char *string_table;
     uint32_t string_table_size;
+    bool string_table_terminated;
     uint32_t *defined_indices;
     uint32_t defined_count;
     uint32_t *undefined_indices;
@@ -57,6 +71,16 @@ typedef struct {
     uint32_t *function_indices;
     uint32_t function_count;
     
+    /* Lookup indexes, built on first query and dropped whenever the symbol
+       array is reparsed or reordered. Call symbol_table_build_indices up
+       front before sharing the context between threads. */
+    uint32_t *name_slots;
+    uint32_t *name_slot_hashes;
+    uint32_t name_slot_mask;
+    SymbolAddressEntry *address_index;
+    SymbolRangeEntry *range_index;
+    uint32_t range_count;
+    
 } SymbolTableContext;
 
 #pragma mark - Function Declarations
@@ -65,6 +89,8 @@ SymbolTableContext* symbol_table_create(MachOContext *macho_ctx);
 
 bool symbol_table_parse(SymbolTableContext *ctx);
 
+bool symbol_table_parse_parallel(SymbolTableContext *ctx, uint32_t thread_count);
+
 bool symbol_table_load_strings(SymbolTableContext *ctx);
 
 const char* symbol_table_get_string(SymbolTableContext *ctx, uint32_t strx);
@@ -77,6 +103,10 @@ int32_t symbol_table_find_by_name(SymbolTableContext *ctx, const char *name);
 
 int32_t symbol_table_find_by_address(SymbolTableContext *ctx, uint64_t address);
 
+int32_t symbol_table_find_containing(SymbolTableContext *ctx, uint64_t address);
+
+void symbol_table_build_indices(SymbolTableContext *ctx);
+
 const char* symbol_type_string(SymbolType type);
 
 const char* symbol_scope_string(SymbolScope scope);
@@ -85,6 +115,11 @@ bool symbol_table_parse_dysymtab(SymbolTableContext *ctx);
 
 bool symbol_table_parse_dyld_info(SymbolTableContext *ctx);
 
+/* Name of the import an S_SYMBOL_STUBS entry (e.g. __stubs, __auth_stubs)
+   at address jumps to, through the indirect symbol table; NULL if address
+   is not a stub or the entry is local. Needs symbol_table_load_strings. */
+const char* symbol_table_stub_name(SymbolTableContext *ctx, uint64_t address);
+
 void symbol_table_sort_by_address(SymbolTableContext *ctx);
 
 void symbol_table_sort_by_name(SymbolTableContext *ctx);
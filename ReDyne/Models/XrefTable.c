@@ -0,0 +1,366 @@
+#include "XrefTable.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* X0-X18 and X30 do not survive a call. */
+#define XREF_CALLER_SAVED (0x0007FFFFu | (1u << 30))
+
+#define XREF_RADIX_BITS 11
+#define XREF_RADIX_MASK ((1u << XREF_RADIX_BITS) - 1)
+
+#pragma mark - Helpers
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+} XrefRange;
+
+static bool xref_in_image(const XrefRange *ranges, uint32_t count, uint64_t address) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (address >= ranges[i].start && address < ranges[i].end) return true;
+    }
+    return false;
+}
+
+static bool xref_append(XrefTable *table, uint64_t from, uint64_t to, XrefKind kind) {
+    if (table->count == table->capacity) {
+        uint32_t new_capacity = table->capacity ? table->capacity * 2 : 4096;
+        XrefEntry *grown = (XrefEntry*)realloc(table->entries, new_capacity * sizeof(XrefEntry));
+        if (!grown) return false;
+        table->entries = grown;
+        table->capacity = new_capacity;
+    }
+
+    XrefEntry *entry = &table->entries[table->count++];
+    entry->from = from;
+    entry->to = to;
+    entry->kind = kind;
+    table->kind_counts[kind]++;
+    return true;
+}
+
+/* Block leaders: the first instruction, function starts, jump targets and
+   whatever follows a jump or return. */
+static uint8_t* xref_mark_leaders(DisassemblyContext *disasm, uint32_t *target_count) {
+    uint32_t count = disasm->instruction_count;
+    uint8_t *leaders = (uint8_t*)calloc(count, 1);
+    if (!leaders) return NULL;
+
+    if (!disasm->index_valid) disasm_build_address_index(disasm);
+
+    DisasmSemantics inst;
+    uint32_t targets = 0;
+    leaders[0] = 1;
+    for (uint32_t i = 0; i < count; i++) {
+        disasm_get_semantics(disasm, i, &inst);
+        if (inst.attrs & DISASM_ATTR_FUNCTION_START) leaders[i] = 1;
+        if (inst.attrs & DISASM_ATTR_HAS_BRANCH_TARGET) targets++;
+        if (inst.branch_type == BRANCH_NONE || inst.branch_type == BRANCH_CALL) continue;
+
+        if (i + 1 < count) leaders[i + 1] = 1;
+        if (inst.attrs & DISASM_ATTR_HAS_BRANCH_TARGET) {
+            int32_t target = disasm_find_by_address(disasm, inst.branch_target);
+            if (target >= 0) leaders[target] = 1;
+        }
+    }
+    *target_count = targets;
+    return leaders;
+}
+
+#pragma mark - Register Tracking
+
+typedef struct {
+    uint64_t values[32];        // X0-X30, SP
+    uint32_t known;             // bit n: values[n] holds an address
+} XrefRegisterFile;
+
+/* First memory operand with an immediate displacement, or NULL. */
+static const ARM64Operand* xref_memory_operand(const ARM64DecodedInstruction *decoded) {
+    for (uint8_t i = 0; i < decoded->operand_count; i++) {
+        const ARM64Operand *op = &decoded->operands[i];
+        if (op->type != ARM64_OPERAND_MEM) continue;
+        if (op->mode == ARM64_ADDR_OFFSET || op->mode == ARM64_ADDR_PRE_INDEX ||
+            op->mode == ARM64_ADDR_POST_INDEX) return op;
+        return NULL;
+    }
+    return NULL;
+}
+
+/* Applies one non-branch ARM64 instruction to the register file, emitting
+   the data xref it makes, if any. Only words that can use a known register
+   are decoded; the rest just clear the registers they write. */
+static bool xref_track_arm64(XrefTable *table, XrefRegisterFile *regs, const DisasmSemantics *inst,
+                             const XrefRange *ranges, uint32_t range_count) {
+    uint32_t word = inst->raw_bytes;
+    uint32_t written = (uint32_t)inst->regs_written;
+
+    if (inst->attrs & DISASM_ATTR_HAS_BRANCH_TARGET) {
+        uint64_t target = inst->branch_target;
+        uint8_t rd = word & 0x1F;
+
+        if ((word & 0x1F000000) == 0x10000000) {
+            // ADRP gives the page, completed by a later ADD or load offset.
+            regs->known &= ~written;
+            if (rd != 31) {
+                regs->values[rd] = target;
+                regs->known |= 1u << rd;
+            }
+            if (!(word & 0x80000000) && xref_in_image(ranges, range_count, target)) {
+                return xref_append(table, inst->address, target, XREF_ADDRESS_LOAD);
+            }
+            return true;
+        }
+
+        regs->known &= ~written;
+        if (inst->category == INST_CATEGORY_LOAD_STORE && xref_in_image(ranges, range_count, target)) {
+            return xref_append(table, inst->address, target, XREF_DATA_READ);
+        }
+        return true;
+    }
+
+    uint8_t rn = (word >> 5) & 0x1F;
+    bool add_imm = (word & 0xFF800000) == 0x91000000;
+    bool load_store = (word & 0x0A000000) == 0x08000000;
+    bool mov_reg = (word & 0xFFE0FFE0) == 0xAA0003E0;
+    uint8_t source = mov_reg ? (word >> 16) & 0x1F : rn;
+
+    if (!(add_imm || load_store || mov_reg) || !(regs->known & (1u << source))) {
+        regs->known &= ~written;
+        return true;
+    }
+
+    ARM64DecodedInstruction decoded;
+    if (!arm64dec_decode_instruction(word, inst->address, &decoded)) {
+        regs->known &= ~written;
+        return true;
+    }
+
+    if (load_store) {
+        const ARM64Operand *mem = xref_memory_operand(&decoded);
+        char access = decoded.mnemonic[0];
+        regs->known &= ~written;
+        if (!mem || mem->reg.num != rn || (access != 'L' && access != 'S')) return true;
+
+        uint64_t target = regs->values[rn] + (mem->mode == ARM64_ADDR_POST_INDEX ? 0 : (uint64_t)mem->imm);
+        if (!xref_in_image(ranges, range_count, target)) return true;
+        return xref_append(table, inst->address, target, access == 'L' ? XREF_DATA_READ : XREF_DATA_WRITE);
+    }
+
+    // ADD Xd, Xn, #imm (MOV to/from SP when imm is 0) or MOV Xd, Xm.
+    if (decoded.operand_count < 2 || decoded.operands[0].type != ARM64_OPERAND_REG ||
+        decoded.operands[1].type != ARM64_OPERAND_REG) {
+        regs->known &= ~written;
+        return true;
+    }
+
+    uint8_t rd = decoded.operands[0].reg.num;
+    uint64_t offset = (decoded.operand_count > 2 && decoded.operands[2].type == ARM64_OPERAND_IMM)
+                    ? (uint64_t)decoded.operands[2].imm : 0;
+    uint64_t value = regs->values[decoded.operands[1].reg.num] + offset;
+
+    regs->known &= ~written;
+    if (mov_reg && rd == 31) return true;   // MOV XZR
+    regs->values[rd] = value;
+    regs->known |= 1u << rd;
+
+    if (add_imm && offset != 0 && xref_in_image(ranges, range_count, value)) {
+        return xref_append(table, inst->address, value, XREF_ADDRESS_LOAD);
+    }
+    return true;
+}
+
+#pragma mark - Analysis
+
+/* Stable LSD radix sort of entry indices by target, 11 bits per pass over
+   the span of targets present (three passes for a 4 GB span). Entries are
+   already in source order, so ties stay in source order. */
+static bool xref_build_target_index(XrefTable *table) {
+    uint32_t count = table->count;
+    uint32_t *order = (uint32_t*)malloc((count ? count : 1) * sizeof(uint32_t));
+    uint32_t *scratch = (uint32_t*)malloc((count ? count : 1) * sizeof(uint32_t));
+    if (!order || !scratch) {
+        free(order);
+        free(scratch);
+        return false;
+    }
+
+    uint64_t min = UINT64_MAX, max = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t to = table->entries[i].to;
+        if (to < min) min = to;
+        if (to > max) max = to;
+        order[i] = i;
+    }
+
+    uint32_t histogram[1u << XREF_RADIX_BITS];
+    uint64_t span = count ? max - min : 0;
+    for (uint32_t shift = 0; shift < 64 && (span >> shift) != 0; shift += XREF_RADIX_BITS) {
+        memset(histogram, 0, sizeof(histogram));
+        for (uint32_t i = 0; i < count; i++) {
+            histogram[((table->entries[i].to - min) >> shift) & XREF_RADIX_MASK]++;
+        }
+
+        uint32_t sum = 0;
+        for (uint32_t d = 0; d <= XREF_RADIX_MASK; d++) {
+            uint32_t bucket = histogram[d];
+            histogram[d] = sum;
+            sum += bucket;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t entry = order[i];
+            scratch[histogram[((table->entries[entry].to - min) >> shift) & XREF_RADIX_MASK]++] = entry;
+        }
+
+        uint32_t *sorted = scratch;
+        scratch = order;
+        order = sorted;
+    }
+
+    free(scratch);
+    table->by_target = order;
+    return true;
+}
+
+XrefTable* xref_analyze(DisassemblyContext *disasm) {
+    if (!disasm || disasm->instruction_count == 0) return NULL;
+
+    // Branches and PC-relative operands bound the code xrefs; tracked
+    // data xrefs rarely add more than one per eight instructions.
+    uint32_t target_count = 0;
+    XrefTable *table = (XrefTable*)calloc(1, sizeof(XrefTable));
+    uint8_t *leaders = table ? xref_mark_leaders(disasm, &target_count) : NULL;
+    if (leaders) {
+        table->capacity = target_count + disasm->instruction_count / 8 + 1;
+        table->entries = (XrefEntry*)malloc(table->capacity * sizeof(XrefEntry));
+    }
+    if (!leaders || !table->entries) {
+        free(leaders);
+        xref_table_free(table);
+        return NULL;
+    }
+
+    XrefRange ranges[64];
+    uint32_t range_count = 0;
+    const MachOContext *macho = disasm->macho_ctx;
+    for (uint32_t i = 0; macho && i < macho->segment_count && range_count < 64; i++) {
+        const SegmentInfo *seg = &macho->segments[i];
+        if (seg->vmsize == 0 || seg->initprot == 0) continue;
+        ranges[range_count].start = seg->vmaddr;
+        ranges[range_count].end = seg->vmaddr + seg->vmsize;
+        range_count++;
+    }
+
+    bool track = disasm->arch == ARCH_ARM64;
+    XrefRegisterFile regs;
+    regs.known = 0;
+
+    bool ok = true;
+    DisasmSemantics inst;
+    for (uint32_t i = 0; ok && i < disasm->instruction_count; i++) {
+        if (leaders[i]) {
+            regs.known = 0;
+            table->block_count++;
+        }
+        disasm_get_semantics(disasm, i, &inst);
+
+        if (inst.branch_type == BRANCH_NONE) {
+            if (track) ok = xref_track_arm64(table, &regs, &inst, ranges, range_count);
+            continue;
+        }
+
+        if (inst.branch_type == BRANCH_CALL) regs.known &= ~XREF_CALLER_SAVED;
+        regs.known &= ~(uint32_t)inst.regs_written;
+
+        if (!(inst.attrs & DISASM_ATTR_HAS_BRANCH_TARGET)) continue;
+        switch (inst.branch_type) {
+            case BRANCH_CALL:
+                ok = xref_append(table, inst.address, inst.branch_target, XREF_CALL);
+                break;
+            case BRANCH_UNCONDITIONAL:
+                ok = xref_append(table, inst.address, inst.branch_target, XREF_JUMP);
+                break;
+            case BRANCH_CONDITIONAL:
+                ok = xref_append(table, inst.address, inst.branch_target, XREF_CONDITIONAL_JUMP);
+                break;
+            default:
+                break;
+        }
+    }
+    free(leaders);
+
+    if (!ok || !xref_build_target_index(table)) {
+        xref_table_free(table);
+        return NULL;
+    }
+    return table;
+}
+
+#pragma mark - Queries
+
+uint32_t xref_find_from(const XrefTable *table, uint64_t start, uint64_t end, uint32_t *first) {
+    if (first) *first = 0;
+    if (!table || start >= end) return 0;
+
+    uint32_t lo = 0, hi = table->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (table->entries[mid].from < start) lo = mid + 1;
+        else hi = mid;
+    }
+    uint32_t begin = lo;
+
+    hi = table->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (table->entries[mid].from < end) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if (first) *first = begin;
+    return lo - begin;
+}
+
+uint32_t xref_find_to(const XrefTable *table, uint64_t start, uint64_t end, uint32_t *first) {
+    if (first) *first = 0;
+    if (!table || start >= end) return 0;
+
+    uint32_t lo = 0, hi = table->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (table->entries[table->by_target[mid]].to < start) lo = mid + 1;
+        else hi = mid;
+    }
+    uint32_t begin = lo;
+
+    hi = table->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (table->entries[table->by_target[mid]].to < end) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if (first) *first = begin;
+    return lo - begin;
+}
+
+const char* xref_kind_name(XrefKind kind) {
+    switch (kind) {
+        case XREF_CALL: return "call";
+        case XREF_JUMP: return "jump";
+        case XREF_CONDITIONAL_JUMP: return "conditionalJump";
+        case XREF_DATA_READ: return "dataRead";
+        case XREF_DATA_WRITE: return "dataWrite";
+        case XREF_ADDRESS_LOAD: return "addressLoad";
+        default: return "unknown";
+    }
+}
+
+void xref_table_free(XrefTable *table) {
+    if (!table) return;
+
+    free(table->entries);
+    free(table->by_target);
+
+    free(table);
+}
@@ -0,0 +1,63 @@
+#ifndef XrefTable_h
+#define XrefTable_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "DisassemblyEngine.h"
+
+#pragma mark - Structures
+
+typedef enum {
+    XREF_CALL = 0,
+    XREF_JUMP,
+    XREF_CONDITIONAL_JUMP,
+    XREF_DATA_READ,             // load from a resolved address
+    XREF_DATA_WRITE,            // store to a resolved address
+    XREF_ADDRESS_LOAD,          // ADR, or ADRP completed by ADD
+    XREF_KIND_COUNT
+} XrefKind;
+
+typedef struct {
+    uint64_t from;              // instruction address
+    uint64_t to;
+    uint32_t kind;              // XrefKind
+} XrefEntry;
+
+/* Every xref of one disassembly. entries is sorted by source address (one
+   entry per instruction at most); by_target lists entry indices sorted by
+   target, ties in source order. */
+typedef struct {
+    XrefEntry *entries;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t *by_target;
+
+    uint32_t kind_counts[XREF_KIND_COUNT];
+    uint32_t block_count;       // register file resets during the sweep
+} XrefTable;
+
+#pragma mark - Function Declarations
+
+/* Sweeps every instruction of the disassembly once. Branches with a target
+   become code xrefs. On ARM64 a register file of known addresses is kept
+   per basic block: ADRP/ADR set a register, ADD and register MOV carry it,
+   and loads and stores through it (or PC-relative literals) become data
+   xrefs. Blocks start at function starts, branch targets and after jumps;
+   calls clobber X0-X18 and X30 without ending the block. Data targets
+   outside every segment are dropped. Returns NULL on allocation failure. */
+XrefTable* xref_analyze(DisassemblyContext *disasm);
+
+/* Xrefs whose source lies in [start, end): entries[*first .. *first + n).
+   O(log N). */
+uint32_t xref_find_from(const XrefTable *table, uint64_t start, uint64_t end, uint32_t *first);
+
+/* Xrefs whose target lies in [start, end): by_target[*first .. *first + n).
+   O(log N). */
+uint32_t xref_find_to(const XrefTable *table, uint64_t start, uint64_t end, uint32_t *first);
+
+const char* xref_kind_name(XrefKind kind);
+
+void xref_table_free(XrefTable *table);
+
+#endif
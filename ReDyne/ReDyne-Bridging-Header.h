@@ -13,6 +13,8 @@
 #import "SymbolTable.h"
 #import "DisassemblyEngine.h"
 #import "ControlFlowGraph.h"
+#import "CallGraph.h"
+#import "XrefTable.h"
 #import "RelocationInfo.h"
 #import "ObjCParser.h"
 #import "DyldInfo.h"
@@ -4,6 +4,8 @@
 NS_ASSUME_NONNULL_BEGIN
 
 typedef void (^ParserProgressBlock)(NSString *status, float progress);
+typedef void (^BatchParserProgressBlock)(NSUInteger index, float progress);
+typedef void (^BatchParserResultBlock)(NSUInteger index, DecompiledOutput * _Nullable output, NSError * _Nullable error);
 
 @interface BinaryParserService : NSObject
 
@@ -11,6 +13,15 @@ typedef void (^ParserProgressBlock)(NSString *status, float progress);
                                   progressBlock:(nullable ParserProgressBlock)progressBlock
                                           error:(NSError **)error;
 
+/// Parses several binaries (an app's executable, frameworks and extensions)
+/// on one shared worker pool and blocks until all are done. Larger files
+/// start first. Blocks run on worker threads, one at a time. Each result is
+/// delivered as soon as its binary finishes, and index is the position in
+/// filePaths.
++ (void)parseBinariesAtPaths:(NSArray<NSString *> *)filePaths
+               progressBlock:(nullable BatchParserProgressBlock)progressBlock
+                 resultBlock:(BatchParserResultBlock)resultBlock;
+
 + (BOOL)isValidMachOAtPath:(NSString *)filePath;
 
 + (nullable NSDictionary *)quickInfoForFileAtPath:(NSString *)filePath;
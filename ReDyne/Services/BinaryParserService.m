@@ -2,6 +2,7 @@
 #import "MachOHeader.h"
 #import "SymbolTable.h"
 #import "StringExtractor.h"
+#import "BatchAnalysis.h"
 
 static NSString * const ReDyneBinaryParserErrorDomain = @"com.jian.ReDyne.BinaryParser";
 
@@ -9,10 +10,63 @@ typedef NS_ENUM(NSInteger, ReDyneBinaryParserError) {
     ReDyneBinaryParserErrorInvalidFile = 1001,
     ReDyneBinaryParserErrorInvalidMachO = 1002,
     ReDyneBinaryParserErrorParsingFailed = 1003,
-    ReDyneBinaryParserErrorEncrypted = 1004,
-    ReDyneBinaryParserErrorTooLarge = 1005
+    ReDyneBinaryParserErrorEncrypted = 1004
 };
 
+@interface BinaryParserService ()
++ (DecompiledOutput *)outputForContext:(MachOContext *)macho_ctx filePath:(NSString *)filePath;
++ (void)populateOutput:(DecompiledOutput *)output withSymbols:(SymbolTableContext *)sym_ctx;
++ (void)populateOutput:(DecompiledOutput *)output withStrings:(StringContext *)str_ctx;
+@end
+
+#pragma mark - Batch Callbacks
+
+/* Carries the caller's blocks through batch_analyze's user_data. */
+@interface ReDyneBatchParse : NSObject
+@property (nonatomic, copy) BatchParserProgressBlock progressBlock;
+@property (nonatomic, copy) BatchParserResultBlock resultBlock;
+@end
+
+@implementation ReDyneBatchParse
+@end
+
+static void batch_parse_progress(uint32_t index, BatchStage stage, uint32_t stages_done,
+                                 uint32_t stage_count, void *user_data) {
+    ReDyneBatchParse *batch = (__bridge ReDyneBatchParse *)user_data;
+    if (batch.progressBlock) {
+        batch.progressBlock(index, (float)stages_done / (float)stage_count);
+    }
+}
+
+static void batch_parse_result(BatchJobResult *result, void *user_data) {
+    @autoreleasepool {
+        ReDyneBatchParse *batch = (__bridge ReDyneBatchParse *)user_data;
+        if (!batch.resultBlock) return;
+        
+        NSString *filePath = [NSString stringWithUTF8String:result->path];
+        if (!result->ok) {
+            NSError *error = [NSError errorWithDomain:ReDyneBinaryParserErrorDomain
+                                                 code:ReDyneBinaryParserErrorParsingFailed
+                                             userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithUTF8String:result->error]}];
+            batch.resultBlock(result->index, nil, error);
+            return;
+        }
+        if (result->macho->is_encrypted) {
+            NSError *error = [NSError errorWithDomain:ReDyneBinaryParserErrorDomain
+                                                 code:ReDyneBinaryParserErrorEncrypted
+                                             userInfo:@{NSLocalizedDescriptionKey: @"Binary is encrypted and cannot be decompiled"}];
+            batch.resultBlock(result->index, nil, error);
+            return;
+        }
+        
+        DecompiledOutput *output = [BinaryParserService outputForContext:result->macho filePath:filePath];
+        if (result->symbols) [BinaryParserService populateOutput:output withSymbols:result->symbols];
+        if (result->strings) [BinaryParserService populateOutput:output withStrings:result->strings];
+        output.processingTime = result->elapsed;
+        batch.resultBlock(result->index, output, nil);
+    }
+}
+
 @implementation BinaryParserService
 
 #pragma mark - Public Methods
@@ -83,25 +137,7 @@ typedef NS_ENUM(NSInteger, ReDyneBinaryParserError) {
     macho_extract_segments(macho_ctx);
     macho_extract_sections(macho_ctx);
     
-    DecompiledOutput *output = [[DecompiledOutput alloc] init];
-    output.filePath = filePath;
-    output.fileName = [filePath lastPathComponent];
-    output.fileSize = macho_ctx->file_size;
-    output.header = [self createHeaderModelFromContext:macho_ctx];
-    
-    NSMutableArray *segments = [NSMutableArray array];
-    for (uint32_t i = 0; i < macho_ctx->segment_count; i++) {
-        SegmentModel *seg = [self createSegmentModelFromInfo:&macho_ctx->segments[i]];
-        [segments addObject:seg];
-    }
-    output.segments = segments;
-    
-    NSMutableArray *sections = [NSMutableArray array];
-    for (uint32_t i = 0; i < macho_ctx->section_count; i++) {
-        SectionModel *sect = [self createSectionModelFromInfo:&macho_ctx->sections[i]];
-        [sections addObject:sect];
-    }
-    output.sections = sections;
+    DecompiledOutput *output = [self outputForContext:macho_ctx filePath:filePath];
     
     if (progressBlock) {
         progressBlock(@"Parsing symbol table...", 0.5);
@@ -112,19 +148,7 @@ typedef NS_ENUM(NSInteger, ReDyneBinaryParserError) {
         symbol_table_parse(sym_ctx);
         symbol_table_categorize(sym_ctx);
         symbol_table_extract_functions(sym_ctx);
-        
-        NSMutableArray *symbols = [NSMutableArray array];
-        for (uint32_t i = 0; i < sym_ctx->symbol_count; i++) {
-            SymbolModel *sym = [self createSymbolModelFromInfo:&sym_ctx->symbols[i]];
-            [symbols addObject:sym];
-        }
-        output.symbols = symbols;
-        
-        output.totalSymbols = sym_ctx->symbol_count;
-        output.definedSymbols = sym_ctx->defined_count;
-        output.undefinedSymbols = sym_ctx->undefined_count;
-        output.totalFunctions = sym_ctx->function_count;
-        
+        [self populateOutput:output withSymbols:sym_ctx];
         symbol_table_free(sym_ctx);
     }
     
@@ -134,37 +158,8 @@ typedef NS_ENUM(NSInteger, ReDyneBinaryParserError) {
     
     StringContext *str_ctx = string_context_create(1024);
     if (str_ctx) {
-        for (uint32_t i = 0; i < macho_ctx->section_count; i++) {
-            SectionInfo *sect = &macho_ctx->sections[i];
-            if (strcmp(sect->sectname, "__cstring") == 0) {
-                string_extract_cstrings(str_ctx, macho_ctx->file, sect->offset, sect->size, sect->addr);
-            }
-        }
-        
-        for (uint32_t i = 0; i < macho_ctx->segment_count; i++) {
-            SegmentInfo *seg = &macho_ctx->segments[i];
-            if ((seg->initprot & 0x01) && seg->filesize > 0) {
-                uint8_t *data = malloc(seg->filesize);
-                if (data) {
-                    fseek(macho_ctx->file, seg->fileoff, SEEK_SET);
-                    if (fread(data, 1, seg->filesize, macho_ctx->file) == seg->filesize) {
-                        string_extract_from_data(str_ctx, data, seg->filesize, seg->vmaddr, seg->segname, 4);
-                    }
-                    free(data);
-                }
-            }
-        }
-        
-        string_context_sort(str_ctx);
-        
-        NSMutableArray *strings = [NSMutableArray array];
-        for (uint32_t i = 0; i < str_ctx->count; i++) {
-            StringModel *str = [self createStringModelFromInfo:&str_ctx->strings[i]];
-            [strings addObject:str];
-        }
-        output.strings = strings;
-        output.totalStrings = str_ctx->count;
-        
+        string_extract_all(str_ctx, macho_ctx);
+        [self populateOutput:output withStrings:str_ctx];
         string_context_free(str_ctx);
     }
     
@@ -179,6 +174,33 @@ typedef NS_ENUM(NSInteger, ReDyneBinaryParserError) {
     return output;
 }
 
++ (void)parseBinariesAtPaths:(NSArray<NSString *> *)filePaths
+               progressBlock:(BatchParserProgressBlock)progressBlock
+                 resultBlock:(BatchParserResultBlock)resultBlock {
+    
+    if (filePaths.count == 0) return;
+    
+    ReDyneBatchParse *batch = [[ReDyneBatchParse alloc] init];
+    batch.progressBlock = progressBlock;
+    batch.resultBlock = resultBlock;
+    
+    const char **paths = (const char **)calloc(filePaths.count, sizeof(char *));
+    if (!paths) return;
+    for (NSUInteger i = 0; i < filePaths.count; i++) {
+        paths[i] = [filePaths[i] fileSystemRepresentation];
+    }
+    
+    BatchOptions options = {
+        .stages = BATCH_STAGE_FLAG_SYMBOLS | BATCH_STAGE_FLAG_STRINGS,
+        .progress = batch_parse_progress,
+        .result = batch_parse_result,
+        .user_data = (__bridge void *)batch
+    };
+    batch_analyze(paths, (uint32_t)filePaths.count, &options);
+    
+    free(paths);
+}
+
 + (BOOL)isValidMachOAtPath:(NSString *)filePath {
     MachOContext *ctx = macho_open([filePath UTF8String], NULL);
     if (!ctx) return NO;
@@ -252,6 +274,54 @@ typedef NS_ENUM(NSInteger, ReDyneBinaryParserError) {
 
 #pragma mark - Private Helper Methods
 
++ (DecompiledOutput *)outputForContext:(MachOContext *)macho_ctx filePath:(NSString *)filePath {
+    DecompiledOutput *output = [[DecompiledOutput alloc] init];
+    output.filePath = filePath;
+    output.fileName = [filePath lastPathComponent];
+    output.fileSize = macho_ctx->file_size;
+    output.header = [self createHeaderModelFromContext:macho_ctx];
+    
+    NSMutableArray *segments = [NSMutableArray array];
+    for (uint32_t i = 0; i < macho_ctx->segment_count; i++) {
+        SegmentModel *seg = [self createSegmentModelFromInfo:&macho_ctx->segments[i]];
+        [segments addObject:seg];
+    }
+    output.segments = segments;
+    
+    NSMutableArray *sections = [NSMutableArray array];
+    for (uint32_t i = 0; i < macho_ctx->section_count; i++) {
+        SectionModel *sect = [self createSectionModelFromInfo:&macho_ctx->sections[i]];
+        [sections addObject:sect];
+    }
+    output.sections = sections;
+    
+    return output;
+}
+
++ (void)populateOutput:(DecompiledOutput *)output withSymbols:(SymbolTableContext *)sym_ctx {
+    NSMutableArray *symbols = [NSMutableArray array];
+    for (uint32_t i = 0; i < sym_ctx->symbol_count; i++) {
+        SymbolModel *sym = [self createSymbolModelFromInfo:&sym_ctx->symbols[i]];
+        [symbols addObject:sym];
+    }
+    output.symbols = symbols;
+    
+    output.totalSymbols = sym_ctx->symbol_count;
+    output.definedSymbols = sym_ctx->defined_count;
+    output.undefinedSymbols = sym_ctx->undefined_count;
+    output.totalFunctions = sym_ctx->function_count;
+}
+
++ (void)populateOutput:(DecompiledOutput *)output withStrings:(StringContext *)str_ctx {
+    NSMutableArray *strings = [NSMutableArray array];
+    for (uint32_t i = 0; i < str_ctx->count; i++) {
+        StringModel *str = [self createStringModelFromInfo:&str_ctx->strings[i]];
+        [strings addObject:str];
+    }
+    output.strings = strings;
+    output.totalStrings = str_ctx->count;
+}
+
 + (MachOHeaderModel *)createHeaderModelFromContext:(MachOContext *)ctx {
     MachOHeaderModel *model = [[MachOHeaderModel alloc] init];
     
@@ -340,6 +410,7 @@ typedef NS_ENUM(NSInteger, ReDyneBinaryParserError) {
     model.section = [NSString stringWithUTF8String:info->section];
     model.isCString = info->is_cstring;
     model.isUnicode = info->is_unicode;
+    model.cfstringAddress = info->cfstring_address;
     
     return model;
 }
@@ -38,6 +38,116 @@ import Foundation
         return result
     }
     
+    /// Converts CFGs built natively by cfg_build_functions into result models
+    /// - Parameters:
+    ///   - cfgContext: Opaque pointer to a CFGContext over a compact disassembly, after cfg_detect_loops
+    ///   - functions: Functions whose names label the CFGs, matched by start address
+    /// - Returns: Analysis result containing one CFG per built function
+    @objc static func analyze(cfgContext: OpaquePointer, functions: [FunctionModel]) -> CFGAnalysisResult {
+        let ctx = UnsafeMutablePointer<CFGContext>(cfgContext)
+        guard let disasm = ctx.pointee.disasm_ctx,
+              let blocks = ctx.pointee.blocks,
+              let builtFunctions = ctx.pointee.functions else {
+            return CFGAnalysisResult(functionCFGs: [])
+        }
+        let opcodes = disasm.pointee.compact.opcodes
+        
+        var names: [UInt64: String] = [:]
+        for function in functions {
+            names[function.startAddress] = function.name
+        }
+        
+        var functionCFGs: [FunctionCFG] = []
+        functionCFGs.reserveCapacity(Int(ctx.pointee.function_count))
+        
+        for f in 0..<Int(ctx.pointee.function_count) {
+            let function = builtFunctions[f]
+            let first = function.first_block
+            var nodes: [CFGNode] = []
+            var edges: [CFGEdge] = []
+            nodes.reserveCapacity(Int(function.block_count))
+            
+            for local in 0..<function.block_count {
+                let blockIndex = first + local
+                let block = blocks[Int(blockIndex)]
+                let lastIndex = block.instruction_start + block.instruction_count - 1
+                
+                var mnemonics: [String] = []
+                if let opcodes = opcodes {
+                    mnemonics.reserveCapacity(Int(block.instruction_count))
+                    for i in block.instruction_start...lastIndex {
+                        mnemonics.append(String(cString: disasm_opcode_name(disasm, opcodes[Int(i)])))
+                    }
+                }
+                
+                let node = CFGNode(
+                    id: Int(local),
+                    startAddress: block.start_address,
+                    endAddress: disasm_address_at(disasm, lastIndex),
+                    instructions: mnemonics
+                )
+                node.loopDepth = Int(cfg_loop_depth(ctx, blockIndex))
+                
+                var isConditional = false
+                for s in 0..<Int(block.successor_count) {
+                    let type = block.successor_edge_types[s]
+                    if type == EDGE_CALL { continue }
+                    
+                    let target = block.successors[s]
+                    let edgeType: CFGEdgeType
+                    if cfg_is_back_edge(ctx, blockIndex, target) {
+                        edgeType = .loopBack
+                    } else if type == EDGE_CONDITIONAL_TRUE {
+                        edgeType = .trueBranch
+                    } else if type == EDGE_CONDITIONAL_FALSE {
+                        edgeType = .falseBranch
+                    } else {
+                        edgeType = .normal
+                    }
+                    if type == EDGE_CONDITIONAL_TRUE || type == EDGE_CONDITIONAL_FALSE {
+                        isConditional = true
+                    }
+                    
+                    let to = Int(target - first)
+                    node.successors.append(to)
+                    edges.append(CFGEdge(from: Int(local), to: to, edgeType: edgeType))
+                }
+                
+                if local == 0 {
+                    node.nodeType = .entry
+                }
+                if block.is_exit {
+                    node.nodeType = .exit
+                }
+                if isConditional {
+                    node.nodeType = .conditional
+                }
+                if block.is_loop_header {
+                    node.nodeType = .loop
+                }
+                
+                nodes.append(node)
+            }
+            
+            let name = names[function.start_address] ?? String(format: "sub_%llx", function.start_address)
+            functionCFGs.append(FunctionCFG(
+                functionName: name,
+                functionAddress: function.start_address,
+                nodes: nodes,
+                edges: edges
+            ))
+        }
+        
+        let result = CFGAnalysisResult(functionCFGs: functionCFGs)
+        
+        print("CFG analysis complete")
+        print("   • \(result.totalFunctions) functions")
+        print("   • \(result.totalNodes) nodes")
+        print("   • \(result.totalEdges) edges")
+        
+        return result
+    }
+    
     /// Analyzes a single function to construct its control flow graph
     /// - Parameter function: The function to analyze
     /// - Returns: Control flow graph for the function, or nil if analysis fails
@@ -212,7 +322,9 @@ import Foundation
             "cyclomaticComplexity": cyclomaticComplexity,
             "conditionalBranches": conditionalBranches,
             "entryNodes": cfg.nodes.filter { $0.nodeType == .entry }.count,
-            "exitNodes": cfg.nodes.filter { $0.nodeType == .exit }.count
+            "exitNodes": cfg.nodes.filter { $0.nodeType == .exit }.count,
+            "loopHeaders": cfg.nodes.filter { $0.nodeType == .loop }.count,
+            "maxLoopDepth": cfg.nodes.map { $0.loopDepth }.max() ?? 0
         ]
     }
 }
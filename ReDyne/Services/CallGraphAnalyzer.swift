@@ -0,0 +1,58 @@
+import Foundation
+
+/// Converts a call graph built natively by callgraph_build into a result model
+@objc class CallGraphAnalyzer: NSObject {
+
+    /// Copies nodes, both CSR adjacencies and recursion flags out of the C graph
+    /// - Parameters:
+    ///   - callGraph: Opaque pointer to a CallGraph
+    ///   - functions: Functions whose names label nodes the symbol table left unnamed, matched by start address
+    /// - Returns: Call graph answering caller/callee queries in O(degree)
+    @objc static func analyze(callGraph: OpaquePointer, functions: [FunctionModel]) -> CallGraphResult {
+        let graph = UnsafeMutablePointer<CallGraph>(callGraph)
+        let nodeCount = Int(graph.pointee.node_count)
+        let edgeCount = Int(graph.pointee.edge_count)
+
+        var names: [UInt64: String] = [:]
+        for function in functions {
+            names[function.startAddress] = function.name
+        }
+
+        var nodes: [CallGraphNodeInfo] = []
+        var recursive: [Bool] = []
+        nodes.reserveCapacity(nodeCount)
+        recursive.reserveCapacity(nodeCount)
+
+        for v in 0..<nodeCount {
+            let node = graph.pointee.nodes[v]
+            let name: String
+            if let cName = node.name {
+                name = String(cString: cName)
+            } else if let known = names[node.address] {
+                name = known
+            } else {
+                name = String(format: node.is_stub ? "stub_%llx" : "sub_%llx", node.address)
+            }
+            nodes.append(CallGraphNodeInfo(index: v, address: node.address, endAddress: node.end_address,
+                                           name: name, isStub: node.is_stub))
+            recursive.append(callgraph_is_recursive(graph, UInt32(v)))
+        }
+
+        let result = CallGraphResult(
+            nodes: nodes,
+            functionCount: Int(graph.pointee.function_count),
+            calleeOffsets: Array(UnsafeBufferPointer(start: graph.pointee.callee_offsets, count: nodeCount + 1)),
+            callees: Array(UnsafeBufferPointer(start: graph.pointee.callees, count: edgeCount)),
+            callerOffsets: Array(UnsafeBufferPointer(start: graph.pointee.caller_offsets, count: nodeCount + 1)),
+            callers: Array(UnsafeBufferPointer(start: graph.pointee.callers, count: edgeCount)),
+            recursive: recursive,
+            callSiteCount: Int(graph.pointee.call_site_count),
+            unresolvedCallCount: Int(graph.pointee.unresolved_call_count),
+            componentCount: Int(graph.pointee.scc_count)
+        )
+
+        print("Call graph: \(result.functionCount) functions, \(result.stubCount) stubs, \(result.totalEdges) edges")
+
+        return result
+    }
+}
@@ -23,6 +23,7 @@ final class DecompilationCache {
     private let cacheDirectoryName = "DecompilationCache"
     private let metadataFileName = "metadata.json"
     private let cacheFileName = "cache.dat"
+    private let xrefIndexFileName = "xrefs.idx"
     
     private init() {
         try? createCacheDirectoryIfNeeded()
@@ -38,26 +39,9 @@ final class DecompilationCache {
     func hasCachedResult(for fileURL: URL, fileHash: String? = nil) -> Bool {
         do {
             let hash = try fileHash ?? computeFileHash(at: fileURL)
-            let cacheDir = try cacheDirectory(for: hash)
-            let metadataURL = cacheDir.appendingPathComponent(metadataFileName)
-            let cacheFileURL = cacheDir.appendingPathComponent(cacheFileName)
-            
-            guard fileManager.fileExists(atPath: metadataURL.path),
-                  fileManager.fileExists(atPath: cacheFileURL.path) else {
-                return false
-            }
-            
-            let metadata = try loadMetadata(from: metadataURL)
+            let cacheFileURL = try cacheDirectory(for: hash).appendingPathComponent(cacheFileName)
             
-            // Verify metadata matches current file
-            let currentFileSize = try fileManager.attributesOfItem(atPath: fileURL.path)[.size] as? Int64 ?? 0
-            guard metadata.fileSize == currentFileSize,
-                  metadata.fileHash == hash,
-                  metadata.isValid else {
-                return false
-            }
-            
-            return true
+            return fileManager.fileExists(atPath: cacheFileURL.path) && hasValidMetadata(for: fileURL, fileHash: hash)
         } catch {
             return false
         }
@@ -92,6 +76,56 @@ final class DecompilationCache {
         }
     }
     
+    /// Retrieve a saved xref index. It is kept apart from the cached result,
+    /// so it is available even when the full output is not.
+    /// - Parameters:
+    ///   - fileURL: URL of the binary file
+    ///   - fileHash: Optional pre-computed hash (will compute if nil)
+    /// - Returns: Index answering to/from queries without re-running xref analysis
+    func getCachedXrefIndex(for fileURL: URL, fileHash: String? = nil) -> XrefIndex? {
+        do {
+            let hash = try fileHash ?? computeFileHash(at: fileURL)
+            let indexURL = try cacheDirectory(for: hash).appendingPathComponent(xrefIndexFileName)
+            
+            guard fileManager.fileExists(atPath: indexURL.path),
+                  hasValidMetadata(for: fileURL, fileHash: hash) else {
+                return nil
+            }
+            
+            let data = try Data(contentsOf: indexURL)
+            return try NSKeyedUnarchiver.unarchivedObject(ofClass: XrefIndex.self, from: data)
+        } catch {
+            print("DecompilationCache: Failed to load xref index: \(error)")
+            return nil
+        }
+    }
+    
+    /// Save the xref index of a binary, as soon as analysis produces it
+    /// - Parameters:
+    ///   - index: The index to cache
+    ///   - fileURL: URL of the source binary file
+    ///   - fileHash: Optional pre-computed hash (will compute if nil)
+    func saveXrefIndex(_ index: XrefIndex, for fileURL: URL, fileHash: String? = nil) {
+        do {
+            let hash = try fileHash ?? computeFileHash(at: fileURL)
+            let cacheDir = try cacheDirectory(for: hash, create: true)
+            try saveMetadata(for: fileURL, fileHash: hash, in: cacheDir)
+            
+            let indexURL = cacheDir.appendingPathComponent(xrefIndexFileName)
+            let indexData = try NSKeyedArchiver.archivedData(withRootObject: index, requiringSecureCoding: true)
+            try indexData.write(to: indexURL, options: .atomic)
+        } catch {
+            print("DecompilationCache: Failed to save xref index: \(error)")
+        }
+    }
+    
+    /// Hash identifying a binary's cache entry, to compute once and pass to the other calls
+    /// - Parameter fileURL: URL of the binary file
+    /// - Returns: SHA-256 of the file contents, or nil if it cannot be read
+    func fileHash(for fileURL: URL) -> String? {
+        return try? computeFileHash(at: fileURL)
+    }
+    
     /// Save decompilation result to cache
     /// - Parameters:
     ///   - output: The decompilation result to cache
@@ -101,20 +135,7 @@ final class DecompilationCache {
         do {
             let hash = try fileHash ?? computeFileHash(at: fileURL)
             let cacheDir = try cacheDirectory(for: hash, create: true)
-            
-            // Save metadata
-            let fileSize = try fileManager.attributesOfItem(atPath: fileURL.path)[.size] as? Int64 ?? 0
-            let metadata = CacheMetadata(
-                binaryPath: fileURL.path,
-                fileHash: hash,
-                fileSize: fileSize,
-                cacheDate: Date(),
-                appVersion: Constants.App.versionString
-            )
-            
-            let metadataURL = cacheDir.appendingPathComponent(metadataFileName)
-            let metadataData = try JSONEncoder().encode(metadata)
-            try metadataData.write(to: metadataURL, options: .atomicWrite)
+            try saveMetadata(for: fileURL, fileHash: hash, in: cacheDir)
             
             // Save cache data using NSKeyedArchiver
             let cacheFileURL = cacheDir.appendingPathComponent(cacheFileName)
@@ -258,6 +279,39 @@ final class DecompilationCache {
         }
     }
     
+    private func saveMetadata(for fileURL: URL, fileHash: String, in cacheDir: URL) throws {
+        let fileSize = try fileManager.attributesOfItem(atPath: fileURL.path)[.size] as? Int64 ?? 0
+        let metadata = CacheMetadata(
+            binaryPath: fileURL.path,
+            fileHash: fileHash,
+            fileSize: fileSize,
+            cacheDate: Date(),
+            appVersion: Constants.App.versionString
+        )
+        
+        let metadataURL = cacheDir.appendingPathComponent(metadataFileName)
+        let metadataData = try JSONEncoder().encode(metadata)
+        try metadataData.write(to: metadataURL, options: .atomicWrite)
+    }
+    
+    /// Whether the metadata in the cache directory for fileHash still describes the file
+    private func hasValidMetadata(for fileURL: URL, fileHash: String) -> Bool {
+        do {
+            let metadataURL = try cacheDirectory(for: fileHash).appendingPathComponent(metadataFileName)
+            guard fileManager.fileExists(atPath: metadataURL.path) else {
+                return false
+            }
+            
+            let metadata = try loadMetadata(from: metadataURL)
+            
+            // Verify metadata matches current file
+            let currentFileSize = try fileManager.attributesOfItem(atPath: fileURL.path)[.size] as? Int64 ?? 0
+            return metadata.fileSize == currentFileSize && metadata.fileHash == fileHash && metadata.isValid
+        } catch {
+            return false
+        }
+    }
+    
     private func loadMetadata(from url: URL) throws -> CacheMetadata {
         let data = try Data(contentsOf: url)
         return try JSONDecoder().decode(CacheMetadata.self, from: data)
@@ -1,16 +1,36 @@
 #import <Foundation/Foundation.h>
 #import "DecompiledOutput.h"
+#import "DisassemblyEngine.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 typedef void (^DisassemblyProgressBlock)(NSString *status, float progress);
 
+/// The compact disassembly of a binary's __text, kept so the native CFG,
+/// call graph and xref passes reuse it instead of decoding the section again.
+/// The context and its Mach-O file are closed when this is released.
+@interface CompactDisassembly : NSObject
+
+@property (nonatomic, readonly) DisassemblyContext *context NS_RETURNS_INNER_POINTER;
+@property (nonatomic, readonly) NSUInteger instructionCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
 @interface DisassemblerService : NSObject
 
 + (nullable NSArray<InstructionModel *> *)disassembleFileAtPath:(NSString *)filePath
                                                   progressBlock:(nullable DisassemblyProgressBlock)progressBlock
                                                           error:(NSError **)error;
 
+/// As above, and hands the decoded __text out through disassembly (left nil
+/// when nothing was decoded) for the native analyses to share.
++ (nullable NSArray<InstructionModel *> *)disassembleFileAtPath:(NSString *)filePath
+                                                  progressBlock:(nullable DisassemblyProgressBlock)progressBlock
+                                                    disassembly:(CompactDisassembly * _Nullable * _Nullable)disassembly
+                                                          error:(NSError **)error;
+
 + (nullable NSArray<InstructionModel *> *)disassembleFileAtPath:(NSString *)filePath
                                                     startAddress:(uint64_t)startAddress
                                                       endAddress:(uint64_t)endAddress
@@ -11,6 +11,34 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
     ReDyneDisassemblerErrorDisassemblyFailed = 2003
 };
 
+@implementation CompactDisassembly {
+    DisassemblyContext *_context;
+}
+
+- (instancetype)initWithContext:(DisassemblyContext *)context {
+    self = [super init];
+    if (self) {
+        _context = context;
+    }
+    return self;
+}
+
+- (DisassemblyContext *)context {
+    return _context;
+}
+
+- (NSUInteger)instructionCount {
+    return _context->instruction_count;
+}
+
+- (void)dealloc {
+    MachOContext *macho_ctx = _context->macho_ctx;
+    disasm_free(_context);
+    macho_close(macho_ctx);
+}
+
+@end
+
 @implementation DisassemblerService
 
 #pragma mark - Public Methods
@@ -18,6 +46,17 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
 + (NSArray<InstructionModel *> *)disassembleFileAtPath:(NSString *)filePath
                                          progressBlock:(DisassemblyProgressBlock)progressBlock
                                                  error:(NSError **)error {
+    return [self disassembleFileAtPath:filePath progressBlock:progressBlock disassembly:NULL error:error];
+}
+
++ (NSArray<InstructionModel *> *)disassembleFileAtPath:(NSString *)filePath
+                                         progressBlock:(DisassemblyProgressBlock)progressBlock
+                                           disassembly:(CompactDisassembly **)disassembly
+                                                 error:(NSError **)error {
+    
+    if (disassembly) {
+        *disassembly = nil;
+    }
     
     if (progressBlock) {
         progressBlock(@"Opening binary...", 0.0);
@@ -52,6 +91,10 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
         return nil;
     }
     
+    // Keep only the compact per-instruction record; text is re-decoded
+    // one instruction at a time while the models are built.
+    disasm_enable_flag(disasm_ctx, DISASM_FLAG_COMPACT);
+    
     if (!disasm_load_section(disasm_ctx, "__text")) {
         NSLog(@"No __text section found. Available sections:");
         for (uint32_t i = 0; i < macho_ctx->section_count; i++) {
@@ -75,7 +118,8 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
         progressBlock(@"Disassembling instructions...", 0.4);
     }
     
-    uint32_t count = disasm_all(disasm_ctx);
+    uint32_t threads = (uint32_t)[NSProcessInfo processInfo].activeProcessorCount;
+    uint32_t count = disasm_all_parallel(disasm_ctx, threads);
     NSLog(@"Disassembled %u instructions from __text section (size: %llu bytes)",
           count, disasm_ctx->code_size);
     
@@ -92,7 +136,9 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
     
     NSMutableArray<InstructionModel *> *instructions = [NSMutableArray arrayWithCapacity:count];
     for (uint32_t i = 0; i < count; i++) {
-        InstructionModel *model = [self createInstructionModelFromDisasm:&disasm_ctx->instructions[i]];
+        DisassembledInstruction inst;
+        if (!disasm_get_instruction(disasm_ctx, i, &inst)) break;
+        InstructionModel *model = [self createInstructionModelFromDisasm:&inst];
         [instructions addObject:model];
     }
     
@@ -100,8 +146,12 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
         progressBlock(@"Complete!", 1.0);
     }
     
-    disasm_free(disasm_ctx);
-    macho_close(macho_ctx);
+    if (disassembly) {
+        *disassembly = [[CompactDisassembly alloc] initWithContext:disasm_ctx];
+    } else {
+        disasm_free(disasm_ctx);
+        macho_close(macho_ctx);
+    }
     
     return instructions;
 }
@@ -137,6 +187,7 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
         return nil;
     }
     
+    disasm_enable_flag(disasm_ctx, DISASM_FLAG_COMPACT);
     uint32_t count = disasm_range(disasm_ctx, startAddress, endAddress);
     
     if (count == 0) {
@@ -150,7 +201,9 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
     
     NSMutableArray<InstructionModel *> *instructions = [NSMutableArray arrayWithCapacity:count];
     for (uint32_t i = 0; i < count; i++) {
-        InstructionModel *model = [self createInstructionModelFromDisasm:&disasm_ctx->instructions[i]];
+        DisassembledInstruction inst;
+        if (!disasm_get_instruction(disasm_ctx, i, &inst)) break;
+        InstructionModel *model = [self createInstructionModelFromDisasm:&inst];
         [instructions addObject:model];
     }
     
@@ -408,6 +461,11 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
     NSMutableSet<NSNumber *> *blockStarts = [NSMutableSet set];
     [blockStarts addObject:@(0)];
     
+    NSMutableDictionary<NSNumber *, NSNumber *> *indexByAddress = [NSMutableDictionary dictionaryWithCapacity:instructions.count];
+    for (NSInteger j = instructions.count - 1; j >= 0; j--) {
+        indexByAddress[@(instructions[j].address)] = @(j);
+    }
+    
     for (NSInteger i = 0; i < instructions.count; i++) {
         InstructionModel *inst = instructions[i];
         
@@ -417,11 +475,9 @@ typedef NS_ENUM(NSInteger, ReDyneDisassemblerError) {
             }
             
             if (inst.hasBranchTarget) {
-                for (NSInteger j = 0; j < instructions.count; j++) {
-                    if (instructions[j].address == inst.branchTarget) {
-                        [blockStarts addObject:@(j)];
-                        break;
-                    }
+                NSNumber *targetIndex = indexByAddress[@(inst.branchTarget)];
+                if (targetIndex) {
+                    [blockStarts addObject:targetIndex];
                 }
             }
         }
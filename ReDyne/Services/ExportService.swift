@@ -257,6 +257,8 @@ class ExportService {
                 "length": string.length,
                 "section": string.section,
                 "is_cstring": string.isCString,
+                "is_unicode": string.isUnicode,
+                "cfstring_address": string.cfstringAddress != 0 ? String(format: "0x%llX", string.cfstringAddress) as Any : NSNull() as Any,
                 "content": string.content
             ]
         }
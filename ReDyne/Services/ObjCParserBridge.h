@@ -2,6 +2,10 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class CompactDisassembly;
+@class FunctionModel;
+@class SymbolModel;
+
 @interface ObjCParserBridge : NSObject
 
 + (nullable id)parseObjCRuntimeAtPath:(NSString *)filePath;
@@ -10,6 +14,21 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (nullable id)parseCodeSignatureAtPath:(NSString *)filePath;
 
+/// Builds the CFG of every function in the disassembled __text natively,
+/// split at the functions' start addresses, and returns a CFGAnalysisResult.
++ (nullable id)buildControlFlowGraphsWithDisassembly:(CompactDisassembly *)disassembly
+                                           functions:(NSArray<FunctionModel *> *)functions;
+
+/// Builds the whole-program call graph of the disassembled __text natively
+/// from direct calls and symbol stubs and returns a CallGraphResult.
++ (nullable id)buildCallGraphWithDisassembly:(CompactDisassembly *)disassembly
+                                   functions:(NSArray<FunctionModel *> *)functions;
+
+/// Finds every code and data xref in the disassembled __text natively and
+/// returns an XrefAnalysisResult.
++ (nullable id)analyzeCrossReferencesWithDisassembly:(CompactDisassembly *)disassembly
+                                             symbols:(NSArray<SymbolModel *> *)symbols;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -2,6 +2,13 @@
 #import "MachOHeader.h"
 #import "ObjCParser.h"
 #import "DyldInfo.h"
+#import "DisassemblyEngine.h"
+#import "ControlFlowGraph.h"
+#import "SymbolTable.h"
+#import "CallGraph.h"
+#import "XrefTable.h"
+#import "DecompiledOutput.h"
+#import "DisassemblerService.h"
 #import "ReDyne-Swift.h"
 
 @implementation ObjCParserBridge
@@ -60,4 +67,80 @@
     return result;
 }
 
++ (nullable id)buildControlFlowGraphsWithDisassembly:(CompactDisassembly *)disassembly
+                                           functions:(NSArray<FunctionModel *> *)functions {
+    if (functions.count == 0) {
+        return nil;
+    }
+    
+    uint32_t threads = (uint32_t)[NSProcessInfo processInfo].activeProcessorCount;
+    uint32_t count = (uint32_t)functions.count;
+    uint64_t *starts = malloc(count * sizeof(uint64_t));
+    CFGContext *cfg = starts ? cfg_create(disassembly.context) : NULL;
+    if (!cfg) {
+        free(starts);
+        return nil;
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        starts[i] = functions[i].startAddress;
+    }
+    
+    id result = nil;
+    if (cfg_build_functions(cfg, starts, count, threads) > 0) {
+        cfg_detect_loops(cfg);
+        result = [CFGAnalyzer analyzeWithCfgContext:cfg functions:functions];
+    }
+    
+    free(starts);
+    cfg_free(cfg);
+    
+    return result;
+}
+
++ (nullable id)buildCallGraphWithDisassembly:(CompactDisassembly *)disassembly
+                                   functions:(NSArray<FunctionModel *> *)functions {
+    if (functions.count == 0) {
+        return nil;
+    }
+    
+    DisassemblyContext *disasm = disassembly.context;
+    
+    // Names only; a binary without a symbol table still gets its graph.
+    SymbolTableContext *symbols = symbol_table_create(disasm->macho_ctx);
+    if (symbols && !symbol_table_parse(symbols)) {
+        symbol_table_free(symbols);
+        symbols = NULL;
+    }
+    
+    uint32_t count = (uint32_t)functions.count;
+    uint64_t *starts = malloc(count * sizeof(uint64_t));
+    for (uint32_t i = 0; starts && i < count; i++) {
+        starts[i] = functions[i].startAddress;
+    }
+    
+    CallGraph *graph = starts ? callgraph_build(disasm, symbols, starts, count) : NULL;
+    id result = graph ? [CallGraphAnalyzer analyzeWithCallGraph:graph functions:functions] : nil;
+    
+    free(starts);
+    callgraph_free(graph);
+    symbol_table_free(symbols);
+    
+    return result;
+}
+
++ (nullable id)analyzeCrossReferencesWithDisassembly:(CompactDisassembly *)disassembly
+                                             symbols:(NSArray<SymbolModel *> *)symbols {
+    XrefTable *table = xref_analyze(disassembly.context);
+    if (!table) {
+        return nil;
+    }
+    
+    id result = [XrefAnalyzer analyzeWithXrefTable:table disassembly:disassembly.context symbols:symbols];
+    
+    xref_table_free(table);
+    
+    return result;
+}
+
 @end
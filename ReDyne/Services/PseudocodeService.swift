@@ -193,18 +193,13 @@ public class PseudocodeService {
                 ptr.load(as: UInt32.self)
             }
             
+            // Undecodable words come back as ".word 0x..." and are formatted like the disassembler's.
             var decoded = ARM64DecodedInstruction()
-            let success = arm64dec_decode_instruction(rawInstruction, currentAddr, &decoded)
+            _ = arm64dec_decode_instruction(rawInstruction, currentAddr, &decoded)
             
-            if success {
-                var buffer = [CChar](repeating: 0, count: 512)
-                let _ = arm64dec_format_instruction(&decoded, &buffer, 512)
-                let assembly = String(cString: buffer)
-                
-                disassembly += String(format: "0x%llx: %@\n", currentAddr, assembly)
-            } else {
-                disassembly += String(format: "0x%llx: .long 0x%08X\n", currentAddr, rawInstruction)
-            }
+            var buffer = [CChar](repeating: 0, count: 256)
+            _ = arm64dec_format_instruction(&decoded, &buffer, buffer.count)
+            disassembly += String(format: "0x%llx: %@\n", currentAddr, String(cString: buffer))
             
             currentAddr += 4
         }
@@ -50,7 +50,7 @@ private class RegisterState {
 /// Analyzer for cross-references (xrefs) in disassembled code
 /// Uses symbolic execution to track register values and resolve addresses
 /// Identifies calls, jumps, and data references between functions and memory locations
-class XrefAnalyzer {
+@objc class XrefAnalyzer: NSObject {
     
     // MARK: - ARM64 Instruction Patterns
     
@@ -109,7 +109,9 @@ class XrefAnalyzer {
         
         print("Found \(allXrefs.count) cross-references")
         
-        let functionXrefs = buildFunctionXrefs(allXrefs: allXrefs, symbols: symbols, symbolTable: symbolTable)
+        allXrefs.sort { $0.fromAddress < $1.fromAddress }
+        let index = XrefIndex(xrefs: allXrefs)
+        let functionXrefs = buildFunctionXrefs(allXrefs: allXrefs, index: index, symbols: symbols)
         let totalCalls = allXrefs.filter { $0.xrefType == .call }.count
         let totalJumps = allXrefs.filter { $0.xrefType == .jump || $0.xrefType == .conditionalJump }.count
         let totalDataRefs = allXrefs.filter { $0.xrefType == .dataRead || $0.xrefType == .dataWrite }.count
@@ -126,10 +128,161 @@ class XrefAnalyzer {
             totalJumps: totalJumps,
             totalDataRefs: totalDataRefs,
             functionXrefs: functionXrefs,
-            allXrefs: allXrefs
+            allXrefs: allXrefs,
+            index: index
         )
     }
     
+    // MARK: - Native Table
+    
+    /// Converts xrefs found natively by xref_analyze into the analysis result
+    /// - Parameters:
+    ///   - xrefTable: Opaque pointer to an XrefTable
+    ///   - disassembly: Opaque pointer to the DisassemblyContext the table was built from, for instruction text
+    ///   - symbols: Known symbols for resolution
+    /// - Returns: Analysis result containing every xref in the table, in source address order
+    @objc static func analyze(xrefTable: OpaquePointer, disassembly: OpaquePointer, symbols: [SymbolModel]) -> XrefAnalysisResult {
+        let startTime = CFAbsoluteTimeGetCurrent()
+        let table = UnsafeMutablePointer<XrefTable>(xrefTable)
+        let disasm = UnsafeMutablePointer<DisassemblyContext>(disassembly)
+        let count = Int(table.pointee.count)
+        let symbolName = symbolResolver(symbols)
+        
+        var allXrefs: [CrossReference] = []
+        allXrefs.reserveCapacity(count)
+        var inst = DisassembledInstruction()
+        
+        for i in 0..<count {
+            let entry = table.pointee.entries[i]
+            var text = ""
+            let index = disasm_find_by_address(disasm, entry.from)
+            if index >= 0 && disasm_get_instruction(disasm, UInt32(index), &inst) {
+                let mnemonic = withUnsafePointer(to: inst.mnemonic) {
+                    $0.withMemoryRebound(to: CChar.self, capacity: 32) { String(cString: $0) }
+                }
+                let operands = withUnsafePointer(to: inst.operands) {
+                    $0.withMemoryRebound(to: CChar.self, capacity: Int(MAX_OPERAND_STRING)) { String(cString: $0) }
+                }
+                text = "\(mnemonic.lowercased()) \(operands)"
+            }
+            let type = XrefType(rawValue: String(cString: xref_kind_name(XrefKind(entry.kind)))) ?? .unknown
+            
+            allXrefs.append(CrossReference(
+                fromAddress: entry.from,
+                toAddress: entry.to,
+                type: type,
+                instruction: text,
+                fromSymbol: symbolName(entry.from),
+                toSymbol: symbolName(entry.to)
+            ))
+        }
+        
+        let index = XrefIndex(
+            sources: allXrefs.map { $0.fromAddress },
+            targets: allXrefs.map { $0.toAddress },
+            kindCodes: (0..<count).map { UInt8(table.pointee.entries[$0].kind) },
+            targetOrder: Array(UnsafeBufferPointer(start: table.pointee.by_target, count: count))
+        )
+        let functionXrefs = buildFunctionXrefs(allXrefs: allXrefs, index: index, symbols: symbols.map { SymbolInfo(from: $0) })
+        
+        let counts = table.pointee.kind_counts
+        let totalCalls = Int(counts.0)
+        let totalJumps = Int(counts.1) + Int(counts.2)
+        let totalDataRefs = Int(counts.3) + Int(counts.4)
+        
+        let elapsed = CFAbsoluteTimeGetCurrent() - startTime
+        print("Native xref table: \(count) xrefs over \(table.pointee.block_count) blocks, converted in \(String(format: "%.2f", elapsed))s")
+        
+        return XrefAnalysisResult(
+            totalXrefs: count,
+            totalCalls: totalCalls,
+            totalJumps: totalJumps,
+            totalDataRefs: totalDataRefs,
+            functionXrefs: functionXrefs,
+            allXrefs: allXrefs,
+            index: index
+        )
+    }
+    
+    // MARK: - Cached Index
+    
+    /// Rebuilds the analysis result from an index saved by DecompilationCache, without sweeping the binary again
+    /// - Parameters:
+    ///   - index: Index from an earlier analysis of the same binary
+    ///   - symbols: Known symbols for resolution
+    ///   - instructions: Disassembly of the binary in address order, for instruction text
+    /// - Returns: Analysis result containing every xref in the index, in source address order
+    @objc static func analyze(index: XrefIndex, symbols: [SymbolModel], instructions: [InstructionModel]) -> XrefAnalysisResult {
+        let symbolName = symbolResolver(symbols)
+        let addresses = instructions.map { $0.address }
+        
+        var allXrefs: [CrossReference] = []
+        allXrefs.reserveCapacity(index.count)
+        for entry in 0..<index.count {
+            let from = index.source(at: entry)
+            let to = index.target(at: entry)
+            var text = ""
+            let position = upperBound(addresses, from) - 1
+            if position >= 0 && addresses[position] == from {
+                text = "\(instructions[position].mnemonic.lowercased()) \(instructions[position].operands)"
+            }
+            
+            allXrefs.append(CrossReference(
+                fromAddress: from,
+                toAddress: to,
+                type: index.kind(at: entry),
+                instruction: text,
+                fromSymbol: symbolName(from),
+                toSymbol: symbolName(to)
+            ))
+        }
+        
+        let functionXrefs = buildFunctionXrefs(allXrefs: allXrefs, index: index, symbols: symbols.map { SymbolInfo(from: $0) })
+        
+        return XrefAnalysisResult(
+            totalXrefs: allXrefs.count,
+            totalCalls: allXrefs.filter { $0.xrefType == .call }.count,
+            totalJumps: allXrefs.filter { $0.xrefType == .jump || $0.xrefType == .conditionalJump }.count,
+            totalDataRefs: allXrefs.filter { $0.xrefType == .dataRead || $0.xrefType == .dataWrite }.count,
+            functionXrefs: functionXrefs,
+            allXrefs: allXrefs,
+            index: index
+        )
+    }
+    
+    /// Names an address as the defined symbol at it, or "symbol+offset" within 1 KB past one; memoized
+    private static func symbolResolver(_ symbols: [SymbolModel]) -> (UInt64) -> String {
+        let defined = symbols.filter { $0.isDefined }.sorted { $0.address < $1.address }
+        let addresses = defined.map { $0.address }
+        var names: [UInt64: String] = [:]
+        
+        return { address in
+            if let cached = names[address] { return cached }
+            var name = ""
+            let index = upperBound(addresses, address) - 1
+            if index >= 0 {
+                let offset = address - addresses[index]
+                if offset == 0 {
+                    name = defined[index].name
+                } else if offset < 1024 {
+                    name = "\(defined[index].name)+\(offset)"
+                }
+            }
+            names[address] = name
+            return name
+        }
+    }
+    
+    private static func upperBound(_ sorted: [UInt64], _ value: UInt64) -> Int {
+        var lo = 0
+        var hi = sorted.count
+        while lo < hi {
+            let mid = (lo + hi) / 2
+            if sorted[mid] <= value { lo = mid + 1 } else { hi = mid }
+        }
+        return lo
+    }
+    
     // MARK: - Disassembly Parsing
     
     private struct Instruction {
@@ -537,19 +690,15 @@ class XrefAnalyzer {
     
     // MARK: - Function Xref Building
     
-    private static func buildFunctionXrefs(allXrefs: [CrossReference], symbols: [SymbolInfo], symbolTable: [UInt64: SymbolInfo]) -> [String: FunctionXrefs] {
+    private static func buildFunctionXrefs(allXrefs: [CrossReference], index: XrefIndex, symbols: [SymbolInfo]) -> [String: FunctionXrefs] {
         var result: [String: FunctionXrefs] = [:]
         
         for symbol in symbols where symbol.isFunction {
             let address = symbol.address
             let key = String(format: "0x%llX", address)
-            let xrefsTo = allXrefs.filter { xref in
-                xref.toAddress == address || (xref.toAddress >= address && xref.toAddress < address + symbol.size)
-            }
-            
-            let xrefsFrom = allXrefs.filter { xref in
-                xref.fromAddress >= address && xref.fromAddress < address + symbol.size
-            }
+            let end = address + max(symbol.size, 1)
+            let xrefsTo = index.entries(targeting: address, to: end).map { allXrefs[$0] }
+            let xrefsFrom = Array(allXrefs[index.entries(from: address, to: end)])
             
             if !xrefsTo.isEmpty || !xrefsFrom.isEmpty {
                 result[key] = FunctionXrefs(
@@ -575,20 +724,6 @@ class XrefAnalyzer {
         return xrefs.filter { $0.xrefType == type }
     }
     
-    /// Groups cross-references by their from address
-    /// - Parameter xrefs: Array of cross-references to group
-    /// - Returns: Dictionary mapping from addresses to their xrefs
-    static func groupXrefsByFromAddress(_ xrefs: [CrossReference]) -> [UInt64: [CrossReference]] {
-        return Dictionary(grouping: xrefs) { $0.fromAddress }
-    }
-    
-    /// Groups cross-references by their target address
-    /// - Parameter xrefs: Array of cross-references to group
-    /// - Returns: Dictionary mapping target addresses to their xrefs
-    static func groupXrefsByToAddress(_ xrefs: [CrossReference]) -> [UInt64: [CrossReference]] {
-        return Dictionary(grouping: xrefs) { $0.toAddress }
-    }
-    
     /// Finds all callers of a specific function
     /// - Parameters:
     ///   - address: The function address to find callers for
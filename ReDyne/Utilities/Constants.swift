@@ -7,7 +7,6 @@ enum Constants {
     // MARK: - File Constraints
     
     enum File {
-        static let maxFileSize: Int64 = 200 * 1024 * 1024
         static let allowedExtensions = ["dylib", "so", ""]
         static let tempDirectoryName = "ReDyneTempFiles"
         static let patchSetsDirectoryName = "PatchSets"
@@ -6,7 +6,6 @@ enum ReDyneError: LocalizedError {
     case invalidMachO(reason: String)
     case parseFailure(detail: String)
     case encryptedBinary
-    case fileTooLarge(size: Int64, limit: Int64)
     case noCodeSection
     case disassemblyFailed
     case unsupportedArchitecture(arch: String)
@@ -23,8 +22,6 @@ enum ReDyneError: LocalizedError {
             return "Failed to parse binary: \(detail)"
         case .encryptedBinary:
             return "Binary is encrypted"
-        case .fileTooLarge(let size, let limit):
-            return "File too large: \(size) bytes (limit: \(limit) bytes)"
         case .noCodeSection:
             return "No executable code section found"
         case .disassemblyFailed:
@@ -48,8 +45,6 @@ enum ReDyneError: LocalizedError {
             return "The binary may be corrupted or use an unsupported format."
         case .encryptedBinary:
             return "Encrypted binaries cannot be decompiled. Try decrypting first or select an unencrypted binary."
-        case .fileTooLarge:
-            return "Try selecting a smaller binary file (limit: 200MB)."
         case .noCodeSection:
             return "This binary doesn't contain executable code to disassemble."
         case .disassemblyFailed:
@@ -73,8 +68,6 @@ enum ReDyneError: LocalizedError {
             return "Binary structure could not be parsed."
         case .encryptedBinary:
             return "The binary's code section is encrypted."
-        case .fileTooLarge:
-            return "File size exceeds maximum processing limit."
         case .noCodeSection:
             return "No __text section found in binary."
         case .disassemblyFailed:
@@ -129,11 +122,6 @@ class ErrorHandler {
             return .parseFailure(detail: errorMessage)
         case 1004:
             return .encryptedBinary
-        case 1005:
-            if errorMessage.contains("bytes") {
-                return .parseFailure(detail: errorMessage)
-            }
-            return .fileTooLarge(size: 0, limit: 200_000_000)
         case 2002:
             return .noCodeSection
         default:
@@ -135,11 +135,20 @@ class DecompileViewController: UIViewController {
         
         // Check for cached result first
         statusLabel.text = "Checking cache..."
-        if let cachedOutput = DecompilationCache.shared.getCachedResult(for: fileURL) {
+        let fileHash = DecompilationCache.shared.fileHash(for: fileURL)
+        if let cachedOutput = DecompilationCache.shared.getCachedResult(for: fileURL, fileHash: fileHash) {
             print("✅ Using cached decompilation result for \(fileURL.lastPathComponent)")
             statusLabel.text = "Loading from cache..."
             progressView.progress = 1.0
             
+            if cachedOutput.xrefAnalysis == nil,
+               let index = DecompilationCache.shared.getCachedXrefIndex(for: fileURL, fileHash: fileHash) {
+                let xrefResult = XrefAnalyzer.analyze(index: index, symbols: cachedOutput.symbols, instructions: cachedOutput.instructions)
+                cachedOutput.xrefAnalysis = xrefResult
+                cachedOutput.totalXrefs = UInt(xrefResult.totalXrefs)
+                cachedOutput.totalCalls = UInt(xrefResult.totalCalls)
+            }
+            
             // Small delay to show the cache message
             DispatchQueue.main.asyncAfter(deadline: .now() + 0.3) { [weak self] in
                 self?.showResults(cachedOutput)
@@ -169,10 +178,11 @@ class DecompileViewController: UIViewController {
                 )
 
                 // Cache the binary data into the DecompiledOutput so other viewers (like Hex Viewer)
-                // can read from memory instead of attempting to load from disk later.
+                // can read from memory instead of attempting to load from disk later. The file is
+                // mapped rather than read so only the pages a viewer touches become resident.
                 if let out = output {
                     do {
-                        let data = try Data(contentsOf: self.fileURL)
+                        let data = try Data(contentsOf: self.fileURL, options: .alwaysMapped)
                         out.fileData = data
                     } catch {
                         // If we can't read the file here, log the error but continue.
@@ -195,6 +205,8 @@ class DecompileViewController: UIViewController {
             
             self.updateStatus("Disassembling code...", progress: 0.6)
             
+            // __text is decoded once here; the xref, call graph and CFG passes share it.
+            var disassembly: CompactDisassembly?
             do {
                 let instructions = try DisassemblerService.disassembleFile(
                     atPath: self.fileURL.path,
@@ -203,7 +215,8 @@ class DecompileViewController: UIViewController {
                             self.statusLabel.text = status
                             self.progressView.progress = 0.6 + (progress * 0.3)
                         }
-                    }
+                    },
+                    disassembly: &disassembly
                 )
                 
                 output.instructions = instructions
@@ -213,10 +226,25 @@ class DecompileViewController: UIViewController {
                 output.functions = functions
                 
                 self.updateStatus("Analyzing cross-references...", progress: 0.85)
-                let disassemblyText = instructions.map { $0.fullDisassembly }.joined(separator: "\n")
                 let symbols = (output.symbols as NSArray).map { $0 as! SymbolModel }
-                let symbolInfos = symbols.map { SymbolInfo(from: $0) }
-                let xrefResult = XrefAnalyzer.analyze(disassembly: disassemblyText, symbols: symbolInfos)
+                let xrefResult: XrefAnalysisResult
+                let cachedIndex = DecompilationCache.shared.getCachedXrefIndex(for: self.fileURL, fileHash: fileHash)
+                if let index = cachedIndex {
+                    xrefResult = XrefAnalyzer.analyze(index: index, symbols: symbols, instructions: instructions)
+                } else if let disassembly = disassembly,
+                          let nativeResult = ObjCParserBridge.analyzeCrossReferences(with: disassembly, symbols: symbols) as? XrefAnalysisResult {
+                    xrefResult = nativeResult
+                } else {
+                    let disassemblyText = instructions.map { $0.fullDisassembly }.joined(separator: "\n")
+                    let symbolInfos = symbols.map { SymbolInfo(from: $0) }
+                    xrefResult = XrefAnalyzer.analyze(disassembly: disassemblyText, symbols: symbolInfos)
+                }
+                if let disassembly = disassembly {
+                    xrefResult.callGraph = ObjCParserBridge.buildCallGraph(with: disassembly, functions: functions) as? CallGraphResult
+                }
+                if cachedIndex == nil {
+                    DecompilationCache.shared.saveXrefIndex(xrefResult.index, for: self.fileURL, fileHash: fileHash)
+                }
                 output.xrefAnalysis = xrefResult
                 output.totalXrefs = UInt(xrefResult.totalXrefs)
                 output.totalCalls = UInt(xrefResult.totalCalls)
@@ -258,13 +286,18 @@ class DecompileViewController: UIViewController {
             
             self.updateStatus("Analyzing control flow graphs...", progress: 0.97)
             let functions = (output.functions as NSArray).map { $0 as! FunctionModel }
-            let cfgResult = CFGAnalyzer.analyze(functions: functions)
-            output.cfgAnalysis = cfgResult
+            if let disassembly = disassembly,
+               let cfgResult = ObjCParserBridge.buildControlFlowGraphs(with: disassembly, functions: functions) as? CFGAnalysisResult {
+                output.cfgAnalysis = cfgResult
+            } else {
+                output.cfgAnalysis = CFGAnalyzer.analyze(functions: functions)
+            }
+            disassembly = nil
             
             self.updateStatus("Finalizing...", progress: 0.99)
             
             // Save to cache for future use
-            DecompilationCache.shared.saveCachedResult(output, for: self.fileURL)
+            DecompilationCache.shared.saveCachedResult(output, for: self.fileURL, fileHash: fileHash)
             
             DispatchQueue.main.async {
                 self.showResults(output)
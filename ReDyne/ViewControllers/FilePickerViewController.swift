@@ -286,16 +286,6 @@ import Combine
             return
         }
         
-        do {
-            let attributes = try FileManager.default.attributesOfItem(atPath: url.path)
-            if let fileSize = attributes[.size] as? Int64, fileSize > Constants.File.maxFileSize {
-                ErrorHandler.showError(ReDyneError.fileTooLarge(size: fileSize, limit: Constants.File.maxFileSize), in: self)
-                return
-            }
-        } catch {
-            ErrorHandler.log(error)
-        }
-        
         if addToRecent {
             UserDefaults.standard.addRecentFile(url.path)
             loadRecentFiles()
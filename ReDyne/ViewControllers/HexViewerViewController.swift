@@ -216,7 +216,7 @@ class HexViewerViewController: UIViewController, UITableViewDelegate, UITableVie
             if let cached = initialFileData {
                 binaryData = cached
             } else {
-                binaryData = try Data(contentsOf: fileURL)
+                binaryData = try Data(contentsOf: fileURL, options: .alwaysMapped)
             }
             resetFilteredRanges()
             updateInfoLabel()
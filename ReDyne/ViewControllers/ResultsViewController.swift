@@ -725,12 +725,15 @@ class StringsViewController: UITableViewController {
         let string = filteredStrings[indexPath.row]
         let alert = UIAlertController(title: "String Details", message: nil, preferredStyle: .alert)
         
+        let type = string.isUnicode ? "UTF-16 String" : (string.isCString ? "C String" : "Data String")
+        let cfstring = string.cfstringAddress != 0 ? "\nCFString: \(Constants.formatAddress(string.cfstringAddress))" : ""
+        
         let details = """
         Address: \(Constants.formatAddress(string.address))
         Offset: 0x\(String(format: "%llX", string.offset))
         Length: \(string.length) bytes
         Section: \(string.section)
-        Type: \(string.isCString ? "C String" : "Data String")
+        Type: \(type)\(cfstring)
         
         Content:
         \(string.content)
@@ -0,0 +1,421 @@
+/*
+ * redyne-cli - headless driver for the native analysis core.
+ *
+ * Runs the pipeline of BinaryParserService and DisassemblerService (header,
+ * load commands, segments, sections, symbols, strings, __text disassembly,
+ * ObjC runtime) on each input through batch_analyze and writes one JSON
+ * object per binary per line (JSON Lines) as each one finishes.
+ *
+ *   redyne-cli [-j workers] [-m budget_mb] [-o out.jsonl] [-r] [-p]
+ *              [--symbols] [--strings] [--instructions] [--classes]
+ *              path...
+ *
+ * All binaries share one pool of `workers` threads (default: online CPUs)
+ * and a memory budget for the binaries in flight. Directories are walked
+ * (recursively with -r) and files without a Mach-O or fat magic are left
+ * out, so an unpacked IPA can be passed as a directory.
+ */
+
+#include "BatchAnalysis.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#pragma mark - Options
+
+enum {
+    CLI_DETAIL_SYMBOLS      = (1u << 0),
+    CLI_DETAIL_STRINGS      = (1u << 1),
+    CLI_DETAIL_INSTRUCTIONS = (1u << 2),
+    CLI_DETAIL_CLASSES      = (1u << 3),
+};
+
+typedef struct {
+    uint32_t details;       // CLI_DETAIL_* lists to include
+    bool recursive;
+    bool progress;
+    FILE *out;
+    uint32_t total;
+    uint32_t completed;
+} CLIOptions;
+
+typedef struct {
+    char **items;
+    uint32_t count;
+    uint32_t capacity;
+} CLIPathList;
+
+static bool cli_path_list_add(CLIPathList *list, const char *path) {
+    if (list->count == list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 64;
+        char **items = (char**)realloc(list->items, capacity * sizeof(char*));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count] = strdup(path);
+    if (!list->items[list->count]) return false;
+    list->count++;
+    return true;
+}
+
+static bool cli_has_macho_magic(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+    uint32_t magic = 0;
+    size_t n = fread(&magic, sizeof(magic), 1, file);
+    fclose(file);
+    if (n != 1) return false;
+    return magic == MH_MAGIC || magic == MH_CIGAM || magic == MH_MAGIC_64 || magic == MH_CIGAM_64 ||
+           magic == FAT_MAGIC || magic == FAT_CIGAM;
+}
+
+static void cli_collect_directory(CLIPathList *list, const char *path, bool recursive) {
+    DIR *dir = opendir(path);
+    if (!dir) return;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        char child[PATH_MAX];
+        if (snprintf(child, sizeof(child), "%s/%s", path, entry->d_name) >= (int)sizeof(child)) continue;
+        struct stat st;
+        if (lstat(child, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            if (recursive) cli_collect_directory(list, child, recursive);
+        } else if (S_ISREG(st.st_mode) && cli_has_macho_magic(child)) {
+            cli_path_list_add(list, child);
+        }
+    }
+    closedir(dir);
+}
+
+#pragma mark - JSON
+
+/* Writes s as a JSON string. Bytes that are not valid UTF-8 are written as
+   the code point of the same value so every output line stays valid. */
+static void cli_json_string(FILE *out, const char *s) {
+    const unsigned char *p = (const unsigned char*)(s ? s : "");
+    fputc('"', out);
+    while (*p) {
+        unsigned char c = *p;
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+            p++;
+        } else if (c < 0x20) {
+            switch (c) {
+                case '\n': fputs("\\n", out); break;
+                case '\r': fputs("\\r", out); break;
+                case '\t': fputs("\\t", out); break;
+                default: fprintf(out, "\\u%04x", c); break;
+            }
+            p++;
+        } else if (c < 0x80) {
+            fputc(c, out);
+            p++;
+        } else {
+            int length = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 0;
+            int valid = length > 0;
+            for (int i = 1; valid && i < length; i++) valid = (p[i] & 0xC0) == 0x80;
+            if (valid) {
+                fwrite(p, 1, (size_t)length, out);
+                p += length;
+            } else {
+                fprintf(out, "\\u%04x", c);
+                p++;
+            }
+        }
+    }
+    fputc('"', out);
+}
+
+/* Fixed-size name fields (segname, sectname) are not always terminated. */
+static void cli_json_name(FILE *out, const char *name, size_t size) {
+    char buffer[32];
+    size_t length = strnlen(name, size < sizeof(buffer) ? size : sizeof(buffer) - 1);
+    memcpy(buffer, name, length);
+    buffer[length] = '\0';
+    cli_json_string(out, buffer);
+}
+
+static void cli_json_address(FILE *out, uint64_t address) {
+    fprintf(out, "\"0x%llx\"", (unsigned long long)address);
+}
+
+#pragma mark - Results
+
+static void cli_write_layout(FILE *out, MachOContext *ctx) {
+    fprintf(out, ",\"header\":{\"cpu\":");
+    cli_json_string(out, macho_cpu_type_string(ctx->header.cputype));
+    fprintf(out, ",\"cpu_subtype\":");
+    cli_json_string(out, macho_cpu_subtype_string(ctx->header.cputype, ctx->header.cpusubtype));
+    fprintf(out, ",\"filetype\":");
+    cli_json_string(out, macho_filetype_string(ctx->header.filetype));
+    fprintf(out, ",\"ncmds\":%u,\"flags\":%u,\"is_64bit\":%s}",
+            ctx->header.ncmds, ctx->header.flags, ctx->header.is_64bit ? "true" : "false");
+
+    if (ctx->has_uuid) {
+        fprintf(out, ",\"uuid\":\"");
+        for (int i = 0; i < 16; i++) {
+            fprintf(out, "%02X", ctx->uuid[i]);
+            if (i == 3 || i == 5 || i == 7 || i == 9) fputc('-', out);
+        }
+        fputc('"', out);
+    }
+    fprintf(out, ",\"encrypted\":%s", ctx->is_encrypted ? "true" : "false");
+
+    fprintf(out, ",\"segments\":[");
+    for (uint32_t i = 0; i < ctx->segment_count; i++) {
+        const SegmentInfo *seg = &ctx->segments[i];
+        fprintf(out, "%s{\"name\":", i ? "," : "");
+        cli_json_name(out, seg->segname, sizeof(seg->segname));
+        fprintf(out, ",\"vmaddr\":");
+        cli_json_address(out, seg->vmaddr);
+        fprintf(out, ",\"vmsize\":%llu,\"fileoff\":%llu,\"filesize\":%llu,\"maxprot\":%u,\"initprot\":%u,\"nsects\":%u}",
+                (unsigned long long)seg->vmsize, (unsigned long long)seg->fileoff,
+                (unsigned long long)seg->filesize, seg->maxprot, seg->initprot, seg->nsects);
+    }
+    fprintf(out, "],\"sections\":[");
+    for (uint32_t i = 0; i < ctx->section_count; i++) {
+        const SectionInfo *sect = &ctx->sections[i];
+        fprintf(out, "%s{\"segment\":", i ? "," : "");
+        cli_json_name(out, sect->segname, sizeof(sect->segname));
+        fprintf(out, ",\"name\":");
+        cli_json_name(out, sect->sectname, sizeof(sect->sectname));
+        fprintf(out, ",\"addr\":");
+        cli_json_address(out, sect->addr);
+        fprintf(out, ",\"size\":%llu,\"offset\":%u}", (unsigned long long)sect->size, sect->offset);
+    }
+    fputc(']', out);
+}
+
+static void cli_write_symbols(FILE *out, SymbolTableContext *symbols, const CLIOptions *options) {
+    fprintf(out, ",\"symbols\":{\"count\":%u,\"defined\":%u,\"undefined\":%u,\"external\":%u,\"functions\":%u",
+            symbols->symbol_count, symbols->defined_count, symbols->undefined_count,
+            symbols->external_count, symbols->function_count);
+    if (options->details & CLI_DETAIL_SYMBOLS) {
+        fprintf(out, ",\"list\":[");
+        for (uint32_t i = 0; i < symbols->symbol_count; i++) {
+            const SymbolInfo *sym = &symbols->symbols[i];
+            fprintf(out, "%s{\"name\":", i ? "," : "");
+            cli_json_string(out, sym->name);
+            fprintf(out, ",\"address\":");
+            cli_json_address(out, sym->address);
+            fprintf(out, ",\"size\":%llu,\"type\":\"%s\",\"scope\":\"%s\"}", (unsigned long long)sym->size,
+                    symbol_type_string(sym->type), symbol_scope_string(sym->scope));
+        }
+        fputc(']', out);
+    }
+    fputc('}', out);
+}
+
+static void cli_write_strings(FILE *out, StringContext *strings, const CLIOptions *options) {
+    fprintf(out, ",\"strings\":{\"count\":%u", strings->count);
+    if (options->details & CLI_DETAIL_STRINGS) {
+        fprintf(out, ",\"list\":[");
+        for (uint32_t i = 0; i < strings->count; i++) {
+            const StringInfo *info = &strings->strings[i];
+            fprintf(out, "%s{\"address\":", i ? "," : "");
+            cli_json_address(out, info->address);
+            fprintf(out, ",\"section\":");
+            cli_json_string(out, info->section);
+            fprintf(out, ",\"content\":");
+            cli_json_string(out, info->content);
+            if (info->is_unicode) fprintf(out, ",\"unicode\":true");
+            if (info->cfstring_address) {
+                fprintf(out, ",\"cfstring\":");
+                cli_json_address(out, info->cfstring_address);
+            }
+            fputc('}', out);
+        }
+        fputc(']', out);
+    }
+    fputc('}', out);
+}
+
+static void cli_write_disassembly(FILE *out, DisassemblyContext *disasm, const CLIOptions *options) {
+    uint32_t count = disasm->compact.count ? disasm->compact.count : disasm->instruction_count;
+    uint32_t function_starts = 0, branches = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        DisasmSemantics semantics;
+        if (!disasm_get_semantics(disasm, i, &semantics)) break;
+        if (semantics.attrs & DISASM_ATTR_FUNCTION_START) function_starts++;
+        if (semantics.attrs & DISASM_ATTR_HAS_BRANCH) branches++;
+    }
+
+    fprintf(out, ",\"disassembly\":{\"section\":\"__text\",\"address\":");
+    cli_json_address(out, disasm->code_base_addr);
+    fprintf(out, ",\"size\":%llu,\"instructions\":%u,\"function_starts\":%u,\"branches\":%u",
+            (unsigned long long)disasm->code_size, count, function_starts, branches);
+    if (options->details & CLI_DETAIL_INSTRUCTIONS) {
+        fprintf(out, ",\"list\":[");
+        DisassembledInstruction inst;
+        for (uint32_t i = 0; i < count; i++) {
+            if (!disasm_get_instruction(disasm, i, &inst)) break;
+            char text[sizeof(inst.mnemonic) + sizeof(inst.operands) + 1];
+            snprintf(text, sizeof(text), inst.operands[0] ? "%s %s" : "%s", inst.mnemonic, inst.operands);
+            fprintf(out, "%s[", i ? "," : "");
+            cli_json_address(out, inst.address);
+            fputc(',', out);
+            cli_json_string(out, text);
+            fputc(']', out);
+        }
+        fputc(']', out);
+    }
+    fputc('}', out);
+}
+
+static void cli_write_objc(FILE *out, ObjCRuntimeInfo *objc, const CLIOptions *options) {
+    fprintf(out, ",\"objc\":{\"classes\":%d,\"categories\":%d,\"protocols\":%d",
+            objc->class_count, objc->category_count, objc->protocol_count);
+    if (options->details & CLI_DETAIL_CLASSES) {
+        fprintf(out, ",\"class_list\":[");
+        for (int i = 0; i < objc->class_count; i++) {
+            const ObjCClassInfo *cls = &objc->classes[i];
+            fprintf(out, "%s{\"name\":", i ? "," : "");
+            cli_json_string(out, cls->name);
+            fprintf(out, ",\"superclass\":");
+            cli_json_string(out, cls->superclass_name);
+            fprintf(out, ",\"instance_methods\":%d,\"class_methods\":%d,\"properties\":%d,\"ivars\":%d}",
+                    cls->instance_method_count, cls->class_method_count, cls->property_count, cls->ivar_count);
+        }
+        fputc(']', out);
+    }
+    fputc('}', out);
+}
+
+/* Result callback: one complete line per binary. Encrypted binaries only
+   carry their layout and symbol table. */
+static void cli_write_result(BatchJobResult *result, void *user_data) {
+    CLIOptions *options = (CLIOptions*)user_data;
+    FILE *out = options->out;
+
+    fprintf(out, "{\"path\":");
+    cli_json_string(out, result->path);
+    if (!result->ok) {
+        fprintf(out, ",\"status\":\"error\",\"error\":");
+        cli_json_string(out, result->error);
+    } else {
+        MachOContext *ctx = result->macho;
+        fprintf(out, ",\"status\":\"%s\",\"file_size\":%ld", ctx->is_encrypted ? "encrypted" : "ok", ctx->file_size);
+        cli_write_layout(out, ctx);
+        if (result->symbols) cli_write_symbols(out, result->symbols, options);
+        if (result->strings) cli_write_strings(out, result->strings, options);
+        if (result->disasm) cli_write_disassembly(out, result->disasm, options);
+        if (result->objc) cli_write_objc(out, result->objc, options);
+        fprintf(out, ",\"elapsed_ms\":%.3f", result->elapsed * 1e3);
+    }
+    fprintf(out, "}\n");
+    fflush(out);
+
+    options->completed++;
+    if (options->progress) {
+        fprintf(stderr, "[%u/%u] %s\n", options->completed, options->total, result->path);
+    }
+}
+
+static void cli_report_progress(uint32_t index, BatchStage stage, uint32_t stages_done,
+                                uint32_t stage_count, void *user_data) {
+    CLIOptions *options = (CLIOptions*)user_data;
+    if (!options->progress) return;
+    fprintf(stderr, "  job %u: %s (%u/%u)\n", index, batch_stage_name(stage), stages_done, stage_count);
+}
+
+#pragma mark - Main
+
+static void cli_usage(FILE *out, const char *argv0) {
+    fprintf(out,
+            "usage: %s [-j workers] [-m budget_mb] [-o out.jsonl] [-r] [-p] [--symbols]\n"
+            "          [--strings] [--instructions] [--classes] path...\n"
+            "  -j, --jobs N        worker threads shared by all binaries (default: online CPUs)\n"
+            "  -m, --memory MB     budget for the binaries in flight (default: %zu)\n"
+            "  -o, --output FILE   write JSON Lines here instead of stdout\n"
+            "  -r, --recursive     descend into subdirectories\n"
+            "  -p, --progress      report per-binary stage progress on stderr\n"
+            "      --symbols       include every symbol\n"
+            "      --strings       include every extracted string\n"
+            "      --instructions  include the __text disassembly\n"
+            "      --classes       include ObjC class summaries\n",
+            argv0, BATCH_DEFAULT_MEMORY_BUDGET / (1024 * 1024));
+}
+
+int main(int argc, char **argv) {
+    CLIOptions options = {0};
+    BatchOptions batch = {
+        .stages = BATCH_STAGE_FLAG_ALL,
+        .disasm_flags = DISASM_FLAG_COMPACT,
+        .progress = cli_report_progress,
+        .result = cli_write_result,
+        .user_data = &options,
+    };
+    const char *output_path = NULL;
+
+    static const struct option long_options[] = {
+        { "jobs",         required_argument, NULL, 'j' },
+        { "memory",       required_argument, NULL, 'm' },
+        { "output",       required_argument, NULL, 'o' },
+        { "recursive",    no_argument,       NULL, 'r' },
+        { "progress",     no_argument,       NULL, 'p' },
+        { "symbols",      no_argument,       NULL, 'S' },
+        { "strings",      no_argument,       NULL, 's' },
+        { "instructions", no_argument,       NULL, 'i' },
+        { "classes",      no_argument,       NULL, 'c' },
+        { "help",         no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "j:m:o:rph", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'j': batch.worker_count = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'm': batch.memory_budget = (size_t)strtoull(optarg, NULL, 10) * 1024 * 1024; break;
+            case 'o': output_path = optarg; break;
+            case 'r': options.recursive = true; break;
+            case 'p': options.progress = true; break;
+            case 'S': options.details |= CLI_DETAIL_SYMBOLS; break;
+            case 's': options.details |= CLI_DETAIL_STRINGS; break;
+            case 'i': options.details |= CLI_DETAIL_INSTRUCTIONS; break;
+            case 'c': options.details |= CLI_DETAIL_CLASSES; break;
+            case 'h':
+                cli_usage(stdout, argv[0]);
+                return 0;
+            default:
+                cli_usage(stderr, argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc) {
+        cli_usage(stderr, argv[0]);
+        return 2;
+    }
+
+    CLIPathList paths = {0};
+    for (int i = optind; i < argc; i++) {
+        struct stat st;
+        if (stat(argv[i], &st) == 0 && S_ISDIR(st.st_mode)) {
+            cli_collect_directory(&paths, argv[i], options.recursive);
+        } else {
+            cli_path_list_add(&paths, argv[i]);
+        }
+    }
+
+    options.out = output_path ? fopen(output_path, "w") : stdout;
+    if (!options.out) {
+        fprintf(stderr, "redyne-cli: cannot write %s: %s\n", output_path, strerror(errno));
+        return 1;
+    }
+    options.total = paths.count;
+
+    uint32_t failures = batch_analyze((const char *const *)paths.items, paths.count, &batch);
+
+    if (options.out != stdout) fclose(options.out);
+    for (uint32_t i = 0; i < paths.count; i++) free(paths.items[i]);
+    free(paths.items);
+
+    return failures > 0 ? 1 : 0;
+}
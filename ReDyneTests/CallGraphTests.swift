@@ -0,0 +1,170 @@
+import XCTest
+@testable import ReDyne
+
+class CallGraphTests: XCTestCase {
+
+    /// Function starts, as instruction indices into program
+    private static let starts = [0, 2, 8, 10, 12, 15, 18]
+
+    /// Seven functions. leaf comes first with no calls, so its callee row is
+    /// empty before any edge exists. The last two have no symbol of their own.
+    private static let program: [UInt32] = [
+        0xD503201F, //  0 leaf:    NOP
+        0xD65F03C0, //  1          RET
+        0x94000006, //  2 main:    BL recurse
+        0x94000007, //  3          BL ping
+        0x94000006, //  4          BL ping (same callee again)
+        0x9400000D, //  5          BL unnamed2
+        0x97FFFFFA, //  6          BL leaf
+        0xD65F03C0, //  7          RET
+        0x94000000, //  8 recurse: BL recurse
+        0xD65F03C0, //  9          RET
+        0x94000002, // 10 ping:    BL pong
+        0xD65F03C0, // 11          RET
+        0x97FFFFFE, // 12 pong:    BL ping
+        0x97FFFFF3, // 13          BL leaf
+        0xD65F03C0, // 14          RET
+        0x97FFFFF3, // 15 unnamed1: BL main
+        0x94010000, // 16          BL outside the image
+        0xD65F03C0, // 17          RET
+        0x97FFFFF6, // 18 unnamed2: BL recurse
+        0x97FFFFED, // 19          BL leaf (after a higher callee)
+        0xD63F0100, // 20          BLR X8
+        0xD65F03C0, // 21          RET
+    ]
+
+    private static let names = ["_leaf", "_main", "_recurse", "_ping", "_pong"]
+
+    private var fixture: MachOFixture!
+    private var disasm: UnsafeMutablePointer<DisassemblyContext>!
+    private var symbols: UnsafeMutablePointer<SymbolTableContext>!
+    private var graph: UnsafeMutablePointer<CallGraph>!
+
+    override func setUpWithError() throws {
+        try super.setUpWithError()
+        let text = MachOFixture.textAddress
+        let named = CallGraphTests.names.enumerated().map {
+            (name: $0.element, address: text + UInt64(CallGraphTests.starts[$0.offset] * 4))
+        }
+        fixture = try MachOFixture(text: CallGraphTests.program, symbols: named)
+        disasm = try XCTUnwrap(fixture.disassemble())
+        symbols = try XCTUnwrap(symbol_table_create(disasm.pointee.macho_ctx))
+        XCTAssertTrue(symbol_table_parse(symbols))
+
+        // Out of order and with a duplicate, as callers may pass them
+        var starts = CallGraphTests.starts.reversed().map { text + UInt64($0 * 4) }
+        starts.append(starts[0])
+        graph = try XCTUnwrap(callgraph_build(disasm, symbols, starts, UInt32(starts.count)))
+    }
+
+    override func tearDown() {
+        if graph != nil { callgraph_free(graph) }
+        if symbols != nil { symbol_table_free(symbols) }
+        if disasm != nil { MachOFixture.close(disasm) }
+        graph = nil
+        symbols = nil
+        disasm = nil
+        fixture = nil
+        super.tearDown()
+    }
+
+    private func callees(_ node: Int) -> [UInt32] {
+        var count: UInt32 = 0
+        let row = callgraph_callees(graph, UInt32(node), &count)
+        return Array(UnsafeBufferPointer(start: row, count: Int(count)))
+    }
+
+    private func callers(_ node: Int) -> [UInt32] {
+        var count: UInt32 = 0
+        let row = callgraph_callers(graph, UInt32(node), &count)
+        return Array(UnsafeBufferPointer(start: row, count: Int(count)))
+    }
+
+    private func reachable(from node: Int, callers: Bool) -> [UInt32] {
+        var out = [UInt32](repeating: 0, count: Int(graph.pointee.node_count))
+        let count = callgraph_reachable(graph, UInt32(node), callers, &out)
+        return Array(out.prefix(Int(count)))
+    }
+
+    // MARK: - Nodes
+
+    func testNodesFollowFunctionStarts() {
+        XCTAssertEqual(graph.pointee.node_count, 7)
+        XCTAssertEqual(graph.pointee.function_count, 7)
+
+        let text = MachOFixture.textAddress
+        let bounds = CallGraphTests.starts + [CallGraphTests.program.count]
+        for v in 0..<7 {
+            let node = graph.pointee.nodes[v]
+            XCTAssertEqual(node.address, text + UInt64(bounds[v] * 4), "node \(v)")
+            XCTAssertEqual(node.end_address, text + UInt64(bounds[v + 1] * 4), "node \(v)")
+            XCTAssertFalse(node.is_stub, "node \(v)")
+            XCTAssertEqual(callgraph_find_node(graph, node.address), Int32(v))
+            XCTAssertEqual(callgraph_find_node(graph, node.end_address - 4), Int32(v))
+        }
+        XCTAssertEqual(callgraph_find_node(graph, text - 4), -1)
+        XCTAssertEqual(callgraph_find_node(graph, text + UInt64(CallGraphTests.program.count * 4)), -1)
+    }
+
+    func testNodesAreNamedOnlyBySymbolsAtTheirStart() {
+        let names = (0..<7).map { v in graph.pointee.nodes[v].name.map { String(cString: $0) } }
+        // The last two lie inside _pong's symbol range but do not start it
+        XCTAssertEqual(names, CallGraphTests.names.map { Optional($0) } + [nil, nil])
+    }
+
+    // MARK: - Edges
+
+    func testRowsAreSortedAndDeduplicated() {
+        let expectedCallees: [[UInt32]] = [[], [0, 2, 3, 6], [2], [4], [0, 3], [1], [0, 2]]
+        let expectedCallers: [[UInt32]] = [[1, 4, 6], [5], [1, 2, 6], [1, 4], [3], [], [1]]
+        for v in 0..<7 {
+            XCTAssertEqual(callees(v), expectedCallees[v], "callees of \(v)")
+            XCTAssertEqual(callers(v), expectedCallers[v], "callers of \(v)")
+        }
+
+        XCTAssertEqual(graph.pointee.edge_count, 11)
+        XCTAssertEqual(graph.pointee.call_site_count, 12)
+        // BL outside every function and BLR X8
+        XCTAssertEqual(graph.pointee.unresolved_call_count, 2)
+    }
+
+    func testFunctionWithoutCallsHasEmptyRow() {
+        var count: UInt32 = 99
+        XCTAssertNotNil(callgraph_callees(graph, 0, &count))
+        XCTAssertEqual(count, 0)
+        XCTAssertNotNil(callgraph_callers(graph, 5, &count))
+        XCTAssertEqual(count, 0)
+        XCTAssertNil(callgraph_callees(graph, 7, &count))
+        XCTAssertEqual(count, 0)
+    }
+
+    // MARK: - Recursion
+
+    func testSelfAndMutualRecursion() {
+        let recursive = (0..<7).map { callgraph_is_recursive(graph, UInt32($0)) }
+        XCTAssertEqual(recursive, [false, false, true, true, true, false, false])
+
+        let ids = Array(UnsafeBufferPointer(start: graph.pointee.scc_ids, count: 7))
+        let sizes = Array(UnsafeBufferPointer(start: graph.pointee.scc_sizes, count: Int(graph.pointee.scc_count)))
+        XCTAssertEqual(graph.pointee.scc_count, 6)
+        XCTAssertEqual(ids[3], ids[4])
+        XCTAssertEqual(sizes[Int(ids[3])], 2)
+        XCTAssertEqual(sizes[Int(ids[2])], 1)
+
+        // Components are numbered callees first
+        for v in 0..<7 {
+            for w in callees(v) where ids[Int(w)] != ids[v] {
+                XCTAssertLessThan(ids[Int(w)], ids[v], "edge \(v) -> \(w)")
+            }
+        }
+    }
+
+    // MARK: - Reachability
+
+    func testReachableFromEntry() {
+        // Breadth-first over callees; unnamed1 only calls main, so main never reaches it
+        XCTAssertEqual(reachable(from: 1, callers: false), [1, 0, 2, 3, 6, 4])
+        XCTAssertEqual(reachable(from: 0, callers: true), [0, 1, 4, 6, 5, 3])
+        XCTAssertEqual(reachable(from: 5, callers: true), [5])
+    }
+}
@@ -0,0 +1,588 @@
+import XCTest
+@testable import ReDyne
+
+class ControlFlowGraphTests: XCTestCase {
+
+    private static let seed: UInt64 = 0xC0FF_EE15
+
+    private var disasm: UnsafeMutablePointer<DisassemblyContext>!
+
+    override func setUp() {
+        super.setUp()
+        disasm = UnsafeMutablePointer<DisassemblyContext>.allocate(capacity: 1)
+        disasm.initialize(to: DisassemblyContext())
+    }
+
+    override func tearDown() {
+        disasm.deallocate()
+        disasm = nil
+        super.tearDown()
+    }
+
+    /// Blocks 0x10 bytes apart from 0x1000, added in address order
+    private func makeGraph(blockCount: Int, edges: [(Int, Int)] = [], calls: [(Int, Int)] = []) -> UnsafeMutablePointer<CFGContext> {
+        let ctx = cfg_create(disasm)!
+        for i in 0..<blockCount {
+            let start = 0x1000 + 0x10 * UInt64(i)
+            _ = cfg_add_block(ctx, start, start + 0x10)
+        }
+        for (from, to) in edges {
+            _ = cfg_add_edge(ctx, UInt32(from), UInt32(to), EDGE_UNCONDITIONAL)
+        }
+        for (from, to) in calls {
+            _ = cfg_add_edge(ctx, UInt32(from), UInt32(to), EDGE_CALL)
+        }
+        return ctx
+    }
+
+    // MARK: - Block Lookup
+
+    func testFindBlockInAddressOrder() {
+        let ctx = makeGraph(blockCount: 4)
+        defer { cfg_free(ctx) }
+
+        XCTAssertTrue(ctx.pointee.blocks_ordered)
+        let expected: [(UInt64, Int32)] = [(0xFFF, -1), (0x1000, 0), (0x101F, 1), (0x1030, 3), (0x103F, 3), (0x1040, -1)]
+        for (address, index) in expected {
+            XCTAssertEqual(cfg_find_block_index(ctx, address), index, String(format: "0x%llX", address))
+        }
+        XCTAssertEqual(cfg_find_block(ctx, 0x1024), ctx.pointee.blocks + 2)
+        XCTAssertNil(cfg_find_block(ctx, 0x2000))
+    }
+
+    func testFindBlockOutOfOrder() {
+        let ctx = cfg_create(disasm)!
+        defer { cfg_free(ctx) }
+
+        _ = cfg_add_block(ctx, 0x3000, 0x3100)
+        _ = cfg_add_block(ctx, 0x1000, 0x1100)
+        _ = cfg_add_block(ctx, 0x2000, 0x2100)
+        XCTAssertFalse(ctx.pointee.blocks_ordered)
+
+        XCTAssertEqual(cfg_find_block_index(ctx, 0x1080), 1)
+        XCTAssertEqual(cfg_find_block_index(ctx, 0x2000), 2)
+        XCTAssertEqual(cfg_find_block_index(ctx, 0x30FF), 0)
+        XCTAssertEqual(cfg_find_block_index(ctx, 0x1100), -1)
+        XCTAssertEqual(cfg_find_block_index(ctx, 0x3100), -1)
+
+        // A block added after a lookup must be found by the next one
+        _ = cfg_add_block(ctx, 0x1800, 0x1900)
+        XCTAssertEqual(cfg_find_block_index(ctx, 0x1800), 3)
+        XCTAssertEqual(cfg_find_block_index(ctx, 0x1080), 1)
+        XCTAssertEqual(cfg_find_block_index(ctx, 0x1A00), -1)
+    }
+
+    func testEdgesSurviveBlockGrowth() {
+        let ctx = makeGraph(blockCount: 2, edges: [(0, 1)])
+        defer { cfg_free(ctx) }
+
+        // Past the initial capacity of 256 the block array moves
+        for i in 2..<300 {
+            let start = 0x1000 + 0x10 * UInt64(i)
+            _ = cfg_add_block(ctx, start, start + 0x10)
+        }
+        XCTAssertEqual(ctx.pointee.block_count, 300)
+        for i in stride(from: 0, to: 300, by: 7) {
+            XCTAssertEqual(cfg_find_block_index(ctx, 0x1004 + 0x10 * UInt64(i)), Int32(i))
+        }
+
+        let entry = ctx.pointee.blocks[0]
+        XCTAssertEqual(entry.successor_count, 1)
+        XCTAssertEqual(ctx.pointee.blocks[Int(entry.successors[0])].start_address, 0x1010)
+        XCTAssertEqual(ctx.pointee.blocks[1].predecessors[0], 0)
+    }
+
+    // MARK: - Dominance
+
+    /// Dominator sets by the textbook fixpoint, as bitsets over the blocks plus
+    /// the virtual root (bit nodeCount). Unreachable blocks get an empty set.
+    private func naiveDominators(nodeCount n: Int, predecessors: [UInt64]) -> [UInt64] {
+        let root = UInt64(1) << n
+        var reachable = root
+        var changed = true
+        while changed {
+            changed = false
+            for v in 0..<n where reachable & (1 << v) == 0 && predecessors[v] & reachable != 0 {
+                reachable |= 1 << v
+                changed = true
+            }
+        }
+
+        let all = (root << 1) &- 1
+        var dom = (0...n).map { reachable & (1 << $0) != 0 ? all : 0 }
+        dom[n] = root
+        changed = true
+        while changed {
+            changed = false
+            for v in 0..<n where dom[v] != 0 {
+                var set = all
+                for p in 0...n where predecessors[v] & (1 << p) != 0 && dom[p] != 0 {
+                    set &= dom[p]
+                }
+                set |= 1 << v
+                if set != dom[v] {
+                    dom[v] = set
+                    changed = true
+                }
+            }
+        }
+        return dom
+    }
+
+    /// Checks the computed tree, levels, queries and frontiers against the
+    /// naive sets; predecessors include the virtual root's edges.
+    private func assertMatchesNaive(_ ctx: UnsafeMutablePointer<CFGContext>, predecessors: [UInt64], post: Bool, _ label: String) {
+        let n = Int(ctx.pointee.block_count)
+        let dom = naiveDominators(nodeCount: n, predecessors: predecessors)
+
+        for v in 0..<n {
+            let block = ctx.pointee.blocks[v]
+            let idom = post ? block.immediate_post_dominator : block.immediate_dominator
+            let level = post ? block.post_dom_level : block.dom_level
+            let message = "\(label) \(post ? "post" : "dom") block \(v)"
+
+            if dom[v] == 0 {
+                XCTAssertNil(idom, message)
+                XCTAssertEqual(level, UInt32.max, message)
+            } else {
+                // The immediate dominator is the strict dominator dominated by all others
+                let strict = (0...n).filter { $0 != v && dom[v] & (1 << $0) != 0 }
+                let expected = strict.max { dom[$0].nonzeroBitCount < dom[$1].nonzeroBitCount }!
+                if expected == n {
+                    XCTAssertNil(idom, message)
+                } else {
+                    XCTAssertEqual(idom.map { ctx.pointee.blocks.distance(to: $0) }, expected, message)
+                }
+                XCTAssertEqual(Int(level), dom[v].nonzeroBitCount - 2, message)
+            }
+
+            for a in 0..<n {
+                let expected = dom[v] != 0 && dom[a] != 0 && dom[v] & (1 << a) != 0
+                let actual = post ? cfg_post_dominates(ctx, UInt32(a), UInt32(v)) : cfg_dominates(ctx, UInt32(a), UInt32(v))
+                XCTAssertEqual(actual, expected, "\(message) by \(a)")
+            }
+
+            var expectedFrontier: Set<Int> = []
+            if dom[v] != 0 {
+                for y in 0..<n where dom[y] & (1 << v) == 0 || y == v {
+                    if (0...n).contains(where: { predecessors[y] & (1 << $0) != 0 && dom[$0] & (1 << v) != 0 }) {
+                        expectedFrontier.insert(y)
+                    }
+                }
+            }
+            XCTAssertEqual(frontier(ctx, v, post: post), expectedFrontier, message)
+        }
+    }
+
+    private func frontier(_ ctx: UnsafeMutablePointer<CFGContext>, _ block: Int, post: Bool) -> Set<Int> {
+        var count: UInt32 = 0
+        let list = post ? cfg_post_dominance_frontier(ctx, UInt32(block), &count) : cfg_dominance_frontier(ctx, UInt32(block), &count)
+        return Set((0..<Int(count)).map { Int(list![$0]) })
+    }
+
+    func testDominanceMatchesNaiveFixpoint() {
+        var rng = SplitMix64(seed: ControlFlowGraphTests.seed)
+        for iteration in 0..<500 {
+            let n = Int.random(in: 1...40, using: &rng)
+            let ctx = makeGraph(blockCount: n)
+            defer { cfg_free(ctx) }
+
+            // Bitsets of each block's predecessors and successors, call edges excluded
+            var forward = [UInt64](repeating: 0, count: n + 1)
+            var reverse = [UInt64](repeating: 0, count: n + 1)
+            for _ in 0..<Int.random(in: 0...(2 * n), using: &rng) {
+                let from = Int.random(in: 0..<n, using: &rng)
+                let to = Int.random(in: 0..<n, using: &rng)
+                let isCall = Int.random(in: 0..<8, using: &rng) == 0
+                _ = cfg_add_edge(ctx, UInt32(from), UInt32(to), isCall ? EDGE_CALL : EDGE_UNCONDITIONAL)
+                if !isCall {
+                    forward[to] |= 1 << from
+                    reverse[from] |= 1 << to
+                }
+            }
+
+            // The virtual root enters block 0, and every exit in the reversed graph
+            forward[0] |= 1 << n
+            for v in 0..<n where reverse[v] == 0 {
+                reverse[v] = 1 << n
+            }
+
+            XCTAssertTrue(cfg_compute_dominance(ctx))
+            XCTAssertTrue(cfg_compute_post_dominance(ctx))
+            let label = "(seed \(ControlFlowGraphTests.seed), iteration \(iteration))"
+            assertMatchesNaive(ctx, predecessors: forward, post: false, label)
+            assertMatchesNaive(ctx, predecessors: reverse, post: true, label)
+        }
+    }
+
+    func testPostDominanceWithSeveralExits() {
+        // 0 branches to two returning blocks and an endless loop; 1 calls 4
+        let ctx = makeGraph(blockCount: 5, edges: [(0, 1), (0, 2), (0, 3), (3, 3)], calls: [(1, 4)])
+        defer { cfg_free(ctx) }
+        XCTAssertTrue(cfg_compute_dominance(ctx))
+        XCTAssertTrue(cfg_compute_post_dominance(ctx))
+        let blocks = ctx.pointee.blocks!
+
+        // No single exit post-dominates 0, so its parent is the virtual exit
+        for exit in [0, 1, 2, 4] {
+            XCTAssertNil(blocks[exit].immediate_post_dominator, "block \(exit)")
+            XCTAssertEqual(blocks[exit].post_dom_level, 0, "block \(exit)")
+        }
+        XCTAssertEqual(blocks[3].post_dom_level, UInt32.max)
+        XCTAssertFalse(cfg_post_dominates(ctx, 1, 0))
+        XCTAssertFalse(cfg_post_dominates(ctx, 3, 3))
+        XCTAssertEqual(frontier(ctx, 1, post: true), [0])
+        XCTAssertEqual(frontier(ctx, 2, post: true), [0])
+        XCTAssertEqual(frontier(ctx, 3, post: true), [])
+
+        // The call edge does not make its target reachable
+        XCTAssertEqual(blocks[3].immediate_dominator, blocks + 0)
+        XCTAssertEqual(blocks[3].dom_level, 1)
+        XCTAssertEqual(blocks[4].dom_level, UInt32.max)
+        XCTAssertFalse(cfg_dominates(ctx, 0, 4))
+        XCTAssertEqual(frontier(ctx, 3, post: false), [3])
+    }
+
+    // MARK: - Parallel Build
+
+    /// Functions opening with STP X29, X30, [SP, #-16]! and closing with the
+    /// matching LDP and RET, with branches inside the function, early returns
+    /// and calls to earlier functions in between. Returns the function starts.
+    private func syntheticText(instructionCount: Int, using rng: inout SplitMix64) -> (words: [UInt32], starts: [UInt64]) {
+        var words: [UInt32] = []
+        var starts: [Int] = []
+        while words.count < instructionCount {
+            let start = words.count
+            let length = Int.random(in: 4...120, using: &rng)
+            starts.append(start)
+            words.append(0xA9BF7BFD)
+            for i in (start + 1)..<(start + length - 2) {
+                let offset = Int.random(in: (start + 1)..<(start + length), using: &rng) - i
+                let imm19 = UInt32(truncatingIfNeeded: offset) & 0x7FFFF
+                switch Int.random(in: 0..<10, using: &rng) {
+                case 5: words.append(0x54000001 | imm19 << 5)                  // B.NE
+                case 6: words.append(0xB4000000 | imm19 << 5)                  // CBZ X0
+                case 7: words.append(0x14000000 | UInt32(truncatingIfNeeded: offset) & 0x3FFFFFF)
+                case 8:
+                    let callee = starts.randomElement(using: &rng)!
+                    words.append(0x94000000 | UInt32(truncatingIfNeeded: callee - i) & 0x3FFFFFF)
+                case 9: words.append(0xD65F03C0)                               // RET
+                default: words.append(0xD503201F)                              // NOP
+                }
+            }
+            words += [0xA8C17BFD, 0xD65F03C0]
+        }
+        return (words, starts.map { MachOFixture.textAddress + UInt64($0 * 4) })
+    }
+
+    private func assertSameGraph(_ expected: UnsafeMutablePointer<CFGContext>, _ actual: UnsafeMutablePointer<CFGContext>, _ label: String) {
+        XCTAssertEqual(actual.pointee.block_count, expected.pointee.block_count, label)
+        XCTAssertEqual(actual.pointee.function_count, expected.pointee.function_count, label)
+        guard actual.pointee.block_count == expected.pointee.block_count,
+              actual.pointee.function_count == expected.pointee.function_count else { return }
+
+        for f in 0..<Int(expected.pointee.function_count) {
+            let a = expected.pointee.functions[f]
+            let b = actual.pointee.functions[f]
+            XCTAssertTrue(a.start_address == b.start_address && a.end_address == b.end_address &&
+                          a.first_block == b.first_block && a.block_count == b.block_count, "\(label) function \(f)")
+        }
+
+        for i in 0..<Int(expected.pointee.block_count) {
+            let a = expected.pointee.blocks[i]
+            let b = actual.pointee.blocks[i]
+            let message = "\(label) block \(i) at 0x\(String(a.start_address, radix: 16))"
+            XCTAssertTrue(a.start_address == b.start_address && a.end_address == b.end_address &&
+                          a.instruction_start == b.instruction_start && a.instruction_count == b.instruction_count &&
+                          a.is_entry == b.is_entry && a.is_exit == b.is_exit, message)
+            XCTAssertEqual(successors(b), successors(a), message)
+            XCTAssertEqual(predecessors(b), predecessors(a), message)
+        }
+    }
+
+    private func successors(_ block: BasicBlock) -> [String] {
+        return (0..<Int(block.successor_count)).map {
+            "\(block.successors[$0]) \(block.successor_edge_types[$0].rawValue)"
+        }
+    }
+
+    private func predecessors(_ block: BasicBlock) -> [UInt32] {
+        return (0..<Int(block.predecessor_count)).map { block.predecessors[$0] }
+    }
+
+    func testParallelBuildMatchesSerial() throws {
+        var rng = SplitMix64(seed: ControlFlowGraphTests.seed)
+        // At least five times CFG_MIN_PER_THREAD (32K), so eight requested threads run five
+        let (text, starts) = syntheticText(instructionCount: 5 * 32_768, using: &rng)
+        let fixture = try MachOFixture(text: text)
+        let disasm = try XCTUnwrap(fixture.disassemble(threads: 4))
+        defer { MachOFixture.close(disasm) }
+        XCTAssertEqual(Int(disasm.pointee.instruction_count), text.count)
+
+        let serial = cfg_create(disasm)!
+        defer { cfg_free(serial) }
+        XCTAssertGreaterThan(cfg_build_all(serial), 0)
+        XCTAssertEqual(Int(serial.pointee.function_count), starts.count)
+
+        for threads: UInt32 in [2, 8] {
+            let parallel = cfg_create(disasm)!
+            XCTAssertEqual(cfg_build_all_parallel(parallel, threads), serial.pointee.block_count)
+            assertSameGraph(serial, parallel, "(seed \(ControlFlowGraphTests.seed), \(threads) threads)")
+            cfg_free(parallel)
+        }
+
+        // Caller-supplied starts in any order split the text the same way
+        let shuffled = starts.shuffled(using: &rng)
+        let ranges = cfg_create(disasm)!
+        defer { cfg_free(ranges) }
+        XCTAssertEqual(cfg_build_functions(ranges, shuffled, UInt32(shuffled.count), 8), serial.pointee.block_count)
+        assertSameGraph(serial, ranges, "(seed \(ControlFlowGraphTests.seed), shuffled starts)")
+    }
+
+    // MARK: - Loop Forest
+
+    private struct LoopShape: Equatable {
+        let headers: Set<Int>
+        let body: Set<Int>
+        let exits: Set<Int>
+    }
+
+    private func shape(_ ctx: UnsafeMutablePointer<CFGContext>, _ loop: Int) -> LoopShape {
+        let info = ctx.pointee.loops[loop]
+        let slots = Int(info.body_start)..<Int(info.body_start + info.body_count)
+        let body = slots.map { Int(ctx.pointee.loop_blocks[$0]) }
+        let exits = (0..<Int(info.exit_count)).map { Int(ctx.pointee.loop_exits[Int(info.exit_start) + $0]) }
+        return LoopShape(headers: Set(body.prefix(Int(info.header_count))), body: Set(body), exits: Set(exits))
+    }
+
+    /// The innermost loop containing block, which for a header is the loop it heads
+    private func loop(_ ctx: UnsafeMutablePointer<CFGContext>, at block: Int) -> Int {
+        return Int(ctx.pointee.block_loop[block])
+    }
+
+    private func assertLoopDepths(_ ctx: UnsafeMutablePointer<CFGContext>, _ depths: [UInt32]) {
+        for (block, depth) in depths.enumerated() {
+            XCTAssertEqual(cfg_loop_depth(ctx, UInt32(block)), depth, "block \(block)")
+        }
+    }
+
+    func testNestedLoops() {
+        let ctx = makeGraph(blockCount: 6, edges: [(0, 1), (1, 2), (2, 3), (3, 2), (3, 4), (4, 1), (4, 5)])
+        defer { cfg_free(ctx) }
+        XCTAssertEqual(cfg_detect_loops(ctx), 2)
+
+        let outer = loop(ctx, at: 1)
+        let inner = loop(ctx, at: 2)
+        XCTAssertEqual(shape(ctx, outer), LoopShape(headers: [1], body: [1, 2, 3, 4], exits: [5]))
+        XCTAssertEqual(shape(ctx, inner), LoopShape(headers: [2], body: [2, 3], exits: [4]))
+        XCTAssertEqual(ctx.pointee.loops[outer].parent, -1)
+        XCTAssertEqual(ctx.pointee.loops[outer].depth, 1)
+        XCTAssertEqual(ctx.pointee.loops[inner].parent, Int32(outer))
+        XCTAssertEqual(ctx.pointee.loops[inner].depth, 2)
+        XCTAssertLessThan(outer, inner)
+        XCTAssertFalse(ctx.pointee.loops[outer].is_irreducible)
+        XCTAssertFalse(ctx.pointee.loops[inner].is_irreducible)
+
+        assertLoopDepths(ctx, [0, 1, 2, 2, 1, 0])
+        XCTAssertEqual(loop(ctx, at: 4), outer)
+        XCTAssertEqual(loop(ctx, at: 5), -1)
+        XCTAssertTrue(cfg_loop_contains(ctx, UInt32(outer), 3))
+        XCTAssertFalse(cfg_loop_contains(ctx, UInt32(inner), 4))
+        XCTAssertTrue(cfg_is_back_edge(ctx, 3, 2))
+        XCTAssertTrue(cfg_is_back_edge(ctx, 4, 1))
+        XCTAssertFalse(cfg_is_back_edge(ctx, 1, 2))
+    }
+
+    func testLatchesSharingAHeaderFormOneLoop() {
+        let ctx = makeGraph(blockCount: 5, edges: [(0, 1), (1, 2), (2, 1), (1, 3), (3, 1), (3, 4)])
+        defer { cfg_free(ctx) }
+        XCTAssertEqual(cfg_detect_loops(ctx), 1)
+
+        XCTAssertEqual(shape(ctx, 0), LoopShape(headers: [1], body: [1, 2, 3], exits: [4]))
+        XCTAssertEqual(ctx.pointee.loops[0].parent, -1)
+        XCTAssertEqual(ctx.pointee.loops[0].depth, 1)
+        assertLoopDepths(ctx, [0, 1, 1, 1, 0])
+        XCTAssertTrue(ctx.pointee.blocks[1].is_loop_header)
+        XCTAssertTrue(cfg_is_back_edge(ctx, 2, 1))
+        XCTAssertTrue(cfg_is_back_edge(ctx, 3, 1))
+        XCTAssertFalse(cfg_is_back_edge(ctx, 1, 3))
+    }
+
+    func testIrreducibleLoop() {
+        // The cycle 1 <-> 2 is entered at both blocks
+        let ctx = makeGraph(blockCount: 4, edges: [(0, 1), (0, 2), (1, 2), (2, 1), (2, 3)])
+        defer { cfg_free(ctx) }
+        XCTAssertEqual(cfg_detect_loops(ctx), 1)
+
+        XCTAssertEqual(shape(ctx, 0), LoopShape(headers: [1, 2], body: [1, 2], exits: [3]))
+        XCTAssertTrue(ctx.pointee.loops[0].is_irreducible)
+        XCTAssertEqual(ctx.pointee.loops[0].depth, 1)
+        assertLoopDepths(ctx, [0, 1, 1, 0])
+        XCTAssertTrue(cfg_is_back_edge(ctx, 1, 2))
+        XCTAssertTrue(cfg_is_back_edge(ctx, 2, 1))
+    }
+
+    func testIrreducibleLoopInsideReducibleLoop() {
+        let ctx = makeGraph(blockCount: 6, edges: [(0, 1), (1, 2), (1, 3), (2, 3), (3, 2), (3, 4), (4, 1), (4, 5)])
+        defer { cfg_free(ctx) }
+        XCTAssertEqual(cfg_detect_loops(ctx), 2)
+
+        let outer = loop(ctx, at: 1)
+        let inner = loop(ctx, at: 2)
+        XCTAssertEqual(loop(ctx, at: 3), inner)
+        XCTAssertEqual(shape(ctx, outer), LoopShape(headers: [1], body: [1, 2, 3, 4], exits: [5]))
+        XCTAssertEqual(shape(ctx, inner), LoopShape(headers: [2, 3], body: [2, 3], exits: [4]))
+        XCTAssertFalse(ctx.pointee.loops[outer].is_irreducible)
+        XCTAssertTrue(ctx.pointee.loops[inner].is_irreducible)
+        XCTAssertEqual(ctx.pointee.loops[inner].parent, Int32(outer))
+        XCTAssertEqual(ctx.pointee.loops[inner].depth, 2)
+        assertLoopDepths(ctx, [0, 1, 2, 2, 1, 0])
+        XCTAssertTrue(cfg_is_back_edge(ctx, 4, 1))
+    }
+
+    // MARK: - Edge Arena
+
+    private func syntheticFixture(instructionCount: Int) throws -> MachOFixture {
+        var rng = SplitMix64(seed: ControlFlowGraphTests.seed)
+        return try MachOFixture(text: syntheticText(instructionCount: instructionCount, using: &rng).words)
+    }
+
+    /// Every successor edge appears once as a predecessor of its target
+    private func assertEdgesMirrored(_ ctx: UnsafeMutablePointer<CFGContext>) {
+        var forward: [UInt64] = []
+        var backward: [UInt64] = []
+        for b in 0..<Int(ctx.pointee.block_count) {
+            let block = ctx.pointee.blocks[b]
+            for j in 0..<Int(block.successor_count) {
+                forward.append(UInt64(b) << 32 | UInt64(block.successors[j]))
+            }
+            for j in 0..<Int(block.predecessor_count) {
+                backward.append(UInt64(block.predecessors[j]) << 32 | UInt64(b))
+            }
+        }
+        XCTAssertEqual(forward.sorted(), backward.sorted())
+    }
+
+    func testBuiltEdgesAreLaidOutAsCSR() throws {
+        let fixture = try syntheticFixture(instructionCount: 4_000)
+        let disasm = try XCTUnwrap(fixture.disassemble())
+        let ctx = cfg_create(disasm)!
+        defer {
+            cfg_free(ctx)
+            MachOFixture.close(disasm)
+        }
+        XCTAssertGreaterThan(cfg_build_all_parallel(ctx, 4), 0)
+
+        let pool = ctx.pointee.edge_pool!
+        let types = ctx.pointee.edge_pool_types!
+        var cursor = 0
+        var edgeCount = 0
+        for f in 0..<Int(ctx.pointee.function_count) {
+            let function = ctx.pointee.functions[f]
+            let blocks = Int(function.first_block)..<Int(function.first_block + function.block_count)
+            let start = cursor
+
+            // Each function holds its blocks' successors in order, then their predecessors
+            for b in blocks {
+                let block = ctx.pointee.blocks[b]
+                XCTAssertEqual(block.successor_capacity, block.successor_count, "block \(b)")
+                if block.successor_count > 0 {
+                    XCTAssertEqual(pool.distance(to: block.successors), cursor, "block \(b)")
+                    XCTAssertEqual(types.distance(to: block.successor_edge_types), cursor, "block \(b)")
+                } else {
+                    XCTAssertNil(block.successors, "block \(b)")
+                }
+                XCTAssertTrue((0..<Int(block.successor_count)).allSatisfy { blocks.contains(Int(block.successors[$0])) },
+                              "block \(b) leaves function \(f)")
+                cursor += Int(block.successor_count)
+            }
+            let functionEdges = cursor - start
+
+            for b in blocks {
+                let block = ctx.pointee.blocks[b]
+                XCTAssertEqual(block.predecessor_capacity, block.predecessor_count, "block \(b)")
+                if block.predecessor_count > 0 {
+                    XCTAssertEqual(pool.distance(to: block.predecessors), cursor, "block \(b)")
+                } else {
+                    XCTAssertNil(block.predecessors, "block \(b)")
+                }
+                cursor += Int(block.predecessor_count)
+            }
+            XCTAssertEqual(cursor - start, 2 * functionEdges, "function \(f)")
+            edgeCount += functionEdges
+        }
+
+        XCTAssertGreaterThan(edgeCount, 0)
+        XCTAssertEqual(Int(ctx.pointee.edge_pool_count), 2 * edgeCount)
+        XCTAssertLessThanOrEqual(ctx.pointee.edge_pool_count, ctx.pointee.edge_pool_capacity)
+        assertEdgesMirrored(ctx)
+    }
+
+    func testAddedEdgesKeepTheArenaConsistent() throws {
+        let fixture = try syntheticFixture(instructionCount: 2_000)
+        let disasm = try XCTUnwrap(fixture.disassemble())
+        let ctx = cfg_create(disasm)!
+        defer {
+            cfg_free(ctx)
+            MachOFixture.close(disasm)
+        }
+        XCTAssertGreaterThan(cfg_build_all_parallel(ctx, 4), 0)
+
+        let n = Int(ctx.pointee.block_count)
+        var successorModel = (0..<n).map { b -> [UInt64] in
+            let block = ctx.pointee.blocks[b]
+            return (0..<Int(block.successor_count)).map {
+                UInt64(block.successors[$0]) << 32 | UInt64(block.successor_edge_types[$0].rawValue)
+            }
+        }
+        var predecessorModel = (0..<n).map { b -> [UInt32] in
+            let block = ctx.pointee.blocks[b]
+            return (0..<Int(block.predecessor_count)).map { block.predecessors[$0] }
+        }
+
+        // Enough edges that slices move out of the CSR layout and the arena reallocates
+        let initialCapacity = ctx.pointee.edge_pool_capacity
+        var rng = SplitMix64(seed: ControlFlowGraphTests.seed)
+        for _ in 0..<4_000 {
+            let from = Int.random(in: 0..<n, using: &rng)
+            let to = Int.random(in: 0..<n, using: &rng)
+            let type = EdgeType(rawValue: UInt32.random(in: 0...4, using: &rng))
+            XCTAssertTrue(cfg_add_edge(ctx, UInt32(from), UInt32(to), type))
+            successorModel[from].append(UInt64(to) << 32 | UInt64(type.rawValue))
+            predecessorModel[to].append(UInt32(from))
+        }
+        XCTAssertGreaterThan(ctx.pointee.edge_pool_capacity, initialCapacity)
+        XCTAssertLessThanOrEqual(ctx.pointee.edge_pool_count, ctx.pointee.edge_pool_capacity)
+
+        var slices: [Range<Int>] = []
+        let pool = ctx.pointee.edge_pool!
+        for b in 0..<n {
+            let block = ctx.pointee.blocks[b]
+            XCTAssertEqual((0..<Int(block.successor_count)).map {
+                UInt64(block.successors[$0]) << 32 | UInt64(block.successor_edge_types[$0].rawValue)
+            }, successorModel[b], "block \(b)")
+            XCTAssertEqual(predecessors(block), predecessorModel[b], "block \(b)")
+
+            if block.successor_count > 0 {
+                XCTAssertLessThanOrEqual(block.successor_count, block.successor_capacity)
+                let offset = pool.distance(to: block.successors)
+                XCTAssertEqual(ctx.pointee.edge_pool_types.distance(to: block.successor_edge_types), offset)
+                slices.append(offset..<(offset + Int(block.successor_capacity)))
+            }
+            if block.predecessor_count > 0 {
+                XCTAssertLessThanOrEqual(block.predecessor_count, block.predecessor_capacity)
+                let offset = pool.distance(to: block.predecessors)
+                slices.append(offset..<(offset + Int(block.predecessor_capacity)))
+            }
+        }
+
+        // Live slices stay inside the used part of the arena and never overlap
+        slices.sort { $0.lowerBound < $1.lowerBound }
+        XCTAssertGreaterThanOrEqual(slices.first?.lowerBound ?? 0, 0)
+        XCTAssertLessThanOrEqual(slices.last?.upperBound ?? 0, Int(ctx.pointee.edge_pool_count))
+        for (a, b) in zip(slices, slices.dropFirst()) {
+            XCTAssertLessThanOrEqual(a.upperBound, b.lowerBound)
+        }
+        assertEdgesMirrored(ctx)
+    }
+}
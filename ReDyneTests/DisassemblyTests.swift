@@ -97,5 +97,101 @@ class DisassemblyTests: XCTestCase {
         XCTAssertEqual(padded.count, 10)
         XCTAssertTrue(padded.hasPrefix("test"))
     }
+
+    private func decodeARM64(_ word: UInt32, at address: UInt64 = 0x1000) -> DisassembledInstruction {
+        var ctx = DisassemblyContext()
+        ctx.flags = UInt32(DISASM_FLAG_PROLOGUE_EPILOGUE_HEURISTICS)
+        var inst = DisassembledInstruction()
+        _ = disasm_arm64(&ctx, word, address, &inst)
+        return inst
+    }
+
+    private func text(_ inst: DisassembledInstruction) -> String {
+        var copy = inst
+        let mnemonic = withUnsafeBytes(of: &copy.mnemonic) { String(cString: $0.bindMemory(to: CChar.self).baseAddress!) }
+        let operands = withUnsafeBytes(of: &copy.operands) { String(cString: $0.bindMemory(to: CChar.self).baseAddress!) }
+        return operands.isEmpty ? mnemonic : "\(mnemonic) \(operands)"
+    }
+
+    func testARM64EncodingTables() throws {
+        let expected: [(UInt32, String)] = [
+            (0x54000040, "B.EQ 0x1008"),
+            (0xB4000040, "CBZ X0, 0x1008"),
+            (0x36080060, "TBZ W0, #1, 0x100c"),
+            (0xF9400420, "LDR X0, [X1, #8]"),
+            (0xB8616800, "LDR W0, [X0, X1]"),
+            (0xAA0103E0, "MOV X0, X1"),
+            (0x910003FD, "MOV X29, SP"),
+            (0xF100041F, "CMP X0, #1"),
+            (0xD37FF820, "LSL X0, X1, #1"),
+            (0x1A9F17E0, "CSET W0, EQ"),
+            (0x9B027C20, "MUL X0, X1, X2"),
+            (0xD503201F, "NOP"),
+            (0xD5033BBF, "DMB ISH"),
+            (0xD53BD040, "MRS X0, TPIDR_EL0"),
+            (0xC85F7C20, "LDXR X0, [X1]"),
+            (0xF85FCB74, "LDTR X20, [X27, #-4]"),
+            (0x3897686D, "LDTRSB X13, [X3, #-138]"),
+            (0x4C407000, ".word 0x4C407000"),
+            (0x4C9F7000, ".word 0x4C9F7000"),
+            (0x1E602020, "FCMP D1, D0"),
+            (0x00000000, ".word 0x00000000"),
+        ]
+
+        for (word, disassembly) in expected {
+            XCTAssertEqual(text(decodeARM64(word)), disassembly, String(format: "0x%08X", word))
+        }
+    }
+
+    func testARM64FunctionBoundaries() throws {
+        XCTAssertTrue(decodeARM64(0xA9BF7BFD).is_function_start)   // STP X29, X30, [SP, #-16]!
+        XCTAssertFalse(decodeARM64(0xA9017BFD).is_function_start)  // STP X29, X30, [SP, #16]
+        XCTAssertTrue(decodeARM64(0xA8C17BFD).is_function_end)     // LDP X29, X30, [SP], #16
+        XCTAssertTrue(decodeARM64(0xD65F03C0).is_function_end)     // RET
+
+        let call = decodeARM64(0x94000010)
+        XCTAssertEqual(call.branch_type, BRANCH_CALL)
+        XCTAssertEqual(call.branch_target, 0x1040)
+        XCTAssertEqual(call.regs_written, 1 << 30)
+    }
+
+    func testARM64StructuredOperands() throws {
+        var decoded = ARM64DecodedInstruction()
+        XCTAssertTrue(arm64dec_decode_instruction(0xF9400420, 0x1000, &decoded))   // LDR X0, [X1, #8]
+        XCTAssertEqual(decoded.operand_count, 2)
+        XCTAssertEqual(decoded.operands.0.type, ARM64_OPERAND_REG)
+        XCTAssertEqual(decoded.operands.1.type, ARM64_OPERAND_MEM)
+        XCTAssertEqual(decoded.operands.1.reg.num, 1)
+        XCTAssertEqual(decoded.operands.1.imm, 8)
+
+        var buffer = [CChar](repeating: 0, count: 64)
+        _ = arm64dec_format_instruction(&decoded, &buffer, buffer.count)
+        XCTAssertEqual(String(cString: buffer), "LDR X0, [X1, #8]")
+
+        XCTAssertFalse(arm64dec_decode_instruction(0x00000000, 0x1000, &decoded))
+        XCTAssertTrue(arm64dec_decode_instruction(0x54000040, 0x1000, &decoded))    // B.EQ 0x1008
+        XCTAssertTrue(arm64dec_is_conditional_branch(&decoded))
+        XCTAssertEqual(decoded.condition, ARM64_COND_EQ)
+        XCTAssertEqual(decoded.target, 0x1008)
+    }
+
+    func testARM64BatchDecodeMatchesSingle() throws {
+        let words: [UInt32] = [0xA9BF7BFD, 0x910003FD, 0x94000010, 0xF9400420, 0x1E602020,
+                               0x00000000, 0x54000040, 0xAA0103E0, 0xD503201F, 0xD65F03C0]
+        var batch = [ARM64DecodedInstruction](repeating: ARM64DecodedInstruction(), count: words.count)
+        XCTAssertEqual(arm64dec_decode_batch(words, words.count, 0x1000, &batch), words.count - 1)
+
+        for (i, word) in words.enumerated() {
+            var single = ARM64DecodedInstruction()
+            _ = arm64dec_decode_instruction(word, 0x1000 + UInt64(i * 4), &single)
+            var expected = [CChar](repeating: 0, count: 64)
+            var actual = [CChar](repeating: 0, count: 64)
+            _ = arm64dec_format_instruction(&single, &expected, expected.count)
+            _ = arm64dec_format_instruction(&batch[i], &actual, actual.count)
+            XCTAssertEqual(String(cString: actual), String(cString: expected))
+            XCTAssertEqual(batch[i].target, single.target)
+            XCTAssertEqual(batch[i].regs_written, single.regs_written)
+        }
+    }
 }
 
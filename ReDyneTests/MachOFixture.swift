@@ -0,0 +1,139 @@
+import Foundation
+@testable import ReDyne
+
+/// Minimal arm64 executable in a temporary file: __TEXT,__text holds the given
+/// instructions at textAddress and is followed by a 16 KB __DATA,__data. Symbols,
+/// if any, are defined external symbols in __text, stored after __DATA.
+final class MachOFixture {
+    static let imageBase: UInt64 = 0x1_0000_0000
+    static let textAddress: UInt64 = imageBase + 0x4000
+    static let dataSize: UInt64 = 0x4000
+
+    private static let pageSize = 0x4000
+
+    let url: URL
+    let dataAddress: UInt64
+
+    init(text: [UInt32], symbols: [(name: String, address: UInt64)] = []) throws {
+        let page = MachOFixture.pageSize
+        let textSize = text.count * 4
+        let textSegmentSize = page + (textSize + page - 1) / page * page
+        dataAddress = MachOFixture.imageBase + UInt64(textSegmentSize)
+
+        var commands = Data()
+        MachOFixture.appendSegment(&commands, "__PAGEZERO", address: 0, size: MachOFixture.imageBase,
+                                   fileOffset: 0, fileSize: 0, protection: 0, section: nil)
+        MachOFixture.appendSegment(&commands, "__TEXT", address: MachOFixture.imageBase, size: UInt64(textSegmentSize),
+                                   fileOffset: 0, fileSize: UInt64(textSegmentSize), protection: 5,
+                                   section: ("__text", MachOFixture.textAddress, UInt64(textSize), UInt32(page), 0x80000400))
+        MachOFixture.appendSegment(&commands, "__DATA", address: dataAddress, size: MachOFixture.dataSize,
+                                   fileOffset: UInt64(textSegmentSize), fileSize: MachOFixture.dataSize, protection: 3,
+                                   section: ("__data", dataAddress, MachOFixture.dataSize, UInt32(textSegmentSize), 0))
+
+        // nlist_64 entries (N_SECT | N_EXT in section 1) and their string table
+        var symbolTable = Data()
+        var strings = Data([0])
+        for symbol in symbols {
+            MachOFixture.append(&symbolTable, UInt32(strings.count))
+            symbolTable.append(contentsOf: [0x0F, 1])
+            MachOFixture.append(&symbolTable, UInt16(0))
+            MachOFixture.append(&symbolTable, symbol.address)
+            strings.append(contentsOf: Array(symbol.name.utf8) + [0])
+        }
+        if !symbols.isEmpty {
+            let symbolOffset = UInt32(textSegmentSize) + UInt32(MachOFixture.dataSize)
+            for field: UInt32 in [0x2, 24, symbolOffset, UInt32(symbols.count),
+                                  symbolOffset + UInt32(symbolTable.count), UInt32(strings.count)] {
+                MachOFixture.append(&commands, field)
+            }
+        }
+
+        var image = Data()
+        let commandCount: UInt32 = symbols.isEmpty ? 3 : 4
+        for field: UInt32 in [0xFEEDFACF, 0x0100000C, 0, 2, commandCount, UInt32(commands.count), 0, 0] {
+            MachOFixture.append(&image, field)
+        }
+        image.append(commands)
+        image.append(Data(count: page - image.count))
+        for word in text {
+            MachOFixture.append(&image, word)
+        }
+        image.append(Data(count: textSegmentSize + Int(MachOFixture.dataSize) - image.count))
+        if !symbols.isEmpty {
+            image.append(symbolTable)
+            image.append(strings)
+        }
+
+        url = FileManager.default.temporaryDirectory.appendingPathComponent("ReDyneFixture-\(UUID().uuidString)")
+        try image.write(to: url)
+    }
+
+    deinit {
+        try? FileManager.default.removeItem(at: url)
+    }
+
+    /// Opens the file and disassembles __text into compact storage, as the
+    /// analysis bridge does. Release the result with close(_:).
+    func disassemble(threads: UInt32 = 1) -> UnsafeMutablePointer<DisassemblyContext>? {
+        guard let macho = macho_open(url.path, nil) else { return nil }
+        guard macho_parse_header(macho), macho_parse_load_commands(macho) else {
+            macho_close(macho)
+            return nil
+        }
+        _ = macho_extract_segments(macho)
+        _ = macho_extract_sections(macho)
+
+        guard let disasm = disasm_create(macho) else {
+            macho_close(macho)
+            return nil
+        }
+        disasm_enable_flag(disasm, UInt32(DISASM_FLAG_COMPACT))
+        guard disasm_load_section(disasm, "__text"), disasm_all_parallel(disasm, threads) > 0 else {
+            MachOFixture.close(disasm)
+            return nil
+        }
+        return disasm
+    }
+
+    static func close(_ disasm: UnsafeMutablePointer<DisassemblyContext>) {
+        let macho = disasm.pointee.macho_ctx
+        disasm_free(disasm)
+        macho_close(macho)
+    }
+
+    private static func append<T: FixedWidthInteger>(_ data: inout Data, _ value: T) {
+        withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+    }
+
+    private static func appendName(_ data: inout Data, _ name: String) {
+        var bytes = Array(name.utf8.prefix(16))
+        bytes += [UInt8](repeating: 0, count: 16 - bytes.count)
+        data.append(contentsOf: bytes)
+    }
+
+    /// LC_SEGMENT_64 with at most one section
+    private static func appendSegment(_ data: inout Data, _ name: String, address: UInt64, size: UInt64,
+                                      fileOffset: UInt64, fileSize: UInt64, protection: Int32,
+                                      section: (name: String, address: UInt64, size: UInt64, offset: UInt32, flags: UInt32)?) {
+        append(&data, UInt32(0x19))
+        append(&data, UInt32(72 + (section == nil ? 0 : 80)))
+        appendName(&data, name)
+        for field in [address, size, fileOffset, fileSize] {
+            append(&data, field)
+        }
+        append(&data, protection)
+        append(&data, protection)
+        append(&data, UInt32(section == nil ? 0 : 1))
+        append(&data, UInt32(0))
+
+        guard let section = section else { return }
+        appendName(&data, section.name)
+        appendName(&data, name)
+        append(&data, section.address)
+        append(&data, section.size)
+        // offset, align (2^2), reloff, nreloc, flags, reserved1-3
+        for field: UInt32 in [section.offset, 2, 0, 0, section.flags, 0, 0, 0] {
+            append(&data, field)
+        }
+    }
+}
@@ -27,13 +27,6 @@ class MachOParserTests: XCTestCase {
         try? FileManager.default.removeItem(at: tempURL)
     }
     
-    func testFileSize() throws {
-        let size: Int64 = 250 * 1024 * 1024
-        let limit = Constants.File.maxFileSize
-        
-        XCTAssertGreaterThan(size, limit, "Test file size should exceed limit")
-    }
-    
     func testErrorHandling() throws {
         let nsError = NSError(domain: "com.jian.ReDyne.BinaryParser", code: 1004, userInfo: nil)
         let redyneError = ErrorHandler.convert(nsError)
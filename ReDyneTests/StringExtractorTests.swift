@@ -0,0 +1,153 @@
+import XCTest
+@testable import ReDyne
+
+class StringExtractorTests: XCTestCase {
+
+    private static let seed: UInt64 = 0x5EED_5CA7
+
+    private struct ExtractedString: Equatable {
+        let address: UInt64
+        let offset: UInt64
+        let length: UInt32
+        let content: String
+        let section: String
+    }
+
+    private func extract(_ bytes: [UInt8], mode: StringScanMode, minLength: UInt32, utf16: Bool = false) -> [ExtractedString] {
+        guard let ctx = string_context_create(0) else {
+            XCTFail("Failed to create string context")
+            return []
+        }
+        defer { string_context_free(ctx) }
+        ctx.pointee.scan_mode = mode
+
+        bytes.withUnsafeBufferPointer { buffer in
+            if utf16 {
+                _ = string_extract_utf16_from_data(ctx, buffer.baseAddress, buffer.count, 0x100004000, "__ustring", minLength)
+            } else {
+                _ = string_extract_from_data(ctx, buffer.baseAddress, buffer.count, 0x100004000, "__TEXT", minLength)
+            }
+        }
+
+        var results: [ExtractedString] = []
+        for i in 0..<Int(ctx.pointee.count) {
+            var info = ctx.pointee.strings[i]
+            let section = withUnsafeBytes(of: &info.section) { raw in
+                String(cString: raw.bindMemory(to: CChar.self).baseAddress!)
+            }
+            results.append(ExtractedString(address: info.address,
+                                           offset: info.offset,
+                                           length: info.length,
+                                           content: String(cString: info.content),
+                                           section: section))
+        }
+        return results
+    }
+
+    private func randomBuffer(count: Int, using rng: inout SplitMix64) -> [UInt8] {
+        let style = Int.random(in: 0..<4, using: &rng)
+        return (0..<count).map { _ in
+            let roll = Int.random(in: 0..<100, using: &rng)
+            switch style {
+            case 0:
+                return UInt8.random(in: 0...255, using: &rng)
+            case 1:
+                if roll < 85 { return UInt8.random(in: 0x20...0x7E, using: &rng) }
+                if roll < 93 { return 0 }
+                if roll < 96 { return [0x09, 0x0A, 0x0D].randomElement(using: &rng)! }
+                return UInt8.random(in: 0...255, using: &rng)
+            case 2:
+                return roll < 99 ? 0x61 : 0
+            default:
+                if roll < 50 { return 0 }
+                return roll < 80 ? 0x78 : UInt8.random(in: 0x80...0xFF, using: &rng)
+            }
+        }
+    }
+
+    func testVectorScanMatchesScalar() throws {
+        var rng = SplitMix64(seed: StringExtractorTests.seed)
+
+        for iteration in 0..<500 {
+            let count = iteration % 10 == 0 ? Int.random(in: 0..<20_000, using: &rng) : Int.random(in: 0..<300, using: &rng)
+            let bytes = randomBuffer(count: count, using: &rng)
+            let minLength = UInt32.random(in: 0..<8, using: &rng)
+
+            let scalar = extract(bytes, mode: STRING_SCAN_SCALAR, minLength: minLength)
+            let vector = extract(bytes, mode: STRING_SCAN_AUTO, minLength: minLength)
+
+            XCTAssertEqual(scalar, vector, "Kernel \(String(cString: string_scan_kernel_name())) diverged on a \(count)-byte buffer (seed \(StringExtractorTests.seed), iteration \(iteration))")
+        }
+    }
+
+    func testRunsAcrossBlockBoundaries() throws {
+        var bytes = [UInt8](repeating: 0xFF, count: 31)
+        bytes += Array("boundary".utf8) + [0]
+        bytes += [UInt8](repeating: 0x41, count: 5000) + [0]
+        bytes += Array("tail".utf8)
+
+        let scalar = extract(bytes, mode: STRING_SCAN_SCALAR, minLength: 4)
+        let vector = extract(bytes, mode: STRING_SCAN_AUTO, minLength: 4)
+
+        XCTAssertEqual(scalar, vector)
+        XCTAssertEqual(vector.count, 2)
+        XCTAssertEqual(vector.first?.content, "boundary")
+        XCTAssertEqual(vector.first?.offset, 31)
+        XCTAssertEqual(vector.last?.length, 4095)
+    }
+
+    func testUTF16VectorScanMatchesScalar() throws {
+        var rng = SplitMix64(seed: StringExtractorTests.seed)
+
+        for iteration in 0..<300 {
+            let count = Int.random(in: 0..<2_000, using: &rng)
+            var bytes: [UInt8] = []
+            for _ in 0..<count {
+                let roll = Int.random(in: 0..<100, using: &rng)
+                let unit: UInt16
+                if roll < 60 { unit = UInt16.random(in: 0x20...0x7E, using: &rng) }
+                else if roll < 75 { unit = 0 }
+                else if roll < 85 { unit = UInt16.random(in: 0x4E00...0x9FFF, using: &rng) }
+                else if roll < 92 { unit = UInt16.random(in: 0xD800...0xDFFF, using: &rng) }
+                else { unit = UInt16.random(in: 0...0xFFFF, using: &rng) }
+                bytes += [UInt8(unit & 0xFF), UInt8(unit >> 8)]
+            }
+
+            let scalar = extract(bytes, mode: STRING_SCAN_SCALAR, minLength: 4, utf16: true)
+            let vector = extract(bytes, mode: STRING_SCAN_AUTO, minLength: 4, utf16: true)
+
+            XCTAssertEqual(scalar, vector, "UTF-16 scan diverged on a \(count)-unit buffer (seed \(StringExtractorTests.seed), iteration \(iteration))")
+        }
+    }
+
+    func testUTF16Decoding() throws {
+        var bytes: [UInt8] = []
+        for unit in Array("héllo wörld 😀".utf16) + [0] + [0x61, 0x62, 0xD800, 0x63, 0x64, 0x65, 0x66, 0] {
+            bytes += [UInt8(unit & 0xFF), UInt8(unit >> 8)]
+        }
+
+        let strings = extract(bytes, mode: STRING_SCAN_AUTO, minLength: 4, utf16: true)
+
+        XCTAssertEqual(strings.map(\.content), ["héllo wörld 😀", "cdef"])
+        XCTAssertEqual(strings.first?.length, 28)
+        XCTAssertEqual(strings.last?.offset, 36)
+    }
+
+    func testDuplicateStringsShareStorage() throws {
+        guard let ctx = string_context_create(0) else {
+            XCTFail("Failed to create string context")
+            return
+        }
+        defer { string_context_free(ctx) }
+
+        let bytes = Array("shared literal".utf8) + [0]
+        bytes.withUnsafeBufferPointer { buffer in
+            _ = string_extract_from_data(ctx, buffer.baseAddress, buffer.count, 0x100004000, "__cstring", 4)
+            _ = string_extract_from_data(ctx, buffer.baseAddress, buffer.count, 0x100004000, "__TEXT", 4)
+        }
+
+        XCTAssertEqual(ctx.pointee.count, 2)
+        XCTAssertEqual(ctx.pointee.strings[0].content, ctx.pointee.strings[1].content)
+        XCTAssertEqual(ctx.pointee.intern_count, 1)
+    }
+}
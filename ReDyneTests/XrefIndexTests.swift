@@ -0,0 +1,134 @@
+import XCTest
+@testable import ReDyne
+
+class XrefIndexTests: XCTestCase {
+
+    private var xrefs: [CrossReference] = []
+
+    override func setUpWithError() throws {
+        xrefs = [
+            CrossReference(fromAddress: 0x1000, toAddress: 0x2000, type: .call, instruction: "bl 0x2000"),
+            CrossReference(fromAddress: 0x1004, toAddress: 0x8000, type: .dataRead, instruction: "ldr x0, [x8]"),
+            CrossReference(fromAddress: 0x1008, toAddress: 0x2000, type: .call, instruction: "bl 0x2000"),
+            CrossReference(fromAddress: 0x2000, toAddress: 0x2010, type: .jump, instruction: "b 0x2010"),
+            CrossReference(fromAddress: 0x2004, toAddress: 0x8000, type: .addressLoad, instruction: "adr x1, 0x8000"),
+        ]
+    }
+
+    private func entries(_ index: XrefIndex) -> [String] {
+        return (0..<index.count).map {
+            "0x\(String(index.source(at: $0), radix: 16)) \(index.kind(at: $0).rawValue) 0x\(String(index.target(at: $0), radix: 16))"
+        }
+    }
+
+    /// Decodes an index from raw arrays, as if read from a damaged archive
+    private func decode(sources: [UInt64], targets: [UInt64], kinds: [UInt8], targetOrder: [UInt32]) throws -> XrefIndex? {
+        let archiver = NSKeyedArchiver(requiringSecureCoding: true)
+        archiver.encode(sources.withUnsafeBufferPointer { Data(buffer: $0) }, forKey: "sources")
+        archiver.encode(targets.withUnsafeBufferPointer { Data(buffer: $0) }, forKey: "targets")
+        archiver.encode(kinds.withUnsafeBufferPointer { Data(buffer: $0) }, forKey: "kinds")
+        archiver.encode(targetOrder.withUnsafeBufferPointer { Data(buffer: $0) }, forKey: "targetOrder")
+        archiver.finishEncoding()
+
+        let unarchiver = try NSKeyedUnarchiver(forReadingFrom: archiver.encodedData)
+        defer { unarchiver.finishDecoding() }
+        return XrefIndex(coder: unarchiver)
+    }
+
+    // MARK: - Archiving
+
+    func testArchiveRoundTrip() throws {
+        let index = XrefIndex(xrefs: xrefs)
+        let data = try NSKeyedArchiver.archivedData(withRootObject: index, requiringSecureCoding: true)
+        let decoded = try XCTUnwrap(NSKeyedUnarchiver.unarchivedObject(ofClass: XrefIndex.self, from: data))
+
+        XCTAssertEqual(entries(decoded), entries(index))
+        XCTAssertEqual(decoded.sources(referencing: 0x8000), [0x1004, 0x2004])
+        XCTAssertEqual(decoded.sources(referencing: 0x2000), [0x1000, 0x1008])
+        XCTAssertEqual(decoded.targets(referencedFrom: 0x2000), [0x2010])
+        XCTAssertEqual(decoded.entries(targeting: 0x2000, to: 0x2100), [0, 2, 3])
+        XCTAssertEqual(decoded.entries(from: 0x1004, to: 0x2000), 1..<3)
+    }
+
+    func testDecodingRejectsInconsistentArrays() throws {
+        let sources: [UInt64] = [0x1000, 0x1004, 0x1008]
+        let targets: [UInt64] = [0x3000, 0x2000, 0x3000]
+        let kinds: [UInt8] = [0, 3, 0]
+
+        XCTAssertNotNil(try decode(sources: sources, targets: targets, kinds: kinds, targetOrder: [1, 0, 2]))
+
+        // Not sorted by target
+        XCTAssertNil(try decode(sources: sources, targets: targets, kinds: kinds, targetOrder: [0, 1, 2]))
+        // Equal targets out of entry order
+        XCTAssertNil(try decode(sources: sources, targets: targets, kinds: kinds, targetOrder: [1, 2, 0]))
+        // Not a permutation
+        XCTAssertNil(try decode(sources: sources, targets: targets, kinds: kinds, targetOrder: [1, 0, 0]))
+        XCTAssertNil(try decode(sources: sources, targets: targets, kinds: kinds, targetOrder: [1, 0, 3]))
+        XCTAssertNil(try decode(sources: sources, targets: targets, kinds: kinds, targetOrder: [1, 0]))
+        // Sources out of order, or a kind past the known ones
+        XCTAssertNil(try decode(sources: [0x1008, 0x1004, 0x1000], targets: targets, kinds: kinds, targetOrder: [1, 0, 2]))
+        XCTAssertNil(try decode(sources: sources, targets: targets, kinds: [0, 3, 42], targetOrder: [1, 0, 2]))
+    }
+
+    // MARK: - Cache
+
+    func testCachedIndexRoundTrip() throws {
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("ReDyneXrefIndex-\(UUID().uuidString)")
+        try Data((0..<4096).map { UInt8(truncatingIfNeeded: $0 &* 31) }).write(to: url)
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        let cache = DecompilationCache.shared
+        let hash = try XCTUnwrap(cache.fileHash(for: url))
+        XCTAssertNil(cache.getCachedXrefIndex(for: url, fileHash: hash))
+
+        let index = XrefIndex(xrefs: xrefs)
+        cache.saveXrefIndex(index, for: url, fileHash: hash)
+        defer { cache.clearCache(for: url, fileHash: hash) }
+
+        // The index is usable without a cached DecompiledOutput
+        XCTAssertFalse(cache.hasCachedResult(for: url, fileHash: hash))
+        let loaded = try XCTUnwrap(cache.getCachedXrefIndex(for: url))
+        XCTAssertEqual(entries(loaded), entries(index))
+
+        cache.clearCache(for: url, fileHash: hash)
+        XCTAssertNil(cache.getCachedXrefIndex(for: url, fileHash: hash))
+    }
+
+    func testAnalysisRebuiltFromIndex() {
+        func symbol(_ name: String, _ address: UInt64, function: Bool) -> SymbolModel {
+            let model = SymbolModel()
+            model.name = name
+            model.address = address
+            model.size = 0x100
+            model.type = "Section"
+            model.scope = "Global"
+            model.isDefined = true
+            model.isFunction = function
+            return model
+        }
+        let symbols = [symbol("_main", 0x1000, function: true), symbol("_helper", 0x2000, function: true),
+                       symbol("_table", 0x8000, function: false)]
+
+        let instructions: [InstructionModel] = xrefs.map { xref in
+            let parts = xref.instruction.split(separator: " ", maxSplits: 1)
+            let model = InstructionModel()
+            model.address = xref.fromAddress
+            model.mnemonic = parts[0].uppercased()
+            model.operands = String(parts[1])
+            return model
+        }
+
+        let result = XrefAnalyzer.analyze(index: XrefIndex(xrefs: xrefs), symbols: symbols, instructions: instructions)
+        XCTAssertEqual(result.totalXrefs, 5)
+        XCTAssertEqual(result.totalCalls, 2)
+        XCTAssertEqual(result.totalJumps, 1)
+        XCTAssertEqual(result.totalDataRefs, 1)
+
+        XCTAssertEqual(result.allXrefs.map { $0.instruction }, xrefs.map { $0.instruction })
+        XCTAssertEqual(result.allXrefs[1].fromSymbol, "_main+4")
+        XCTAssertEqual(result.allXrefs[1].toSymbol, "_table")
+        XCTAssertEqual(result.getCallersOfFunction(address: 0x2000).map { $0.fromAddress }, [0x1000, 0x1008])
+        XCTAssertEqual(result.getXrefs(forAddress: 0x1000)?.xrefsFrom.count, 3)
+        XCTAssertEqual(result.getXrefs(forAddress: 0x2000)?.xrefsTo.count, 3)
+    }
+}
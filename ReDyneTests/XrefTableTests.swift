@@ -0,0 +1,115 @@
+import XCTest
+@testable import ReDyne
+
+class XrefTableTests: XCTestCase {
+
+    /// Two functions at MachOFixture.textAddress, the second at +0x40. __data
+    /// follows __TEXT at 0x100008000.
+    private static let program: [UInt32] = [
+        0x90000028, // +0x00  ADRP X8, 0x100008000
+        0x91048108, // +0x04  ADD  X8, X8, #0x120
+        0xF9400909, // +0x08  LDR  X9, [X8, #16]
+        0xF9000101, // +0x0C  STR  X1, [X8]
+        0x90000033, // +0x10  ADRP X19, 0x100008000
+        0x9400000B, // +0x14  BL   +0x40 (clobbers X8, keeps X19)
+        0xF9400100, // +0x18  LDR  X0, [X8]
+        0xF9400660, // +0x1C  LDR  X0, [X19, #8]
+        0xAA1303E2, // +0x20  MOV  X2, X19
+        0xF8410443, // +0x24  LDR  X3, [X2], #16 (post-index, X2 no longer known)
+        0xF9400044, // +0x28  LDR  X4, [X2]
+        0x14000001, // +0x2C  B    +0x30
+        0xF9400260, // +0x30  LDR  X0, [X19] (branch target, registers reset)
+        0x10000045, // +0x34  ADR  X5, +0x3C
+        0x58020E46, // +0x38  LDR  X6, 0x100008200
+        0xD65F03C0, // +0x3C  RET
+        0x901FFFE8, // +0x40  ADRP X8, 0x140000000 (outside every segment)
+        0xF9400100, // +0x44  LDR  X0, [X8]
+        0xF9400100, // +0x48  LDR  X0, [X8]
+        0xD65F03C0, // +0x4C  RET
+    ]
+
+    private func describe(_ from: UInt64, _ to: UInt64, _ kind: UInt32) -> String {
+        let name = String(cString: xref_kind_name(XrefKind(rawValue: kind)))
+        return "+0x\(String(from - MachOFixture.textAddress, radix: 16)) \(name) 0x\(String(to, radix: 16))"
+    }
+
+    func testRegisterTrackedXrefs() throws {
+        let fixture = try MachOFixture(text: XrefTableTests.program)
+        XCTAssertEqual(fixture.dataAddress, 0x100008000)
+        let disasm = try XCTUnwrap(fixture.disassemble())
+        defer { MachOFixture.close(disasm) }
+        let table = try XCTUnwrap(xref_analyze(disasm))
+        defer { xref_table_free(table) }
+
+        let text = MachOFixture.textAddress
+        let data = fixture.dataAddress
+        let expected: [(UInt64, UInt64, XrefKind)] = [
+            (text + 0x04, data + 0x120, XREF_ADDRESS_LOAD),
+            (text + 0x08, data + 0x130, XREF_DATA_READ),
+            (text + 0x0C, data + 0x120, XREF_DATA_WRITE),
+            (text + 0x14, text + 0x40, XREF_CALL),
+            (text + 0x1C, data + 0x8, XREF_DATA_READ),
+            (text + 0x24, data, XREF_DATA_READ),
+            (text + 0x2C, text + 0x30, XREF_JUMP),
+            (text + 0x34, text + 0x3C, XREF_ADDRESS_LOAD),
+            (text + 0x38, data + 0x200, XREF_DATA_READ),
+        ]
+        let actual = (0..<Int(table.pointee.count)).map { table.pointee.entries[$0] }
+        XCTAssertEqual(actual.map { describe($0.from, $0.to, $0.kind) },
+                       expected.map { describe($0.0, $0.1, $0.2.rawValue) })
+
+        let counts = withUnsafeBytes(of: table.pointee.kind_counts) { Array($0.bindMemory(to: UInt32.self)) }
+        XCTAssertEqual(counts, [1, 1, 0, 4, 1, 2])
+    }
+
+    func testQueriesByRange() throws {
+        let fixture = try MachOFixture(text: XrefTableTests.program)
+        let disasm = try XCTUnwrap(fixture.disassemble())
+        defer { MachOFixture.close(disasm) }
+        let table = try XCTUnwrap(xref_analyze(disasm))
+        defer { xref_table_free(table) }
+
+        let text = MachOFixture.textAddress
+        let data = fixture.dataAddress
+        var first: UInt32 = 0
+
+        // The ADD and the STR both reach data + 0x120, in source order
+        XCTAssertEqual(xref_find_to(table, data + 0x120, data + 0x121, &first), 2)
+        let sources = (0..<2).map { table.pointee.entries[Int(table.pointee.by_target[Int(first) + $0])].from }
+        XCTAssertEqual(sources, [text + 0x04, text + 0x0C])
+
+        XCTAssertEqual(xref_find_to(table, data, data + 0x1000, &first), 6)
+        XCTAssertEqual(xref_find_from(table, text, text + 0x10, &first), 3)
+        XCTAssertEqual(first, 0)
+
+        // Nothing survives in the second function
+        XCTAssertEqual(xref_find_from(table, text + 0x40, text + 0x50, &first), 0)
+        XCTAssertEqual(xref_find_to(table, 0x140000000, 0x140001000, &first), 0)
+    }
+
+    func testBridgeReusesTheDecodedText() throws {
+        let fixture = try MachOFixture(text: XrefTableTests.program)
+        var disassembly: CompactDisassembly?
+        let instructions = try DisassemblerService.disassembleFile(atPath: fixture.url.path, progressBlock: nil,
+                                                                   disassembly: &disassembly)
+        let shared = try XCTUnwrap(disassembly)
+        XCTAssertEqual(shared.instructionCount, instructions.count)
+        XCTAssertEqual(shared.instructionCount, XrefTableTests.program.count)
+
+        let xrefs = try XCTUnwrap(ObjCParserBridge.analyzeCrossReferences(with: shared, symbols: []) as? XrefAnalysisResult)
+        XCTAssertEqual(xrefs.totalXrefs, 9)
+        XCTAssertEqual(xrefs.totalCalls, 1)
+
+        let functions: [FunctionModel] = [0, 0x40].map { offset in
+            let function = FunctionModel()
+            function.startAddress = MachOFixture.textAddress + offset
+            function.name = String(format: "sub_%llx", function.startAddress)
+            return function
+        }
+        let graph = try XCTUnwrap(ObjCParserBridge.buildCallGraph(with: shared, functions: functions) as? CallGraphResult)
+        XCTAssertEqual(graph.node(containing: MachOFixture.textAddress + 0x44)?.address, MachOFixture.textAddress + 0x40)
+
+        // The same context serves every pass and is still intact afterwards
+        XCTAssertEqual(shared.context.pointee.instruction_count, UInt32(XrefTableTests.program.count))
+    }
+}
@@ -0,0 +1,822 @@
+/*
+ * redyne_bench - headless throughput benchmark for the native analysis core.
+ *
+ * Runs the C stages the app drives (Mach-O parsing, symbols, strings,
+ * disassembly, ARM64 decoding, CFG and call graph construction, xref
+ * analysis, ObjC runtime parsing)
+ * over a corpus of binaries and synthetic ARM64 images, and reports
+ * throughput, peak RSS and per-stage latency percentiles as JSON.
+ *
+ *   redyne_bench [-n iterations] [-s synthetic_mb]... [-c cfg_instructions]
+ *                [-t threads] [-o report.json] [path | directory]...
+ *
+ * Directories are scanned one level deep; files that do not parse as
+ * Mach-O are listed under "skipped". Synthetic images are written to
+ * $TMPDIR and removed afterwards.
+ */
+
+#include "MachOHeader.h"
+#include "SymbolTable.h"
+#include "StringExtractor.h"
+#include "DisassemblyEngine.h"
+#include "ARM64InstructionDecoder.h"
+#include "ControlFlowGraph.h"
+#include "CallGraph.h"
+#include "XrefTable.h"
+#include "ObjCParser.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+#define BENCH_DEFAULT_ITERATIONS 5
+#define BENCH_DEFAULT_CFG_INSTRUCTIONS (64 * 1024)
+#define BENCH_MAX_BINARIES 4096
+#define BENCH_DECODE_CHUNK 4096
+
+#pragma mark - Stages
+
+typedef enum {
+    STAGE_PARSE,
+    STAGE_SYMBOLS,
+    STAGE_STRINGS,
+    STAGE_DISASM,
+    STAGE_DISASM_PARALLEL,
+    STAGE_DECODE,
+    STAGE_DECODE_BATCH,
+    STAGE_CFG,
+    STAGE_CFG_PARALLEL,
+    STAGE_CALLGRAPH,
+    STAGE_XREFS,
+    STAGE_OBJC,
+    STAGE_COUNT
+} BenchStage;
+
+static const struct {
+    const char *name;
+    const char *unit;       // what `items` counts
+} bench_stages[STAGE_COUNT] = {
+    [STAGE_PARSE]           = { "macho_parse", "load_commands" },
+    [STAGE_SYMBOLS]         = { "symbol_table_parse", "symbols" },
+    [STAGE_STRINGS]         = { "string_extraction", "strings" },
+    [STAGE_DISASM]          = { "disasm_all", "instructions" },
+    [STAGE_DISASM_PARALLEL] = { "disasm_all_parallel", "instructions" },
+    [STAGE_DECODE]          = { "arm64dec_decode_instruction", "instructions" },
+    [STAGE_DECODE_BATCH]    = { "arm64dec_decode_batch", "instructions" },
+    [STAGE_CFG]             = { "cfg_build_all", "instructions" },
+    [STAGE_CFG_PARALLEL]    = { "cfg_build_all_parallel", "instructions" },
+    [STAGE_CALLGRAPH]       = { "callgraph_build", "instructions" },
+    [STAGE_XREFS]           = { "xref_analyze", "instructions" },
+    [STAGE_OBJC]            = { "objc_parse_runtime", "classes" },
+};
+
+/* Latency samples of one stage on one binary. bytes/items describe a
+   single run and are the same for every iteration. */
+typedef struct {
+    double *samples;
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t bytes;
+    uint64_t items;
+} BenchSeries;
+
+typedef struct {
+    char *path;
+    bool synthetic;
+    uint64_t file_size;
+    uint32_t cputype;
+    BenchSeries stages[STAGE_COUNT];
+} BenchBinary;
+
+typedef struct {
+    uint32_t iterations;
+    uint32_t threads;
+    uint64_t cfg_instructions;
+    BenchBinary binaries[BENCH_MAX_BINARIES];
+    uint32_t binary_count;
+    char *skipped[BENCH_MAX_BINARIES];
+    uint32_t skipped_count;
+} BenchRun;
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void bench_record(BenchSeries *series, double seconds, uint64_t bytes, uint64_t items) {
+    if (series->count == series->capacity) {
+        uint32_t capacity = series->capacity ? series->capacity * 2 : 16;
+        double *samples = (double*)realloc(series->samples, capacity * sizeof(double));
+        if (!samples) return;
+        series->samples = samples;
+        series->capacity = capacity;
+    }
+    series->samples[series->count++] = seconds;
+    series->bytes = bytes;
+    series->items = items;
+}
+
+static int bench_compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted samples. */
+static double bench_percentile(const double *sorted, uint32_t count, double p) {
+    if (count == 0) return 0.0;
+    uint32_t rank = (uint32_t)(p / 100.0 * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static uint64_t bench_peak_rss_bytes(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (uint64_t)usage.ru_maxrss;
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+#pragma mark - Pipeline
+
+static const SectionInfo* bench_find_section(const MachOContext *ctx, const char *name) {
+    for (uint32_t i = 0; i < ctx->section_count; i++) {
+        if (strncmp(ctx->sections[i].sectname, name, sizeof(ctx->sections[i].sectname)) == 0 &&
+            strncmp(ctx->sections[i].segname, "__TEXT", sizeof(ctx->sections[i].segname)) == 0) {
+            return &ctx->sections[i];
+        }
+    }
+    return NULL;
+}
+
+static MachOContext* bench_open(const char *path) {
+    char error[256] = {0};
+    MachOContext *ctx = macho_open(path, error);
+    if (!ctx) return NULL;
+    if (!macho_parse_header(ctx) || !macho_parse_load_commands(ctx)) {
+        macho_close(ctx);
+        return NULL;
+    }
+    macho_extract_segments(ctx);
+    macho_extract_sections(ctx);
+    return ctx;
+}
+
+/* Same passes as BinaryParserService; returns the bytes handed to the scanners. */
+static uint64_t bench_extract_strings(StringContext *strings, MachOContext *ctx) {
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < ctx->section_count; i++) {
+        SectionInfo *sect = &ctx->sections[i];
+        if (strcmp(sect->sectname, "__cstring") == 0) {
+            string_extract_cstrings(strings, ctx, sect->offset, sect->size, sect->addr);
+            bytes += sect->size;
+        } else if (strcmp(sect->sectname, "__ustring") == 0) {
+            string_extract_ustrings(strings, ctx, sect->offset, sect->size, sect->addr);
+            bytes += sect->size;
+        }
+    }
+    for (uint32_t i = 0; i < ctx->section_count; i++) {
+        SectionInfo *sect = &ctx->sections[i];
+        if (strcmp(sect->sectname, "__cfstring") == 0) {
+            string_extract_cfstrings(strings, ctx, sect->offset, sect->size, sect->addr);
+            bytes += sect->size;
+        }
+    }
+    for (uint32_t i = 0; i < ctx->segment_count; i++) {
+        SegmentInfo *seg = &ctx->segments[i];
+        if ((seg->initprot & 0x01) && seg->filesize > 0) {
+            string_extract_from_image(strings, ctx, seg->fileoff, seg->filesize, seg->vmaddr, seg->segname, 4);
+            bytes += seg->filesize;
+        }
+    }
+    string_context_sort(strings);
+    return bytes;
+}
+
+static void bench_disasm(BenchSeries *series, MachOContext *ctx, uint32_t threads) {
+    double start = bench_now();
+    DisassemblyContext *disasm = disasm_create(ctx);
+    if (!disasm) return;
+    disasm_enable_flag(disasm, DISASM_FLAG_COMPACT);
+    if (!disasm_load_section(disasm, "__text")) {
+        disasm_free(disasm);
+        return;
+    }
+    uint32_t count = threads > 1 ? disasm_all_parallel(disasm, threads) : disasm_all(disasm);
+    double elapsed = bench_now() - start;
+
+    bench_record(series, elapsed, disasm->code_size, count);
+    disasm_free(disasm);
+}
+
+static uint32_t* bench_load_words(MachOContext *ctx, size_t *out_count) {
+    const SectionInfo *text = bench_find_section(ctx, "__text");
+    *out_count = 0;
+    if (!text || text->size < 4 || ctx->header.cputype != CPU_TYPE_ARM64) return NULL;
+
+    size_t count = (size_t)(text->size / 4);
+    uint32_t *words = (uint32_t*)malloc(count * sizeof(uint32_t));
+    if (!words) return NULL;
+    if (!macho_read(ctx, text->offset, words, (uint64_t)count * 4)) {
+        free(words);
+        return NULL;
+    }
+    if (ctx->header.is_swapped) {
+        for (size_t i = 0; i < count; i++) words[i] = swap_uint32(words[i]);
+    }
+    *out_count = count;
+    return words;
+}
+
+static void bench_decode(BenchBinary *binary, const uint32_t *words, size_t count, uint64_t base_address) {
+    static ARM64DecodedInstruction decoded[BENCH_DECODE_CHUNK];
+
+    double start = bench_now();
+    for (size_t i = 0; i < count; i++) {
+        arm64dec_decode_instruction(words[i], base_address + (uint64_t)i * 4, &decoded[i % BENCH_DECODE_CHUNK]);
+    }
+    bench_record(&binary->stages[STAGE_DECODE], bench_now() - start, (uint64_t)count * 4, count);
+
+    start = bench_now();
+    for (size_t first = 0; first < count; first += BENCH_DECODE_CHUNK) {
+        size_t n = count - first;
+        if (n > BENCH_DECODE_CHUNK) n = BENCH_DECODE_CHUNK;
+        arm64dec_decode_batch(words + first, n, base_address + (uint64_t)first * 4, decoded);
+    }
+    bench_record(&binary->stages[STAGE_DECODE_BATCH], bench_now() - start, (uint64_t)count * 4, count);
+}
+
+/* CFG construction over the first `limit` instructions of __text (all of
+   them when limit is 0), decoded beforehand so only the graph is timed. */
+static void bench_cfg(BenchSeries *series, MachOContext *ctx, uint64_t limit, uint32_t threads) {
+    DisassemblyContext *disasm = disasm_create(ctx);
+    if (!disasm) return;
+    disasm_enable_flag(disasm, DISASM_FLAG_COMPACT);
+    if (!disasm_load_section(disasm, "__text")) {
+        disasm_free(disasm);
+        return;
+    }
+
+    uint64_t end = disasm->code_base_addr + disasm->code_size;
+    if (limit > 0 && disasm->arch == ARCH_ARM64 && limit * 4 < disasm->code_size) {
+        end = disasm->code_base_addr + limit * 4;
+    }
+    uint32_t count = disasm_range(disasm, disasm->code_base_addr, end);
+
+    if (count > 0) {
+        double start = bench_now();
+        CFGContext *cfg = cfg_create(disasm);
+        if (cfg) {
+            if (threads > 1) cfg_build_all_parallel(cfg, threads);
+            else cfg_build_all(cfg);
+            cfg_free(cfg);
+            bench_record(series, bench_now() - start, end - disasm->code_base_addr, count);
+        }
+    }
+    disasm_free(disasm);
+}
+
+/* Call graph and xref table over the whole of __text, decoded once
+   beforehand. */
+static void bench_callgraph_xrefs(BenchBinary *binary, MachOContext *ctx) {
+    DisassemblyContext *disasm = disasm_create(ctx);
+    if (!disasm) return;
+    disasm_enable_flag(disasm, DISASM_FLAG_COMPACT);
+    if (!disasm_load_section(disasm, "__text")) {
+        disasm_free(disasm);
+        return;
+    }
+
+    uint32_t count = disasm_all(disasm);
+    if (count > 0) {
+        double start = bench_now();
+        CallGraph *graph = callgraph_build(disasm, NULL, NULL, 0);
+        if (graph) {
+            callgraph_free(graph);
+            bench_record(&binary->stages[STAGE_CALLGRAPH], bench_now() - start, disasm->code_size, count);
+        }
+
+        start = bench_now();
+        XrefTable *xrefs = xref_analyze(disasm);
+        if (xrefs) {
+            xref_table_free(xrefs);
+            bench_record(&binary->stages[STAGE_XREFS], bench_now() - start, disasm->code_size, count);
+        }
+    }
+    disasm_free(disasm);
+}
+
+static bool bench_binary(BenchRun *run, BenchBinary *binary) {
+    for (uint32_t iteration = 0; iteration < run->iterations; iteration++) {
+        double start = bench_now();
+        MachOContext *ctx = bench_open(binary->path);
+        double elapsed = bench_now() - start;
+        if (!ctx) return false;
+
+        binary->file_size = (uint64_t)ctx->file_size;
+        binary->cputype = ctx->header.cputype;
+        bench_record(&binary->stages[STAGE_PARSE], elapsed, ctx->slice_size, ctx->header.ncmds);
+
+        start = bench_now();
+        SymbolTableContext *symbols = symbol_table_create(ctx);
+        if (symbols) {
+            symbol_table_parse(symbols);
+            symbol_table_categorize(symbols);
+            symbol_table_extract_functions(symbols);
+            bench_record(&binary->stages[STAGE_SYMBOLS], bench_now() - start,
+                         (uint64_t)ctx->nsyms * sizeof(struct nlist_64) + ctx->strsize, symbols->symbol_count);
+            symbol_table_free(symbols);
+        }
+
+        start = bench_now();
+        StringContext *strings = string_context_create(1024);
+        if (strings) {
+            uint64_t bytes = bench_extract_strings(strings, ctx);
+            bench_record(&binary->stages[STAGE_STRINGS], bench_now() - start, bytes, strings->count);
+            string_context_free(strings);
+        }
+
+        bench_disasm(&binary->stages[STAGE_DISASM], ctx, 1);
+        if (run->threads > 1) bench_disasm(&binary->stages[STAGE_DISASM_PARALLEL], ctx, run->threads);
+
+        size_t word_count = 0;
+        uint32_t *words = bench_load_words(ctx, &word_count);
+        if (words) {
+            bench_decode(binary, words, word_count, bench_find_section(ctx, "__text")->addr);
+            free(words);
+        }
+
+        bench_cfg(&binary->stages[STAGE_CFG], ctx, run->cfg_instructions, 1);
+        if (run->threads > 1) bench_cfg(&binary->stages[STAGE_CFG_PARALLEL], ctx, run->cfg_instructions, run->threads);
+        bench_callgraph_xrefs(binary, ctx);
+
+        start = bench_now();
+        ObjCRuntimeInfo *objc = objc_parse_runtime(ctx);
+        elapsed = bench_now() - start;
+        bench_record(&binary->stages[STAGE_OBJC], elapsed, ctx->slice_size, objc ? (uint64_t)objc->class_count : 0);
+        if (objc) objc_free_runtime_info(objc);
+
+        macho_close(ctx);
+    }
+    return true;
+}
+
+#pragma mark - Synthetic Images
+
+/* Common user-space encodings. Entries marked with_rd get a random
+   destination register so the decoder sees a spread of operands. */
+static const struct { uint32_t word; bool with_rd; } bench_body_words[] = {
+    { 0xF9400660, true },   // LDR Xd, [X19, #8]
+    { 0xB9400A60, true },   // LDR Wd, [X19, #8]
+    { 0xF9000660, true },   // STR Xt, [X19, #8]
+    { 0x91000400, true },   // ADD Xd, X0, #1
+    { 0xD1004000, true },   // SUB Xd, X0, #16
+    { 0xAA0103E0, true },   // MOV Xd, X1
+    { 0x2A0103E0, true },   // MOV Wd, W1
+    { 0x52800020, true },   // MOV Wd, #1
+    { 0xD2800000, true },   // MOV Xd, #0
+    { 0x90000000, true },   // ADRP Xd, page
+    { 0x91000000, true },   // ADD Xd, X0, #0
+    { 0xF100041F, false },  // CMP X0, #1
+    { 0x6B01001F, false },  // CMP W0, W1
+    { 0x1A9F17E0, true },   // CSET Wd, EQ
+    { 0x9A811000, true },   // CSEL Xd, X0, X1, NE
+    { 0x9B027C20, true },   // MUL Xd, X1, X2
+    { 0xD37FF820, true },   // LSL Xd, X1, #1
+    { 0x8B020020, true },   // ADD Xd, X1, X2
+    { 0x8A020020, true },   // AND Xd, X1, X2
+    { 0xA94107E0, false },  // LDP X0, X1, [SP, #16]
+    { 0xA90107E0, false },  // STP X0, X1, [SP, #16]
+    { 0xB8616800, true },   // LDR Wt, [X0, X1]
+    { 0x1E602020, false },  // FCMP D1, D0
+    { 0x1E620020, true },   // SCVTF Dd, W1
+    { 0xD503201F, false },  // NOP
+};
+
+static uint32_t bench_random(uint64_t *state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(*state >> 33);
+}
+
+/* Function-shaped ARM64 code: frame setup, a body with forward B.cond and
+   BL to earlier functions, frame teardown and RET. Function start indices
+   are written to starts. */
+static void bench_generate_code(uint32_t *words, uint32_t count, uint32_t *starts, uint32_t *start_count,
+                                uint64_t *seed) {
+    uint32_t i = 0;
+    *start_count = 0;
+
+    while (i + 8 <= count) {
+        uint32_t length = 8 + bench_random(seed) % 192;
+        if (i + length > count) length = count - i;
+        uint32_t end = i + length - 2;
+
+        starts[(*start_count)++] = i;
+        words[i++] = 0xA9BF7BFD;    // STP X29, X30, [SP, #-16]!
+        words[i++] = 0x910003FD;    // MOV X29, SP
+
+        while (i < end) {
+            uint32_t pick = bench_random(seed) % 16;
+            if (pick == 0 && *start_count > 1) {
+                uint32_t callee = starts[bench_random(seed) % (*start_count - 1)];
+                int32_t offset = (int32_t)callee - (int32_t)i;
+                words[i] = 0x94000000 | ((uint32_t)offset & 0x3FFFFFF);                 // BL callee
+            } else if (pick == 1 && end - i > 2) {
+                uint32_t skip = 1 + bench_random(seed) % (end - i - 1);
+                words[i] = 0x54000000 | ((skip & 0x7FFFF) << 5) | (bench_random(seed) % 14);  // B.cond forward
+            } else {
+                uint32_t entry = bench_random(seed) % (sizeof(bench_body_words) / sizeof(bench_body_words[0]));
+                words[i] = bench_body_words[entry].word;
+                if (bench_body_words[entry].with_rd) words[i] = (words[i] & ~0x1Fu) | (bench_random(seed) % 29);
+            }
+            i++;
+        }
+
+        words[i++] = 0xA8C17BFD;    // LDP X29, X30, [SP], #16
+        words[i++] = 0xD65F03C0;    // RET
+    }
+    while (i < count) words[i++] = 0xD503201F;
+}
+
+static bool bench_write(int fd, const void *data, size_t size) {
+    const uint8_t *p = (const uint8_t*)data;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+/* Writes a thin ARM64 MH_EXECUTE with __TEXT,__text of about text_mb MB,
+   __TEXT,__cstring and a symbol table with one external symbol per
+   function. Returns the malloc'd path or NULL. */
+static char* bench_write_synthetic(uint32_t text_mb, uint64_t seed) {
+    const uint64_t vmbase = 0x100000000ULL;
+    const uint64_t page = 0x4000;
+    uint32_t count = (uint32_t)((uint64_t)text_mb * 1024 * 1024 / 4);
+
+    uint32_t *words = (uint32_t*)malloc((size_t)count * 4);
+    uint32_t *starts = (uint32_t*)malloc(((size_t)count / 8 + 1) * sizeof(uint32_t));
+    if (!words || !starts) {
+        free(words);
+        free(starts);
+        return NULL;
+    }
+    uint32_t function_count = 0;
+    bench_generate_code(words, count, starts, &function_count, &seed);
+
+    size_t cstring_size = (size_t)function_count * 24;
+    char *cstrings = (char*)malloc(cstring_size + 1);
+    size_t strtab_capacity = (size_t)function_count * 24 + 2;
+    char *strtab = (char*)malloc(strtab_capacity);
+    struct nlist_64 *symbols = (struct nlist_64*)calloc(function_count, sizeof(struct nlist_64));
+    if (!cstrings || !strtab || !symbols) {
+        free(words); free(starts); free(cstrings); free(strtab); free(symbols);
+        return NULL;
+    }
+
+    size_t cstring_used = 0;
+    for (uint32_t f = 0; f < function_count && cstring_used + 24 <= cstring_size; f++) {
+        cstring_used += (size_t)snprintf(cstrings + cstring_used, 24, "message %u: %s", f,
+                                         (f & 1) ? "failed" : "ok") + 1;
+    }
+
+    uint64_t text_offset = page;
+    uint64_t text_size = (uint64_t)count * 4;
+    uint64_t cstring_offset = text_offset + text_size;
+    uint64_t text_segment_size = (cstring_offset + cstring_used + page - 1) & ~(page - 1);
+
+    size_t strtab_size = 1;
+    strtab[0] = '\0';
+    for (uint32_t f = 0; f < function_count; f++) {
+        symbols[f].n_un.n_strx = (uint32_t)strtab_size;
+        symbols[f].n_type = N_SECT | N_EXT;
+        symbols[f].n_sect = 1;
+        symbols[f].n_value = vmbase + text_offset + (uint64_t)starts[f] * 4;
+        strtab_size += (size_t)snprintf(strtab + strtab_size, 24, "_synthetic_fn_%u", f) + 1;
+    }
+
+    uint64_t linkedit_offset = text_segment_size;
+    uint64_t symtab_size = (uint64_t)function_count * sizeof(struct nlist_64);
+    uint64_t linkedit_size = symtab_size + strtab_size;
+
+    struct {
+        struct mach_header_64 header;
+        struct segment_command_64 pagezero;
+        struct segment_command_64 text;
+        struct section_64 text_sections[2];
+        struct segment_command_64 linkedit;
+        struct symtab_command symtab;
+    } commands;
+    memset(&commands, 0, sizeof(commands));
+
+    commands.header.magic = MH_MAGIC_64;
+    commands.header.cputype = CPU_TYPE_ARM64;
+    commands.header.cpusubtype = 0;
+    commands.header.filetype = MH_EXECUTE;
+    commands.header.ncmds = 4;
+    commands.header.sizeofcmds = (uint32_t)(sizeof(commands) - sizeof(struct mach_header_64));
+
+    commands.pagezero.cmd = LC_SEGMENT_64;
+    commands.pagezero.cmdsize = sizeof(struct segment_command_64);
+    strncpy(commands.pagezero.segname, "__PAGEZERO", sizeof(commands.pagezero.segname));
+    commands.pagezero.vmsize = vmbase;
+
+    commands.text.cmd = LC_SEGMENT_64;
+    commands.text.cmdsize = sizeof(struct segment_command_64) + 2 * sizeof(struct section_64);
+    strncpy(commands.text.segname, "__TEXT", sizeof(commands.text.segname));
+    commands.text.vmaddr = vmbase;
+    commands.text.vmsize = text_segment_size;
+    commands.text.filesize = text_segment_size;
+    commands.text.maxprot = commands.text.initprot = 5;
+    commands.text.nsects = 2;
+
+    strncpy(commands.text_sections[0].sectname, "__text", sizeof(commands.text_sections[0].sectname));
+    strncpy(commands.text_sections[0].segname, "__TEXT", sizeof(commands.text_sections[0].segname));
+    commands.text_sections[0].addr = vmbase + text_offset;
+    commands.text_sections[0].size = text_size;
+    commands.text_sections[0].offset = (uint32_t)text_offset;
+    commands.text_sections[0].align = 2;
+    commands.text_sections[0].flags = S_ATTR_PURE_INSTRUCTIONS | S_ATTR_SOME_INSTRUCTIONS;
+
+    strncpy(commands.text_sections[1].sectname, "__cstring", sizeof(commands.text_sections[1].sectname));
+    strncpy(commands.text_sections[1].segname, "__TEXT", sizeof(commands.text_sections[1].segname));
+    commands.text_sections[1].addr = vmbase + cstring_offset;
+    commands.text_sections[1].size = cstring_used;
+    commands.text_sections[1].offset = (uint32_t)cstring_offset;
+    commands.text_sections[1].flags = S_CSTRING_LITERALS;
+
+    commands.linkedit.cmd = LC_SEGMENT_64;
+    commands.linkedit.cmdsize = sizeof(struct segment_command_64);
+    strncpy(commands.linkedit.segname, "__LINKEDIT", sizeof(commands.linkedit.segname));
+    commands.linkedit.vmaddr = vmbase + linkedit_offset;
+    commands.linkedit.vmsize = (linkedit_size + page - 1) & ~(page - 1);
+    commands.linkedit.fileoff = linkedit_offset;
+    commands.linkedit.filesize = linkedit_size;
+    commands.linkedit.maxprot = commands.linkedit.initprot = 1;
+
+    commands.symtab.cmd = LC_SYMTAB;
+    commands.symtab.cmdsize = sizeof(struct symtab_command);
+    commands.symtab.symoff = (uint32_t)linkedit_offset;
+    commands.symtab.nsyms = function_count;
+    commands.symtab.stroff = (uint32_t)(linkedit_offset + symtab_size);
+    commands.symtab.strsize = (uint32_t)strtab_size;
+
+    const char *tmpdir = getenv("TMPDIR");
+    char *path = (char*)malloc(PATH_MAX);
+    bool ok = path != NULL;
+    int fd = -1;
+    if (ok) {
+        snprintf(path, PATH_MAX, "%s/redyne-bench-%uMB-XXXXXX", (tmpdir && *tmpdir) ? tmpdir : "/tmp", text_mb);
+        fd = mkstemp(path);
+        ok = fd >= 0;
+    }
+
+    static const uint8_t zeros[0x4000];
+    ok = ok && bench_write(fd, &commands, sizeof(commands)) &&
+         bench_write(fd, zeros, (size_t)(text_offset - sizeof(commands))) &&
+         bench_write(fd, words, (size_t)text_size) &&
+         bench_write(fd, cstrings, cstring_used) &&
+         bench_write(fd, zeros, (size_t)(linkedit_offset - cstring_offset - cstring_used)) &&
+         bench_write(fd, symbols, (size_t)symtab_size) &&
+         bench_write(fd, strtab, strtab_size);
+    if (fd >= 0) close(fd);
+
+    free(words); free(starts); free(cstrings); free(strtab); free(symbols);
+    if (!ok) {
+        if (fd >= 0) unlink(path);
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+#pragma mark - Corpus
+
+static void bench_add_path(BenchRun *run, const char *path, bool synthetic) {
+    if (run->binary_count >= BENCH_MAX_BINARIES) return;
+    BenchBinary *binary = &run->binaries[run->binary_count++];
+    memset(binary, 0, sizeof(BenchBinary));
+    binary->path = strdup(path);
+    binary->synthetic = synthetic;
+}
+
+static void bench_add_corpus(BenchRun *run, const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        if (run->skipped_count < BENCH_MAX_BINARIES) run->skipped[run->skipped_count++] = strdup(path);
+        return;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        bench_add_path(run, path, false);
+        return;
+    }
+
+    DIR *dir = opendir(path);
+    if (!dir) return;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        char child[PATH_MAX];
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        if (stat(child, &st) == 0 && S_ISREG(st.st_mode)) bench_add_path(run, child, false);
+    }
+    closedir(dir);
+}
+
+#pragma mark - Report
+
+static void bench_json_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+/* One stage summary. Throughput uses the median run. */
+static void bench_json_series(FILE *out, BenchStage stage, const double *samples, uint32_t count,
+                              uint64_t bytes, uint64_t items, const char *indent) {
+    double *sorted = (double*)malloc((count ? count : 1) * sizeof(double));
+    if (!sorted) return;
+    memcpy(sorted, samples, count * sizeof(double));
+    qsort(sorted, count, sizeof(double), bench_compare_double);
+
+    double p50 = bench_percentile(sorted, count, 50.0);
+    double p99 = bench_percentile(sorted, count, 99.0);
+    fprintf(out, "%s\"%s\": { \"runs\": %u, \"bytes\": %llu, \"%s\": %llu, "
+            "\"p50_ms\": %.3f, \"p99_ms\": %.3f, \"mb_per_s\": %.1f, \"%s_per_s\": %.0f }",
+            indent, bench_stages[stage].name, count, (unsigned long long)bytes,
+            bench_stages[stage].unit, (unsigned long long)items, p50 * 1e3, p99 * 1e3,
+            p50 > 0 ? (double)bytes / (1024.0 * 1024.0) / p50 : 0.0,
+            bench_stages[stage].unit, p50 > 0 ? (double)items / p50 : 0.0);
+    free(sorted);
+}
+
+static void bench_report(FILE *out, const BenchRun *run) {
+    fprintf(out, "{\n  \"tool\": \"redyne_bench\",\n  \"timestamp\": %lld,\n", (long long)time(NULL));
+    fprintf(out, "  \"iterations\": %u,\n  \"threads\": %u,\n  \"cfg_instruction_limit\": %llu,\n",
+            run->iterations, run->threads, (unsigned long long)run->cfg_instructions);
+    fprintf(out, "  \"string_scan_kernel\": \"%s\",\n", string_scan_kernel_name());
+    fprintf(out, "  \"peak_rss_bytes\": %llu,\n", (unsigned long long)bench_peak_rss_bytes());
+
+    /* Corpus totals: summed bytes and items over the summed per-binary
+       medians; latency percentiles pool every run. */
+    fprintf(out, "  \"stages\": {\n");
+    bool first_stage = true;
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        uint32_t total_count = 0;
+        for (uint32_t b = 0; b < run->binary_count; b++) total_count += run->binaries[b].stages[stage].count;
+        if (total_count == 0) continue;
+
+        double *pooled = (double*)malloc(total_count * sizeof(double));
+        if (!pooled) continue;
+        uint32_t n = 0;
+        uint64_t bytes = 0, items = 0;
+        double median_sum = 0.0;
+        for (uint32_t b = 0; b < run->binary_count; b++) {
+            const BenchSeries *series = &run->binaries[b].stages[stage];
+            if (series->count == 0) continue;
+            memcpy(pooled + n, series->samples, series->count * sizeof(double));
+            double *sorted = pooled + n;
+            qsort(sorted, series->count, sizeof(double), bench_compare_double);
+            median_sum += bench_percentile(sorted, series->count, 50.0);
+            n += series->count;
+            bytes += series->bytes;
+            items += series->items;
+        }
+        qsort(pooled, n, sizeof(double), bench_compare_double);
+
+        fprintf(out, "%s    \"%s\": { \"runs\": %u, \"bytes\": %llu, \"%s\": %llu, "
+                "\"p50_ms\": %.3f, \"p99_ms\": %.3f, \"mb_per_s\": %.1f, \"%s_per_s\": %.0f }",
+                first_stage ? "" : ",\n", bench_stages[stage].name, n, (unsigned long long)bytes,
+                bench_stages[stage].unit, (unsigned long long)items,
+                bench_percentile(pooled, n, 50.0) * 1e3, bench_percentile(pooled, n, 99.0) * 1e3,
+                median_sum > 0 ? (double)bytes / (1024.0 * 1024.0) / median_sum : 0.0,
+                bench_stages[stage].unit, median_sum > 0 ? (double)items / median_sum : 0.0);
+        first_stage = false;
+        free(pooled);
+    }
+    fprintf(out, "\n  },\n  \"binaries\": [\n");
+
+    bool first_binary = true;
+    for (uint32_t b = 0; b < run->binary_count; b++) {
+        const BenchBinary *binary = &run->binaries[b];
+        if (binary->stages[STAGE_PARSE].count == 0) continue;
+
+        fprintf(out, "%s    { \"path\": ", first_binary ? "" : ",\n");
+        bench_json_string(out, binary->path);
+        fprintf(out, ", \"synthetic\": %s, \"file_size\": %llu, \"cpu\": \"%s\",\n      \"stages\": {\n",
+                binary->synthetic ? "true" : "false", (unsigned long long)binary->file_size,
+                macho_cpu_type_string(binary->cputype));
+        bool first = true;
+        for (int stage = 0; stage < STAGE_COUNT; stage++) {
+            const BenchSeries *series = &binary->stages[stage];
+            if (series->count == 0) continue;
+            if (!first) fprintf(out, ",\n");
+            bench_json_series(out, (BenchStage)stage, series->samples, series->count,
+                              series->bytes, series->items, "        ");
+            first = false;
+        }
+        fprintf(out, "\n      } }");
+        first_binary = false;
+    }
+
+    fprintf(out, "\n  ],\n  \"skipped\": [");
+    for (uint32_t i = 0; i < run->skipped_count; i++) {
+        if (i > 0) fprintf(out, ", ");
+        bench_json_string(out, run->skipped[i]);
+    }
+    fprintf(out, "]\n}\n");
+}
+
+#pragma mark - Main
+
+static void bench_usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-n iterations] [-s synthetic_mb]... [-c cfg_instructions] [-t threads]\n"
+            "          [-o report.json] [path | directory]...\n"
+            "  -n  runs per binary and stage (default %d)\n"
+            "  -s  add a synthetic ARM64 image with this many MB of __text (repeatable)\n"
+            "  -c  instructions given to cfg_build_all, 0 for the whole section (default %d)\n"
+            "  -t  threads for the parallel stages (default: online CPUs, 1 to skip)\n"
+            "  -o  write the JSON report here instead of stdout\n",
+            argv0, BENCH_DEFAULT_ITERATIONS, BENCH_DEFAULT_CFG_INSTRUCTIONS);
+}
+
+int main(int argc, char **argv) {
+    static BenchRun run;
+    run.iterations = BENCH_DEFAULT_ITERATIONS;
+    run.cfg_instructions = BENCH_DEFAULT_CFG_INSTRUCTIONS;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    run.threads = cpus > 0 ? (uint32_t)cpus : 1;
+
+    uint32_t synthetic_mb[16];
+    uint32_t synthetic_count = 0;
+    const char *output_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:c:t:o:h")) != -1) {
+        switch (opt) {
+            case 'n': run.iterations = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 's':
+                if (synthetic_count < 16) synthetic_mb[synthetic_count++] = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            case 'c': run.cfg_instructions = strtoull(optarg, NULL, 10); break;
+            case 't': run.threads = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'o': output_path = optarg; break;
+            default:
+                bench_usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (run.iterations == 0) run.iterations = 1;
+
+    for (int i = optind; i < argc; i++) bench_add_corpus(&run, argv[i]);
+
+    uint32_t first_synthetic = run.binary_count;
+    for (uint32_t i = 0; i < synthetic_count; i++) {
+        if (synthetic_mb[i] == 0) continue;
+        char *path = bench_write_synthetic(synthetic_mb[i], 0x5EED0000ULL + i);
+        if (!path) {
+            fprintf(stderr, "redyne_bench: could not write a %u MB synthetic image\n", synthetic_mb[i]);
+            continue;
+        }
+        bench_add_path(&run, path, true);
+        free(path);
+    }
+
+    for (uint32_t b = 0; b < run.binary_count; b++) {
+        BenchBinary *binary = &run.binaries[b];
+        fprintf(stderr, "redyne_bench: %s\n", binary->path);
+        if (!bench_binary(&run, binary) && run.skipped_count < BENCH_MAX_BINARIES) {
+            run.skipped[run.skipped_count++] = strdup(binary->path);
+        }
+    }
+
+    FILE *out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "redyne_bench: cannot write %s\n", output_path);
+        return 1;
+    }
+    bench_report(out, &run);
+    if (out != stdout) fclose(out);
+
+    for (uint32_t b = first_synthetic; b < run.binary_count; b++) unlink(run.binaries[b].path);
+    return 0;
+}